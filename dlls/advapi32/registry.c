@@ -41,6 +41,7 @@
 #include "advapi32_misc.h"
 
 #include "wine/unicode.h"
+#include "wine/server.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(reg);
@@ -1780,6 +1781,88 @@ static VOID ADVAPI_ApplyRestrictions( DWORD dwFlags, DWORD dwType,
 }
 
 
+/******************************************************************************
+ * query_subkey_value
+ *
+ * Helper function for RegGetValueW: open the subkey, query the value and close
+ * the subkey again in a single server round trip. Returns FALSE if the value
+ * needs to be expanded, in which case the caller has to do it the slow way.
+ */
+static BOOL query_subkey_value( HKEY hkey, LPCWSTR subkey, LPCWSTR value, DWORD flags,
+                                DWORD *type, void *data, DWORD *count, LONG *open_ret, LONG *ret )
+{
+    struct __server_request_info open_info, query_info, close_info;
+    struct open_key_request *open_req = &open_info.u.req.open_key_request;
+    const struct get_key_value_reply *query_reply = &query_info.u.reply.get_key_value_reply;
+    struct __server_batch_entry batch[3];
+    DWORD subkey_len, value_len = value ? strlenW( value ) * sizeof(WCHAR) : 0;
+    unsigned int status;
+
+    /* NT+ allows beginning backslash for HKEY_CLASSES_ROOT */
+    if (HandleToUlong(hkey) == HandleToUlong(HKEY_CLASSES_ROOT) && *subkey == '\\') subkey++;
+    subkey_len = strlenW( subkey ) * sizeof(WCHAR);
+    if (subkey_len > 0xfffe || value_len > 16383 * sizeof(WCHAR)) return FALSE;
+    /* the reply is staged in a temporary buffer, don't bother for large values */
+    if (data && *count > 0x10000) return FALSE;
+
+    if (!(hkey = get_special_root_hkey( hkey, KEY_QUERY_VALUE )))
+    {
+        *open_ret = ERROR_INVALID_HANDLE;
+        return TRUE;
+    }
+
+    wine_server_init_req( &open_info, REQ_open_key );
+    open_req->parent = wine_server_obj_handle( hkey );
+    open_req->access = KEY_QUERY_VALUE;
+    wine_server_add_data( &open_info, subkey, subkey_len );
+    batch[0].req = &open_info;
+    batch[0].handle_from = -1;
+
+    wine_server_init_req( &query_info, REQ_get_key_value );
+    wine_server_add_data( &query_info, value, value_len );
+    if (data) wine_server_set_reply( &query_info, data, *count );
+    batch[1].req = &query_info;
+    batch[1].handle_from = 0;
+    batch[1].handle_offset = offsetof( struct get_key_value_request, hkey );
+    batch[1].reply_offset = offsetof( struct open_key_reply, hkey );
+
+    wine_server_init_req( &close_info, REQ_close_handle );
+    batch[2].req = &close_info;
+    batch[2].handle_from = 0;
+    batch[2].handle_offset = offsetof( struct close_handle_request, handle );
+    batch[2].reply_offset = offsetof( struct open_key_reply, hkey );
+
+    wine_server_call_batch( batch, 3 );
+
+    if ((status = open_info.u.reply.reply_header.error))
+    {
+        *open_ret = RtlNtStatusToDosError( status );
+        return TRUE;
+    }
+    *open_ret = ERROR_SUCCESS;
+
+    status = query_info.u.reply.reply_header.error;
+    if (status) *ret = RtlNtStatusToDosError( status );
+    else if (data && query_reply->total > *count) *ret = ERROR_MORE_DATA;
+    else *ret = ERROR_SUCCESS;
+    if (*ret != ERROR_SUCCESS && *ret != ERROR_MORE_DATA) return TRUE;
+
+    if (query_reply->type == REG_EXPAND_SZ && !(flags & RRF_NOEXPAND)) return FALSE;
+
+    /* if the type is REG_SZ and data is not 0-terminated
+     * and there is enough space in the buffer NT appends a \0 */
+    if (*ret == ERROR_SUCCESS && data && is_string( query_reply->type ) &&
+        query_reply->total <= *count - sizeof(WCHAR))
+    {
+        WCHAR *ptr = (WCHAR *)((char *)data + query_reply->total);
+        if (ptr > (WCHAR *)data && ptr[-1]) *ptr = 0;
+    }
+    *type = query_reply->type;
+    *count = query_reply->total;
+    return TRUE;
+}
+
+
 /******************************************************************************
  * RegGetValueW   [ADVAPI32.@]
  *
@@ -1829,6 +1912,14 @@ LSTATUS WINAPI RegGetValueW( HKEY hKey, LPCWSTR pszSubKey, LPCWSTR pszValue,
 
     if (pszSubKey && pszSubKey[0])
     {
+        LONG open_ret;
+
+        if (query_subkey_value( hKey, pszSubKey, pszValue, dwFlags, &dwType,
+                                pvData, &cbData, &open_ret, &ret ))
+        {
+            if (open_ret != ERROR_SUCCESS) return open_ret;
+            goto done;
+        }
         ret = RegOpenKeyExW(hKey, pszSubKey, 0, KEY_QUERY_VALUE, &hKey);
         if (ret != ERROR_SUCCESS) return ret;
     }
@@ -1888,6 +1979,7 @@ LSTATUS WINAPI RegGetValueW( HKEY hKey, LPCWSTR pszSubKey, LPCWSTR pszValue,
     if (pszSubKey && pszSubKey[0])
         RegCloseKey(hKey);
 
+done:
     ADVAPI_ApplyRestrictions(dwFlags, dwType, cbData, &ret);
 
     if (pvData && ret != ERROR_SUCCESS && (dwFlags & RRF_ZEROONFAILURE))
@@ -42,6 +42,7 @@ static const char * sTestpath2 = "%FOO%\\subdir1";
 static const DWORD ptr_size = 8 * sizeof(void*);
 
 static DWORD (WINAPI *pRegGetValueA)(HKEY,LPCSTR,LPCSTR,DWORD,LPDWORD,PVOID,LPDWORD);
+static DWORD (WINAPI *pRegGetValueW)(HKEY,LPCWSTR,LPCWSTR,DWORD,LPDWORD,PVOID,LPDWORD);
 static LONG (WINAPI *pRegCopyTreeA)(HKEY,const char *,HKEY);
 static LONG (WINAPI *pRegDeleteTreeA)(HKEY,const char *);
 static DWORD (WINAPI *pRegDeleteKeyExA)(HKEY,LPCSTR,REGSAM,DWORD);
@@ -137,6 +138,7 @@ static void InitFunctionPtrs(void)
 
     /* This function was introduced with Windows 2003 SP1 */
     ADVAPI32_GET_PROC(RegGetValueA);
+    ADVAPI32_GET_PROC(RegGetValueW);
     ADVAPI32_GET_PROC(RegCopyTreeA);
     ADVAPI32_GET_PROC(RegDeleteTreeA);
     ADVAPI32_GET_PROC(RegDeleteKeyExA);
@@ -806,6 +808,12 @@ static void test_get_value(void)
     CHAR buf[80];
     CHAR expanded[] = "bar\\subdir1";
     CHAR expanded2[] = "ImARatherLongButIndeedNeededString\\subdir1";
+    WCHAR bufW[80], expectedW[80];
+    static const WCHAR subkeyW[] = {'S','o','f','t','w','a','r','e','\\','W','i','n','e','\\','T','e','s','t',0};
+    static const WCHAR tp1_szW[] = {'T','P','1','_','S','Z',0};
+    static const WCHAR tp1_exp_szW[] = {'T','P','1','_','E','X','P','_','S','Z',0};
+    static const WCHAR dwordW[] = {'D','W','O','R','D',0};
+    static const WCHAR missingW[] = {'M','i','s','s','i','n','g',0};
    
     if(!pRegGetValueA)
     {
@@ -999,7 +1007,48 @@ static void test_get_value(void)
         "strlen(expanded)=%d, strlen(sTestpath1)=%d, size=%d\n", lstrlenA(expanded), lstrlenA(sTestpath1), size);
     ok(type == REG_SZ, "type=%d\n", type);
     ok(!strcmp(expanded, buf), "expanded=\"%s\" buf=\"%s\"\n", expanded, buf);
-} 
+
+    if (!pRegGetValueW) return;
+
+    /* Query by subkey-name with the unicode version */
+    MultiByteToWideChar(CP_ACP, 0, sTestpath1, -1, expectedW, sizeof(expectedW)/sizeof(WCHAR));
+    bufW[0] = 0; type = 0xdeadbeef; size = sizeof(bufW);
+    ret = pRegGetValueW(HKEY_CURRENT_USER, subkeyW, tp1_szW, RRF_RT_REG_SZ, &type, bufW, &size);
+    ok(ret == ERROR_SUCCESS, "ret=%d\n", ret);
+    ok(size == (strlen(sTestpath1)+1) * sizeof(WCHAR), "size=%d\n", size);
+    ok(type == REG_SZ, "type=%d\n", type);
+    ok(!lstrcmpW(expectedW, bufW), "buf=%s\n", wine_dbgstr_w(bufW));
+
+    /* Buffer too small */
+    type = 0xdeadbeef; size = sizeof(WCHAR);
+    ret = pRegGetValueW(HKEY_CURRENT_USER, subkeyW, tp1_szW, RRF_RT_REG_SZ, &type, bufW, &size);
+    ok(ret == ERROR_MORE_DATA, "ret=%d\n", ret);
+    ok(size == (strlen(sTestpath1)+1) * sizeof(WCHAR), "size=%d\n", size);
+    ok(type == REG_SZ, "type=%d\n", type);
+
+    /* No buffer */
+    type = 0xdeadbeef; size = 0xdeadbeef;
+    ret = pRegGetValueW(HKEY_CURRENT_USER, subkeyW, dwordW, RRF_RT_REG_DWORD, &type, NULL, &size);
+    ok(ret == ERROR_SUCCESS, "ret=%d\n", ret);
+    ok(size == 4, "size=%d\n", size);
+    ok(type == REG_DWORD, "type=%d\n", type);
+
+    /* Missing value and missing subkey */
+    ret = pRegGetValueW(HKEY_CURRENT_USER, subkeyW, missingW, RRF_RT_ANY, NULL, NULL, NULL);
+    ok(ret == ERROR_FILE_NOT_FOUND, "ret=%d\n", ret);
+    ret = pRegGetValueW(HKEY_CURRENT_USER, missingW, dwordW, RRF_RT_ANY, NULL, NULL, NULL);
+    ok(ret == ERROR_FILE_NOT_FOUND, "ret=%d\n", ret);
+
+    /* REG_EXPAND_SZ is still expanded */
+    MultiByteToWideChar(CP_ACP, 0, expanded, -1, expectedW, sizeof(expectedW)/sizeof(WCHAR));
+    bufW[0] = 0; type = 0xdeadbeef; size = sizeof(bufW);
+    ret = pRegGetValueW(HKEY_CURRENT_USER, subkeyW, tp1_exp_szW, RRF_RT_REG_SZ, &type, bufW, &size);
+    ok(ret == ERROR_SUCCESS, "ret=%d\n", ret);
+    ok(size == (strlen(expanded)+1) * sizeof(WCHAR) || broken(size == (strlen(sTestpath1)+1) * sizeof(WCHAR)),
+       "size=%d\n", size);
+    ok(type == REG_SZ, "type=%d\n", type);
+    ok(!lstrcmpW(expectedW, bufW), "buf=%s\n", wine_dbgstr_w(bufW));
+}
 
 static void test_reg_open_key(void)
 {
@@ -148,6 +148,8 @@ struct ZIPstate {
     cab_ULONG v[ZIPN_MAX];      /* values in order of bit length */
     cab_ULONG x[ZIPBMAX+1];     /* bit offsets, then code stack */
     cab_UBYTE *inpos;
+    cab_UWORD pair[1<<ZIPLBITS];     /* two literals decoded with one lookup */
+    cab_UBYTE pair_len[1<<ZIPLBITS]; /* bits used by the pair, 0 if none */
 };
   
 /* Quantum stuff */
@@ -232,6 +234,10 @@ struct LZXstate {
     LZX_DECLARE_TABLE(MAINTREE);
     LZX_DECLARE_TABLE(LENGTH);
     LZX_DECLARE_TABLE(ALIGNED);
+
+    /* pairs of literals whose codes both fit in the first MAINTREE lookup */
+    cab_UWORD MAINTREE_pair[1<<LZX_MAINTREE_TABLEBITS];
+    cab_UBYTE MAINTREE_pair_len[1<<LZX_MAINTREE_TABLEBITS];
 };
 
 struct lzx_bits {
@@ -454,6 +460,13 @@ typedef struct cds_forward {
     MAXSYMBOLS(tbl), TABLEBITS(tbl), LENTABLE(tbl), SYMTABLE(tbl)       \
   )) { return DECR_ILLEGALDATA; }
 
+/* BUILD_PAIR_TABLE(tablename) builds the table of pairs of literals used
+ * by READ_HUFFPAIR, once BUILD_TABLE has accepted the code lengths.
+ */
+#define BUILD_PAIR_TABLE(tbl)                                           \
+  make_pair_table(MAXSYMBOLS(tbl), LZX_NUM_CHARS, TABLEBITS(tbl),       \
+    LENTABLE(tbl), LZX(tbl##_pair), LZX(tbl##_pair_len))
+
 /* READ_HUFFSYM(tablename, var) decodes one huffman symbol from the
  * bitstream using the stated table and puts it in var.
  */
@@ -471,6 +484,20 @@ typedef struct cds_forward {
   REMOVE_BITS(j);                                                       \
 } while (0)
 
+/* READ_HUFFPAIR(tablename, var) decodes two literals with a single lookup
+ * and puts them in var, the first one in the low byte. j is set to the
+ * number of bits used, or to 0 when the next codes aren't such a pair, in
+ * which case nothing is removed from the bitstream.
+ */
+#define READ_HUFFPAIR(tbl,var) do {                                     \
+  ENSURE_BITS(16);                                                      \
+  i = PEEK_BITS(TABLEBITS(tbl));                                        \
+  if ((j = LZX(tbl##_pair_len)[i])) {                                   \
+    (var) = LZX(tbl##_pair)[i];                                         \
+    REMOVE_BITS(j);                                                     \
+  }                                                                     \
+} while (0)
+
 /* READ_LENGTHS(tablename, first, last) reads in code lengths for symbols
  * first to last in the given table. The code lengths are stored in their
  * own special LZX way.
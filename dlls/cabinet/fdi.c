@@ -163,7 +163,7 @@ typedef struct fdi_cds_fwd {
   struct fdi_cds_fwd *next;
 } fdi_decomp_state;
 
-#define ZIPNEEDBITS(n) {while(k<(n)){cab_LONG c=*(ZIP(inpos)++);\
+#define ZIPNEEDBITS(n) {while(k<(n)){cab_LONG c=*(inpos++);\
     b|=((cab_ULONG)c)<<k;k+=8;}}
 #define ZIPDUMPBITS(n) {b>>=(n);k-=(n);}
 
@@ -1068,19 +1068,47 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
   cab_ULONG ml, md;         /* masks for bl and bd bits */
   register cab_ULONG b;     /* bit buffer */
   register cab_ULONG k;     /* number of bits in bit buffer */
+  cab_UBYTE *inpos;         /* input position */
+  cab_UBYTE *pair_len = NULL; /* bits of two literals decoded at once */
 
   /* make local copies of globals */
   b = ZIP(bb);                       /* initialize bit buffer */
   k = ZIP(bk);
+  inpos = ZIP(inpos);
   w = ZIP(window_posn);                       /* initialize window position */
 
   /* inflate the coded data */
   ml = Zipmask[bl];           	/* precompute masks for speed */
   md = Zipmask[bd];
 
+  /* find the pairs of literals that both fit in the first lookup */
+  if (bl <= ZIPLBITS)
+  {
+    pair_len = ZIP(pair_len);
+    for (n = 0; n <= ml; n++)
+    {
+      pair_len[n] = 0;
+      if (tl[n].e != 16 || tl[n].b >= bl)
+        continue;
+      t = tl + (n >> tl[n].b);
+      if (t->e != 16 || t->b + tl[n].b > bl)
+        continue;
+      pair_len[n] = t->b + tl[n].b;
+      ZIP(pair)[n] = tl[n].v.n | (t->v.n << 8);
+    }
+  }
+
   for(;;)
   {
     ZIPNEEDBITS((cab_ULONG)bl)
+    if (pair_len && (e = pair_len[b & ml]))
+    {
+      n = ZIP(pair)[b & ml];
+      CAB(outbuf)[w++] = (cab_UBYTE)n;
+      CAB(outbuf)[w++] = (cab_UBYTE)(n >> 8);
+      ZIPDUMPBITS(e)
+      continue;
+    }
     if((e = (t = tl + (b & ml))->e) > 16)
       do
       {
@@ -1124,10 +1152,17 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
         e = ZIPWSIZE - max(d, w);
         e = min(e, n);
         n -= e;
-        do
+        if (d + e <= w || w + e <= d)   /* no overlap */
         {
-          CAB(outbuf)[w++] = CAB(outbuf)[d++];
-        } while (--e);
+          memcpy(CAB(outbuf) + w, CAB(outbuf) + d, e);
+          w += e;
+          d += e;
+        }
+        else
+          do
+          {
+            CAB(outbuf)[w++] = CAB(outbuf)[d++];
+          } while (--e);
       } while (n);
     }
   }
@@ -1136,6 +1171,7 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
   ZIP(window_posn) = w;              /* restore global window pointer */
   ZIP(bb) = b;                       /* restore global bit buffer */
   ZIP(bk) = k;
+  ZIP(inpos) = inpos;
 
   /* done */
   return 0;
@@ -1151,10 +1187,12 @@ static cab_LONG fdi_Zipinflate_stored(fdi_decomp_state *decomp_state)
   cab_ULONG w;           /* current window position */
   register cab_ULONG b;  /* bit buffer */
   register cab_ULONG k;  /* number of bits in bit buffer */
+  cab_UBYTE *inpos;      /* input position */
 
   /* make local copies of globals */
   b = ZIP(bb);                       /* initialize bit buffer */
   k = ZIP(bk);
+  inpos = ZIP(inpos);
   w = ZIP(window_posn);              /* initialize window position */
 
   /* go to byte boundary */
@@ -1182,6 +1220,7 @@ static cab_LONG fdi_Zipinflate_stored(fdi_decomp_state *decomp_state)
   ZIP(window_posn) = w;              /* restore global window pointer */
   ZIP(bb) = b;                       /* restore global bit buffer */
   ZIP(bk) = k;
+  ZIP(inpos) = inpos;
   return 0;
 }
 
@@ -1250,10 +1289,12 @@ static cab_LONG fdi_Zipinflate_dynamic(fdi_decomp_state *decomp_state)
   cab_ULONG nd;          	/* number of distance codes */
   register cab_ULONG b;         /* bit buffer */
   register cab_ULONG k;	        /* number of bits in bit buffer */
+  cab_UBYTE *inpos;             /* input position */
 
   /* make local bit buffer */
   b = ZIP(bb);
   k = ZIP(bk);
+  inpos = ZIP(inpos);
   ll = ZIP(ll);
 
   /* read in table lengths */
@@ -1340,6 +1381,7 @@ static cab_LONG fdi_Zipinflate_dynamic(fdi_decomp_state *decomp_state)
   /* restore the global bit buffer */
   ZIP(bb) = b;
   ZIP(bk) = k;
+  ZIP(inpos) = inpos;
 
   /* build the decoding tables for literal/length and distance codes */
   bl = ZIPLBITS;
@@ -1370,10 +1412,12 @@ static cab_LONG fdi_Zipinflate_block(cab_LONG *e, fdi_decomp_state *decomp_state
   cab_ULONG t;           	/* block type */
   register cab_ULONG b;     /* bit buffer */
   register cab_ULONG k;     /* number of bits in bit buffer */
+  cab_UBYTE *inpos;         /* input position */
 
   /* make local bit buffer */
   b = ZIP(bb);
   k = ZIP(bk);
+  inpos = ZIP(inpos);
 
   /* read in last block bit */
   ZIPNEEDBITS(1)
@@ -1388,6 +1432,7 @@ static cab_LONG fdi_Zipinflate_block(cab_LONG *e, fdi_decomp_state *decomp_state
   /* restore the global bit buffer */
   ZIP(bb) = b;
   ZIP(bk) = k;
+  ZIP(inpos) = inpos;
 
   /* inflate that block type */
   if(t == 2)
@@ -1600,6 +1645,55 @@ static int fdi_lzx_read_lens(cab_UBYTE *lens, cab_ULONG first, cab_ULONG last, s
   return 0;
 }
 
+/*************************************************************************
+ * make_pair_table (internal)
+ *
+ * Builds a table to decode two literals with a single lookup, for the
+ * pairs whose codes fit together in nbits. The codes are allocated in
+ * the same order as in make_decode_table, which must have accepted the
+ * lengths first.
+ *
+ * PARAMS
+ *   nsyms:    total number of symbols in this huffman tree.
+ *   nlits:    number of literals, the first symbols of the tree.
+ *   nbits:    number of bits used to index the table.
+ *   length:   A table to get code lengths from [0 to syms-1]
+ *   pair:     The table to fill up with the literals, first one in the low byte.
+ *   pair_len: The table to fill up with the length of both codes, 0 if none.
+ */
+static void make_pair_table(cab_ULONG nsyms, cab_ULONG nlits, cab_ULONG nbits,
+                            const cab_UBYTE *length, cab_UWORD *pair, cab_UBYTE *pair_len) {
+  cab_UWORD lits[LZX_NUM_CHARS];  /* literals by increasing code length */
+  cab_ULONG pos[LZX_NUM_CHARS];   /* first table entry of each literal */
+  cab_ULONG count = 0, next = 0, bit_num, sym, i, j, first, fill, len;
+
+  memset(pair_len, 0, 1 << nbits);
+
+  /* the second literal needs at least one bit */
+  for (bit_num = 1; bit_num < nbits; bit_num++) {
+    for (sym = 0; sym < nsyms; sym++) {
+      if (length[sym] != bit_num) continue;
+      if (sym < nlits) {
+        pos[sym] = next;
+        lits[count++] = sym;
+      }
+      next += 1 << (nbits - bit_num);
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    for (j = 0; j < count; j++) {
+      len = length[lits[i]] + length[lits[j]];
+      if (len > nbits) break;
+      first = pos[lits[i]] + (pos[lits[j]] >> length[lits[i]]);
+      for (fill = 1 << (nbits - len); fill > 0; fill--) {
+        pair[first] = lits[i] | (lits[j] << 8);
+        pair_len[first++] = len;
+      }
+    }
+  }
+}
+
 /*******************************************************
  * LZXfdi_decomp(internal)
  */
@@ -1660,6 +1754,7 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
         READ_LENGTHS(MAINTREE, 0, 256, fdi_lzx_read_lens);
         READ_LENGTHS(MAINTREE, 256, LZX(main_elements), fdi_lzx_read_lens);
         BUILD_TABLE(MAINTREE);
+        BUILD_PAIR_TABLE(MAINTREE);
         if (LENTABLE(MAINTREE)[0xE8] != 0) LZX(intel_started) = 1;
 
         READ_LENGTHS(LENGTH, 0, LZX_NUM_SECONDARY_LENGTHS, fdi_lzx_read_lens);
@@ -1708,6 +1803,15 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
 
       case LZX_BLOCKTYPE_VERBATIM:
         while (this_run > 0) {
+          if (this_run > 1) {
+            READ_HUFFPAIR(MAINTREE, main_element);
+            if (j) {
+              window[window_posn++] = main_element;
+              window[window_posn++] = main_element >> 8;
+              this_run -= 2;
+              continue;
+            }
+          }
           READ_HUFFSYM(MAINTREE, main_element);
 
           if (main_element < LZX_NUM_CHARS) {
@@ -1782,6 +1886,15 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
 
       case LZX_BLOCKTYPE_ALIGNED:
         while (this_run > 0) {
+          if (this_run > 1) {
+            READ_HUFFPAIR(MAINTREE, main_element);
+            if (j) {
+              window[window_posn++] = main_element;
+              window[window_posn++] = main_element >> 8;
+              this_run -= 2;
+              continue;
+            }
+          }
           READ_HUFFSYM(MAINTREE, main_element);
   
           if (main_element < LZX_NUM_CHARS) {
@@ -122,6 +122,71 @@ static const struct
     { 'H','e','l','l','o',' ','W','o','r','l','d','!' }
 };
 
+/* 1024 bytes of skewed text compressed with LZX (window 15) as literals only,
+ * in a single verbatim block with no match lengths */
+#define LZX_SIZE 1024
+
+static const struct
+{
+    struct CFHEADER header;
+    struct CFFOLDER folder;
+    struct CFFILE file;
+    UCHAR szName[sizeof("lzx.txt")];
+    struct CFDATA data;
+    UCHAR ab[666];
+} lzx_cab_data =
+{
+    { {'M','S','C','F'}, 0, 0x2e6, 0, sizeof(struct CFHEADER) + sizeof(struct CFFOLDER), 0, 3,1, 1, 1, 0, 0x1225, 0x2013 },
+    { sizeof(struct CFHEADER) + sizeof(struct CFFOLDER) + sizeof(struct CFFILE) + sizeof("lzx.txt"), 1, tcompTYPE_LZX | (15 << 8) },
+    { LZX_SIZE, 0, 0, 0x1225, 0x2013, 0xa114 },
+    { 'l','z','x','.','t','x','t',0 },
+    { 0, 666, LZX_SIZE },
+    {
+      0x00, 0x10, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x34, 0x00, 0x00, 0x80, 0x03,
+      0x01, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5d, 0x37, 0xb1, 0xf5, 0x4a, 0x5b,
+      0x48, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x01, 0x00, 0xc9, 0x1f, 0x1e, 0x30, 0xf9, 0xa2, 0x5f, 0x20, 0x2b, 0xdc, 0xc3, 0xd5,
+      0xd7, 0x65, 0x18, 0x82, 0xb3, 0x97, 0x00, 0x8f, 0x39, 0x80, 0x07, 0xe9, 0xb0, 0x3f, 0xb8, 0x90,
+      0x9a, 0x59, 0xd7, 0x2f, 0x19, 0xb4, 0xb3, 0x5f, 0x1d, 0x60, 0xfc, 0x20, 0xd5, 0x0b, 0x1c, 0xc2,
+      0x76, 0xa9, 0xfd, 0x19, 0xf6, 0x4c, 0xb0, 0x1a, 0xfe, 0xee, 0x47, 0xfd, 0x20, 0x24, 0x5b, 0xda,
+      0x16, 0xf9, 0x93, 0xda, 0x4c, 0x04, 0xc0, 0xee, 0xdc, 0x05, 0xa5, 0x45, 0xd9, 0xba, 0xeb, 0xae,
+      0x64, 0x70, 0x67, 0x31, 0x78, 0x9e, 0xe7, 0x03, 0xcf, 0xe7, 0xff, 0xab, 0x26, 0x89, 0x41, 0x25,
+      0x9e, 0xbf, 0x32, 0xa9, 0x09, 0x30, 0x67, 0x55, 0xab, 0xf6, 0x83, 0x99, 0x5c, 0x2a, 0x30, 0xb7,
+      0xf8, 0x0d, 0x5a, 0xa3, 0x44, 0xa2, 0x7d, 0x48, 0x8b, 0x9d, 0x71, 0x97, 0x8d, 0xa5, 0xd2, 0x65,
+      0x81, 0x35, 0x0a, 0x75, 0x76, 0x9d, 0x27, 0x0b, 0x81, 0xd4, 0xc7, 0xe6, 0xcf, 0xcc, 0x5c, 0x17,
+      0xbb, 0xf9, 0xe1, 0x4a, 0xba, 0x63, 0xff, 0x2a, 0x68, 0x30, 0x08, 0x6a, 0xec, 0x8a, 0xc7, 0xa2,
+      0xb0, 0x38, 0xa7, 0xe3, 0xfc, 0xfd, 0x03, 0xd5, 0xcd, 0x8b, 0x2f, 0x62, 0x8b, 0xce, 0x68, 0x5e,
+      0x6c, 0xe0, 0xf8, 0x74, 0x66, 0xdb, 0x15, 0x1a, 0x27, 0xfe, 0x1c, 0xad, 0xbd, 0x82, 0x74, 0xfc,
+      0xad, 0x90, 0xef, 0xa3, 0x4d, 0xd3, 0xbc, 0xd3, 0x50, 0x84, 0xeb, 0x4f, 0xa2, 0x0e, 0x20, 0xb9,
+      0x42, 0x3c, 0xc2, 0x9f, 0x6d, 0x1c, 0xc4, 0x68, 0x70, 0xed, 0x8a, 0x81, 0x46, 0x0f, 0x68, 0x7e,
+      0xa2, 0xb2, 0x32, 0x3a, 0xda, 0x15, 0x5e, 0x4e, 0xf2, 0xc8, 0xa2, 0xae, 0x0c, 0x46, 0x1e, 0x5e,
+      0x43, 0xef, 0xe3, 0x30, 0xb9, 0x8a, 0x3f, 0xf6, 0x5f, 0xfb, 0x66, 0xbe, 0x27, 0x9a, 0xea, 0xf3,
+      0xda, 0xf8, 0x82, 0x83, 0xd7, 0x0a, 0x29, 0x90, 0xfe, 0x82, 0x95, 0x44, 0xd6, 0x48, 0x1e, 0xbc,
+      0xbd, 0x0d, 0xa9, 0xc1, 0xe8, 0x7d, 0x34, 0xf8, 0x30, 0x9b, 0x9a, 0x47, 0x5a, 0x11, 0x91, 0x4e,
+      0x57, 0x21, 0xee, 0xd7, 0xcc, 0x44, 0xd8, 0x8d, 0x1a, 0xfc, 0x08, 0x50, 0x86, 0x02, 0x5b, 0x60,
+      0xab, 0x6a, 0x91, 0xf3, 0xbb, 0x16, 0x66, 0x4e, 0xb6, 0x05, 0x9a, 0xae, 0x81, 0x5f, 0xd2, 0x3b,
+      0xe0, 0x99, 0x31, 0x11, 0x82, 0x1f, 0x7c, 0xb1, 0x4e, 0x53, 0x6f, 0x01, 0x22, 0x86, 0x73, 0xc4,
+      0xed, 0xd9, 0x62, 0xa1, 0x34, 0x6f, 0x93, 0x3b, 0x23, 0x61, 0x69, 0x3e, 0xbf, 0x78, 0x0c, 0x8e,
+      0xa7, 0x5b, 0x35, 0xef, 0x52, 0x1a, 0xcd, 0x55, 0xa5, 0x2c, 0x43, 0x13, 0x02, 0xd4, 0x41, 0x17,
+      0x21, 0x98, 0x56, 0xd2, 0x7b, 0x4c, 0x9f, 0x59, 0x11, 0xe2, 0xb9, 0xd2, 0xf2, 0xd7, 0xa1, 0xf4,
+      0x15, 0xc9, 0x0a, 0x04, 0xea, 0x41, 0xe1, 0x35, 0x62, 0x96, 0x28, 0x4c, 0xbe, 0x60, 0x00, 0x3f,
+      0xcd, 0xb9, 0xc2, 0x85, 0xdd, 0xfb, 0xab, 0x40, 0x1f, 0x38, 0xb2, 0x13, 0x0d, 0xbc, 0x69, 0xd7,
+      0x73, 0x94, 0x2c, 0x04, 0x9c, 0x98, 0xf5, 0x63, 0xd9, 0xb0, 0xa8, 0x84, 0x54, 0x21, 0x81, 0x84,
+      0x3d, 0x0a, 0xf8, 0xd0, 0x0e, 0x59, 0xaa, 0x64, 0xcc, 0xb4, 0x6d, 0x0c, 0x69, 0xb6, 0xe6, 0xb4,
+      0x09, 0x9b, 0xf0, 0xb8, 0x05, 0xb8, 0x2b, 0xbc, 0x9b, 0xc1, 0x51, 0x30, 0x7f, 0x23, 0x3a, 0x84,
+      0x48, 0xc5, 0x50, 0xdc, 0xee, 0x55, 0x9f, 0x04, 0x5d, 0xcd, 0x1b, 0xb9, 0xea, 0x3b, 0xc2, 0x3f,
+      0x80, 0xd5, 0x27, 0x78, 0xcc, 0xa0, 0x97, 0x6f, 0x4c, 0xd7, 0xbd, 0xce, 0xfb, 0x68, 0xf3, 0x57,
+      0xf3, 0x88, 0x2f, 0x59, 0xf2, 0x8c, 0x6a, 0x76, 0x79, 0x83, 0xde, 0x97, 0x0b, 0x31, 0x96, 0x4d,
+      0x3e, 0xf8, 0x02, 0x94, 0x1c, 0x17, 0xb6, 0x51, 0x41, 0x5f, 0x5b, 0x10, 0xdc, 0xaa, 0x9b, 0xc7,
+      0x7c, 0x9f, 0xfc, 0x14, 0x76, 0x4c, 0x37, 0xa9, 0x40, 0x0b
+    }
+};
+
 #include <poppack.h>
 
 struct mem_data
@@ -949,6 +1014,169 @@ static void test_FDICopy(void)
     FDIDestroy(hfdi);
 }
 
+#define LARGE_SIZE   (8 * 1024 * 1024)
+#define LARGE_HANDLE 0x1225
+
+static char *large_data;
+static UINT large_pos;
+
+static UINT CDECL fdi_large_write(INT_PTR hf, void *pv, UINT cb)
+{
+    ok(hf == LARGE_HANDLE, "expected %#x, got %#lx\n", LARGE_HANDLE, hf);
+    ok(large_pos + cb <= LARGE_SIZE && !memcmp(pv, large_data + large_pos, cb),
+       "unexpected data at offset %u\n", large_pos);
+    large_pos += cb;
+    return cb;
+}
+
+static INT_PTR CDECL fdi_large_notify(FDINOTIFICATIONTYPE fdint, FDINOTIFICATION *info)
+{
+    switch (fdint)
+    {
+    case fdintCOPY_FILE:
+        ok(!strcmp(info->psz1, "large.txt"), "got %s\n", info->psz1);
+        ok(info->cb == LARGE_SIZE, "expected %u, got %u\n", LARGE_SIZE, info->cb);
+        return LARGE_HANDLE;
+
+    case fdintCLOSE_FILE_INFO:
+        ok(info->hf == LARGE_HANDLE, "expected %#x, got %#lx\n", LARGE_HANDLE, info->hf);
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+static void test_FDICopy_large(void)
+{
+    static const char * const words[] =
+        { "the ", "cabinet ", "folder ", "data ", "block ", "file ", "0x1234, ", "\r\n", "{ ", "} " };
+    static char large_txt[] = "large.txt";
+    char path[MAX_PATH + 1], name[] = "extract.cab";
+    CCAB cabParams;
+    HANDLE file;
+    DWORD written, ticks, seed = 1;
+    UINT i, len;
+    HFDI hfdi;
+    HFCI hfci;
+    ERF erf;
+    BOOL ret;
+
+    /* text like data, compressed with dynamic huffman codes */
+    large_data = HeapAlloc(GetProcessHeap(), 0, LARGE_SIZE);
+    for (i = 0; i < LARGE_SIZE; i += len)
+    {
+        seed = seed * 1103515245 + 12345;
+        len = min(strlen(words[(seed >> 16) % 10]), LARGE_SIZE - i);
+        memcpy(large_data + i, words[(seed >> 16) % 10], len);
+    }
+
+    file = CreateFileA(large_txt, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    ok(file != INVALID_HANDLE_VALUE, "Failure to open file %s\n", large_txt);
+    WriteFile(file, large_data, LARGE_SIZE, &written, NULL);
+    CloseHandle(file);
+
+    set_cab_parameters(&cabParams);
+    hfci = FCICreate(&erf, file_placed, mem_alloc, mem_free, fci_open,
+                     fci_read, fci_write, fci_close, fci_seek,
+                     fci_delete, get_temp_file, &cabParams, NULL);
+    ok(hfci != NULL, "Failed to create an FCI context\n");
+    add_file(hfci, large_txt);
+    ret = FCIFlushCabinet(hfci, FALSE, get_next_cabinet, progress);
+    ok(ret, "Failed to flush the cabinet\n");
+    FCIDestroy(hfci);
+    DeleteFileA(large_txt);
+
+    lstrcpyA(path, CURR_DIR);
+    lstrcatA(path, "\\");
+
+    hfdi = FDICreate(fdi_alloc, fdi_free, fdi_open, fdi_read,
+                     fdi_large_write, fdi_close, fdi_seek, cpuUNKNOWN, &erf);
+    ok(hfdi != NULL, "FDICreate error %d\n", erf.erfOper);
+
+    large_pos = 0;
+    ticks = GetTickCount();
+    ret = FDICopy(hfdi, name, path, 0, fdi_large_notify, NULL, 0);
+    ticks = GetTickCount() - ticks;
+    ok(ret, "FDICopy error %d\n", erf.erfOper);
+    ok(large_pos == LARGE_SIZE, "expected %u bytes, got %u\n", LARGE_SIZE, large_pos);
+    trace("extracted %u bytes in %u ms\n", large_pos, ticks);
+
+    FDIDestroy(hfdi);
+    DeleteFileA(name);
+    HeapFree(GetProcessHeap(), 0, large_data);
+}
+
+static char *lzx_data;
+static UINT lzx_pos;
+
+static UINT CDECL fdi_lzx_write(INT_PTR hf, void *pv, UINT cb)
+{
+    ok(hf == LARGE_HANDLE, "expected %#x, got %#lx\n", LARGE_HANDLE, hf);
+    ok(lzx_pos + cb <= LZX_SIZE && !memcmp(pv, lzx_data + lzx_pos, cb),
+       "unexpected data at offset %u\n", lzx_pos);
+    lzx_pos += cb;
+    return cb;
+}
+
+static INT_PTR CDECL fdi_lzx_notify(FDINOTIFICATIONTYPE fdint, FDINOTIFICATION *info)
+{
+    switch (fdint)
+    {
+    case fdintCOPY_FILE:
+        ok(!strcmp(info->psz1, "lzx.txt"), "got %s\n", info->psz1);
+        ok(info->cb == LZX_SIZE, "expected %u, got %u\n", LZX_SIZE, info->cb);
+        return LARGE_HANDLE;
+
+    case fdintCLOSE_FILE_INFO:
+        ok(info->hf == LARGE_HANDLE, "expected %#x, got %#lx\n", LARGE_HANDLE, info->hf);
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+static void test_FDICopy_lzx(void)
+{
+    static const char letters[] = "eeeeeeetttttaaaaoooiiinnnsshhrrdlucmfwypgb  \n";
+    char path[MAX_PATH + 1], name[] = "lzx.cab";
+    HANDLE file;
+    DWORD written, seed = 1;
+    UINT i;
+    HFDI hfdi;
+    ERF erf;
+    BOOL ret;
+
+    /* the content lzx_cab_data was compressed from */
+    lzx_data = HeapAlloc(GetProcessHeap(), 0, LZX_SIZE);
+    for (i = 0; i < LZX_SIZE; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        lzx_data[i] = letters[(seed >> 16) % (sizeof(letters) - 1)];
+    }
+
+    file = CreateFileA(name, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    ok(file != INVALID_HANDLE_VALUE, "Failure to open file %s\n", name);
+    WriteFile(file, &lzx_cab_data, sizeof(lzx_cab_data), &written, NULL);
+    CloseHandle(file);
+
+    lstrcpyA(path, CURR_DIR);
+    lstrcatA(path, "\\");
+
+    hfdi = FDICreate(fdi_alloc, fdi_free, fdi_open, fdi_read,
+                     fdi_lzx_write, fdi_close, fdi_seek, cpuUNKNOWN, &erf);
+    ok(hfdi != NULL, "FDICreate error %d\n", erf.erfOper);
+
+    lzx_pos = 0;
+    ret = FDICopy(hfdi, name, path, 0, fdi_lzx_notify, NULL, 0);
+    ok(ret, "FDICopy error %d\n", erf.erfOper);
+    ok(lzx_pos == LZX_SIZE, "expected %u bytes, got %u\n", LZX_SIZE, lzx_pos);
+
+    FDIDestroy(hfdi);
+    DeleteFileA(name);
+    HeapFree(GetProcessHeap(), 0, lzx_data);
+}
 
 START_TEST(fdi)
 {
@@ -956,4 +1184,6 @@ START_TEST(fdi)
     test_FDIDestroy();
     test_FDIIsCabinet();
     test_FDICopy();
+    test_FDICopy_large();
+    test_FDICopy_lzx();
 }
@@ -390,20 +390,29 @@ D3DXMATRIX * WINAPI D3DXMatrixLookAtRH(D3DXMATRIX *out, const D3DXVECTOR3 *eye,
     return out;
 }
 
+/* Each row of the product is a combination of the rows of m2, computed on
+ * whole rows so that the compiler can use vector instructions. The order of
+ * the operations is the same as with the dot product of a row and a column. */
+static inline void matrix_multiply(D3DXMATRIX *out, const D3DXMATRIX *m1, const D3DXMATRIX *m2)
+{
+    int i, j;
+
+    for (i = 0; i < 4; i++)
+    {
+        const float a0 = m1->u.m[i][0], a1 = m1->u.m[i][1], a2 = m1->u.m[i][2], a3 = m1->u.m[i][3];
+
+        for (j = 0; j < 4; j++)
+            out->u.m[i][j] = a0 * m2->u.m[0][j] + a1 * m2->u.m[1][j] + a2 * m2->u.m[2][j] + a3 * m2->u.m[3][j];
+    }
+}
+
 D3DXMATRIX* WINAPI D3DXMatrixMultiply(D3DXMATRIX *pout, const D3DXMATRIX *pm1, const D3DXMATRIX *pm2)
 {
     D3DXMATRIX out;
-    int i,j;
 
     TRACE("pout %p, pm1 %p, pm2 %p\n", pout, pm1, pm2);
 
-    for (i=0; i<4; i++)
-    {
-        for (j=0; j<4; j++)
-        {
-            out.u.m[i][j] = pm1->u.m[i][0] * pm2->u.m[0][j] + pm1->u.m[i][1] * pm2->u.m[1][j] + pm1->u.m[i][2] * pm2->u.m[2][j] + pm1->u.m[i][3] * pm2->u.m[3][j];
-        }
-    }
+    matrix_multiply(&out, pm1, pm2);
 
     *pout = out;
     return pout;
@@ -416,11 +425,12 @@ D3DXMATRIX* WINAPI D3DXMatrixMultiplyTranspose(D3DXMATRIX *pout, const D3DXMATRI
 
     TRACE("pout %p, pm1 %p, pm2 %p\n", pout, pm1, pm2);
 
+    matrix_multiply(&temp, pm1, pm2);
+
     for (i = 0; i < 4; i++)
         for (j = 0; j < 4; j++)
-            temp.u.m[j][i] = pm1->u.m[i][0] * pm2->u.m[0][j] + pm1->u.m[i][1] * pm2->u.m[1][j] + pm1->u.m[i][2] * pm2->u.m[2][j] + pm1->u.m[i][3] * pm2->u.m[3][j];
+            pout->u.m[j][i] = temp.u.m[i][j];
 
-    *pout = temp;
     return pout;
 }
 
@@ -1324,15 +1334,22 @@ D3DXPLANE* WINAPI D3DXPlaneTransform(D3DXPLANE *pout, const D3DXPLANE *pplane, c
 
 D3DXPLANE* WINAPI D3DXPlaneTransformArray(D3DXPLANE* out, UINT outstride, const D3DXPLANE* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXPlaneTransform(
-            (D3DXPLANE*)((char*)out + outstride * i),
-            (const D3DXPLANE*)((const char*)in + instride * i),
-            matrix);
+    /* Transform the elements inline with a local copy of the matrix, which
+     * the compiler can keep in registers since it can't alias the output. */
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXPLANE p = *(const D3DXPLANE *)((const char *)in + instride * i);
+        D3DXPLANE *o = (D3DXPLANE *)((char *)out + outstride * i);
+
+        o->a = m.u.m[0][0] * p.a + m.u.m[1][0] * p.b + m.u.m[2][0] * p.c + m.u.m[3][0] * p.d;
+        o->b = m.u.m[0][1] * p.a + m.u.m[1][1] * p.b + m.u.m[2][1] * p.c + m.u.m[3][1] * p.d;
+        o->c = m.u.m[0][2] * p.a + m.u.m[1][2] * p.b + m.u.m[2][2] * p.c + m.u.m[3][2] * p.d;
+        o->d = m.u.m[0][3] * p.a + m.u.m[1][3] * p.b + m.u.m[2][3] * p.c + m.u.m[3][3] * p.d;
     }
     return out;
 }
@@ -1727,15 +1744,20 @@ D3DXVECTOR4* WINAPI D3DXVec2Transform(D3DXVECTOR4 *pout, const D3DXVECTOR2 *pv,
 
 D3DXVECTOR4* WINAPI D3DXVec2TransformArray(D3DXVECTOR4* out, UINT outstride, const D3DXVECTOR2* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec2Transform(
-            (D3DXVECTOR4*)((char*)out + outstride * i),
-            (const D3DXVECTOR2*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR2 v = *(const D3DXVECTOR2 *)((const char *)in + instride * i);
+        D3DXVECTOR4 *o = (D3DXVECTOR4 *)((char *)out + outstride * i);
+
+        o->x = m.u.m[0][0] * v.x + m.u.m[1][0] * v.y + m.u.m[3][0];
+        o->y = m.u.m[0][1] * v.x + m.u.m[1][1] * v.y + m.u.m[3][1];
+        o->z = m.u.m[0][2] * v.x + m.u.m[1][2] * v.y + m.u.m[3][2];
+        o->w = m.u.m[0][3] * v.x + m.u.m[1][3] * v.y + m.u.m[3][3];
     }
     return out;
 }
@@ -1758,15 +1780,19 @@ D3DXVECTOR2* WINAPI D3DXVec2TransformCoord(D3DXVECTOR2 *pout, const D3DXVECTOR2
 
 D3DXVECTOR2* WINAPI D3DXVec2TransformCoordArray(D3DXVECTOR2* out, UINT outstride, const D3DXVECTOR2* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec2TransformCoord(
-            (D3DXVECTOR2*)((char*)out + outstride * i),
-            (const D3DXVECTOR2*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR2 v = *(const D3DXVECTOR2 *)((const char *)in + instride * i);
+        D3DXVECTOR2 *o = (D3DXVECTOR2 *)((char *)out + outstride * i);
+        const FLOAT norm = m.u.m[0][3] * v.x + m.u.m[1][3] * v.y + m.u.m[3][3];
+
+        o->x = (m.u.m[0][0] * v.x + m.u.m[1][0] * v.y + m.u.m[3][0]) / norm;
+        o->y = (m.u.m[0][1] * v.x + m.u.m[1][1] * v.y + m.u.m[3][1]) / norm;
     }
     return out;
 }
@@ -1784,15 +1810,18 @@ D3DXVECTOR2* WINAPI D3DXVec2TransformNormal(D3DXVECTOR2 *pout, const D3DXVECTOR2
 
 D3DXVECTOR2* WINAPI D3DXVec2TransformNormalArray(D3DXVECTOR2* out, UINT outstride, const D3DXVECTOR2 *in, UINT instride, const D3DXMATRIX *matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec2TransformNormal(
-            (D3DXVECTOR2*)((char*)out + outstride * i),
-            (const D3DXVECTOR2*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR2 v = *(const D3DXVECTOR2 *)((const char *)in + instride * i);
+        D3DXVECTOR2 *o = (D3DXVECTOR2 *)((char *)out + outstride * i);
+
+        o->x = m.u.m[0][0] * v.x + m.u.m[1][0] * v.y;
+        o->y = m.u.m[0][1] * v.x + m.u.m[1][1] * v.y;
     }
     return out;
 }
@@ -1913,15 +1942,20 @@ D3DXVECTOR4* WINAPI D3DXVec3Transform(D3DXVECTOR4 *pout, const D3DXVECTOR3 *pv,
 
 D3DXVECTOR4* WINAPI D3DXVec3TransformArray(D3DXVECTOR4* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3Transform(
-            (D3DXVECTOR4*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR3 v = *(const D3DXVECTOR3 *)((const char *)in + instride * i);
+        D3DXVECTOR4 *o = (D3DXVECTOR4 *)((char *)out + outstride * i);
+
+        o->x = m.u.m[0][0] * v.x + m.u.m[1][0] * v.y + m.u.m[2][0] * v.z + m.u.m[3][0];
+        o->y = m.u.m[0][1] * v.x + m.u.m[1][1] * v.y + m.u.m[2][1] * v.z + m.u.m[3][1];
+        o->z = m.u.m[0][2] * v.x + m.u.m[1][2] * v.y + m.u.m[2][2] * v.z + m.u.m[3][2];
+        o->w = m.u.m[0][3] * v.x + m.u.m[1][3] * v.y + m.u.m[2][3] * v.z + m.u.m[3][3];
     }
     return out;
 }
@@ -1946,15 +1980,20 @@ D3DXVECTOR3* WINAPI D3DXVec3TransformCoord(D3DXVECTOR3 *pout, const D3DXVECTOR3
 
 D3DXVECTOR3* WINAPI D3DXVec3TransformCoordArray(D3DXVECTOR3* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3TransformCoord(
-            (D3DXVECTOR3*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR3 v = *(const D3DXVECTOR3 *)((const char *)in + instride * i);
+        D3DXVECTOR3 *o = (D3DXVECTOR3 *)((char *)out + outstride * i);
+        const FLOAT norm = m.u.m[0][3] * v.x + m.u.m[1][3] * v.y + m.u.m[2][3] * v.z + m.u.m[3][3];
+
+        o->x = (m.u.m[0][0] * v.x + m.u.m[1][0] * v.y + m.u.m[2][0] * v.z + m.u.m[3][0]) / norm;
+        o->y = (m.u.m[0][1] * v.x + m.u.m[1][1] * v.y + m.u.m[2][1] * v.z + m.u.m[3][1]) / norm;
+        o->z = (m.u.m[0][2] * v.x + m.u.m[1][2] * v.y + m.u.m[2][2] * v.z + m.u.m[3][2]) / norm;
     }
     return out;
 }
@@ -1974,15 +2013,19 @@ D3DXVECTOR3* WINAPI D3DXVec3TransformNormal(D3DXVECTOR3 *pout, const D3DXVECTOR3
 
 D3DXVECTOR3* WINAPI D3DXVec3TransformNormalArray(D3DXVECTOR3* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3TransformNormal(
-            (D3DXVECTOR3*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR3 v = *(const D3DXVECTOR3 *)((const char *)in + instride * i);
+        D3DXVECTOR3 *o = (D3DXVECTOR3 *)((char *)out + outstride * i);
+
+        o->x = m.u.m[0][0] * v.x + m.u.m[1][0] * v.y + m.u.m[2][0] * v.z;
+        o->y = m.u.m[0][1] * v.x + m.u.m[1][1] * v.y + m.u.m[2][1] * v.z;
+        o->z = m.u.m[0][2] * v.x + m.u.m[1][2] * v.y + m.u.m[2][2] * v.z;
     }
     return out;
 }
@@ -2114,15 +2157,20 @@ D3DXVECTOR4* WINAPI D3DXVec4Transform(D3DXVECTOR4 *pout, const D3DXVECTOR4 *pv,
 
 D3DXVECTOR4* WINAPI D3DXVec4TransformArray(D3DXVECTOR4* out, UINT outstride, const D3DXVECTOR4* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec4Transform(
-            (D3DXVECTOR4*)((char*)out + outstride * i),
-            (const D3DXVECTOR4*)((const char*)in + instride * i),
-            matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR4 v = *(const D3DXVECTOR4 *)((const char *)in + instride * i);
+        D3DXVECTOR4 *o = (D3DXVECTOR4 *)((char *)out + outstride * i);
+
+        o->x = m.u.m[0][0] * v.x + m.u.m[1][0] * v.y + m.u.m[2][0] * v.z + m.u.m[3][0] * v.w;
+        o->y = m.u.m[0][1] * v.x + m.u.m[1][1] * v.y + m.u.m[2][1] * v.z + m.u.m[3][1] * v.w;
+        o->z = m.u.m[0][2] * v.x + m.u.m[1][2] * v.y + m.u.m[2][2] * v.z + m.u.m[3][2] * v.w;
+        o->w = m.u.m[0][3] * v.x + m.u.m[1][3] * v.y + m.u.m[2][3] * v.z + m.u.m[3][3] * v.w;
     }
     return out;
 }
@@ -260,6 +260,9 @@ struct d3dx_pres_ins
     unsigned int component_count;
     struct d3dx_pres_operand inputs[MAX_INPUTS_COUNT];
     struct d3dx_pres_operand output;
+    /* no relative addressing and no overlap between the inputs and the
+       output, all the inputs can be read before computing the output */
+    BOOL direct;
 };
 
 struct const_upload_info
@@ -1103,6 +1106,27 @@ static void dump_preshader(struct d3dx_preshader *pres)
         dump_ins(&pres->regs, &pres->ins[i]);
 }
 
+static BOOL is_ins_direct(const struct d3dx_pres_ins *ins)
+{
+    const struct op_info *oi = &pres_op_info[ins->op];
+    unsigned int i, start, end, out_start, out_end;
+
+    out_start = ins->output.reg.offset;
+    out_end = out_start + (oi->func_all_comps ? 1 : ins->component_count);
+    for (i = 0; i < oi->input_count; ++i)
+    {
+        if (ins->inputs[i].index_reg.table != PRES_REGTAB_COUNT)
+            return FALSE;
+        if (ins->inputs[i].reg.table != ins->output.reg.table)
+            continue;
+        start = ins->inputs[i].reg.offset;
+        end = start + (ins->scalar_op && !i ? 1 : ins->component_count);
+        if (start < out_end && out_start < end)
+            return FALSE;
+    }
+    return TRUE;
+}
+
 static HRESULT parse_preshader(struct d3dx_preshader *pres, unsigned int *ptr, unsigned int count, struct d3dx9_base_effect *base)
 {
     unsigned int *p;
@@ -1214,6 +1238,7 @@ static HRESULT parse_preshader(struct d3dx_preshader *pres, unsigned int *ptr, u
         }
         update_table_size(pres->regs.table_sizes, pres->ins[i].output.reg.table,
                 get_reg_offset(pres->ins[i].output.reg.table, pres->ins[i].output.reg.offset));
+        pres->ins[i].direct = is_ins_direct(&pres->ins[i]);
     }
     if (FAILED(regstore_alloc_table(&pres->regs, PRES_REGTAB_IMMED)))
         return E_OUTOFMEMORY;
@@ -1648,6 +1673,99 @@ static void exec_set_arg(struct d3dx_regstore *rs, const struct d3dx_pres_reg *r
 }
 
 #define ARGS_ARRAY_SIZE 8
+
+/* Reads the components of an input without relative addressing, which
+ * parse_preshader() checked to be in the bounds of its table. */
+static void exec_get_direct_arg(struct d3dx_regstore *rs, const struct d3dx_pres_reg *reg,
+        unsigned int count, double *args)
+{
+    const BYTE *p = (const BYTE *)rs->tables[reg->table] + table_info[reg->table].component_size * reg->offset;
+    unsigned int i;
+
+    switch (table_info[reg->table].type)
+    {
+        case PRES_VT_FLOAT:
+            for (i = 0; i < count; ++i)
+                args[i] = ((const float *)p)[i];
+            break;
+        case PRES_VT_DOUBLE:
+            for (i = 0; i < count; ++i)
+                args[i] = ((const double *)p)[i];
+            break;
+        default:
+            FIXME("Unexpected preshader input from table %u.\n", reg->table);
+            for (i = 0; i < count; ++i)
+                args[i] = NAN;
+            break;
+    }
+}
+
+static void execute_direct_ins(struct d3dx_regstore *rs, const struct d3dx_pres_ins *ins)
+{
+    const struct op_info *oi = &pres_op_info[ins->op];
+    double inputs[MAX_INPUTS_COUNT][4], args[ARGS_ARRAY_SIZE], res[4];
+    unsigned int count = ins->component_count;
+    unsigned int j, k;
+
+    for (k = 0; k < oi->input_count; ++k)
+    {
+        if (ins->scalar_op && !k)
+        {
+            exec_get_direct_arg(rs, &ins->inputs[k].reg, 1, inputs[k]);
+            for (j = 1; j < count; ++j)
+                inputs[k][j] = inputs[k][0];
+        }
+        else
+        {
+            exec_get_direct_arg(rs, &ins->inputs[k].reg, count, inputs[k]);
+        }
+    }
+
+    /* The most common operations are computed on all the components at
+     * once, the others go through the generic functions. */
+    switch (ins->op)
+    {
+        case PRESHADER_OP_MOV:
+            for (j = 0; j < count; ++j)
+                res[j] = inputs[0][j];
+            break;
+        case PRESHADER_OP_NEG:
+            for (j = 0; j < count; ++j)
+                res[j] = -inputs[0][j];
+            break;
+        case PRESHADER_OP_ADD:
+            for (j = 0; j < count; ++j)
+                res[j] = inputs[0][j] + inputs[1][j];
+            break;
+        case PRESHADER_OP_MUL:
+            for (j = 0; j < count; ++j)
+                res[j] = inputs[0][j] * inputs[1][j];
+            break;
+        case PRESHADER_OP_CMP:
+            for (j = 0; j < count; ++j)
+                res[j] = inputs[0][j] >= 0.0 ? inputs[1][j] : inputs[2][j];
+            break;
+        case PRESHADER_OP_DOT:
+            for (k = 0; k < 2; ++k)
+                for (j = 0; j < count; ++j)
+                    args[k * count + j] = inputs[k][j];
+            res[0] = oi->func(args, count);
+            count = 1;
+            break;
+        default:
+            for (j = 0; j < count; ++j)
+            {
+                for (k = 0; k < oi->input_count; ++k)
+                    args[k] = inputs[k][j];
+                res[j] = oi->func(args, count);
+            }
+            break;
+    }
+
+    for (j = 0; j < count; ++j)
+        regstore_set_double(rs, ins->output.reg.table, ins->output.reg.offset + j, res[j]);
+}
+
 static HRESULT execute_preshader(struct d3dx_preshader *pres)
 {
     unsigned int i, j, k;
@@ -1661,7 +1779,11 @@ static HRESULT execute_preshader(struct d3dx_preshader *pres)
 
         ins = &pres->ins[i];
         oi = &pres_op_info[ins->op];
-        if (oi->func_all_comps)
+        if (ins->direct)
+        {
+            execute_direct_ins(&pres->regs, ins);
+        }
+        else if (oi->func_all_comps)
         {
             if (oi->input_count * ins->component_count > ARGS_ARRAY_SIZE)
             {
@@ -1715,6 +1715,371 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
     }
 }
 
+struct filter_taps
+{
+    UINT count;     /* number of taps per destination pixel */
+    UINT *index;    /* source pixel of each tap, clamped to the source */
+    float *weight;  /* normalized weight of each tap */
+};
+
+static void free_filter_taps(struct filter_taps *taps)
+{
+    HeapFree(GetProcessHeap(), 0, taps->index);
+    HeapFree(GetProcessHeap(), 0, taps->weight);
+}
+
+/************************************************************
+ * init_filter_taps
+ *
+ * Computes the source pixels contributing to each destination pixel along
+ * one axis, and their weights, for the box, triangle and linear filters.
+ */
+static BOOL init_filter_taps(struct filter_taps *taps, UINT src_len, UINT dst_len, DWORD filter)
+{
+    float scale = (float)src_len / dst_len, radius, center, weight, sum;
+    UINT i, k, *index;
+    int first, j;
+
+    if (src_len == dst_len)
+        taps->count = 1;
+    else if (filter == D3DX_FILTER_BOX)
+        taps->count = (UINT)ceilf(scale) + 1;
+    else
+        taps->count = (UINT)ceilf(2.0f * (filter == D3DX_FILTER_TRIANGLE ? max(scale, 1.0f) : 1.0f)) + 1;
+
+    taps->index = HeapAlloc(GetProcessHeap(), 0, dst_len * taps->count * sizeof(*taps->index));
+    taps->weight = HeapAlloc(GetProcessHeap(), 0, dst_len * taps->count * sizeof(*taps->weight));
+    if (!taps->index || !taps->weight)
+    {
+        free_filter_taps(taps);
+        return FALSE;
+    }
+
+    for (i = 0; i < dst_len; ++i)
+    {
+        index = taps->index + i * taps->count;
+        sum = 0.0f;
+
+        if (src_len == dst_len)
+        {
+            index[0] = i;
+            taps->weight[i] = 1.0f;
+            continue;
+        }
+
+        if (filter == D3DX_FILTER_BOX)
+        {
+            /* Average the source pixels covered by the destination pixel. */
+            float start = i * scale, end = (i + 1) * scale;
+
+            first = (int)floorf(start);
+            for (k = 0; k < taps->count; ++k)
+            {
+                j = first + k;
+                weight = min(end, j + 1.0f) - max(start, (float)j);
+                taps->weight[i * taps->count + k] = weight = max(weight, 0.0f);
+                index[k] = min(j, src_len - 1);
+                sum += weight;
+            }
+        }
+        else
+        {
+            /* Tent centered on the destination pixel; its radius grows with the
+             * minification ratio for the triangle filter. */
+            radius = filter == D3DX_FILTER_TRIANGLE ? max(scale, 1.0f) : 1.0f;
+            center = (i + 0.5f) * scale - 0.5f;
+            first = (int)floorf(center - radius) + 1;
+            for (k = 0; k < taps->count; ++k)
+            {
+                j = first + k;
+                weight = 1.0f - fabsf(j - center) / radius;
+                taps->weight[i * taps->count + k] = weight = max(weight, 0.0f);
+                index[k] = j < 0 ? 0 : min(j, src_len - 1);
+                sum += weight;
+            }
+        }
+
+        for (k = 0; k < taps->count; ++k)
+            taps->weight[i * taps->count + k] /= sum;
+    }
+
+    return TRUE;
+}
+
+static inline BOOL is_argb8_format(const struct pixel_format_desc *format)
+{
+    return format->format == D3DFMT_A8R8G8B8 || format->format == D3DFMT_X8R8G8B8;
+}
+
+/* Reads a row of source pixels as RGBA colors, applying the color key. */
+static void read_argb_row(const struct pixel_format_desc *format, const BYTE *src, UINT width,
+        struct vec4 *dst, const struct pixel_format_desc *ck_format, D3DCOLOR color_key,
+        const PALETTEENTRY *palette)
+{
+    struct vec4 color;
+    DWORD ck_pixel;
+    UINT x;
+
+    if (is_argb8_format(format))
+    {
+        const DWORD *pixels = (const DWORD *)src;
+        DWORD alpha_fill = format->bits[0] ? 0 : 0xff000000;
+
+        for (x = 0; x < width; ++x)
+        {
+            DWORD val = pixels[x] | alpha_fill;
+
+            dst[x].x = (float)((val >> 16) & 0xff) / 0xff;
+            dst[x].y = (float)((val >> 8) & 0xff) / 0xff;
+            dst[x].z = (float)(val & 0xff) / 0xff;
+            dst[x].w = (float)(val >> 24) / 0xff;
+            if (ck_format && val == color_key)
+                dst[x].w = 0.0f;
+        }
+        return;
+    }
+
+    for (x = 0; x < width; ++x)
+    {
+        format_to_vec4(format, src + x * format->bytes_per_pixel, &color);
+        if (format->to_rgba)
+            format->to_rgba(&color, &dst[x], palette);
+        else
+            dst[x] = color;
+
+        if (ck_format)
+        {
+            format_from_vec4(ck_format, &dst[x], (BYTE *)&ck_pixel);
+            if (ck_pixel == color_key)
+                dst[x].w = 0.0f;
+        }
+    }
+}
+
+/* Writes a row of RGBA colors in the destination format. */
+static void write_argb_row(const struct pixel_format_desc *format, const struct vec4 *src, UINT width, BYTE *dst)
+{
+    struct vec4 color;
+    UINT x;
+
+    if (is_argb8_format(format))
+    {
+        DWORD *pixels = (DWORD *)dst;
+        DWORD alpha_mask = format->bits[0] ? 0xff000000 : 0;
+
+        for (x = 0; x < width; ++x)
+        {
+            pixels[x] = ((DWORD)(src[x].w * 0xff + 0.5f) << 24 & alpha_mask)
+                    | (DWORD)(src[x].x * 0xff + 0.5f) << 16
+                    | (DWORD)(src[x].y * 0xff + 0.5f) << 8
+                    | (DWORD)(src[x].z * 0xff + 0.5f);
+        }
+        return;
+    }
+
+    for (x = 0; x < width; ++x)
+    {
+        if (format->from_rgba)
+        {
+            format->from_rgba(&src[x], &color);
+            format_from_vec4(format, &color, dst + x * format->bytes_per_pixel);
+        }
+        else
+            format_from_vec4(format, &src[x], dst + x * format->bytes_per_pixel);
+    }
+}
+
+/* Filters a row horizontally, storing or adding the result scaled by 'scale'. */
+static void filter_argb_row(const struct filter_taps *taps, const struct vec4 *src, struct vec4 *dst,
+        UINT width, float scale, BOOL accumulate)
+{
+    const float *weight = taps->weight;
+    const UINT *index = taps->index;
+    struct vec4 sum;
+    UINT x, k;
+
+    for (x = 0; x < width; ++x)
+    {
+        sum.x = sum.y = sum.z = sum.w = 0.0f;
+        for (k = 0; k < taps->count; ++k)
+        {
+            const struct vec4 *c = &src[index[k]];
+            float w = weight[k] * scale;
+
+            sum.x += c->x * w;
+            sum.y += c->y * w;
+            sum.z += c->z * w;
+            sum.w += c->w * w;
+        }
+        if (accumulate)
+        {
+            dst[x].x += sum.x;
+            dst[x].y += sum.y;
+            dst[x].z += sum.z;
+            dst[x].w += sum.w;
+        }
+        else
+            dst[x] = sum;
+        weight += taps->count;
+        index += taps->count;
+    }
+}
+
+/* Halves A8R8G8B8 or X8R8G8B8 pixels along the axes where the sizes differ, as
+ * done for every level of a power of two mipmap chain. */
+static BOOL box_filter_argb8_half(const BYTE *src, UINT src_row_pitch, const struct volume *src_size,
+        const struct pixel_format_desc *src_format, BYTE *dst, UINT dst_row_pitch,
+        const struct volume *dst_size, const struct pixel_format_desc *dst_format)
+{
+    UINT x, y, xstep, ystep;
+    DWORD alpha_mask;
+
+    if (!is_argb8_format(src_format) || src_format != dst_format
+            || src_size->depth != 1 || dst_size->depth != 1)
+        return FALSE;
+    if (src_size->width != dst_size->width && src_size->width != dst_size->width * 2)
+        return FALSE;
+    if (src_size->height != dst_size->height && src_size->height != dst_size->height * 2)
+        return FALSE;
+
+    xstep = src_size->width == dst_size->width ? 0 : 1;
+    ystep = src_size->height == dst_size->height ? 0 : src_row_pitch;
+    alpha_mask = dst_format->bits[0] ? 0xffffffff : 0x00ffffff;
+
+    for (y = 0; y < dst_size->height; ++y)
+    {
+        const DWORD *row0 = (const DWORD *)(src + (ystep ? 2 * y : y) * src_row_pitch);
+        const DWORD *row1 = (const DWORD *)((const BYTE *)row0 + ystep);
+        DWORD *dst_row = (DWORD *)(dst + y * dst_row_pitch);
+
+        for (x = 0; x < dst_size->width; ++x)
+        {
+            UINT x0 = xstep ? 2 * x : x, x1 = x0 + xstep;
+            DWORD a = row0[x0], b = row0[x1], c = row1[x0], d = row1[x1];
+            /* Sum two channels at once, each has room for 4 bytes. */
+            DWORD rb = (a & 0x00ff00ff) + (b & 0x00ff00ff) + (c & 0x00ff00ff) + (d & 0x00ff00ff) + 0x00020002;
+            DWORD ag = ((a >> 8) & 0x00ff00ff) + ((b >> 8) & 0x00ff00ff)
+                    + ((c >> 8) & 0x00ff00ff) + ((d >> 8) & 0x00ff00ff) + 0x00020002;
+
+            dst_row[x] = (((rb >> 2) & 0x00ff00ff) | ((ag << 6) & 0xff00ff00)) & alpha_mask;
+        }
+    }
+    return TRUE;
+}
+
+/************************************************************
+ * linear_filter_argb_pixels
+ *
+ * Copies the source buffer to the destination buffer, performing
+ * any necessary format conversion, color keying and stretching
+ * using a box, triangle or linear filter.
+ *
+ * The filter is separable: source rows are filtered horizontally
+ * once into a ring of rows, which are then combined vertically.
+ */
+HRESULT linear_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pitch,
+        const struct volume *src_size, const struct pixel_format_desc *src_format, BYTE *dst,
+        UINT dst_row_pitch, UINT dst_slice_pitch, const struct volume *dst_size,
+        const struct pixel_format_desc *dst_format, D3DCOLOR color_key, const PALETTEENTRY *palette,
+        DWORD filter)
+{
+    const struct pixel_format_desc *ck_format = NULL;
+    struct filter_taps xtaps, ytaps, ztaps;
+    struct vec4 *line = NULL, *rows = NULL, *out = NULL;
+    UINT *row_tags = NULL;
+    HRESULT hr = E_OUTOFMEMORY;
+    UINT x, y, z, k, kz, slot;
+
+    filter &= 0xf;
+    if (filter == D3DX_FILTER_BOX && !color_key && !src_format->to_rgba
+            && box_filter_argb8_half(src, src_row_pitch, src_size, src_format,
+            dst, dst_row_pitch, dst_size, dst_format))
+        return D3D_OK;
+
+    if (color_key)
+    {
+        /* Color keys are always represented in D3DFMT_A8R8G8B8 format. */
+        ck_format = get_format_info(D3DFMT_A8R8G8B8);
+    }
+
+    if (!init_filter_taps(&xtaps, src_size->width, dst_size->width, filter))
+        return E_OUTOFMEMORY;
+    if (!init_filter_taps(&ytaps, src_size->height, dst_size->height, filter))
+    {
+        free_filter_taps(&xtaps);
+        return E_OUTOFMEMORY;
+    }
+    if (!init_filter_taps(&ztaps, src_size->depth, dst_size->depth, filter))
+    {
+        free_filter_taps(&ytaps);
+        free_filter_taps(&xtaps);
+        return E_OUTOFMEMORY;
+    }
+
+    if (!(line = HeapAlloc(GetProcessHeap(), 0, src_size->width * sizeof(*line)))
+            || !(rows = HeapAlloc(GetProcessHeap(), 0, ytaps.count * dst_size->width * sizeof(*rows)))
+            || !(out = HeapAlloc(GetProcessHeap(), 0, dst_size->width * sizeof(*out)))
+            || !(row_tags = HeapAlloc(GetProcessHeap(), 0, ytaps.count * sizeof(*row_tags))))
+        goto done;
+
+    for (z = 0; z < dst_size->depth; ++z)
+    {
+        const UINT *zindex = ztaps.index + z * ztaps.count;
+        const float *zweight = ztaps.weight + z * ztaps.count;
+
+        for (k = 0; k < ytaps.count; ++k)
+            row_tags[k] = ~0u;
+
+        for (y = 0; y < dst_size->height; ++y)
+        {
+            const UINT *yindex = ytaps.index + y * ytaps.count;
+            const float *yweight = ytaps.weight + y * ytaps.count;
+            float *out_data = (float *)out;
+
+            /* The source rows of a destination row are consecutive, so they
+             * never share a slot of the ring. */
+            for (k = 0; k < ytaps.count; ++k)
+            {
+                slot = yindex[k] % ytaps.count;
+                if (row_tags[slot] == yindex[k])
+                    continue;
+
+                for (kz = 0; kz < ztaps.count; ++kz)
+                {
+                    read_argb_row(src_format, src + zindex[kz] * src_slice_pitch + yindex[k] * src_row_pitch,
+                            src_size->width, line, ck_format, color_key, palette);
+                    filter_argb_row(&xtaps, line, rows + slot * dst_size->width, dst_size->width,
+                            zweight[kz], kz != 0);
+                }
+                row_tags[slot] = yindex[k];
+            }
+
+            memset(out, 0, dst_size->width * sizeof(*out));
+            for (k = 0; k < ytaps.count; ++k)
+            {
+                const float *row_data = (const float *)(rows + (yindex[k] % ytaps.count) * dst_size->width);
+                float w = yweight[k];
+
+                for (x = 0; x < dst_size->width * 4; ++x)
+                    out_data[x] += row_data[x] * w;
+            }
+
+            write_argb_row(dst_format, out, dst_size->width, dst + z * dst_slice_pitch + y * dst_row_pitch);
+        }
+    }
+    hr = D3D_OK;
+
+done:
+    HeapFree(GetProcessHeap(), 0, row_tags);
+    HeapFree(GetProcessHeap(), 0, out);
+    HeapFree(GetProcessHeap(), 0, rows);
+    HeapFree(GetProcessHeap(), 0, line);
+    free_filter_taps(&ztaps);
+    free_filter_taps(&ytaps);
+    free_filter_taps(&xtaps);
+    return hr;
+}
+
 /************************************************************
  * D3DXLoadSurfaceFromMemory
  *
@@ -1756,6 +2121,7 @@ HRESULT WINAPI D3DXLoadSurfaceFromMemory(IDirect3DSurface9 *dst_surface,
     D3DSURFACE_DESC surfdesc;
     D3DLOCKED_RECT lockrect;
     struct volume src_size, dst_size;
+    HRESULT hr = D3D_OK;
 
     TRACE("(%p, %p, %s, %p, %#x, %u, %p, %s, %#x, 0x%08x)\n",
             dst_surface, dst_palette, wine_dbgstr_rect(dst_rect), src_memory, src_format,
@@ -1852,21 +2218,23 @@ HRESULT WINAPI D3DXLoadSurfaceFromMemory(IDirect3DSurface9 *dst_surface,
             convert_argb_pixels(src_memory, src_pitch, 0, &src_size, srcformatdesc,
                     lockrect.pBits, lockrect.Pitch, 0, &dst_size, destformatdesc, color_key, src_palette);
         }
-        else /* if ((filter & 0xf) == D3DX_FILTER_POINT) */
+        else if ((filter & 0xf) == D3DX_FILTER_POINT
+                || (dst_size.width == src_size.width && dst_size.height == src_size.height))
         {
-            if ((filter & 0xf) != D3DX_FILTER_POINT)
-                FIXME("Unhandled filter %#x.\n", filter);
-
-            /* Always apply a point filter until D3DX_FILTER_LINEAR,
-             * D3DX_FILTER_TRIANGLE and D3DX_FILTER_BOX are implemented. */
             point_filter_argb_pixels(src_memory, src_pitch, 0, &src_size, srcformatdesc,
                     lockrect.pBits, lockrect.Pitch, 0, &dst_size, destformatdesc, color_key, src_palette);
         }
+        else
+        {
+            hr = linear_filter_argb_pixels(src_memory, src_pitch, 0, &src_size, srcformatdesc,
+                    lockrect.pBits, lockrect.Pitch, 0, &dst_size, destformatdesc, color_key, src_palette,
+                    filter);
+        }
 
         IDirect3DSurface9_UnlockRect(dst_surface);
     }
 
-    return D3D_OK;
+    return hr;
 }
 
 /************************************************************
@@ -5224,6 +5224,117 @@ static void test_effect_out_of_bounds_selector(IDirect3DDevice9 *device)
     effect->lpVtbl->Release(effect);
 }
 
+static void test_effect_preshader_evaluation(IDirect3DDevice9 *device)
+{
+    static const D3DXVECTOR4 opvect1 = {1.0f, 2.0f, 4.0f, 8.0f};
+    static const D3DXVECTOR4 opvect2 = {1e12f, 2e12f, 4e12f, 0.0f};
+    static const D3DXVECTOR4 opvect3 = {0.5f, 0.5f, 0.5f, 0.5f};
+    static const float expected_ambient5[] = {1e-2f, 1e-2f / 2.0f, 1e-2f / 4.0f, 1e-2f / 8.0f};
+    static const float expected_ambient7[] = {1.5f, 3.5f, 7.5f, 7.5f};
+    LARGE_INTEGER start, end, freq;
+    D3DXVECTOR4 fvect = {1.0f, 2.0f, 3.0f, 4.0f};
+    unsigned int npasses, i, j;
+    ID3DXEffect *effect;
+    D3DLIGHT9 light;
+    D3DXHANDLE par;
+    D3DCAPS9 caps;
+    DWORD *blob;
+    HRESULT hr;
+
+    hr = IDirect3DDevice9_GetDeviceCaps(device, &caps);
+    ok(SUCCEEDED(hr), "Failed to get device caps, hr %#x.\n", hr);
+    if (caps.VertexShaderVersion < D3DVS_VERSION(3, 0)
+            || caps.PixelShaderVersion < D3DPS_VERSION(3, 0))
+    {
+        skip("Test requires VS >= 3 and PS >= 3, skipping.\n");
+        return;
+    }
+
+    blob = HeapAlloc(GetProcessHeap(), 0, sizeof(test_effect_preshader_effect_blob));
+    ok(!!blob, "Failed to allocate memory.\n");
+    if (!blob)
+        return;
+
+    for (i = 0; i < 2; ++i)
+    {
+        memcpy(blob, test_effect_preshader_effect_blob, sizeof(test_effect_preshader_effect_blob));
+        if (i)
+        {
+            /* Manually edited to compute LightAmbient[7] with an instruction
+             * writing over its own input:
+             *     mul r0, 1e-12, c4
+             *     add r0, r0, c0
+             *     neg r4, c8
+             *     add oc0, r4, r0 */
+            blob[4627] = 0;
+            blob[4635] = 4;
+            blob[4640] = 4;
+            blob[4643] = 0;
+        }
+
+        hr = D3DXCreateEffect(device, blob, sizeof(test_effect_preshader_effect_blob),
+                NULL, NULL, 0, NULL, &effect, NULL);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+
+        hr = effect->lpVtbl->Begin(effect, &npasses, 0);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+        hr = effect->lpVtbl->BeginPass(effect, 0);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+
+        hr = effect->lpVtbl->SetVector(effect, "opvect1", &opvect1);
+        ok(hr == D3D_OK, "SetVector failed, hr %#x.\n", hr);
+        hr = effect->lpVtbl->SetVector(effect, "opvect2", &opvect2);
+        ok(hr == D3D_OK, "SetVector failed, hr %#x.\n", hr);
+        hr = effect->lpVtbl->SetVector(effect, "opvect3", &opvect3);
+        ok(hr == D3D_OK, "SetVector failed, hr %#x.\n", hr);
+        hr = effect->lpVtbl->CommitChanges(effect);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+
+        /* 1e-2 / opvect1 multiplies all the components by a scalar. */
+        hr = IDirect3DDevice9_GetLight(device, 5, &light);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+        for (j = 0; j < 4; ++j)
+            ok(compare_float((&light.Ambient.r)[j], expected_ambient5[j], 1),
+                    "Blob %u, LightAmbient[5] component %u, got %.8e, expected %.8e.\n",
+                    i, j, (&light.Ambient.r)[j], expected_ambient5[j]);
+
+        hr = IDirect3DDevice9_GetLight(device, 7, &light);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+        for (j = 0; j < 4; ++j)
+            ok(compare_float((&light.Ambient.r)[j], expected_ambient7[j], 1),
+                    "Blob %u, LightAmbient[7] component %u, got %.8e, expected %.8e.\n",
+                    i, j, (&light.Ambient.r)[j], expected_ambient7[j]);
+
+        if (!i)
+        {
+            par = effect->lpVtbl->GetParameterByName(effect, NULL, "g_Pos1");
+            ok(par != NULL, "GetParameterByName failed.\n");
+
+            /* Every update runs the preshaders depending on the parameter. */
+            QueryPerformanceFrequency(&freq);
+            QueryPerformanceCounter(&start);
+            for (j = 0; j < 1000; ++j)
+            {
+                fvect.x = j;
+                effect->lpVtbl->SetVector(effect, par, &fvect);
+                effect->lpVtbl->CommitChanges(effect);
+            }
+            QueryPerformanceCounter(&end);
+            trace("Parameter update and commit: %.2f us.\n",
+                    (end.QuadPart - start.QuadPart) * 1e6 / freq.QuadPart / 1000);
+        }
+
+        hr = effect->lpVtbl->EndPass(effect);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+        hr = effect->lpVtbl->End(effect);
+        ok(hr == D3D_OK, "Got result %#x.\n", hr);
+
+        effect->lpVtbl->Release(effect);
+    }
+
+    HeapFree(GetProcessHeap(), 0, blob);
+}
+
 static void test_effect_commitchanges(IDirect3DDevice9 *device)
 {
     static const struct
@@ -7326,6 +7437,7 @@ START_TEST(effect)
     test_effect_isparameterused(device);
     test_effect_out_of_bounds_selector(device);
     test_effect_commitchanges(device);
+    test_effect_preshader_evaluation(device);
     test_effect_preshader_relative_addressing(device);
     test_effect_state_manager(device);
     test_cross_effect_handle(device);
@@ -2446,6 +2446,99 @@ static void test_D3DXVec_Array(void)
     }
 }
 
+static void test_D3DXVec_Array_batch(void)
+{
+    static const unsigned int count = 256;
+    D3DXVECTOR4 *inp_vec, *out_vec, expected;
+    D3DXVECTOR3 expected3;
+    LARGE_INTEGER start, end, freq;
+    D3DXMATRIX mat, mat2, got, exp_mat;
+    unsigned int i, j;
+
+    inp_vec = HeapAlloc(GetProcessHeap(), 0, count * sizeof(*inp_vec));
+    out_vec = HeapAlloc(GetProcessHeap(), 0, count * sizeof(*out_vec));
+    ok(inp_vec && out_vec, "Failed to allocate memory.\n");
+    if (!inp_vec || !out_vec)
+    {
+        HeapFree(GetProcessHeap(), 0, out_vec);
+        HeapFree(GetProcessHeap(), 0, inp_vec);
+        return;
+    }
+
+    for (i = 0; i < 4; ++i)
+    {
+        for (j = 0; j < 4; ++j)
+        {
+            U(mat).m[i][j] = (i * 4 + j) * 0.37f - 2.1f;
+            U(mat2).m[i][j] = 1.0f / (i + 2 * j + 1.5f);
+        }
+    }
+    for (i = 0; i < count; ++i)
+    {
+        inp_vec[i].x = sinf(i * 0.1f) * 10.0f;
+        inp_vec[i].y = cosf(i * 0.3f) * 5.0f;
+        inp_vec[i].z = i * 0.01f - 20.0f;
+        inp_vec[i].w = 1.0f + (i % 7) * 0.25f;
+    }
+
+    /* The array functions give the same results as the single element ones. */
+    D3DXVec3TransformArray(out_vec, sizeof(*out_vec), (D3DXVECTOR3 *)inp_vec, sizeof(*inp_vec), &mat, count);
+    for (i = 0; i < count; ++i)
+    {
+        D3DXVec3Transform(&expected, (D3DXVECTOR3 *)&inp_vec[i], &mat);
+        if (!compare_vec4(&expected, &out_vec[i], 1))
+            break;
+    }
+    ok(i == count, "D3DXVec3TransformArray gave unexpected results at index %u.\n", i);
+
+    D3DXVec3TransformCoordArray((D3DXVECTOR3 *)out_vec, sizeof(*out_vec), (D3DXVECTOR3 *)inp_vec,
+            sizeof(*inp_vec), &mat, count);
+    for (i = 0; i < count; ++i)
+    {
+        D3DXVec3TransformCoord(&expected3, (D3DXVECTOR3 *)&inp_vec[i], &mat);
+        if (!compare_vec3(&expected3, (D3DXVECTOR3 *)&out_vec[i], 1))
+            break;
+    }
+    ok(i == count, "D3DXVec3TransformCoordArray gave unexpected results at index %u.\n", i);
+
+    /* The output can overlap the input. */
+    memcpy(out_vec, inp_vec, count * sizeof(*out_vec));
+    D3DXVec4TransformArray(out_vec, sizeof(*out_vec), out_vec, sizeof(*out_vec), &mat, count);
+    for (i = 0; i < count; ++i)
+    {
+        D3DXVec4Transform(&expected, &inp_vec[i], &mat);
+        if (!compare_vec4(&expected, &out_vec[i], 1))
+            break;
+    }
+    ok(i == count, "D3DXVec4TransformArray gave unexpected results at index %u.\n", i);
+
+    for (i = 0; i < 4; ++i)
+    {
+        for (j = 0; j < 4; ++j)
+        {
+            U(exp_mat).m[i][j] = U(mat).m[i][0] * U(mat2).m[0][j] + U(mat).m[i][1] * U(mat2).m[1][j]
+                    + U(mat).m[i][2] * U(mat2).m[2][j] + U(mat).m[i][3] * U(mat2).m[3][j];
+        }
+    }
+    got = mat;
+    D3DXMatrixMultiply(&got, &got, &mat2);
+    expect_matrix(&exp_mat, &got, 1);
+    D3DXMatrixMultiplyTranspose(&got, &mat, &mat2);
+    D3DXMatrixTranspose(&exp_mat, &exp_mat);
+    expect_matrix(&exp_mat, &got, 1);
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+    for (i = 0; i < 100; ++i)
+        D3DXVec3TransformArray(out_vec, sizeof(*out_vec), (D3DXVECTOR3 *)inp_vec, sizeof(*inp_vec), &mat, count);
+    QueryPerformanceCounter(&end);
+    trace("D3DXVec3TransformArray: %.2f ns per vector.\n",
+            (end.QuadPart - start.QuadPart) * 1e9 / freq.QuadPart / (100.0 * count));
+
+    HeapFree(GetProcessHeap(), 0, out_vec);
+    HeapFree(GetProcessHeap(), 0, inp_vec);
+}
+
 static void test_D3DXFloat_Array(void)
 {
     unsigned int i;
@@ -3625,6 +3718,7 @@ START_TEST(math)
     test_Matrix_Decompose();
     test_Matrix_Transformation2D();
     test_D3DXVec_Array();
+    test_D3DXVec_Array_batch();
     test_D3DXFloat_Array();
     test_D3DXSHAdd();
     test_D3DXSHDot();
@@ -1230,6 +1230,121 @@ static void test_D3DXLoadSurface(IDirect3DDevice9 *device)
     if(testbitmap_ok) DeleteFileA("testbitmap.bmp");
 }
 
+static BOOL color_match(DWORD c1, DWORD c2)
+{
+    unsigned int i;
+
+    for (i = 0; i < 4; ++i)
+    {
+        if (abs((int)((c1 >> (i * 8)) & 0xff) - (int)((c2 >> (i * 8)) & 0xff)) > 1)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void test_D3DXLoadSurface_filter(IDirect3DDevice9 *device)
+{
+    static const DWORD pixdata[] =
+    {
+        0xff000000, 0xffffffff, 0xff000000, 0xffffffff,
+        0xffffffff, 0xff000000, 0xffffffff, 0xff000000,
+        0x00ff0000, 0x00ff0000, 0x800000ff, 0x800000ff,
+        0x00ff0000, 0x00ff0000, 0x800000ff, 0x800000ff,
+    };
+    static const DWORD ramp[] = {0xff000000, 0xff0000ff, 0xff0000ff, 0xff000000};
+    static const struct
+    {
+        DWORD filter;
+        DWORD expected[4];
+    }
+    tests[] =
+    {
+        {D3DX_FILTER_BOX,      {0xff7f7f7f, 0xff7f7f7f, 0x00ff0000, 0x800000ff}},
+        {D3DX_FILTER_LINEAR,   {0xff7f7f7f, 0xff7f7f7f, 0x00ff0000, 0x800000ff}},
+    };
+    IDirect3DSurface9 *surface, *big_surface;
+    D3DLOCKED_RECT lockrect;
+    LARGE_INTEGER start, end, freq;
+    DWORD *big_data;
+    unsigned int i, j;
+    RECT rect;
+    HRESULT hr;
+
+    hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, 2, 2, D3DFMT_A8R8G8B8, D3DPOOL_SCRATCH, &surface, NULL);
+    if (FAILED(hr))
+    {
+        skip("Failed to create a surface, hr %#x.\n", hr);
+        return;
+    }
+
+    SetRect(&rect, 0, 0, 4, 4);
+    for (i = 0; i < sizeof(tests) / sizeof(*tests); ++i)
+    {
+        hr = D3DXLoadSurfaceFromMemory(surface, NULL, NULL, pixdata, D3DFMT_A8R8G8B8,
+                4 * sizeof(DWORD), NULL, &rect, tests[i].filter, 0);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+        hr = IDirect3DSurface9_LockRect(surface, &lockrect, NULL, D3DLOCK_READONLY);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+        for (j = 0; j < 4; ++j)
+        {
+            DWORD color = ((DWORD *)((BYTE *)lockrect.pBits + (j / 2) * lockrect.Pitch))[j % 2];
+
+            ok(color_match(color, tests[i].expected[j]), "Test %u, pixel %u: got unexpected color 0x%08x.\n",
+                    i, j, color);
+        }
+        IDirect3DSurface9_UnlockRect(surface);
+    }
+
+    /* The triangle filter also weights the neighbours of the covered pixels. */
+    SetRect(&rect, 0, 0, 4, 1);
+    hr = D3DXLoadSurfaceFromMemory(surface, NULL, NULL, ramp, D3DFMT_A8R8G8B8,
+            sizeof(ramp), NULL, &rect, D3DX_FILTER_TRIANGLE, 0);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DSurface9_LockRect(surface, &lockrect, NULL, D3DLOCK_READONLY);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (j = 0; j < 4; ++j)
+    {
+        DWORD color = ((DWORD *)((BYTE *)lockrect.pBits + (j / 2) * lockrect.Pitch))[j % 2];
+
+        ok(color_match(color, 0xff000080), "Pixel %u: got unexpected color 0x%08x.\n", j, color);
+    }
+    IDirect3DSurface9_UnlockRect(surface);
+
+    IDirect3DSurface9_Release(surface);
+
+    /* Downsampling a large image, as done for every level of a mipmap chain. */
+    hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, 512, 512, D3DFMT_A8R8G8B8,
+            D3DPOOL_SCRATCH, &big_surface, NULL);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    big_data = HeapAlloc(GetProcessHeap(), 0, 1024 * 1024 * sizeof(*big_data));
+    for (i = 0; i < 1024 * 1024; ++i)
+        big_data[i] = i * 2654435761u;
+
+    QueryPerformanceFrequency(&freq);
+    SetRect(&rect, 0, 0, 1024, 1024);
+    for (i = D3DX_FILTER_POINT; i <= D3DX_FILTER_BOX; ++i)
+    {
+        QueryPerformanceCounter(&start);
+        hr = D3DXLoadSurfaceFromMemory(big_surface, NULL, NULL, big_data, D3DFMT_A8R8G8B8,
+                1024 * sizeof(*big_data), NULL, &rect, i, 0);
+        QueryPerformanceCounter(&end);
+        ok(hr == D3D_OK, "Filter %#x: got unexpected hr %#x.\n", i, hr);
+        trace("Filter %#x: 1024x1024 to 512x512 A8R8G8B8 in %.2f ms.\n", i,
+                (end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart);
+
+        QueryPerformanceCounter(&start);
+        hr = D3DXLoadSurfaceFromMemory(big_surface, NULL, NULL, big_data, D3DFMT_X8R8G8B8,
+                1024 * sizeof(*big_data), NULL, &rect, i, 0);
+        QueryPerformanceCounter(&end);
+        ok(hr == D3D_OK, "Filter %#x: got unexpected hr %#x.\n", i, hr);
+        trace("Filter %#x: 1024x1024 X8R8G8B8 to 512x512 A8R8G8B8 in %.2f ms.\n", i,
+                (end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart);
+    }
+
+    HeapFree(GetProcessHeap(), 0, big_data);
+    IDirect3DSurface9_Release(big_surface);
+}
+
 static void test_D3DXSaveSurfaceToFileInMemory(IDirect3DDevice9 *device)
 {
     HRESULT hr;
@@ -1435,6 +1550,7 @@ START_TEST(surface)
 
     test_D3DXGetImageInfo();
     test_D3DXLoadSurface(device);
+    test_D3DXLoadSurface_filter(device);
     test_D3DXSaveSurfaceToFileInMemory(device);
     test_D3DXSaveSurfaceToFile(device);
 
@@ -210,17 +210,22 @@ HRESULT WINAPI D3DXLoadVolumeFromMemory(IDirect3DVolume9 *dst_volume,
                     locked_box.pBits, locked_box.RowPitch, locked_box.SlicePitch, &dst_size, dst_format_desc, color_key,
                     src_palette);
         }
-        else
+        else if ((filter & 0xf) == D3DX_FILTER_POINT || (dst_size.width == src_size.width
+                && dst_size.height == src_size.height && dst_size.depth == src_size.depth))
         {
-            if ((filter & 0xf) != D3DX_FILTER_POINT)
-                FIXME("Unhandled filter %#x.\n", filter);
-
             point_filter_argb_pixels(src_addr, src_row_pitch, src_slice_pitch, &src_size, src_format_desc,
                     locked_box.pBits, locked_box.RowPitch, locked_box.SlicePitch, &dst_size, dst_format_desc, color_key,
                     src_palette);
         }
+        else
+        {
+            hr = linear_filter_argb_pixels(src_addr, src_row_pitch, src_slice_pitch, &src_size, src_format_desc,
+                    locked_box.pBits, locked_box.RowPitch, locked_box.SlicePitch, &dst_size, dst_format_desc, color_key,
+                    src_palette, filter);
+        }
 
         IDirect3DVolume9_UnlockBox(dst_volume);
+        return hr;
     }
 
     return D3D_OK;
@@ -521,12 +521,10 @@ static GpStatus alpha_blend_pixels(GpGraphics *graphics, INT dst_x, INT dst_y,
     return alpha_blend_pixels_hrgn(graphics, dst_x, dst_y, src, src_width, src_height, src_stride, NULL, fmt);
 }
 
-static ARGB blend_colors(ARGB start, ARGB end, REAL position)
+/* blend two colors, pos is the position between them from 0 to 0xff */
+static ARGB blend_colors_pos(ARGB start, ARGB end, INT pos)
 {
     INT start_a, end_a, final_a;
-    INT pos;
-
-    pos = gdip_round(position * 0xff);
 
     start_a = ((start >> 24) & 0xff) * (pos ^ 0xff);
     end_a = ((end >> 24) & 0xff) * pos;
@@ -541,6 +539,11 @@ static ARGB blend_colors(ARGB start, ARGB end, REAL position)
         (((start & 0xff) * start_a + ((end & 0xff) * end_a)) / final_a);
 }
 
+static ARGB blend_colors(ARGB start, ARGB end, REAL position)
+{
+    return blend_colors_pos(start, end, gdip_round(position * 0xff));
+}
+
 static ARGB blend_line_gradient(GpLineGradient* brush, REAL position)
 {
     REAL blendfac;
@@ -823,10 +826,16 @@ static void get_bitmap_sample_size(InterpolationMode interpolation, WrapMode wra
 
     switch (interpolation)
     {
-    case InterpolationModeHighQualityBilinear:
     case InterpolationModeHighQualityBicubic:
-    /* FIXME: Include a greater range for the prefilter? */
     case InterpolationModeBicubic:
+        /* one more pixel before and after the bilinear range */
+        left = (INT)(floorf(srcx)) - 1;
+        top = (INT)(floorf(srcy)) - 1;
+        right = (INT)(ceilf(srcx+srcwidth)) + 1;
+        bottom = (INT)(ceilf(srcy+srcheight)) + 1;
+        break;
+    case InterpolationModeHighQualityBilinear:
+    /* FIXME: Include a greater range for the prefilter? */
     case InterpolationModeBilinear:
         left = (INT)(floorf(srcx));
         top = (INT)(floorf(srcy));
@@ -927,73 +936,268 @@ static ARGB sample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT wi
     return ((DWORD*)(bits))[(x - src_rect->X) + (y - src_rect->Y) * src_rect->Width];
 }
 
-static ARGB resample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
-    UINT height, GpPointF *point, GDIPCONST GpImageAttributes *attributes,
-    InterpolationMode interpolation, PixelOffsetMode offset_mode)
+/* source pixels and weights used to sample along one axis */
+struct sample_position
+{
+    INT index[4];
+    INT pos;        /* bilinear position between index[0] and index[1], from 0 to 0xff */
+    REAL weights[4];
+};
+
+static InterpolationMode get_sample_interpolation(InterpolationMode interpolation)
 {
     static int fixme;
 
     switch (interpolation)
     {
+    case InterpolationModeNearestNeighbor:
+    case InterpolationModeBilinear:
+        return interpolation;
+    case InterpolationModeBicubic:
+    case InterpolationModeHighQualityBicubic:
+        return InterpolationModeBicubic;
     default:
         if (!fixme++)
             FIXME("Unimplemented interpolation %i\n", interpolation);
-        /* fall-through */
-    case InterpolationModeBilinear:
-    {
-        REAL leftxf, topyf;
-        INT leftx, rightx, topy, bottomy;
-        ARGB topleft, topright, bottomleft, bottomright;
-        ARGB top, bottom;
-        float x_offset;
-
-        leftxf = floorf(point->X);
-        leftx = (INT)leftxf;
-        rightx = (INT)ceilf(point->X);
-        topyf = floorf(point->Y);
-        topy = (INT)topyf;
-        bottomy = (INT)ceilf(point->Y);
-
-        if (leftx == rightx && topy == bottomy)
-            return sample_bitmap_pixel(src_rect, bits, width, height,
-                leftx, topy, attributes);
-
-        topleft = sample_bitmap_pixel(src_rect, bits, width, height,
-            leftx, topy, attributes);
-        topright = sample_bitmap_pixel(src_rect, bits, width, height,
-            rightx, topy, attributes);
-        bottomleft = sample_bitmap_pixel(src_rect, bits, width, height,
-            leftx, bottomy, attributes);
-        bottomright = sample_bitmap_pixel(src_rect, bits, width, height,
-            rightx, bottomy, attributes);
-
-        x_offset = point->X - leftxf;
-        top = blend_colors(topleft, topright, x_offset);
-        bottom = blend_colors(bottomleft, bottomright, x_offset);
-
-        return blend_colors(top, bottom, point->Y - topyf);
+        return InterpolationModeBilinear;
     }
-    case InterpolationModeNearestNeighbor:
+}
+
+/* Keys cubic convolution kernel, a = -0.5 */
+static inline REAL cubic_weight(REAL x)
+{
+    x = fabsf(x);
+    if (x < 1.0f) return (1.5f * x - 2.5f) * x * x + 1.0f;
+    if (x < 2.0f) return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+    return 0.0f;
+}
+
+static void get_sample_position(REAL coord, InterpolationMode interpolation,
+    PixelOffsetMode offset_mode, struct sample_position *sample)
+{
+    REAL base = floorf(coord), t = coord - base;
+
+    switch (interpolation)
     {
-        FLOAT pixel_offset;
+    case InterpolationModeNearestNeighbor:
         switch (offset_mode)
         {
         default:
         case PixelOffsetModeNone:
         case PixelOffsetModeHighSpeed:
-            pixel_offset = 0.5;
+            sample->index[0] = floorf(coord + 0.5f);
             break;
 
         case PixelOffsetModeHalf:
         case PixelOffsetModeHighQuality:
-            pixel_offset = 0.0;
+            sample->index[0] = base;
             break;
         }
-        return sample_bitmap_pixel(src_rect, bits, width, height,
-            floorf(point->X + pixel_offset), floorf(point->Y + pixel_offset), attributes);
+        break;
+    case InterpolationModeBicubic:
+        sample->index[0] = (INT)base - 1;
+        sample->index[1] = (INT)base;
+        sample->index[2] = (INT)base + 1;
+        sample->index[3] = (INT)base + 2;
+        sample->weights[0] = cubic_weight(t + 1.0f);
+        sample->weights[1] = cubic_weight(t);
+        sample->weights[2] = cubic_weight(1.0f - t);
+        sample->weights[3] = cubic_weight(2.0f - t);
+        break;
+    default:
+        sample->index[0] = (INT)base;
+        sample->index[1] = (INT)ceilf(coord);
+        sample->pos = gdip_round(t * 0xff);
+        break;
+    }
+}
+
+static inline ARGB fetch_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
+    UINT height, INT x, INT y, GDIPCONST GpImageAttributes *attributes)
+{
+    /* with clamping, the source rectangle lies within the bitmap */
+    if (attributes->wrap == WrapModeClamp &&
+        x >= src_rect->X && y >= src_rect->Y &&
+        x < src_rect->X + src_rect->Width && y < src_rect->Y + src_rect->Height)
+        return ((DWORD*)(bits))[(x - src_rect->X) + (y - src_rect->Y) * src_rect->Width];
+
+    return sample_bitmap_pixel(src_rect, bits, width, height, x, y, attributes);
+}
+
+static ARGB sample_bitmap_bicubic(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
+    UINT height, const struct sample_position *x, const struct sample_position *y,
+    GDIPCONST GpImageAttributes *attributes)
+{
+    REAL a = 0.0f, r = 0.0f, g = 0.0f, b = 0.0f, weight;
+    ARGB pixel;
+    INT i, j;
+
+    /* colors are weighted by their alpha, like blend_colors() does */
+    for (j = 0; j < 4; j++)
+    {
+        if (y->weights[j] == 0.0f) continue;
+        for (i = 0; i < 4; i++)
+        {
+            pixel = fetch_bitmap_pixel(src_rect, bits, width, height,
+                x->index[i], y->index[j], attributes);
+            weight = x->weights[i] * y->weights[j] * (pixel >> 24);
+            a += weight;
+            r += weight * ((pixel >> 16) & 0xff);
+            g += weight * ((pixel >> 8) & 0xff);
+            b += weight * (pixel & 0xff);
+        }
+    }
+
+    if (a < 1.0f) return 0;
+
+    r = r / a + 0.5f;
+    g = g / a + 0.5f;
+    b = b / a + 0.5f;
+    a += 0.5f;
+    return (ARGB)min(a, 255.0f) << 24 |
+        (ARGB)max(min(r, 255.0f), 0.0f) << 16 |
+        (ARGB)max(min(g, 255.0f), 0.0f) << 8 |
+        (ARGB)max(min(b, 255.0f), 0.0f);
+}
+
+static inline ARGB sample_bitmap(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
+    UINT height, const struct sample_position *x, const struct sample_position *y,
+    GDIPCONST GpImageAttributes *attributes, InterpolationMode interpolation)
+{
+    ARGB topleft, topright, bottomleft, bottomright;
+
+    switch (interpolation)
+    {
+    case InterpolationModeNearestNeighbor:
+        return fetch_bitmap_pixel(src_rect, bits, width, height,
+            x->index[0], y->index[0], attributes);
+    case InterpolationModeBicubic:
+        return sample_bitmap_bicubic(src_rect, bits, width, height, x, y, attributes);
+    default:
+        if (x->index[0] == x->index[1] && y->index[0] == y->index[1])
+            return fetch_bitmap_pixel(src_rect, bits, width, height,
+                x->index[0], y->index[0], attributes);
+
+        topleft = fetch_bitmap_pixel(src_rect, bits, width, height,
+            x->index[0], y->index[0], attributes);
+        topright = fetch_bitmap_pixel(src_rect, bits, width, height,
+            x->index[1], y->index[0], attributes);
+        bottomleft = fetch_bitmap_pixel(src_rect, bits, width, height,
+            x->index[0], y->index[1], attributes);
+        bottomright = fetch_bitmap_pixel(src_rect, bits, width, height,
+            x->index[1], y->index[1], attributes);
+
+        return blend_colors_pos(blend_colors_pos(topleft, topright, x->pos),
+            blend_colors_pos(bottomleft, bottomright, x->pos), y->pos);
+    }
+}
+
+static ARGB resample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
+    UINT height, GpPointF *point, GDIPCONST GpImageAttributes *attributes,
+    InterpolationMode interpolation, PixelOffsetMode offset_mode)
+{
+    struct sample_position x, y;
+
+    interpolation = get_sample_interpolation(interpolation);
+    get_sample_position(point->X, interpolation, offset_mode, &x);
+    get_sample_position(point->Y, interpolation, offset_mode, &y);
+
+    return sample_bitmap(src_rect, bits, width, height, &x, &y, attributes, interpolation);
+}
+
+/* Resample the source area into the destination area one scanline at a time.
+ * When the transformation only scales and translates, the source columns of the
+ * destination pixels are the same on every scanline and are computed once. */
+static GpStatus resample_bitmap(GDIPCONST GpRect *src_area, LPBYTE src_data, GpBitmap *bitmap,
+    GDIPCONST GpImageAttributes *attributes, InterpolationMode interpolation,
+    PixelOffsetMode offset_mode, GDIPCONST GpPointF *dst_to_src_points,
+    REAL srcx, REAL srcy, REAL srcwidth, REAL srcheight,
+    GDIPCONST RECT *dst_area, LPBYTE dst_data, INT dst_stride)
+{
+    INT width = dst_area->right - dst_area->left;
+    REAL x_dx, x_dy, y_dx, y_dy, row_dx, row_dy;
+    struct sample_position *columns, row;
+    GpPointF src_pointf, *points;
+    ARGB *dst_color;
+    INT x, y;
+
+    x_dx = dst_to_src_points[1].X - dst_to_src_points[0].X;
+    x_dy = dst_to_src_points[1].Y - dst_to_src_points[0].Y;
+    y_dx = dst_to_src_points[2].X - dst_to_src_points[0].X;
+    y_dy = dst_to_src_points[2].Y - dst_to_src_points[0].Y;
+
+    interpolation = get_sample_interpolation(interpolation);
+
+    /* source position of each column on the scanline through the origin */
+    points = heap_alloc(width * sizeof(*points));
+    if (!points) return OutOfMemory;
+
+    for (x = 0; x < width; x++)
+    {
+        points[x].X = dst_to_src_points[0].X + (dst_area->left + x) * x_dx;
+        points[x].Y = dst_to_src_points[0].Y + (dst_area->left + x) * x_dy;
+    }
+
+    if (x_dy == 0.0f && y_dx == 0.0f)
+    {
+        columns = heap_alloc(width * sizeof(*columns));
+        if (!columns)
+        {
+            heap_free(points);
+            return OutOfMemory;
+        }
+
+        for (x = 0; x < width; x++)
+            get_sample_position(points[x].X, interpolation, offset_mode, &columns[x]);
+
+        for (y = dst_area->top; y < dst_area->bottom; y++)
+        {
+            dst_color = (ARGB *)(dst_data + dst_stride * (y - dst_area->top));
+            src_pointf.Y = points[0].Y + y * y_dy;
+
+            if (src_pointf.Y < srcy || src_pointf.Y >= srcy + srcheight)
+            {
+                memset(dst_color, 0, width * sizeof(ARGB));
+                continue;
+            }
+            get_sample_position(src_pointf.Y, interpolation, offset_mode, &row);
+
+            for (x = 0; x < width; x++)
+            {
+                if (points[x].X >= srcx && points[x].X < srcx + srcwidth)
+                    dst_color[x] = sample_bitmap(src_area, src_data, bitmap->width, bitmap->height,
+                        &columns[x], &row, attributes, interpolation);
+                else
+                    dst_color[x] = 0;
+            }
+        }
+
+        heap_free(columns);
     }
+    else
+    {
+        for (y = dst_area->top; y < dst_area->bottom; y++)
+        {
+            dst_color = (ARGB *)(dst_data + dst_stride * (y - dst_area->top));
+            row_dx = y * y_dx;
+            row_dy = y * y_dy;
+
+            for (x = 0; x < width; x++)
+            {
+                src_pointf.X = points[x].X + row_dx;
+                src_pointf.Y = points[x].Y + row_dy;
 
+                if (src_pointf.X >= srcx && src_pointf.X < srcx + srcwidth && src_pointf.Y >= srcy && src_pointf.Y < srcy+srcheight)
+                    dst_color[x] = resample_bitmap_pixel(src_area, src_data, bitmap->width, bitmap->height,
+                        &src_pointf, attributes, interpolation, offset_mode);
+                else
+                    dst_color[x] = 0;
+            }
+        }
     }
+
+    heap_free(points);
+    return Ok;
 }
 
 static REAL intersect_line_scanline(const GpPointF *p1, const GpPointF *p2, REAL y)
@@ -2982,7 +3186,7 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
             RECT dst_area;
             GpRectF graphics_bounds;
             GpRect src_area;
-            int i, x, y, src_stride, dst_stride;
+            int i, src_stride, dst_stride;
             GpMatrix dst_to_src;
             REAL m11, m12, m21, m22, mdx, mdy;
             LPBYTE src_data, dst_data, dst_dyn_data=NULL;
@@ -2990,7 +3194,6 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
             InterpolationMode interpolation = graphics->interpolation;
             PixelOffsetMode offset_mode = graphics->pixeloffset;
             GpPointF dst_to_src_points[3] = {{0.0, 0.0}, {1.0, 0.0}, {0.0, 1.0}};
-            REAL x_dx, x_dy, y_dx, y_dy;
             static const GpImageAttributes defaultImageAttributes = {WrapModeClamp, 0, FALSE};
 
             if (!imageAttributes)
@@ -3091,29 +3294,14 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
 
                 GdipTransformMatrixPoints(&dst_to_src, dst_to_src_points, 3);
 
-                x_dx = dst_to_src_points[1].X - dst_to_src_points[0].X;
-                x_dy = dst_to_src_points[1].Y - dst_to_src_points[0].Y;
-                y_dx = dst_to_src_points[2].X - dst_to_src_points[0].X;
-                y_dy = dst_to_src_points[2].Y - dst_to_src_points[0].Y;
-
-                for (x=dst_area.left; x<dst_area.right; x++)
+                stat = resample_bitmap(&src_area, src_data, bitmap, imageAttributes,
+                    interpolation, offset_mode, dst_to_src_points, srcx, srcy, srcwidth, srcheight,
+                    &dst_area, dst_data, dst_stride);
+                if (stat != Ok)
                 {
-                    for (y=dst_area.top; y<dst_area.bottom; y++)
-                    {
-                        GpPointF src_pointf;
-                        ARGB *dst_color;
-
-                        src_pointf.X = dst_to_src_points[0].X + x * x_dx + y * y_dx;
-                        src_pointf.Y = dst_to_src_points[0].Y + x * x_dy + y * y_dy;
-
-                        dst_color = (ARGB*)(dst_data + dst_stride * (y - dst_area.top) + sizeof(ARGB) * (x - dst_area.left));
-
-                        if (src_pointf.X >= srcx && src_pointf.X < srcx + srcwidth && src_pointf.Y >= srcy && src_pointf.Y < srcy+srcheight)
-                            *dst_color = resample_bitmap_pixel(&src_area, src_data, bitmap->width, bitmap->height, &src_pointf,
-                                                               imageAttributes, interpolation, offset_mode);
-                        else
-                            *dst_color = 0;
-                    }
+                    heap_free(src_data);
+                    heap_free(dst_dyn_data);
+                    return stat;
                 }
             }
             else
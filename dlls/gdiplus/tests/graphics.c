@@ -6446,6 +6446,110 @@ static void test_GdipFillRectanglesOnBitmapTextureBrush(void)
     GdipFree(src_img_data);
 }
 
+static void test_GdipDrawImage_resampling(void)
+{
+    static const InterpolationMode modes[] =
+    {
+        InterpolationModeNearestNeighbor,
+        InterpolationModeBilinear,
+        InterpolationModeHighQualityBicubic
+    };
+    GpBitmap *src_bitmap, *edge_bitmap, *dst_bitmap;
+    GpGraphics *graphics;
+    GpStatus status;
+    DWORD *bits, *edge_bits, start;
+    ARGB color;
+    UINT i, j;
+
+    bits = GdipAlloc(256 * 256 * 4);
+    for (i = 0; i < 256 * 256; i++) bits[i] = 0xff336699;
+
+    /* blue is a horizontal gradient, red and green have a hard edge in the middle */
+    edge_bits = GdipAlloc(256 * 256 * 4);
+    for (i = 0; i < 256 * 256; i++)
+        edge_bits[i] = 0xff000000 | (i % 256 < 128 ? 0 : 0xffff00) | (i % 256);
+
+    status = GdipCreateBitmapFromScan0(256, 256, 256 * 4, PixelFormat32bppARGB, (BYTE *)bits, &src_bitmap);
+    expect(Ok, status);
+    status = GdipCreateBitmapFromScan0(256, 256, 256 * 4, PixelFormat32bppARGB, (BYTE *)edge_bits, &edge_bitmap);
+    expect(Ok, status);
+    status = GdipCreateBitmapFromScan0(512, 512, 0, PixelFormat32bppARGB, NULL, &dst_bitmap);
+    expect(Ok, status);
+    status = GdipGetImageGraphicsContext((GpImage *)dst_bitmap, &graphics);
+    expect(Ok, status);
+
+    for (i = 0; i < sizeof(modes)/sizeof(modes[0]); i++)
+    {
+        status = GdipSetInterpolationMode(graphics, modes[i]);
+        expect(Ok, status);
+
+        /* scaled */
+        status = GdipGraphicsClear(graphics, 0);
+        expect(Ok, status);
+        status = GdipDrawImageRectI(graphics, (GpImage *)src_bitmap, 0, 0, 400, 300);
+        expect(Ok, status);
+        status = GdipBitmapGetPixel(dst_bitmap, 200, 150, &color);
+        expect(Ok, status);
+        ok(color == 0xff336699, "%d: got %08x\n", modes[i], color);
+        status = GdipBitmapGetPixel(dst_bitmap, 450, 150, &color);
+        expect(Ok, status);
+        ok(color == 0, "%d: got %08x\n", modes[i], color);
+
+        /* rotated */
+        status = GdipGraphicsClear(graphics, 0);
+        expect(Ok, status);
+        status = GdipRotateWorldTransform(graphics, 30.0, MatrixOrderAppend);
+        expect(Ok, status);
+        status = GdipDrawImageRectI(graphics, (GpImage *)src_bitmap, 100, 0, 200, 200);
+        expect(Ok, status);
+        status = GdipResetWorldTransform(graphics);
+        expect(Ok, status);
+        status = GdipBitmapGetPixel(dst_bitmap, 100, 170, &color);
+        expect(Ok, status);
+        ok(color == 0xff336699, "%d: got %08x\n", modes[i], color);
+
+        /* enlarged gradient and edge, on odd columns that fall between source pixels */
+        status = GdipGraphicsClear(graphics, 0);
+        expect(Ok, status);
+        status = GdipDrawImageRectI(graphics, (GpImage *)edge_bitmap, 0, 0, 512, 512);
+        expect(Ok, status);
+        for (j = 33; j < 512; j += 64)
+        {
+            status = GdipBitmapGetPixel(dst_bitmap, j, 256, &color);
+            expect(Ok, status);
+            ok(color >> 24 == 0xff, "%d, %u: got %08x\n", modes[i], j, color);
+            ok(abs((INT)(color & 0xff) - (INT)j / 2) <= 2, "%d, %u: got %08x\n", modes[i], j, color);
+            ok(((color >> 16) & 0xff) == (j < 256 ? 0 : 0xff), "%d, %u: got %08x\n", modes[i], j, color);
+        }
+        status = GdipBitmapGetPixel(dst_bitmap, 255, 256, &color);
+        expect(Ok, status);
+        if (modes[i] == InterpolationModeNearestNeighbor)
+            ok(((color >> 16) & 0xff) == 0 || ((color >> 16) & 0xff) == 0xff, "%d: got %08x\n", modes[i], color);
+        else
+            ok(((color >> 16) & 0xff) > 0x10 && ((color >> 16) & 0xff) < 0xf0, "%d: got %08x\n", modes[i], color);
+
+        if (winetest_interactive)
+        {
+            /* throughput of enlarging the whole picture */
+            start = GetTickCount();
+            for (j = 0; j < 10; j++)
+            {
+                status = GdipDrawImageRectI(graphics, (GpImage *)src_bitmap, 0, 0, 512, 512);
+                if (status != Ok) break;
+            }
+            expect(Ok, status);
+            trace("interpolation %d: 10 draws of 256x256 to 512x512 in %u ms\n", modes[i], GetTickCount() - start);
+        }
+    }
+
+    GdipDeleteGraphics(graphics);
+    GdipDisposeImage((GpImage *)dst_bitmap);
+    GdipDisposeImage((GpImage *)edge_bitmap);
+    GdipDisposeImage((GpImage *)src_bitmap);
+    GdipFree(edge_bits);
+    GdipFree(bits);
+}
+
 static void test_GdipDrawImagePointsRectOnMemoryDC(void)
 {
     ARGB color[6] = {0,0,0,0,0,0};
@@ -6656,6 +6760,7 @@ START_TEST(graphics)
     test_GdipFillRectanglesOnMemoryDCTextureBrush();
     test_GdipFillRectanglesOnBitmapTextureBrush();
     test_GdipDrawImagePointsRectOnMemoryDC();
+    test_GdipDrawImage_resampling();
     test_container_rects();
     test_GdipGraphicsSetAbort();
     test_cliphrgn_transform();
@@ -32,6 +32,12 @@ typedef struct {
     jsdisp_t dispex;
 
     DWORD length;
+
+    /* Elements 0..elems_cnt-1 are kept in dense storage until the array gets holes. */
+    jsval_t *elems;
+    DWORD elems_cnt;
+    DWORD elems_size;
+    BOOL sparse;
 } ArrayInstance;
 
 static const WCHAR lengthW[] = {'l','e','n','g','t','h',0};
@@ -71,6 +77,69 @@ unsigned array_get_length(jsdisp_t *array)
     return array_from_jsdisp(array)->length;
 }
 
+/* Returns array if all its elements are in dense storage. */
+static inline ArrayInstance *dense_array(jsdisp_t *jsdisp)
+{
+    ArrayInstance *array;
+
+    if(!is_class(jsdisp, JSCLASS_ARRAY))
+        return NULL;
+
+    array = array_from_jsdisp(jsdisp);
+    return !array->sparse && array->elems_cnt == array->length ? array : NULL;
+}
+
+static BOOL ensure_elems_size(ArrayInstance *array, DWORD size)
+{
+    jsval_t *new_elems;
+    DWORD new_size;
+
+    if(size <= array->elems_size)
+        return TRUE;
+
+    new_size = max(array->elems_size*2, 8);
+    if(new_size < size)
+        new_size = size;
+
+    if(array->elems)
+        new_elems = heap_realloc(array->elems, new_size*sizeof(*new_elems));
+    else
+        new_elems = heap_alloc(new_size*sizeof(*new_elems));
+    if(!new_elems)
+        return FALSE;
+
+    array->elems = new_elems;
+    array->elems_size = new_size;
+    return TRUE;
+}
+
+static void release_elems(ArrayInstance *array)
+{
+    DWORD i;
+
+    for(i=0; i < array->elems_cnt; i++)
+        jsval_release(array->elems[i]);
+    heap_free(array->elems);
+    array->elems = NULL;
+    array->elems_cnt = array->elems_size = 0;
+}
+
+/* Moves elements from dense storage to regular properties. Used once the array gets holes. */
+static HRESULT array_to_sparse(ArrayInstance *array)
+{
+    HRESULT hres;
+
+    TRACE("%p %u\n", array, array->elems_cnt);
+
+    hres = jsdisp_idx_to_props(&array->dispex);
+    if(FAILED(hres))
+        return hres;
+
+    release_elems(array);
+    array->sparse = TRUE;
+    return S_OK;
+}
+
 static HRESULT get_length(script_ctx_t *ctx, vdisp_t *vdisp, jsdisp_t **jsthis, DWORD *ret)
 {
     ArrayInstance *array;
@@ -150,8 +219,9 @@ static HRESULT Array_set_length(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t val
     if(len!=(DWORD)len)
         return throw_range_error(ctx, JS_E_INVALID_LENGTH, NULL);
 
-    for(i=len; i < This->length; i++) {
-        hres = jsdisp_delete_idx(&This->dispex, i);
+    /* Delete from the end, so that dense storage is truncated instead of getting holes. */
+    for(i=This->length; i > len; i--) {
+        hres = jsdisp_delete_idx(&This->dispex, i-1);
         if(FAILED(hres))
             return hres;
     }
@@ -362,6 +432,7 @@ static HRESULT Array_join(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigne
 static HRESULT Array_pop(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis;
     jsval_t val;
     DWORD length;
@@ -384,6 +455,24 @@ static HRESULT Array_pop(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned
     }
 
     length--;
+
+    if((array = dense_array(jsthis))) {
+        val = array->elems[length];
+        array->elems_cnt = array->length = length;
+
+        hres = jsdisp_delete_idx(jsthis, length);
+        if(FAILED(hres)) {
+            jsval_release(val);
+            return hres;
+        }
+
+        if(r)
+            *r = val;
+        else
+            jsval_release(val);
+        return S_OK;
+    }
+
     hres = jsdisp_get_idx(jsthis, length, &val);
     if(SUCCEEDED(hres))
         hres = jsdisp_delete_idx(jsthis, length);
@@ -495,6 +584,7 @@ static HRESULT Array_reverse(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsi
 static HRESULT Array_shift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis;
     DWORD length = 0, i;
     jsval_t v, ret;
@@ -516,6 +606,24 @@ static HRESULT Array_shift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsign
         return S_OK;
     }
 
+    if((array = dense_array(jsthis))) {
+        ret = array->elems[0];
+        memmove(array->elems, array->elems+1, (length-1)*sizeof(*array->elems));
+        array->elems_cnt = array->length = length-1;
+
+        hres = jsdisp_delete_idx(jsthis, length-1);
+        if(FAILED(hres)) {
+            jsval_release(ret);
+            return hres;
+        }
+
+        if(r)
+            *r = ret;
+        else
+            jsval_release(ret);
+        return S_OK;
+    }
+
     hres = jsdisp_get_idx(jsthis, 0, &ret);
     if(hres == DISP_E_UNKNOWNNAME) {
         ret = jsval_undefined();
@@ -949,6 +1057,7 @@ static HRESULT Array_toLocaleString(script_ctx_t *ctx, vdisp_t *vthis, WORD flag
 static HRESULT Array_unshift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis;
     WCHAR buf[14], *buf_end, *str;
     DWORD i, length;
@@ -962,7 +1071,24 @@ static HRESULT Array_unshift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsi
     if(FAILED(hres))
         return hres;
 
-    if(argc) {
+    if(argc && (array = dense_array(jsthis))) {
+        if(!ensure_elems_size(array, length+argc))
+            return E_OUTOFMEMORY;
+
+        memmove(array->elems+argc, array->elems, length*sizeof(*array->elems));
+        for(i=0; i < argc; i++) {
+            hres = jsval_copy(argv[i], array->elems+i);
+            if(FAILED(hres)) {
+                while(i--)
+                    jsval_release(array->elems[i]);
+                memmove(array->elems, array->elems+argc, length*sizeof(*array->elems));
+                return hres;
+            }
+        }
+
+        length += argc;
+        array->elems_cnt = array->length = length;
+    }else if(argc) {
         buf_end = buf + sizeof(buf)/sizeof(WCHAR)-1;
         *buf_end-- = 0;
         i = length;
@@ -985,15 +1111,13 @@ static HRESULT Array_unshift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsi
 
         if(FAILED(hres))
             return hres;
-    }
 
-    for(i=0; i<argc; i++) {
-        hres = jsdisp_propput_idx(jsthis, i, argv[i]);
-        if(FAILED(hres))
-            return hres;
-    }
+        for(i=0; i<argc; i++) {
+            hres = jsdisp_propput_idx(jsthis, i, argv[i]);
+            if(FAILED(hres))
+                return hres;
+        }
 
-    if(argc) {
         length += argc;
         hres = set_length(jsthis, length);
         if(FAILED(hres))
@@ -1017,6 +1141,7 @@ static HRESULT Array_get_value(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t *r)
 
 static void Array_destructor(jsdisp_t *dispex)
 {
+    release_elems(array_from_jsdisp(dispex));
     heap_free(dispex);
 }
 
@@ -1026,7 +1151,7 @@ static void Array_on_put(jsdisp_t *dispex, const WCHAR *name)
     const WCHAR *ptr = name;
     DWORD id = 0;
 
-    if(!isdigitW(*ptr))
+    if(!isdigitW(*ptr) || (*ptr == '0' && ptr[1]))
         return;
 
     while(*ptr && isdigitW(*ptr)) {
@@ -1037,10 +1162,86 @@ static void Array_on_put(jsdisp_t *dispex, const WCHAR *name)
     if(*ptr)
         return;
 
+    /* A regular element property (e.g. overriding an inherited one) means dense storage can't be used. */
+    if(!array->sparse && FAILED(array_to_sparse(array)))
+        WARN("array_to_sparse failed\n");
+
     if(id >= array->length)
         array->length = id+1;
 }
 
+static unsigned Array_idx_length(jsdisp_t *jsdisp)
+{
+    return array_from_jsdisp(jsdisp)->elems_cnt;
+}
+
+static HRESULT Array_idx_get(jsdisp_t *jsdisp, unsigned idx, jsval_t *r)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+
+    TRACE("%p[%u]\n", array, idx);
+
+    if(idx >= array->elems_cnt) {
+        *r = jsval_undefined();
+        return S_OK;
+    }
+
+    return jsval_copy(array->elems[idx], r);
+}
+
+static HRESULT Array_idx_put(jsdisp_t *jsdisp, unsigned idx, jsval_t val)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+    jsval_t copy;
+    HRESULT hres;
+
+    TRACE("%p[%u] = %s\n", array, idx, debugstr_jsval(val));
+
+    assert(idx < array->elems_cnt);
+
+    hres = jsval_copy(val, &copy);
+    if(FAILED(hres))
+        return hres;
+
+    jsval_release(array->elems[idx]);
+    array->elems[idx] = copy;
+    return S_OK;
+}
+
+static HRESULT Array_idx_add(jsdisp_t *jsdisp, unsigned idx)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+
+    TRACE("%p[%u]\n", array, idx);
+
+    if(array->sparse)
+        return S_FALSE;
+
+    if(idx != array->elems_cnt)
+        return array_to_sparse(array);
+
+    if(!ensure_elems_size(array, array->elems_cnt+1))
+        return E_OUTOFMEMORY;
+
+    array->elems[array->elems_cnt++] = jsval_undefined();
+    if(idx >= array->length)
+        array->length = idx+1;
+    return S_OK;
+}
+
+static HRESULT Array_idx_delete(jsdisp_t *jsdisp, unsigned idx)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+
+    TRACE("%p[%u]\n", array, idx);
+
+    if(idx+1 != array->elems_cnt)
+        return array_to_sparse(array);
+
+    jsval_release(array->elems[--array->elems_cnt]);
+    return S_OK;
+}
+
 static const builtin_prop_t Array_props[] = {
     {concatW,                Array_concat,               PROPF_METHOD|1},
     {joinW,                  Array_join,                 PROPF_METHOD|1},
@@ -1063,7 +1264,12 @@ static const builtin_info_t Array_info = {
     sizeof(Array_props)/sizeof(*Array_props),
     Array_props,
     Array_destructor,
-    Array_on_put
+    Array_on_put,
+    Array_idx_length,
+    Array_idx_get,
+    Array_idx_put,
+    Array_idx_add,
+    Array_idx_delete
 };
 
 static const builtin_prop_t ArrayInst_props[] = {
@@ -1076,7 +1282,12 @@ static const builtin_info_t ArrayInst_info = {
     sizeof(ArrayInst_props)/sizeof(*ArrayInst_props),
     ArrayInst_props,
     Array_destructor,
-    Array_on_put
+    Array_on_put,
+    Array_idx_length,
+    Array_idx_get,
+    Array_idx_put,
+    Array_idx_add,
+    Array_idx_delete
 };
 
 static HRESULT ArrayConstr_value(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
@@ -95,6 +95,9 @@ static void dump_instr_arg(instr_arg_type_t type, instr_arg_t *arg)
     case ARG_INT:
         TRACE_(jscript_disas)("\t%d", arg->uint);
         break;
+    case ARG_SITE:
+        TRACE_(jscript_disas)("\t%s", debugstr_wn(arg->site->name, SysStringLen(arg->site->name)));
+        break;
     case ARG_UINT:
     case ARG_ADDR:
         TRACE_(jscript_disas)("\t%u", arg->uint);
@@ -279,20 +282,27 @@ static HRESULT push_instr_bstr(compiler_ctx_t *ctx, jsop_t op, const WCHAR *arg)
     return S_OK;
 }
 
-static HRESULT push_instr_bstr_uint(compiler_ctx_t *ctx, jsop_t op, const WCHAR *arg1, unsigned arg2)
+static HRESULT push_instr_site(compiler_ctx_t *ctx, jsop_t op, const WCHAR *name, unsigned arg2)
 {
+    prop_site_t *site;
     unsigned instr;
-    WCHAR *str;
 
-    str = compiler_alloc_bstr(ctx, arg1);
-    if(!str)
+    site = compiler_alloc(ctx->code, sizeof(*site));
+    if(!site)
         return E_OUTOFMEMORY;
 
+    site->name = compiler_alloc_bstr(ctx, name);
+    if(!site->name)
+        return E_OUTOFMEMORY;
+
+    site->cache.id = 0;
+    site->cache.hash = 0;
+
     instr = push_instr(ctx, op);
     if(!instr)
         return E_OUTOFMEMORY;
 
-    instr_ptr(ctx, instr)->u.arg[0].bstr = str;
+    instr_ptr(ctx, instr)->u.arg[0].site = site;
     instr_ptr(ctx, instr)->u.arg[1].uint = arg2;
     return S_OK;
 }
@@ -379,7 +389,7 @@ static HRESULT compile_member_expression(compiler_ctx_t *ctx, member_expression_
     if(FAILED(hres))
         return hres;
 
-    return push_instr_bstr(ctx, OP_member, expr->identifier);
+    return push_instr_site(ctx, OP_member, expr->identifier, 0);
 }
 
 #define LABEL_FLAG 0x80000000
@@ -439,7 +449,7 @@ static HRESULT emit_identifier_ref(compiler_ctx_t *ctx, const WCHAR *identifier,
     int local_ref;
     if(bind_local(ctx, identifier, &local_ref))
         return push_instr_int(ctx, OP_local_ref, local_ref);
-    return push_instr_bstr_uint(ctx, OP_identid, identifier, flags);
+    return push_instr_site(ctx, OP_identid, identifier, flags);
 }
 
 static HRESULT emit_identifier(compiler_ctx_t *ctx, const WCHAR *identifier)
@@ -447,7 +457,7 @@ static HRESULT emit_identifier(compiler_ctx_t *ctx, const WCHAR *identifier)
     int local_ref;
     if(bind_local(ctx, identifier, &local_ref))
         return push_instr_int(ctx, OP_local, local_ref);
-    return push_instr_bstr(ctx, OP_ident, identifier);
+    return push_instr_site(ctx, OP_ident, identifier, 0);
 }
 
 static HRESULT compile_memberid_expression(compiler_ctx_t *ctx, expression_t *expr, unsigned flags)
@@ -482,12 +492,7 @@ static HRESULT compile_memberid_expression(compiler_ctx_t *ctx, expression_t *ex
         if(FAILED(hres))
             return hres;
 
-        /* FIXME: Potential optimization */
-        hres = push_instr_str(ctx, OP_str, member_expr->identifier);
-        if(FAILED(hres))
-            return hres;
-
-        hres = push_instr_uint(ctx, OP_memberid, flags);
+        hres = push_instr_site(ctx, OP_member_ref, member_expr->identifier, flags);
         break;
     }
     DEFAULT_UNREACHABLE;
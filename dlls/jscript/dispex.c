@@ -179,10 +179,37 @@ static dispex_prop_t *alloc_protref(jsdisp_t *This, const WCHAR *name, DWORD ref
     return ret;
 }
 
+static BOOL is_idx_name(const WCHAR *name, unsigned *ret)
+{
+    unsigned idx = 0;
+
+    if(!isdigitW(*name) || (*name == '0' && name[1]))
+        return FALSE;
+
+    for(; isdigitW(*name); name++) {
+        if(idx > (~0u-9)/10)
+            return FALSE;
+        idx = idx*10 + (*name-'0');
+    }
+
+    if(*name)
+        return FALSE;
+
+    *ret = idx;
+    return TRUE;
+}
+
+static inline DWORD get_idx_prop_flags(jsdisp_t *This)
+{
+    if(This->builtin_info->idx_add)
+        return PROPF_ENUM;
+    return This->builtin_info->idx_put ? 0 : PROPF_CONST;
+}
+
 static HRESULT find_prop_name(jsdisp_t *This, unsigned hash, const WCHAR *name, dispex_prop_t **ret)
 {
     const builtin_prop_t *builtin;
-    unsigned bucket, pos, prev = 0;
+    unsigned bucket, pos, prev = 0, idx;
     dispex_prop_t *prop;
 
     bucket = get_props_idx(This, hash);
@@ -195,7 +222,17 @@ static HRESULT find_prop_name(jsdisp_t *This, unsigned hash, const WCHAR *name,
                 This->props[bucket].bucket_head = pos;
             }
 
-            *ret = &This->props[pos];
+            prop = &This->props[pos];
+
+            /* Indexed storage may have grown over a deleted property or a prototype reference. */
+            if((prop->type == PROP_DELETED || prop->type == PROP_PROTREF) && This->builtin_info->idx_add
+               && is_idx_name(name, &idx) && idx < This->builtin_info->idx_length(This)) {
+                prop->type = PROP_IDX;
+                prop->flags = get_idx_prop_flags(This);
+                prop->u.idx = idx;
+            }
+
+            *ret = prop;
             return S_OK;
         }
 
@@ -214,21 +251,14 @@ static HRESULT find_prop_name(jsdisp_t *This, unsigned hash, const WCHAR *name,
         return S_OK;
     }
 
-    if(This->builtin_info->idx_length) {
-        const WCHAR *ptr;
-        unsigned idx = 0;
-
-        for(ptr = name; isdigitW(*ptr) && idx < 0x10000; ptr++)
-            idx = idx*10 + (*ptr-'0');
-        if(!*ptr && idx < This->builtin_info->idx_length(This)) {
-            prop = alloc_prop(This, name, PROP_IDX, This->builtin_info->idx_put ? 0 : PROPF_CONST);
-            if(!prop)
-                return E_OUTOFMEMORY;
+    if(This->builtin_info->idx_length && is_idx_name(name, &idx) && idx < This->builtin_info->idx_length(This)) {
+        prop = alloc_prop(This, name, PROP_IDX, get_idx_prop_flags(This));
+        if(!prop)
+            return E_OUTOFMEMORY;
 
-            prop->u.idx = idx;
-            *ret = prop;
-            return S_OK;
-        }
+        prop->u.idx = idx;
+        *ret = prop;
+        return S_OK;
     }
 
     *ret = NULL;
@@ -278,12 +308,21 @@ static HRESULT find_prop_name_prot(jsdisp_t *This, unsigned hash, const WCHAR *n
 static HRESULT ensure_prop_name(jsdisp_t *This, const WCHAR *name, BOOL search_prot, DWORD create_flags, dispex_prop_t **ret)
 {
     dispex_prop_t *prop;
+    unsigned idx;
     HRESULT hres;
 
     if(search_prot)
         hres = find_prop_name_prot(This, string_hash(name), name, &prop);
     else
         hres = find_prop_name(This, string_hash(name), name, &prop);
+    if(SUCCEEDED(hres) && (!prop || prop->type == PROP_DELETED) && This->builtin_info->idx_add
+       && is_idx_name(name, &idx)) {
+        /* The object may either extend its indexed storage or convert it to regular properties,
+         * in both cases the property table may have changed. */
+        hres = This->builtin_info->idx_add(This, idx);
+        if(SUCCEEDED(hres))
+            hres = find_prop_name(This, string_hash(name), name, &prop);
+    }
     if(SUCCEEDED(hres) && (!prop || prop->type == PROP_DELETED)) {
         TRACE("creating prop %s flags %x\n", debugstr_w(name), create_flags);
 
@@ -538,6 +577,25 @@ static HRESULT fill_protrefs(jsdisp_t *This)
     return S_OK;
 }
 
+static HRESULT fill_idx_props(jsdisp_t *This)
+{
+    static const WCHAR formatW[] = {'%','u',0};
+    unsigned i, length;
+    dispex_prop_t *prop;
+    WCHAR buf[12];
+    HRESULT hres;
+
+    length = This->builtin_info->idx_length(This);
+    for(i = 0; i < length; i++) {
+        sprintfW(buf, formatW, i);
+        hres = find_prop_name(This, string_hash(buf), buf, &prop);
+        if(FAILED(hres))
+            return hres;
+    }
+
+    return S_OK;
+}
+
 static inline jsdisp_t *impl_from_IDispatchEx(IDispatchEx *iface)
 {
     return CONTAINING_RECORD(iface, jsdisp_t, IDispatchEx_iface);
@@ -732,7 +790,7 @@ static HRESULT WINAPI DispatchEx_InvokeEx(IDispatchEx *iface, DISPID id, LCID lc
     return hres;
 }
 
-static HRESULT delete_prop(dispex_prop_t *prop, BOOL *ret)
+static HRESULT delete_prop(jsdisp_t *This, dispex_prop_t *prop, BOOL *ret)
 {
     if(prop->flags & PROPF_DONTDELETE) {
         *ret = FALSE;
@@ -741,6 +799,23 @@ static HRESULT delete_prop(dispex_prop_t *prop, BOOL *ret)
 
     *ret = TRUE; /* FIXME: not exactly right */
 
+    if(prop->type == PROP_IDX && This->builtin_info->idx_delete) {
+        DISPID id = prop_to_id(This, prop);
+        HRESULT hres;
+
+        if(prop->u.idx < This->builtin_info->idx_length(This)) {
+            hres = This->builtin_info->idx_delete(This, prop->u.idx);
+            if(FAILED(hres))
+                return hres;
+            prop = This->props + id;
+        }
+
+        if(prop->type == PROP_IDX) {
+            prop->type = PROP_DELETED;
+            return S_OK;
+        }
+    }
+
     if(prop->type == PROP_JSVAL) {
         jsval_release(prop->u.val);
         prop->type = PROP_DELETED;
@@ -768,7 +843,7 @@ static HRESULT WINAPI DispatchEx_DeleteMemberByName(IDispatchEx *iface, BSTR bst
         return S_OK;
     }
 
-    return delete_prop(prop, &b);
+    return delete_prop(This, prop, &b);
 }
 
 static HRESULT WINAPI DispatchEx_DeleteMemberByDispID(IDispatchEx *iface, DISPID id)
@@ -785,7 +860,7 @@ static HRESULT WINAPI DispatchEx_DeleteMemberByDispID(IDispatchEx *iface, DISPID
         return DISP_E_MEMBERNOTFOUND;
     }
 
-    return delete_prop(prop, &b);
+    return delete_prop(This, prop, &b);
 }
 
 static HRESULT WINAPI DispatchEx_GetMemberProperties(IDispatchEx *iface, DISPID id, DWORD grfdexFetch, DWORD *pgrfdex)
@@ -825,6 +900,12 @@ static HRESULT WINAPI DispatchEx_GetNextDispID(IDispatchEx *iface, DWORD grfdex,
         hres = fill_protrefs(This);
         if(FAILED(hres))
             return hres;
+
+        if(This->builtin_info->idx_add) {
+            hres = fill_idx_props(This);
+            if(FAILED(hres))
+                return hres;
+        }
     }
 
     if(id+1>=0 && id+1<This->prop_cnt) {
@@ -1040,6 +1121,27 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, prop_cache_t *cache, DISPID *id)
+{
+    HRESULT hres;
+
+    if(cache->id > 0 && cache->id < jsdisp->prop_cnt) {
+        dispex_prop_t *prop = jsdisp->props + cache->id;
+
+        if(prop->hash == cache->hash && prop->type != PROP_DELETED && !strcmpW(prop->name, name)) {
+            *id = cache->id;
+            return S_OK;
+        }
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(hres == S_OK) {
+        cache->id = *id;
+        cache->hash = jsdisp->props[*id].hash;
+    }
+    return hres;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
@@ -1316,8 +1418,19 @@ HRESULT jsdisp_propput_dontenum(jsdisp_t *obj, const WCHAR *name, jsval_t val)
 HRESULT jsdisp_propput_idx(jsdisp_t *obj, DWORD idx, jsval_t val)
 {
     WCHAR buf[12];
+    HRESULT hres;
 
-    static const WCHAR formatW[] = {'%','d',0};
+    static const WCHAR formatW[] = {'%','u',0};
+
+    if(obj->builtin_info->idx_put) {
+        if(obj->builtin_info->idx_add && idx >= obj->builtin_info->idx_length(obj)) {
+            hres = obj->builtin_info->idx_add(obj, idx);
+            if(FAILED(hres))
+                return hres;
+        }
+        if(idx < obj->builtin_info->idx_length(obj))
+            return obj->builtin_info->idx_put(obj, idx, val);
+    }
 
     sprintfW(buf, formatW, idx);
     return jsdisp_propput_name(obj, buf, val);
@@ -1397,7 +1510,10 @@ HRESULT jsdisp_get_idx(jsdisp_t *obj, DWORD idx, jsval_t *r)
     dispex_prop_t *prop;
     HRESULT hres;
 
-    static const WCHAR formatW[] = {'%','d',0};
+    static const WCHAR formatW[] = {'%','u',0};
+
+    if(obj->builtin_info->idx_length && idx < obj->builtin_info->idx_length(obj))
+        return obj->builtin_info->idx_get(obj, idx, r);
 
     sprintfW(name, formatW, idx);
 
@@ -1463,19 +1579,57 @@ HRESULT disp_propget(script_ctx_t *ctx, IDispatch *disp, DISPID id, jsval_t *val
 
 HRESULT jsdisp_delete_idx(jsdisp_t *obj, DWORD idx)
 {
-    static const WCHAR formatW[] = {'%','d',0};
+    static const WCHAR formatW[] = {'%','u',0};
     WCHAR buf[12];
     dispex_prop_t *prop;
     BOOL b;
     HRESULT hres;
 
+    if(obj->builtin_info->idx_delete && idx < obj->builtin_info->idx_length(obj)) {
+        hres = obj->builtin_info->idx_delete(obj, idx);
+        if(FAILED(hres))
+            return hres;
+    }
+
     sprintfW(buf, formatW, idx);
 
     hres = find_prop_name(obj, string_hash(buf), buf, &prop);
     if(FAILED(hres) || !prop)
         return hres;
 
-    return delete_prop(prop, &b);
+    return delete_prop(obj, prop, &b);
+}
+
+/* Converts all elements of object's indexed storage to regular properties. */
+HRESULT jsdisp_idx_to_props(jsdisp_t *obj)
+{
+    static const WCHAR formatW[] = {'%','u',0};
+    unsigned i, length;
+    dispex_prop_t *prop;
+    WCHAR buf[12];
+    jsval_t val;
+    HRESULT hres;
+
+    length = obj->builtin_info->idx_length(obj);
+    for(i = 0; i < length; i++) {
+        sprintfW(buf, formatW, i);
+
+        hres = find_prop_name(obj, string_hash(buf), buf, &prop);
+        if(FAILED(hres))
+            return hres;
+        if(!prop || prop->type != PROP_IDX)
+            continue;
+
+        hres = obj->builtin_info->idx_get(obj, i, &val);
+        if(FAILED(hres))
+            return hres;
+
+        prop->type = PROP_JSVAL;
+        prop->flags = PROPF_ENUM;
+        prop->u.val = val;
+    }
+
+    return S_OK;
 }
 
 HRESULT disp_delete(IDispatch *disp, DISPID id, BOOL *ret)
@@ -1490,7 +1644,7 @@ HRESULT disp_delete(IDispatch *disp, DISPID id, BOOL *ret)
 
         prop = get_prop(jsdisp, id);
         if(prop)
-            hres = delete_prop(prop, ret);
+            hres = delete_prop(jsdisp, prop, ret);
         else
             hres = DISP_E_MEMBERNOTFOUND;
 
@@ -1533,7 +1687,7 @@ HRESULT disp_delete_name(script_ctx_t *ctx, IDispatch *disp, jsstr_t *name, BOOL
 
         hres = find_prop_name(jsdisp, string_hash(ptr), ptr, &prop);
         if(prop) {
-            hres = delete_prop(prop, ret);
+            hres = delete_prop(jsdisp, prop, ret);
         }else {
             *ret = TRUE;
             hres = S_OK;
@@ -1581,7 +1735,8 @@ HRESULT jsdisp_is_own_prop(jsdisp_t *obj, const WCHAR *name, BOOL *ret)
     if(FAILED(hres))
         return hres;
 
-    *ret = prop && (prop->type == PROP_JSVAL || prop->type == PROP_BUILTIN);
+    *ret = prop && (prop->type == PROP_JSVAL || prop->type == PROP_BUILTIN
+                     || (prop->type == PROP_IDX && obj->builtin_info->idx_add));
     return S_OK;
 }
 
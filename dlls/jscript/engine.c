@@ -51,6 +51,7 @@ typedef struct {
     enum {
         EXPRVAL_JSVAL,
         EXPRVAL_IDREF,
+        EXPRVAL_IDX,
         EXPRVAL_STACK_REF,
         EXPRVAL_INVALID
     } type;
@@ -60,6 +61,10 @@ typedef struct {
             IDispatch *disp;
             DISPID id;
         } idref;
+        struct {
+            jsdisp_t *jsdisp;
+            unsigned idx;
+        } idx;
         unsigned off;
         HRESULT hres;
     } u;
@@ -203,6 +208,14 @@ static HRESULT stack_push_exprval(script_ctx_t *ctx, exprval_t *val)
         else
             IDispatch_Release(val->u.idref.disp);
         return hres;
+    case EXPRVAL_IDX:
+        /* the index goes first, so that it's not taken for a stack reference */
+        hres = stack_push(ctx, jsval_number(val->u.idx.idx));
+        if(SUCCEEDED(hres))
+            hres = stack_push(ctx, jsval_obj(val->u.idx.jsdisp));
+        else
+            jsdisp_release(val->u.idx.jsdisp);
+        return hres;
     case EXPRVAL_STACK_REF:
         hres = stack_push(ctx, jsval_number(val->u.off));
         if(SUCCEEDED(hres))
@@ -228,6 +241,13 @@ static BOOL stack_topn_exprval(script_ctx_t *ctx, unsigned n, exprval_t *r)
         call_frame_t *frame = ctx->call_ctx;
         unsigned off = get_number(v);
 
+        if(is_object_instance(stack_topn(ctx, n))) {
+            r->type = EXPRVAL_IDX;
+            r->u.idx.jsdisp = as_jsdisp(get_object(stack_topn(ctx, n)));
+            r->u.idx.idx = off;
+            return TRUE;
+        }
+
         if(!frame->base_scope->frame && off >= frame->arguments_off) {
             DISPID id;
             BSTR name;
@@ -292,6 +312,8 @@ static HRESULT exprval_propput(script_ctx_t *ctx, exprval_t *ref, jsval_t v)
     }
     case EXPRVAL_IDREF:
         return disp_propput(ctx, ref->u.idref.disp, ref->u.idref.id, v);
+    case EXPRVAL_IDX:
+        return jsdisp_propput_idx(ref->u.idx.jsdisp, ref->u.idx.idx, v);
     default:
         assert(0);
         return E_FAIL;
@@ -305,6 +327,16 @@ static HRESULT exprval_propget(script_ctx_t *ctx, exprval_t *ref, jsval_t *r)
         return jsval_copy(ctx->stack[ref->u.off], r);
     case EXPRVAL_IDREF:
         return disp_propget(ctx, ref->u.idref.disp, ref->u.idref.id, r);
+    case EXPRVAL_IDX: {
+        HRESULT hres;
+
+        hres = jsdisp_get_idx(ref->u.idx.jsdisp, ref->u.idx.idx, r);
+        if(hres == DISP_E_UNKNOWNNAME) {
+            *r = jsval_undefined();
+            hres = S_OK;
+        }
+        return hres;
+    }
     default:
         assert(0);
         return E_FAIL;
@@ -326,6 +358,20 @@ static HRESULT exprval_call(script_ctx_t *ctx, exprval_t *ref, WORD flags, unsig
     }
     case EXPRVAL_IDREF:
         return disp_call(ctx, ref->u.idref.disp, ref->u.idref.id, flags, argc, argv, r);
+    case EXPRVAL_IDX: {
+        WCHAR name[12];
+        DISPID id;
+        HRESULT hres;
+
+        static const WCHAR formatW[] = {'%','u',0};
+
+        sprintfW(name, formatW, ref->u.idx.idx);
+        hres = jsdisp_get_id(ref->u.idx.jsdisp, name, fdexNameEnsure, &id);
+        if(FAILED(hres))
+            return hres;
+
+        return disp_call(ctx, to_disp(ref->u.idx.jsdisp), id, flags, argc, argv, r);
+    }
     default:
         assert(0);
         return E_FAIL;
@@ -347,6 +393,8 @@ static HRESULT exprval_to_value(script_ctx_t *ctx, exprval_t *ref, jsval_t *r)
 
     if(ref->type == EXPRVAL_IDREF)
         IDispatch_Release(ref->u.idref.disp);
+    else if(ref->type == EXPRVAL_IDX)
+        jsdisp_release(ref->u.idx.jsdisp);
     return hres;
 }
 
@@ -360,6 +408,9 @@ static void exprval_release(exprval_t *val)
         if(val->u.idref.disp)
             IDispatch_Release(val->u.idref.disp);
         return;
+    case EXPRVAL_IDX:
+        jsdisp_release(val->u.idx.jsdisp);
+        return;
     case EXPRVAL_STACK_REF:
     case EXPRVAL_INVALID:
         return;
@@ -476,6 +527,21 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
     return hres;
 }
 
+static HRESULT disp_get_id_cached(script_ctx_t *ctx, IDispatch *disp, prop_site_t *site, DWORD flags, DISPID *id)
+{
+    jsdisp_t *jsdisp;
+    HRESULT hres;
+
+    jsdisp = iface_to_jsdisp(disp);
+    if(jsdisp) {
+        hres = jsdisp_get_id_cached(jsdisp, site->name, flags, &site->cache, id);
+        jsdisp_release(jsdisp);
+        return hres;
+    }
+
+    return disp_get_id(ctx, disp, site->name, site->name, flags, id);
+}
+
 static HRESULT disp_cmp(IDispatch *disp1, IDispatch *disp2, BOOL *ret)
 {
     IObjectIdentity *identity;
@@ -625,7 +691,7 @@ local_ref_t *lookup_local(const function_code_t *function, const WCHAR *identifi
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
-static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
+static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, prop_cache_t *cache, exprval_t *ret)
 {
     scope_chain_t *scope;
     named_item_t *item;
@@ -665,7 +731,10 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
         }
     }
 
-    hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
+    if(cache)
+        hres = jsdisp_get_id_cached(ctx->global, identifier, 0, cache, &id);
+    else
+        hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
     if(SUCCEEDED(hres)) {
         exprval_set_disp_ref(ret, to_disp(ctx->global), id);
         return S_OK;
@@ -714,6 +783,12 @@ static inline BSTR get_op_bstr(script_ctx_t *ctx, int i)
     return frame->bytecode->instrs[frame->ip].u.arg[i].bstr;
 }
 
+static inline prop_site_t *get_op_site(script_ctx_t *ctx, int i)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return frame->bytecode->instrs[frame->ip].u.arg[i].site;
+}
+
 static inline unsigned get_op_uint(script_ctx_t *ctx, int i)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -1034,6 +1109,24 @@ static HRESULT interp_array(script_ctx_t *ctx)
         return hres;
     }
 
+    if(is_number(namev) && is_int32(get_number(namev)) && get_number(namev) >= 0) {
+        jsdisp_t *jsdisp = iface_to_jsdisp(obj);
+
+        if(jsdisp) {
+            hres = jsdisp_get_idx(jsdisp, get_number(namev), &v);
+            jsdisp_release(jsdisp);
+            IDispatch_Release(obj);
+            if(hres == DISP_E_UNKNOWNNAME) {
+                v = jsval_undefined();
+                hres = S_OK;
+            }
+            if(FAILED(hres))
+                return hres;
+
+            return stack_push(ctx, v);
+        }
+    }
+
     hres = to_flat_string(ctx, namev, &name_str, &name);
     jsval_release(namev);
     if(FAILED(hres)) {
@@ -1059,19 +1152,19 @@ static HRESULT interp_array(script_ctx_t *ctx)
 /* ECMA-262 3rd Edition    11.2.1 */
 static HRESULT interp_member(script_ctx_t *ctx)
 {
-    const BSTR arg = get_op_bstr(ctx, 0);
+    prop_site_t *site = get_op_site(ctx, 0);
     IDispatch *obj;
     jsval_t v;
     DISPID id;
     HRESULT hres;
 
-    TRACE("\n");
+    TRACE("%s\n", debugstr_w(site->name));
 
     hres = stack_pop_object(ctx, &obj);
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_id_cached(ctx, obj, site, 0, &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1085,6 +1178,44 @@ static HRESULT interp_member(script_ctx_t *ctx)
     return stack_push(ctx, v);
 }
 
+/* ECMA-262 3rd Edition    11.2.1 */
+static HRESULT interp_member_ref(script_ctx_t *ctx)
+{
+    prop_site_t *site = get_op_site(ctx, 0);
+    const unsigned flags = get_op_uint(ctx, 1);
+    IDispatch *obj;
+    exprval_t ref;
+    jsval_t objv;
+    DISPID id;
+    HRESULT hres;
+
+    TRACE("%s %x\n", debugstr_w(site->name), flags);
+
+    objv = stack_pop(ctx);
+    hres = to_object(ctx, objv, &obj);
+    jsval_release(objv);
+    if(FAILED(hres))
+        return hres;
+
+    hres = disp_get_id_cached(ctx, obj, site, flags, &id);
+    if(SUCCEEDED(hres)) {
+        ref.type = EXPRVAL_IDREF;
+        ref.u.idref.disp = obj;
+        ref.u.idref.id = id;
+    }else {
+        IDispatch_Release(obj);
+        if(hres == DISP_E_UNKNOWNNAME && !(flags & fdexNameEnsure)) {
+            exprval_set_exception(&ref, JS_E_INVALID_PROPERTY);
+            hres = S_OK;
+        }else {
+            ERR("failed %08x\n", hres);
+            return hres;
+        }
+    }
+
+    return stack_push_exprval(ctx, &ref);
+}
+
 /* ECMA-262 3rd Edition    11.2.1 */
 static HRESULT interp_memberid(script_ctx_t *ctx)
 {
@@ -1104,6 +1235,21 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
 
     hres = to_object(ctx, objv, &obj);
     jsval_release(objv);
+    if(SUCCEEDED(hres) && (arg & fdexNameEnsure) && is_number(namev)
+       && is_int32(get_number(namev)) && get_number(namev) >= 0) {
+        jsdisp_t *jsdisp = iface_to_jsdisp(obj);
+
+        /* Array elements are assigned by index, without creating a named property. */
+        if(jsdisp && jsdisp->builtin_info->idx_add) {
+            IDispatch_Release(obj);
+            ref.type = EXPRVAL_IDX;
+            ref.u.idx.jsdisp = jsdisp;
+            ref.u.idx.idx = get_number(namev);
+            return stack_push_exprval(ctx, &ref);
+        }
+        if(jsdisp)
+            jsdisp_release(jsdisp);
+    }
     if(SUCCEEDED(hres)) {
         hres = to_flat_string(ctx, namev, &name_str, &name);
         if(FAILED(hres))
@@ -1225,12 +1371,12 @@ static HRESULT interp_this(script_ctx_t *ctx)
     return stack_push(ctx, jsval_disp(frame->this_obj));
 }
 
-static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, unsigned flags)
+static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, prop_cache_t *cache, unsigned flags)
 {
     exprval_t exprval;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval(ctx, identifier, cache, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1253,13 +1399,13 @@ static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, unsigne
     return stack_push_exprval(ctx, &exprval);
 }
 
-static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier)
+static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier, prop_cache_t *cache)
 {
     exprval_t exprval;
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval(ctx, identifier, cache, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1283,7 +1429,7 @@ static HRESULT interp_local_ref(script_ctx_t *ctx)
     TRACE("%d\n", arg);
 
     if(!frame->base_scope || !frame->base_scope->frame)
-        return interp_identifier_ref(ctx, local_name(frame, arg), flags);
+        return interp_identifier_ref(ctx, local_name(frame, arg), NULL, flags);
 
     ref.type = EXPRVAL_STACK_REF;
     ref.u.off = local_off(frame, arg);
@@ -1300,7 +1446,7 @@ static HRESULT interp_local(script_ctx_t *ctx)
     TRACE("%d\n", arg);
 
     if(!frame->base_scope || !frame->base_scope->frame)
-        return identifier_value(ctx, local_name(frame, arg));
+        return identifier_value(ctx, local_name(frame, arg), NULL);
 
     hres = jsval_copy(ctx->stack[local_off(frame, arg)], &copy);
     if(FAILED(hres))
@@ -1312,22 +1458,22 @@ static HRESULT interp_local(script_ctx_t *ctx)
 /* ECMA-262 3rd Edition    10.1.4 */
 static HRESULT interp_ident(script_ctx_t *ctx)
 {
-    const BSTR arg = get_op_bstr(ctx, 0);
+    prop_site_t *site = get_op_site(ctx, 0);
 
-    TRACE("%s\n", debugstr_w(arg));
+    TRACE("%s\n", debugstr_w(site->name));
 
-    return identifier_value(ctx, arg);
+    return identifier_value(ctx, site->name, &site->cache);
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
 static HRESULT interp_identid(script_ctx_t *ctx)
 {
-    const BSTR arg = get_op_bstr(ctx, 0);
+    prop_site_t *site = get_op_site(ctx, 0);
     const unsigned flags = get_op_uint(ctx, 1);
 
-    TRACE("%s %x\n", debugstr_w(arg), flags);
+    TRACE("%s %x\n", debugstr_w(site->name), flags);
 
-    return interp_identifier_ref(ctx, arg, flags);
+    return interp_identifier_ref(ctx, site->name, &site->cache, flags);
 }
 
 /* ECMA-262 3rd Edition    7.8.1 */
@@ -1400,7 +1546,7 @@ static HRESULT interp_carray(script_ctx_t *ctx)
 {
     const unsigned arg = get_op_uint(ctx, 0);
     jsdisp_t *array;
-    jsval_t val;
+    jsval_t *argv;
     unsigned i;
     HRESULT hres;
 
@@ -1410,17 +1556,17 @@ static HRESULT interp_carray(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    i = arg;
-    while(i--) {
-        val = stack_pop(ctx);
-        hres = jsdisp_propput_idx(array, i, val);
-        jsval_release(val);
+    /* Store elements in order, so that they end up in array's dense storage. */
+    argv = stack_args(ctx, arg);
+    for(i = 0; i < arg; i++) {
+        hres = jsdisp_propput_idx(array, i, argv[i]);
         if(FAILED(hres)) {
             jsdisp_release(array);
             return hres;
         }
     }
 
+    stack_popn(ctx, arg);
     return stack_push(ctx, jsval_obj(array));
 }
 
@@ -1852,7 +1998,7 @@ static HRESULT interp_delete_ident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx, arg, &exprval);
+    hres = identifier_eval(ctx, arg, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1963,7 +2109,7 @@ static HRESULT interp_typeofident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx, arg, &exprval);
+    hres = identifier_eval(ctx, arg, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -2820,7 +2966,7 @@ static HRESULT bind_event_target(script_ctx_t *ctx, function_code_t *func, jsdis
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, func->event_target, &exprval);
+    hres = identifier_eval(ctx, func->event_target, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
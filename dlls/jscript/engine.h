@@ -42,8 +42,8 @@
     X(func,       1, ARG_UINT,   0)        \
     X(gt,         1, 0,0)                  \
     X(gteq,       1, 0,0)                  \
-    X(ident,      1, ARG_BSTR,   0)        \
-    X(identid,    1, ARG_BSTR,   ARG_INT)  \
+    X(ident,      1, ARG_SITE,   0)        \
+    X(identid,    1, ARG_SITE,   ARG_INT)  \
     X(in,         1, 0,0)                  \
     X(instanceof, 1, 0,0)                  \
     X(int,        1, ARG_INT,    0)        \
@@ -54,7 +54,8 @@
     X(lshift,     1, 0,0)                  \
     X(lt,         1, 0,0)                  \
     X(lteq,       1, 0,0)                  \
-    X(member,     1, ARG_BSTR,   0)        \
+    X(member,     1, ARG_SITE,   0)        \
+    X(member_ref, 1, ARG_SITE,   ARG_UINT) \
     X(memberid,   1, ARG_UINT,   0)        \
     X(minus,      1, 0,0)                  \
     X(mod,        1, 0,0)                  \
@@ -102,11 +103,17 @@ OP_LIST
     OP_LAST
 } jsop_t;
 
+typedef struct {
+    BSTR name;
+    prop_cache_t cache;
+} prop_site_t;
+
 typedef union {
     BSTR bstr;
     LONG lng;
     jsstr_t *str;
     unsigned uint;
+    prop_site_t *site;
 } instr_arg_t;
 
 typedef enum {
@@ -116,6 +123,7 @@ typedef enum {
     ARG_DBL,
     ARG_FUNC,
     ARG_INT,
+    ARG_SITE,
     ARG_STR,
     ARG_UINT
 } instr_arg_type_t;
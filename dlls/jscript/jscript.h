@@ -218,6 +218,8 @@ typedef struct {
     unsigned (*idx_length)(jsdisp_t*);
     HRESULT (*idx_get)(jsdisp_t*,unsigned,jsval_t*);
     HRESULT (*idx_put)(jsdisp_t*,unsigned,jsval_t);
+    HRESULT (*idx_add)(jsdisp_t*,unsigned);
+    HRESULT (*idx_delete)(jsdisp_t*,unsigned);
 } builtin_info_t;
 
 struct jsdisp_t {
@@ -235,6 +237,16 @@ struct jsdisp_t {
     const builtin_info_t *builtin_info;
 };
 
+/*
+ * Per call site cache of the last resolved property slot. Property slots are never
+ * reused for a different name, so a slot is valid for any object that has a live
+ * property of the same name stored in it.
+ */
+typedef struct {
+    DISPID id;
+    unsigned hash;
+} prop_cache_t;
+
 static inline IDispatch *to_disp(jsdisp_t *jsdisp)
 {
     return (IDispatch*)&jsdisp->IDispatchEx_iface;
@@ -291,9 +303,11 @@ HRESULT jsdisp_propput_idx(jsdisp_t*,DWORD,jsval_t) DECLSPEC_HIDDEN;
 HRESULT jsdisp_propget_name(jsdisp_t*,LPCWSTR,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_idx(jsdisp_t*,DWORD,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*) DECLSPEC_HIDDEN;
+HRESULT jsdisp_get_id_cached(jsdisp_t*,const WCHAR*,DWORD,prop_cache_t*,DISPID*) DECLSPEC_HIDDEN;
 HRESULT disp_delete(IDispatch*,DISPID,BOOL*) DECLSPEC_HIDDEN;
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_delete_idx(jsdisp_t*,DWORD) DECLSPEC_HIDDEN;
+HRESULT jsdisp_idx_to_props(jsdisp_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_is_own_prop(jsdisp_t*,const WCHAR*,BOOL*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_is_enumerable(jsdisp_t*,const WCHAR*,BOOL*) DECLSPEC_HIDDEN;
 
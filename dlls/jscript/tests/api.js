@@ -1056,6 +1056,74 @@ ok(tmp === (invokeVersion < 2 ? undefined : 3), "unshift returned " +tmp);
 ok(arr.length === 3, "arr.length = " + arr.length);
 ok(arr.toString() === "1,2,3", "arr.toString() = " + arr.toString());
 
+arr = [];
+for(i = 0; i < 100; i++)
+    arr[i] = i;
+ok(arr.length === 100, "arr.length = " + arr.length);
+arr.push(100, 101);
+ok(arr.length === 102, "arr.length = " + arr.length);
+ok(arr[101] === 101, "arr[101] = " + arr[101]);
+tmp = arr.pop();
+ok(tmp === 101, "arr.pop() = " + tmp);
+ok(!(101 in arr), "101 in arr");
+ok(arr.hasOwnProperty(100), "arr.hasOwnProperty(100) is false");
+arr.push(tmp);
+ok(arr[101] === 101, "arr[101] = " + arr[101]);
+tmp = arr.shift();
+ok(tmp === 0 && arr[0] === 1 && arr.length === 101, "arr.shift() = " + tmp + " arr[0] = " + arr[0]);
+arr.unshift(tmp);
+ok(arr[0] === 0 && arr[1] === 1 && arr.length === 102, "arr[0] = " + arr[0] + " arr[1] = " + arr[1]);
+tmp = 0;
+for(i in arr)
+    tmp++;
+ok(tmp === 102, "enumerated " + tmp + " elements");
+ok(arr.slice(10, 13).toString() === "10,11,12", "arr.slice(10, 13) = " + arr.slice(10, 13));
+delete arr[50];
+ok(!(50 in arr), "50 in arr after delete");
+ok(arr[49] === 49 && arr[51] === 51, "arr[49] = " + arr[49] + " arr[51] = " + arr[51]);
+ok(arr.length === 102, "arr.length = " + arr.length);
+arr[50] = 50;
+ok(arr[50] === 50, "arr[50] = " + arr[50]);
+arr.length = 3;
+ok(arr.toString() === "0,1,2", "arr = " + arr);
+ok(!(3 in arr), "3 in arr after truncation");
+
+arr = [1,2,3];
+arr[5] = 6;
+ok(arr.length === 6, "arr.length = " + arr.length);
+ok(arr.toString() === "1,2,3,,,6", "arr = " + arr);
+ok(!(3 in arr), "3 in arr");
+arr = [1,2,3];
+arr.length = 5;
+arr[3] = 4;
+ok(arr.toString() === "1,2,3,4,", "arr = " + arr);
+arr = [3,1,2];
+arr.sort();
+ok(arr.toString() === "1,2,3", "sorted arr = " + arr);
+Array.prototype[3] = "proto";
+arr = [1,2,3];
+ok(arr[3] === "proto", "arr[3] = " + arr[3]);
+arr.length = 5;
+ok(arr.join() === "1,2,3,proto,", "arr.join() = " + arr.join());
+arr = [1,2,3];
+ok(arr[3] === "proto", "arr[3] = " + arr[3]);
+arr[3] = 4;
+ok(arr.hasOwnProperty(3), "arr.hasOwnProperty(3) is false");
+ok(arr.join() === "1,2,3,4", "arr.join() = " + arr.join());
+delete Array.prototype[3];
+
+arr = [1,2,3];
+arr[1] += 10;
+arr[2]++;
+arr[3] = 4;
+for(arr[4] in {x: 1});
+ok(arr.toString() === "1,12,4,4,x", "arr = " + arr);
+arr["6"] = 7;
+ok(arr.length === 7, "arr.length = " + arr.length);
+ok(!(5 in arr), "5 in arr");
+arr[5] = 6;
+ok(arr.toString() === "1,12,4,4,x,6,7", "arr = " + arr);
+
 arr = new Object();
 arr.length = 2;
 arr[0] = 1;
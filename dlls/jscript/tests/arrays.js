@@ -0,0 +1,50 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* Array heavy benchmark: building, indexing, push/pop, slice, sort and join. */
+
+function fill(n) {
+    var arr = [], i;
+
+    for(i = 0; i < n; i++)
+        arr[i] = (i * 7919) % n;
+    return arr;
+}
+
+function sum(arr) {
+    var s = 0, i;
+
+    for(i = 0; i < arr.length; i++)
+        s += arr[i];
+    return s;
+}
+
+function stack(n) {
+    var arr = [], s = 0, i;
+
+    for(i = 0; i < n; i++)
+        arr.push(i);
+    while(arr.length)
+        s += arr.pop();
+    return s;
+}
+
+var arr = fill(20000), i;
+
+for(i = 0; i < 10; i++)
+    sum(arr);
+stack(50000);
+arr.slice(100, 10000).sort(function(a, b) { return a - b; }).join(",");
@@ -1451,6 +1451,52 @@ tmp.testWith = true;
 with(tmp)
     ok(testWith === true, "testWith !== true");
 
+function getCachedProps(o) {
+    return o.cachedA + "," + o.cachedB;
+}
+
+(function() {
+    var o1 = {cachedA: 1, cachedB: 2}, o2 = {cachedB: 3, cachedA: 4}, proto = {cachedA: 5, cachedB: 6};
+    var r, i;
+
+    function Ctor() {}
+    Ctor.prototype = proto;
+
+    for(i = 0; i < 3; i++) {
+        r = getCachedProps(o1);
+        ok(r === "1,2", "getCachedProps(o1) = " + r);
+        r = getCachedProps(o2);
+        ok(r === "4,3", "getCachedProps(o2) = " + r);
+    }
+
+    delete o1.cachedA;
+    r = getCachedProps(o1);
+    ok(r === "undefined,2", "getCachedProps(o1) after delete = " + r);
+    o1.cachedA = 7;
+    r = getCachedProps(o1);
+    ok(r === "7,2", "getCachedProps(o1) after readding = " + r);
+
+    o2 = new Ctor();
+    r = getCachedProps(o2);
+    ok(r === "5,6", "getCachedProps(new Ctor()) = " + r);
+    proto.cachedA = 8;
+    r = getCachedProps(o2);
+    ok(r === "8,6", "getCachedProps(new Ctor()) after prototype change = " + r);
+    o2.cachedA = 9;
+    r = getCachedProps(o2);
+    ok(r === "9,6", "getCachedProps(new Ctor()) after own prop = " + r);
+    delete o2.cachedA;
+    r = getCachedProps(o2);
+    ok(r === "8,6", "getCachedProps(new Ctor()) after delete = " + r);
+
+    for(i = 0; i < 3; i++) {
+        r = "test".length;
+        ok(r === 4, "\"test\".length = " + r);
+        o1.cachedB++;
+    }
+    ok(o1.cachedB === 5, "o1.cachedB = " + o1.cachedB);
+})();
+
 if(false) {
     var varTest1 = true;
 }
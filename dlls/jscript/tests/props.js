@@ -0,0 +1,46 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* Property access heavy benchmark: member reads, method calls and global lookups. */
+
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+
+Point.prototype.add = function(p) {
+    return new Point(this.x + p.x, this.y + p.y);
+};
+
+Point.prototype.lengthSq = function() {
+    return this.x * this.x + this.y * this.y;
+};
+
+var counter = 0;
+
+function walk(n) {
+    var p = new Point(0, 0), step = new Point(1, 2), obj = {a: 1, b: 2, c: 3}, sum = 0, i;
+
+    for(i = 0; i < n; i++) {
+        p = p.add(step);
+        sum += obj.a + obj.b + obj.c + p.lengthSq() % 7;
+        counter++;
+    }
+
+    return sum;
+}
+
+walk(100000);
@@ -2894,6 +2894,8 @@ static void run_benchmarks(void)
     run_benchmark("dna.js");
     run_benchmark("base64.js");
     run_benchmark("validateinput.js");
+    run_benchmark("props.js");
+    run_benchmark("arrays.js");
 }
 
 static BOOL check_jscript(void)
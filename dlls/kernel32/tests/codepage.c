@@ -1290,6 +1290,54 @@ static void test_dbcs_to_widechar(void)
     }
 }
 
+static void test_ascii_runs(void)
+{
+    static const struct
+    {
+        UINT cp;
+        const char *tail;
+        int tail_len;
+        WCHAR tailW[2];
+    } tests[] =
+    {
+        { 1252,    "\xe9\x80",             2, {0x00e9, 0x20ac} },
+        { CP_UTF8, "\xc3\xa9\xe2\x82\xac", 5, {0x00e9, 0x20ac} },
+    };
+    char src[160], dst[160];
+    WCHAR srcW[160], dstW[160];
+    int i, j, ret, off, len, tail_len;
+    UINT cp;
+
+    /* 7-bit ASCII runs of any length and alignment followed by non-ASCII chars */
+    for (i = 0; i < sizeof(tests)/sizeof(tests[0]); i++)
+    {
+        cp = tests[i].cp;
+        tail_len = tests[i].tail_len;
+
+        for (off = 0; off < 16; off++)
+        {
+            for (len = 0; len <= 130; len++)
+            {
+                for (j = 0; j < len; j++) src[off + j] = srcW[off + j] = (j * 7 + 1) % 0x80;
+                memcpy(src + off + len, tests[i].tail, tail_len);
+                memcpy(srcW + off + len, tests[i].tailW, sizeof(tests[i].tailW));
+
+                memset(dstW, 0xcc, sizeof(dstW));
+                ret = MultiByteToWideChar(cp, 0, src + off, len + tail_len, dstW + off, len + 2);
+                ok(ret == len + 2 && !memcmp(dstW + off, srcW + off, (len + 2) * sizeof(WCHAR)) &&
+                   dstW[off + len + 2] == 0xcccc,
+                   "%u: offset %d length %d: MultiByteToWideChar returned %d\n", cp, off, len, ret);
+
+                memset(dst, 0xcc, sizeof(dst));
+                ret = WideCharToMultiByte(cp, 0, srcW + off, len + 2, dst + off, len + tail_len, NULL, NULL);
+                ok(ret == len + tail_len && !memcmp(dst + off, src + off, len + tail_len) &&
+                   (BYTE)dst[off + len + tail_len] == 0xcc,
+                   "%u: offset %d length %d: WideCharToMultiByte returned %d\n", cp, off, len, ret);
+            }
+        }
+    }
+}
+
 START_TEST(codepage)
 {
     BOOL bUsedDefaultChar;
@@ -1312,4 +1360,5 @@ START_TEST(codepage)
     test_threadcp();
 
     test_dbcs_to_widechar();
+    test_ascii_runs();
 }
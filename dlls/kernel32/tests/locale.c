@@ -2199,6 +2199,68 @@ static void test_CompareStringEx(void)
 
 }
 
+/* strings sharing a prefix, so that the first difference is at a lower weight level */
+struct comparestring_prefix_test {
+    DWORD flags;
+    const WCHAR first[8];
+    const WCHAR second[8];
+    INT ret;
+    BOOL todo;
+    BOOL todo_key;
+};
+
+static const struct comparestring_prefix_test comparestring_prefix_tests[] = {
+    /* hyphen and apostrophe */
+    { 0,                   {'a','b','c','-','d',0},     {'a','b','c','d',0},         CSTR_GREATER_THAN, FALSE, TRUE  },
+    { SORT_STRINGSORT,     {'a','b','c','-','d',0},     {'a','b','c','d',0},         CSTR_LESS_THAN,    FALSE, FALSE },
+    { 0,                   {'a','b','c','\'','d',0},    {'a','b','c','d',0},         CSTR_GREATER_THAN, FALSE, TRUE  },
+    { SORT_STRINGSORT,     {'a','b','c','\'','d',0},    {'a','b','c','d',0},         CSTR_LESS_THAN,    FALSE, FALSE },
+    { 0,                   {'a','b','c','-','e',0},     {'a','b','c','d',0},         CSTR_GREATER_THAN, FALSE, TRUE  },
+    { 0,                   {'a','b','c','d',0},         {'a','b','c','-','e',0},     CSTR_LESS_THAN,    FALSE, TRUE  },
+    /* case */
+    { 0,                   {'a','b','c','d','E',0},     {'a','b','c','d','e',0},     CSTR_GREATER_THAN, FALSE, FALSE },
+    { 0,                   {'a','b','c','d','E','x',0}, {'a','b','c','d','e','y',0}, CSTR_LESS_THAN,    FALSE, FALSE },
+    { NORM_IGNORECASE,     {'a','b','c','d','E','x',0}, {'a','b','c','d','e','x',0}, CSTR_EQUAL,        FALSE, FALSE },
+    /* diacritics */
+    { 0,                   {'a','b','c',0xe9,0},        {'a','b','c','e',0},         CSTR_GREATER_THAN, TRUE,  FALSE },
+    { NORM_IGNORENONSPACE, {'a','b','c',0xe9,0},        {'a','b','c','e',0},         CSTR_EQUAL,        FALSE, FALSE },
+    { 0,                   {'a','b','c',0xe9,'x',0},    {'a','b','c','e','y',0},     CSTR_LESS_THAN,    FALSE, FALSE },
+    /* diacritic differences take precedence over case differences */
+    { 0,                   {'a','b','c','E','x',0},     {'a','b','c',0xe9,'x',0},    CSTR_LESS_THAN,    TRUE,  TRUE  },
+    { NORM_IGNORECASE,     {'a','b','c',0xc9,'x',0},    {'a','b','c',0xe9,'X',0},    CSTR_EQUAL,        FALSE, FALSE },
+    { 0,                   {'a','b','c',0xc9,'x',0},    {'a','b','c',0xe9,'X',0},    CSTR_GREATER_THAN, FALSE, FALSE },
+};
+
+static void test_CompareString_prefix(void)
+{
+    const char *op[] = {"ERROR", "CSTR_LESS_THAN", "CSTR_EQUAL", "CSTR_GREATER_THAN"};
+    char key1[64], key2[64];
+    INT ret, cmp, i;
+
+    for (i = 0; i < sizeof(comparestring_prefix_tests)/sizeof(comparestring_prefix_tests[0]); i++)
+    {
+        const struct comparestring_prefix_test *e = &comparestring_prefix_tests[i];
+
+        ret = CompareStringW(LOCALE_SYSTEM_DEFAULT, e->flags, e->first, -1, e->second, -1);
+        todo_wine_if (e->todo)
+            ok(ret == e->ret, "%d: got %s, expected %s\n", i, op[ret], op[e->ret]);
+
+        /* sort keys ignoring nonspacing characters differ on Vista */
+        if (e->flags & NORM_IGNORENONSPACE) continue;
+
+        ret = LCMapStringW(LOCALE_SYSTEM_DEFAULT, LCMAP_SORTKEY | e->flags, e->first, -1,
+                           (WCHAR *)key1, sizeof(key1));
+        ok(ret, "%d: LCMapStringW failed with %u\n", i, GetLastError());
+        ret = LCMapStringW(LOCALE_SYSTEM_DEFAULT, LCMAP_SORTKEY | e->flags, e->second, -1,
+                           (WCHAR *)key2, sizeof(key2));
+        ok(ret, "%d: LCMapStringW failed with %u\n", i, GetLastError());
+        cmp = strcmp(key1, key2);
+        ret = cmp < 0 ? CSTR_LESS_THAN : cmp > 0 ? CSTR_GREATER_THAN : CSTR_EQUAL;
+        todo_wine_if (e->todo_key)
+            ok(ret == e->ret, "%d: sort keys compare %s, expected %s\n", i, op[ret], op[e->ret]);
+    }
+}
+
 static const DWORD lcmap_invalid_flags[] = {
     0,
     LCMAP_HIRAGANA | LCMAP_KATAKANA,
@@ -5333,6 +5395,7 @@ START_TEST(locale)
   test_CompareStringA();
   test_CompareStringW();
   test_CompareStringEx();
+  test_CompareString_prefix();
   test_LCMapStringA();
   test_LCMapStringW();
   test_LCMapStringEx();
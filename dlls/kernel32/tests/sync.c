@@ -2648,6 +2648,109 @@ static void test_apc_deadlock(void)
     CloseHandle(pi.hProcess);
 }
 
+struct ping_pong_info
+{
+    HANDLE ping;
+    HANDLE pong;
+    BOOL semaphore;
+    int count;
+};
+
+static void ping_pong_signal(HANDLE handle, BOOL semaphore)
+{
+    BOOL ret;
+
+    if (semaphore) ret = ReleaseSemaphore(handle, 1, NULL);
+    else ret = SetEvent(handle);
+    ok(ret, "failed to signal %p, error %u\n", handle, GetLastError());
+}
+
+static DWORD WINAPI ping_pong_thread(void *arg)
+{
+    struct ping_pong_info *info = arg;
+    DWORD result;
+    int i;
+
+    for (i = 0; i < info->count; i++)
+    {
+        result = WaitForSingleObject(info->ping, 5000);
+        ok(result == WAIT_OBJECT_0, "%d: expected WAIT_OBJECT_0, got %u\n", i, result);
+        if (result != WAIT_OBJECT_0) break;
+        ping_pong_signal(info->pong, info->semaphore);
+    }
+    return 0;
+}
+
+static void test_ping_pong(BOOL semaphore)
+{
+    struct ping_pong_info info;
+    LARGE_INTEGER freq, start, end;
+    HANDLE thread, handles[2];
+    DWORD result;
+    int i;
+
+    if (semaphore)
+    {
+        info.ping = CreateSemaphoreA(NULL, 0, 1, NULL);
+        info.pong = CreateSemaphoreA(NULL, 0, 1, NULL);
+    }
+    else
+    {
+        info.ping = CreateEventA(NULL, FALSE, FALSE, NULL);
+        info.pong = CreateEventA(NULL, FALSE, FALSE, NULL);
+    }
+    ok(info.ping && info.pong, "failed to create objects, error %u\n", GetLastError());
+    info.semaphore = semaphore;
+    info.count = winetest_interactive ? 100000 : 1000;
+
+    thread = CreateThread(NULL, 0, ping_pong_thread, &info, 0, NULL);
+    ok(thread != NULL, "CreateThread failed with %u\n", GetLastError());
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+    for (i = 0; i < info.count; i++)
+    {
+        ping_pong_signal(info.ping, semaphore);
+        result = WaitForSingleObject(info.pong, 5000);
+        ok(result == WAIT_OBJECT_0, "%d: expected WAIT_OBJECT_0, got %u\n", i, result);
+        if (result != WAIT_OBJECT_0) break;
+    }
+    QueryPerformanceCounter(&end);
+    trace("%s ping-pong: %d round trips, %.2f us each\n", semaphore ? "semaphore" : "event",
+          i, i ? (end.QuadPart - start.QuadPart) * 1000000.0 / freq.QuadPart / i : 0.0);
+
+    result = WaitForSingleObject(thread, 5000);
+    ok(result == WAIT_OBJECT_0, "expected WAIT_OBJECT_0, got %u\n", result);
+    CloseHandle(thread);
+
+    /* both objects are unsignaled again, and waits mixing them with other objects still work */
+    handles[0] = info.ping;
+    handles[1] = info.pong;
+    result = WaitForMultipleObjects(2, handles, FALSE, 0);
+    ok(result == WAIT_TIMEOUT, "expected WAIT_TIMEOUT, got %u\n", result);
+    ping_pong_signal(info.pong, semaphore);
+    result = WaitForMultipleObjects(2, handles, TRUE, 0);
+    ok(result == WAIT_TIMEOUT, "expected WAIT_TIMEOUT, got %u\n", result);
+    result = WaitForMultipleObjects(2, handles, FALSE, 0);
+    ok(result == WAIT_OBJECT_0 + 1, "expected WAIT_OBJECT_0 + 1, got %u\n", result);
+    ping_pong_signal(info.ping, semaphore);
+    ping_pong_signal(info.pong, semaphore);
+    result = WaitForMultipleObjects(2, handles, TRUE, 0);
+    ok(result == WAIT_OBJECT_0, "expected WAIT_OBJECT_0, got %u\n", result);
+    result = WaitForMultipleObjects(2, handles, FALSE, 0);
+    ok(result == WAIT_TIMEOUT, "expected WAIT_TIMEOUT, got %u\n", result);
+
+    handles[1] = GetCurrentThread();
+    ping_pong_signal(info.ping, semaphore);
+    result = WaitForMultipleObjects(2, handles, FALSE, 0);
+    ok(result == WAIT_OBJECT_0, "expected WAIT_OBJECT_0, got %u\n", result);
+    result = WaitForSingleObject(info.ping, 0);
+    ok(result == WAIT_TIMEOUT, "expected WAIT_TIMEOUT, got %u\n", result);
+
+    CloseHandle(info.ping);
+    CloseHandle(info.pong);
+}
+
 START_TEST(sync)
 {
     char **argv;
@@ -2715,4 +2818,6 @@ START_TEST(sync)
     test_srwlock_example();
     test_alertable_wait();
     test_apc_deadlock();
+    test_ping_pong(FALSE);
+    test_ping_pong(TRUE);
 }
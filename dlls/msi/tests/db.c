@@ -3993,6 +3993,57 @@ static void test_join(void)
     MsiViewClose(hview);
     MsiCloseHandle(hview);
 
+    query = "CREATE TABLE `Six` (`I` SHORT, `J` SHORT PRIMARY KEY `I`)";
+    r = run_query( hdb, 0, query);
+    ok(r == ERROR_SUCCESS, "cannot create table: %d\n", r );
+
+    for (i = 1; i <= 4; i++)
+    {
+        sprintf( buf, "INSERT INTO `Six` (`I`, `J`) VALUES (%u, %u)", i, i == 1 ? 3 : (i == 4 ? 7 : 5) );
+        r = run_query( hdb, 0, buf);
+        ok(r == ERROR_SUCCESS, "cannot insert into table: %d\n", r );
+    }
+
+    /* numeric equality join, with and without an additional constant condition */
+    query = "SELECT `I`, `D` FROM `Six`, `Two` WHERE `Six`.`J` = `Two`.`C` ORDER BY `I`";
+    r = MsiDatabaseOpenViewA(hdb, query, &hview);
+    ok( r == ERROR_SUCCESS, "failed to open view: %d\n", r );
+
+    r = MsiViewExecute(hview, 0);
+    ok( r == ERROR_SUCCESS, "failed to execute view: %d\n", r );
+
+    i = 0;
+    while ((r = MsiViewFetch(hview, &hrec)) == ERROR_SUCCESS)
+    {
+        ok( MsiRecordGetInteger(hrec, 1) == i + 1, "row %d: got I %d\n", i, MsiRecordGetInteger(hrec, 1) );
+        ok( MsiRecordGetInteger(hrec, 2) == (i ? 6 : 4), "row %d: got D %d\n", i, MsiRecordGetInteger(hrec, 2) );
+        i++;
+        MsiCloseHandle(hrec);
+    }
+    ok( i == 3, "Expected 3 rows, got %d\n", i );
+    ok( r == ERROR_NO_MORE_ITEMS, "expected no more items: %d\n", r );
+
+    MsiViewClose(hview);
+    MsiCloseHandle(hview);
+
+    query = "SELECT `I` FROM `Six`, `Two` WHERE `Two`.`C` = `Six`.`J` AND `D` = 6 AND `I` <> 3";
+    r = MsiDatabaseOpenViewA(hdb, query, &hview);
+    ok( r == ERROR_SUCCESS, "failed to open view: %d\n", r );
+
+    r = MsiViewExecute(hview, 0);
+    ok( r == ERROR_SUCCESS, "failed to execute view: %d\n", r );
+
+    r = MsiViewFetch(hview, &hrec);
+    ok( r == ERROR_SUCCESS, "failed to fetch view: %d\n", r );
+    ok( MsiRecordGetInteger(hrec, 1) == 2, "got I %d\n", MsiRecordGetInteger(hrec, 1) );
+    MsiCloseHandle(hrec);
+
+    r = MsiViewFetch(hview, &hrec);
+    ok( r == ERROR_NO_MORE_ITEMS, "expected no more items: %d\n", r );
+
+    MsiViewClose(hview);
+    MsiCloseHandle(hview);
+
     query = "SELECT * FROM `Nonexistent`, `One`";
     r = MsiDatabaseOpenViewA(hdb, query, &hview);
     ok( r == ERROR_BAD_QUERY_SYNTAX,
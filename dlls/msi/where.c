@@ -54,6 +54,18 @@ typedef struct tagJOINTABLE
     UINT table_index;
 } JOINTABLE;
 
+/* hash index over the rows of a joined table, used for equality conditions */
+typedef struct tagJOININDEX
+{
+    const struct expr *column; /* indexed column of the table */
+    const struct expr *value;  /* value to look up, evaluated with the preceding tables bound */
+    BOOL is_string;
+    UINT bucket_count;
+    UINT *buckets;             /* first row of each bucket */
+    UINT *next;                /* next row in the same bucket */
+    UINT *keys;                /* key of each row */
+} JOININDEX;
+
 typedef struct tagMSIORDERINFO
 {
     UINT col_count;
@@ -599,15 +611,236 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+static UINT hash_string( const WCHAR *str )
+{
+    UINT hash = 0;
+
+    /* NULL and empty strings compare equal */
+    if (str)
+        while (*str) hash = hash * 31 + *str++;
+    return hash;
+}
+
+static UINT join_index_key( MSIWHEREVIEW *wv, const JOININDEX *index, const struct expr *expr,
+                            const UINT rows[], UINT *key )
+{
+    const WCHAR *str;
+    INT val;
+    UINT r;
+
+    if (index->is_string)
+    {
+        r = STRING_evaluate( wv, rows, expr, NULL, &str );
+        if (r == ERROR_SUCCESS)
+            *key = hash_string( str );
+        return r;
+    }
+
+    r = WHERE_evaluate( wv, rows, (struct expr *)expr, &val, NULL );
+    if (r == ERROR_SUCCESS)
+        *key = val;
+    return r;
+}
+
+static inline BOOL is_int_operand( const struct expr *expr )
+{
+    return expr->type == EXPR_COL_NUMBER || expr->type == EXPR_COL_NUMBER32 || expr->type == EXPR_UVAL;
+}
+
+static inline BOOL is_string_operand( const struct expr *expr )
+{
+    return expr->type == EXPR_COL_NUMBER_STRING || expr->type == EXPR_SVAL;
+}
+
+static inline BOOL is_column( const struct expr *expr )
+{
+    return expr->type == EXPR_COL_NUMBER || expr->type == EXPR_COL_NUMBER32 ||
+           expr->type == EXPR_COL_NUMBER_STRING;
+}
+
+/* checks if value can be evaluated once the tables preceding table in the join order are known */
+static BOOL is_bound_value( const struct expr *value, JOINTABLE **ordered_tables, JOINTABLE *table )
+{
+    if (!is_column( value ))
+        return TRUE;
+
+    while (*ordered_tables != table)
+    {
+        if (*ordered_tables == value->u.column.parsed.table)
+            return TRUE;
+        ordered_tables++;
+    }
+    return FALSE;
+}
+
+/* looks for an equality comparison of a table column to a bound value, which all result rows have to satisfy */
+static BOOL find_join_key( const struct expr *cond, JOINTABLE **ordered_tables, JOINTABLE *table,
+                           JOININDEX *index )
+{
+    const struct expr *left, *right;
+    UINT i;
+
+    if (cond->type == EXPR_COMPLEX && cond->u.expr.op == OP_AND)
+        return find_join_key( cond->u.expr.left, ordered_tables, table, index ) ||
+               find_join_key( cond->u.expr.right, ordered_tables, table, index );
+
+    if ((cond->type != EXPR_COMPLEX && cond->type != EXPR_STRCMP) || cond->u.expr.op != OP_EQ)
+        return FALSE;
+
+    left = cond->u.expr.left;
+    right = cond->u.expr.right;
+    if (cond->type == EXPR_COMPLEX ? !is_int_operand( left ) || !is_int_operand( right )
+                                   : !is_string_operand( left ) || !is_string_operand( right ))
+        return FALSE;
+
+    for (i = 0; i < 2; i++)
+    {
+        const struct expr *column = i ? right : left, *value = i ? left : right;
+
+        if (!is_column( column ) || column->u.column.parsed.table != table)
+            continue;
+        if (!is_bound_value( value, ordered_tables, table ))
+            continue;
+
+        index->column = column;
+        index->value = value;
+        index->is_string = cond->type == EXPR_STRCMP;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void free_join_indexes( JOININDEX *indexes, UINT count )
+{
+    UINT i;
+
+    for (i = 0; i < count; i++)
+    {
+        msi_free( indexes[i].buckets );
+        msi_free( indexes[i].next );
+        msi_free( indexes[i].keys );
+    }
+    msi_free( indexes );
+}
+
+static UINT build_join_index( MSIWHEREVIEW *wv, JOINTABLE *table, JOININDEX *index, UINT rows[] )
+{
+    UINT i, r = ERROR_SUCCESS, bucket;
+
+    for (index->bucket_count = 1; index->bucket_count < table->row_count; index->bucket_count <<= 1);
+
+    index->buckets = msi_alloc( index->bucket_count * sizeof(*index->buckets) );
+    index->next = msi_alloc( table->row_count * sizeof(*index->next) );
+    index->keys = msi_alloc( table->row_count * sizeof(*index->keys) );
+    if (!index->buckets || !index->next || !index->keys)
+        return ERROR_OUTOFMEMORY;
+
+    for (i = 0; i < index->bucket_count; i++)
+        index->buckets[i] = INVALID_ROW_INDEX;
+
+    /* insert in reverse order, so that buckets are walked in row order */
+    for (i = table->row_count; i > 0; i--)
+    {
+        rows[table->table_index] = i - 1;
+        r = join_index_key( wv, index, index->column, rows, &index->keys[i - 1] );
+        if (r != ERROR_SUCCESS)
+            break;
+
+        bucket = index->keys[i - 1] & (index->bucket_count - 1);
+        index->next[i - 1] = index->buckets[bucket];
+        index->buckets[bucket] = i - 1;
+    }
+    rows[table->table_index] = INVALID_ROW_INDEX;
+    return r;
+}
+
+/* builds hash indexes for tables joined to a preceding table or compared to a constant by equality */
+static UINT build_join_indexes( MSIWHEREVIEW *wv, JOINTABLE **ordered_tables, JOININDEX **ret )
+{
+    JOININDEX *indexes;
+    UINT i, r = ERROR_SUCCESS;
+    UINT *rows;
+
+    indexes = msi_alloc_zero( wv->table_count * sizeof(*indexes) );
+    rows = msi_alloc( wv->table_count * sizeof(*rows) );
+    if (!indexes || !rows)
+    {
+        msi_free( indexes );
+        msi_free( rows );
+        return ERROR_OUTOFMEMORY;
+    }
+
+    for (i = 0; i < wv->table_count; i++)
+        rows[i] = INVALID_ROW_INDEX;
+
+    for (i = 0; wv->cond && i < wv->table_count; i++)
+    {
+        if (ordered_tables[i]->row_count < 2)
+            continue;
+        if (!find_join_key( wv->cond, ordered_tables, ordered_tables[i], &indexes[i] ))
+            continue;
+
+        TRACE("indexing table %u on column %u\n", ordered_tables[i]->table_index,
+              indexes[i].column->u.column.parsed.column);
+
+        r = build_join_index( wv, ordered_tables[i], &indexes[i], rows );
+        if (r != ERROR_SUCCESS)
+            break;
+    }
+
+    msi_free( rows );
+
+    if (r != ERROR_SUCCESS)
+    {
+        free_join_indexes( indexes, wv->table_count );
+        return r;
+    }
+
+    *ret = indexes;
+    return ERROR_SUCCESS;
+}
+
+static inline UINT next_join_row( const JOINTABLE *table, const JOININDEX *index, UINT row, UINT key )
+{
+    if (!index->buckets)
+        return row + 1 < table->row_count ? row + 1 : INVALID_ROW_INDEX;
+
+    do row = index->next[row];
+    while (row != INVALID_ROW_INDEX && index->keys[row] != key);
+    return row;
+}
+
+static inline UINT first_join_row( const JOINTABLE *table, const JOININDEX *index, UINT key )
+{
+    UINT row;
+
+    if (!index->buckets)
+        return 0;
+
+    row = index->buckets[key & (index->bucket_count - 1)];
+    if (row != INVALID_ROW_INDEX && index->keys[row] != key)
+        row = next_join_row( table, index, row, key );
+    return row;
+}
+
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
-                             UINT table_rows[] )
+                             JOININDEX *index, UINT table_rows[] )
 {
-    UINT r = ERROR_FUNCTION_FAILED;
+    UINT r = ERROR_FUNCTION_FAILED, key = 0;
     INT val;
 
-    for (table_rows[(*tables)->table_index] = 0;
-         table_rows[(*tables)->table_index] < (*tables)->row_count;
-         table_rows[(*tables)->table_index]++)
+    if (index->buckets)
+    {
+        r = join_index_key( wv, index, index->value, table_rows, &key );
+        if (r != ERROR_SUCCESS)
+            return r;
+    }
+
+    for (table_rows[(*tables)->table_index] = first_join_row( *tables, index, key );
+         table_rows[(*tables)->table_index] != INVALID_ROW_INDEX;
+         table_rows[(*tables)->table_index] = next_join_row( *tables, index,
+                                                             table_rows[(*tables)->table_index], key ))
     {
         val = 0;
         wv->rec_index = 0;
@@ -618,7 +851,7 @@ static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **ta
         {
             if (*(tables + 1))
             {
-                r = check_condition(wv, record, tables + 1, table_rows);
+                r = check_condition(wv, record, tables + 1, index + 1, table_rows);
                 if (r != ERROR_SUCCESS)
                     break;
             }
@@ -770,7 +1003,9 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
     JOINTABLE *table = wv->tables;
     UINT *rows;
     JOINTABLE **ordered_tables;
+    JOININDEX *indexes;
     UINT i = 0;
+    DWORD start = GetTickCount();
 
     TRACE("%p %p\n", wv, record);
 
@@ -800,11 +1035,18 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
 
     ordered_tables = ordertables( wv );
 
+    r = build_join_indexes( wv, ordered_tables, &indexes );
+    if (r != ERROR_SUCCESS)
+    {
+        msi_free( ordered_tables );
+        return r;
+    }
+
     rows = msi_alloc( wv->table_count * sizeof(*rows) );
     for (i = 0; i < wv->table_count; i++)
         rows[i] = INVALID_ROW_INDEX;
 
-    r =  check_condition(wv, record, ordered_tables, rows);
+    r =  check_condition(wv, record, ordered_tables, indexes, rows);
 
     if (wv->order_info)
         wv->order_info->error = ERROR_SUCCESS;
@@ -816,6 +1058,9 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
 
     msi_free( rows );
     msi_free( ordered_tables );
+    free_join_indexes( indexes, wv->table_count );
+
+    TRACE("%p: %u tables, %u rows in %u ms\n", wv, wv->table_count, wv->row_count, GetTickCount() - start);
     return r;
 }
 
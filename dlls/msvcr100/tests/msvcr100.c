@@ -146,10 +146,19 @@ typedef struct {
     char pad[64];
 } event;
 
+struct ContextVtbl;
 typedef struct {
-    void *vtable;
+    struct ContextVtbl *vtable;
 } Context;
 
+struct ContextVtbl {
+    unsigned int (__thiscall *GetId)(Context*);
+    unsigned int (__thiscall *GetVirtualProcessorId)(Context*);
+    unsigned int (__thiscall *GetScheduleGroupId)(Context*);
+    void (__thiscall *Unblock)(Context*);
+    MSVCRT_bool (__thiscall *IsSynchronouslyBlocked)(Context*);
+};
+
 typedef struct {
     void *policy_container;
 } SchedulerPolicy;
@@ -168,8 +177,8 @@ struct SchedulerVtbl {
     unsigned int (__thiscall *Release)(Scheduler*);
     void (__thiscall *RegisterShutdownEvent)(Scheduler*,HANDLE);
     void (__thiscall *Attach)(Scheduler*);
-    /* CreateScheduleGroup */
-    /* ScheduleTask */
+    void* (__thiscall *CreateScheduleGroup)(Scheduler*);
+    void (__thiscall *ScheduleTask)(Scheduler*, void (__cdecl*)(void*), void*);
 };
 
 static int* (__cdecl *p_errno)(void);
@@ -221,6 +230,7 @@ static int (__cdecl *p_event_wait_for_multiple)(event**, size_t, MSVCRT_bool, un
 
 static Context* (__cdecl *p_Context_CurrentContext)(void);
 static unsigned int (__cdecl *p_Context_Id)(void);
+static void (__cdecl *p_Context_Block)(void);
 static SchedulerPolicy* (__thiscall *p_SchedulerPolicy_ctor)(SchedulerPolicy*);
 static void (__thiscall *p_SchedulerPolicy_SetConcurrencyLimits)(SchedulerPolicy*, unsigned int, unsigned int);
 static void (__thiscall *p_SchedulerPolicy_dtor)(SchedulerPolicy*);
@@ -228,6 +238,7 @@ static Scheduler* (__cdecl *p_Scheduler_Create)(SchedulerPolicy*);
 static Scheduler* (__cdecl *p_CurrentScheduler_Get)(void);
 static void (__cdecl *p_CurrentScheduler_Detach)(void);
 static unsigned int (__cdecl *p_CurrentScheduler_Id)(void);
+static void (__cdecl *p_CurrentScheduler_ScheduleTask)(void (__cdecl*)(void*), void*);
 
 /* make sure we use the correct errno */
 #undef errno
@@ -264,6 +275,7 @@ static BOOL init(void)
     SET(p_Context_Id, "?Id@Context@Concurrency@@SAIXZ");
     SET(p_CurrentScheduler_Detach, "?Detach@CurrentScheduler@Concurrency@@SAXXZ");
     SET(p_CurrentScheduler_Id, "?Id@CurrentScheduler@Concurrency@@SAIXZ");
+    SET(p_Context_Block, "?Block@Context@Concurrency@@SAXXZ");
 
     if(sizeof(void*) == 8) { /* 64-bit initialization */
         SET(pSpinWait_ctor_yield, "??0?$_SpinWait@$00@details@Concurrency@@QEAA@P6AXXZ@Z");
@@ -306,6 +318,7 @@ static BOOL init(void)
         SET(p_SchedulerPolicy_dtor, "??1SchedulerPolicy@Concurrency@@QEAA@XZ");
         SET(p_Scheduler_Create, "?Create@Scheduler@Concurrency@@SAPEAV12@AEBVSchedulerPolicy@2@@Z");
         SET(p_CurrentScheduler_Get, "?Get@CurrentScheduler@Concurrency@@SAPEAVScheduler@2@XZ");
+        SET(p_CurrentScheduler_ScheduleTask, "?ScheduleTask@CurrentScheduler@Concurrency@@SAXP6AXPEAX@Z0@Z");
     } else {
         SET(pSpinWait_ctor_yield, "??0?$_SpinWait@$00@details@Concurrency@@QAE@P6AXXZ@Z");
         SET(pSpinWait_dtor, "??_F?$_SpinWait@$00@details@Concurrency@@QAEXXZ");
@@ -347,6 +360,7 @@ static BOOL init(void)
         SET(p_SchedulerPolicy_dtor, "??1SchedulerPolicy@Concurrency@@QAE@XZ");
         SET(p_Scheduler_Create, "?Create@Scheduler@Concurrency@@SAPAV12@ABVSchedulerPolicy@2@@Z");
         SET(p_CurrentScheduler_Get, "?Get@CurrentScheduler@Concurrency@@SAPAVScheduler@2@XZ");
+        SET(p_CurrentScheduler_ScheduleTask, "?ScheduleTask@CurrentScheduler@Concurrency@@SAXP6AXPAX@Z0@Z");
     }
 
     init_thiscall_thunk();
@@ -966,6 +980,77 @@ static void test_Scheduler(void)
     call_func1(p_SchedulerPolicy_dtor, &policy);
 }
 
+static LONG scheduled_count;
+static HANDLE scheduled_done;
+
+static void __cdecl scheduled_task(void *arg)
+{
+    volatile unsigned int i;
+
+    for (i = 0; i < 1000; i++);
+    if (InterlockedIncrement(&scheduled_count) == PtrToUlong(arg))
+        SetEvent(scheduled_done);
+}
+
+static void __cdecl unblock_task(void *arg)
+{
+    Context *ctx = arg;
+
+    Sleep(50);
+    InterlockedIncrement(&scheduled_count);
+    call_func1(ctx->vtable->Unblock, ctx);
+}
+
+static void test_ScheduleTask(void)
+{
+    const unsigned int count = 1000;
+    LARGE_INTEGER start, end, freq;
+    Scheduler *scheduler;
+    SchedulerPolicy policy;
+    unsigned int i, n, total = 0;
+    SYSTEM_INFO si;
+    Context *ctx;
+    DWORD ret;
+
+    GetSystemInfo(&si);
+    QueryPerformanceFrequency(&freq);
+    scheduled_done = CreateEventW(NULL, FALSE, FALSE, NULL);
+
+    call_func1(p_SchedulerPolicy_ctor, &policy);
+    QueryPerformanceCounter(&start);
+    for (n = 1; n <= si.dwNumberOfProcessors; n *= 2)
+    {
+        call_func3(p_SchedulerPolicy_SetConcurrencyLimits, &policy, 1, n);
+        scheduler = p_Scheduler_Create(&policy);
+        ok(scheduler != NULL, "Scheduler::Create() = NULL\n");
+
+        scheduled_count = 0;
+        for (i = 0; i < count; i++)
+            call_func3(scheduler->vtable->ScheduleTask, scheduler, scheduled_task, ULongToPtr(count));
+        ret = WaitForSingleObject(scheduled_done, 10000);
+        ok(ret == WAIT_OBJECT_0, "WaitForSingleObject returned %d\n", ret);
+        ok(scheduled_count == count, "scheduled_count = %d\n", scheduled_count);
+        total += count;
+
+        call_func1(scheduler->vtable->Release, scheduler);
+    }
+    QueryPerformanceCounter(&end);
+    trace("%.0f tasks/ms\n", total * (double)freq.QuadPart / 1000 / (end.QuadPart - start.QuadPart));
+    call_func1(p_SchedulerPolicy_dtor, &policy);
+
+    ctx = p_Context_CurrentContext();
+    scheduled_count = 0;
+    p_CurrentScheduler_ScheduleTask(unblock_task, ctx);
+    p_Context_Block();
+    ok(scheduled_count == 1, "Context::Block() returned before Unblock()\n");
+
+    /* Unblock before Block doesn't wait */
+    call_func1(ctx->vtable->Unblock, ctx);
+    p_Context_Block();
+
+    CloseHandle(scheduled_done);
+}
+
 START_TEST(msvcr100)
 {
     if (!init())
@@ -973,6 +1058,7 @@ START_TEST(msvcr100)
 
     test_ExternalContextBase();
     test_Scheduler();
+    test_ScheduleTask();
     test_wmemcpy_s();
     test_wmemmove_s();
     test_fread_s();
@@ -25,6 +25,7 @@
 #include "windef.h"
 #include "winternl.h"
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "msvcrt.h"
 #include "cppexcept.h"
 #include "cxx.h"
@@ -115,6 +116,8 @@ typedef struct {
     struct scheduler_list scheduler;
     unsigned int id;
     union allocator_cache_entry *allocator_cache[8];
+    LONG blocked;
+    struct scheduler_worker *worker;
 } ExternalContextBase;
 extern const vtable_ptr MSVCRT_ExternalContextBase_vtable;
 static void ExternalContextBase_ctor(ExternalContextBase*);
@@ -156,9 +159,40 @@ typedef struct {
     int shutdown_size;
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
+    struct scheduler_pool *pool;
 } ThreadScheduler;
 extern const vtable_ptr MSVCRT_ThreadScheduler_vtable;
 
+struct scheduled_task {
+    struct list entry;
+    ThreadScheduler *scheduler;
+    void (__cdecl *proc)(void*);
+    void *data;
+};
+
+/* worker threads running the tasks of a scheduler */
+struct scheduler_pool {
+    LONG ref;
+    CRITICAL_SECTION cs;
+    CONDITION_VARIABLE cond;
+    struct list tasks;      /* tasks scheduled from outside of the pool */
+    struct list workers;
+    int worker_count;
+    int idle_count;
+    int max_workers;
+    int extra_workers;      /* blocked or oversubscribed workers */
+    unsigned int stack_size;
+    int priority;
+    BOOL shutdown;
+};
+
+struct scheduler_worker {
+    struct list entry;
+    struct scheduler_pool *pool;
+    CRITICAL_SECTION cs;
+    struct list tasks;      /* the worker runs the newest task, others steal the oldest */
+};
+
 typedef struct {
     Scheduler *scheduler;
 } _Scheduler;
@@ -168,6 +202,8 @@ typedef struct {
 } _CurrentScheduler;
 
 static int context_tls_index = TLS_OUT_OF_INDEXES;
+static HMODULE msvcrt_module;
+static HANDLE keyed_event;
 
 static CRITICAL_SECTION default_scheduler_cs;
 static CRITICAL_SECTION_DEBUG default_scheduler_cs_debug =
@@ -256,22 +292,55 @@ unsigned int __cdecl Context_Id(void)
     return ctx ? call_Context_GetId(ctx) : -1;
 }
 
+static void scheduler_pool_oversubscribe(struct scheduler_pool*, MSVCRT_bool);
+
+static HANDLE get_keyed_event(void)
+{
+    if (!keyed_event) {
+        HANDLE event;
+
+        NtCreateKeyedEvent(&event, GENERIC_READ|GENERIC_WRITE, NULL, 0);
+        if (InterlockedCompareExchangePointer(&keyed_event, event, NULL) != NULL)
+            NtClose(event);
+    }
+    return keyed_event;
+}
+
 /* ?Block@Context@Concurrency@@SAXXZ */
 void __cdecl Context_Block(void)
 {
-    FIXME("()\n");
+    ExternalContextBase *context = (ExternalContextBase*)get_current_context();
+
+    TRACE("()\n");
+
+    if (context->context.vtable != &MSVCRT_ExternalContextBase_vtable) {
+        ERR("unknown context set\n");
+        return;
+    }
+
+    if (InterlockedDecrement(&context->blocked) >= 0)
+        return;
+
+    /* let another worker run the pending tasks while this one is blocked */
+    if (context->worker)
+        scheduler_pool_oversubscribe(context->worker->pool, TRUE);
+    NtWaitForKeyedEvent(get_keyed_event(), context, 0, NULL);
+    if (context->worker)
+        scheduler_pool_oversubscribe(context->worker->pool, FALSE);
 }
 
 /* ?Yield@Context@Concurrency@@SAXXZ */
 void __cdecl Context_Yield(void)
 {
-    FIXME("()\n");
+    TRACE("()\n");
+    SwitchToThread();
 }
 
 /* ?_SpinYield@Context@Concurrency@@SAXXZ */
 void __cdecl Context__SpinYield(void)
 {
-    FIXME("()\n");
+    TRACE("()\n");
+    SwitchToThread();
 }
 
 /* ?IsCurrentTaskCollectionCanceling@Context@Concurrency@@SA_NXZ */
@@ -284,7 +353,18 @@ MSVCRT_bool __cdecl Context_IsCurrentTaskCollectionCanceling(void)
 /* ?Oversubscribe@Context@Concurrency@@SAX_N@Z */
 void __cdecl Context_Oversubscribe(MSVCRT_bool begin)
 {
-    FIXME("(%x)\n", begin);
+    ExternalContextBase *context = (ExternalContextBase*)get_current_context();
+
+    TRACE("(%x)\n", begin);
+
+    if (context->context.vtable != &MSVCRT_ExternalContextBase_vtable) {
+        ERR("unknown context set\n");
+        return;
+    }
+
+    /* only the concurrency of worker contexts is limited */
+    if (context->worker)
+        scheduler_pool_oversubscribe(context->worker->pool, begin);
 }
 
 /* ?ScheduleGroupId@Context@Concurrency@@SAIXZ */
@@ -327,14 +407,17 @@ unsigned int __thiscall ExternalContextBase_GetScheduleGroupId(const ExternalCon
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Unblock, 4)
 void __thiscall ExternalContextBase_Unblock(ExternalContextBase *this)
 {
-    FIXME("(%p)->() stub\n", this);
+    TRACE("(%p)->()\n", this);
+
+    if (!InterlockedIncrement(&this->blocked))
+        NtReleaseKeyedEvent(get_keyed_event(), this, 0, NULL);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_IsSynchronouslyBlocked, 4)
 MSVCRT_bool __thiscall ExternalContextBase_IsSynchronouslyBlocked(const ExternalContextBase *this)
 {
-    FIXME("(%p)->() stub\n", this);
-    return FALSE;
+    TRACE("(%p)->()\n", this);
+    return this->blocked < 0;
 }
 
 static void ExternalContextBase_dtor(ExternalContextBase *this)
@@ -623,6 +706,262 @@ void __thiscall SchedulerPolicy_dtor(SchedulerPolicy *this)
     MSVCRT_operator_delete(this->policy_container);
 }
 
+static void scheduler_pool_release(struct scheduler_pool *pool)
+{
+    if (InterlockedDecrement(&pool->ref))
+        return;
+
+    pool->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&pool->cs);
+    MSVCRT_operator_delete(pool);
+}
+
+static struct scheduled_task* scheduler_worker_get_task(struct scheduler_worker *worker)
+{
+    struct scheduler_pool *pool = worker->pool;
+    struct scheduler_worker *victim;
+    struct list *entry;
+    BOOL idle = FALSE;
+
+    EnterCriticalSection(&worker->cs);
+    if ((entry = list_tail(&worker->tasks)))
+        list_remove(entry);
+    LeaveCriticalSection(&worker->cs);
+    if (entry)
+        return LIST_ENTRY(entry, struct scheduled_task, entry);
+
+    EnterCriticalSection(&pool->cs);
+    for (;;) {
+        if ((entry = list_head(&pool->tasks))) {
+            list_remove(entry);
+            break;
+        }
+
+        LIST_FOR_EACH_ENTRY(victim, &pool->workers, struct scheduler_worker, entry) {
+            if (victim == worker) continue;
+            EnterCriticalSection(&victim->cs);
+            if ((entry = list_head(&victim->tasks)))
+                list_remove(entry);
+            LeaveCriticalSection(&victim->cs);
+            if (entry) break;
+        }
+        if (entry || pool->shutdown)
+            break;
+
+        /* workers push without the pool lock, look again once marked as idle */
+        if (!idle) {
+            pool->idle_count++;
+            idle = TRUE;
+            continue;
+        }
+        SleepConditionVariableCS(&pool->cond, &pool->cs, INFINITE);
+    }
+    if (idle)
+        pool->idle_count--;
+    LeaveCriticalSection(&pool->cs);
+
+    return entry ? LIST_ENTRY(entry, struct scheduled_task, entry) : NULL;
+}
+
+static DWORD WINAPI scheduler_worker_proc(void *arg)
+{
+    struct scheduler_worker *worker = arg;
+    struct scheduler_pool *pool = worker->pool;
+    struct scheduled_task *task;
+    struct scheduler_list saved;
+    ExternalContextBase *context;
+    ThreadScheduler *scheduler;
+    void (__cdecl *proc)(void*);
+    void *data;
+
+    TRACE("starting worker %p\n", worker);
+
+    context = (ExternalContextBase*)get_current_context();
+    saved = context->scheduler;
+    context->scheduler.next = NULL;
+    context->worker = worker;
+
+    while ((task = scheduler_worker_get_task(worker))) {
+        scheduler = task->scheduler;
+        proc = task->proc;
+        data = task->data;
+        Concurrency_Free(task);
+
+        context->scheduler.scheduler = &scheduler->scheduler;
+        proc(data);
+        call_Scheduler_Release(&scheduler->scheduler);
+    }
+
+    context->scheduler = saved;
+    context->worker = NULL;
+
+    EnterCriticalSection(&pool->cs);
+    list_remove(&worker->entry);
+    pool->worker_count--;
+    LeaveCriticalSection(&pool->cs);
+
+    TRACE("terminating worker %p\n", worker);
+
+    worker->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&worker->cs);
+    MSVCRT_free(worker);
+    scheduler_pool_release(pool);
+    FreeLibraryAndExitThread(msvcrt_module, 0);
+    return 0;
+}
+
+/* called with the pool lock held */
+static BOOL scheduler_pool_add_worker(struct scheduler_pool *pool)
+{
+    struct scheduler_worker *worker;
+    HMODULE module;
+    HANDLE thread;
+
+    if (!(worker = MSVCRT_malloc(sizeof(*worker))))
+        return FALSE;
+    worker->pool = pool;
+    list_init(&worker->tasks);
+    InitializeCriticalSection(&worker->cs);
+    worker->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": scheduler_worker");
+
+    thread = CreateThread(NULL, pool->stack_size, scheduler_worker_proc, worker,
+            CREATE_SUSPENDED | (pool->stack_size ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0), NULL);
+    if (!thread) {
+        worker->cs.DebugInfo->Spare[0] = 0;
+        DeleteCriticalSection(&worker->cs);
+        MSVCRT_free(worker);
+        return FALSE;
+    }
+
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+            (const WCHAR *)msvcrt_module, &module);
+    InterlockedIncrement(&pool->ref);
+    list_add_tail(&pool->workers, &worker->entry);
+    pool->worker_count++;
+
+    if (pool->priority != INHERIT_THREAD_PRIORITY)
+        SetThreadPriority(thread, pool->priority);
+    ResumeThread(thread);
+    CloseHandle(thread);
+    return TRUE;
+}
+
+/* called with the pool lock held */
+static BOOL scheduler_pool_has_tasks(struct scheduler_pool *pool)
+{
+    struct scheduler_worker *worker;
+    BOOL ret = !list_empty(&pool->tasks);
+
+    LIST_FOR_EACH_ENTRY(worker, &pool->workers, struct scheduler_worker, entry) {
+        if (ret) break;
+        EnterCriticalSection(&worker->cs);
+        ret = !list_empty(&worker->tasks);
+        LeaveCriticalSection(&worker->cs);
+    }
+    return ret;
+}
+
+/* wake up an idle worker or start a new one, called with the pool lock held */
+static void scheduler_pool_signal(struct scheduler_pool *pool)
+{
+    if (pool->idle_count)
+        WakeConditionVariable(&pool->cond);
+    else if (pool->worker_count < pool->max_workers + pool->extra_workers)
+        scheduler_pool_add_worker(pool);
+}
+
+static void scheduler_pool_oversubscribe(struct scheduler_pool *pool, MSVCRT_bool begin)
+{
+    EnterCriticalSection(&pool->cs);
+    if (begin) {
+        pool->extra_workers++;
+        if (scheduler_pool_has_tasks(pool))
+            scheduler_pool_signal(pool);
+    }else if (pool->extra_workers) {
+        pool->extra_workers--;
+    }
+    LeaveCriticalSection(&pool->cs);
+}
+
+static struct scheduler_pool* ThreadScheduler_get_pool(ThreadScheduler *this)
+{
+    struct scheduler_pool *pool;
+    unsigned int factor;
+
+    if ((pool = this->pool))
+        return pool;
+
+    pool = MSVCRT_operator_new(sizeof(*pool));
+    pool->ref = 1;
+    InitializeCriticalSection(&pool->cs);
+    pool->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": scheduler_pool");
+    InitializeConditionVariable(&pool->cond);
+    list_init(&pool->tasks);
+    list_init(&pool->workers);
+    pool->worker_count = 0;
+    pool->idle_count = 0;
+    factor = SchedulerPolicy_GetPolicyValue(&this->policy, TargetOversubscriptionFactor);
+    pool->max_workers = this->virt_proc_no * max(factor, 1);
+    pool->extra_workers = 0;
+    pool->stack_size = SchedulerPolicy_GetPolicyValue(&this->policy, ContextStackSize) * 1024;
+    pool->priority = SchedulerPolicy_GetPolicyValue(&this->policy, ContextPriority);
+    pool->shutdown = FALSE;
+
+    /* the interlocked publication orders the initialization before the pointer */
+    if (InterlockedCompareExchangePointer((void **)&this->pool, pool, NULL))
+        scheduler_pool_release(pool);
+    return this->pool;
+}
+
+static void ThreadScheduler_schedule(ThreadScheduler *this, void (__cdecl *proc)(void*), void *data)
+{
+    struct scheduler_pool *pool = ThreadScheduler_get_pool(this);
+    ExternalContextBase *context = (ExternalContextBase*)try_get_current_context();
+    struct scheduler_worker *worker = NULL;
+    struct scheduled_task *task;
+    BOOL ret;
+
+    task = Concurrency_Alloc(sizeof(*task));
+    task->scheduler = this;
+    task->proc = proc;
+    task->data = data;
+    call_Scheduler_Reference(&this->scheduler);
+
+    if (context && context->context.vtable == &MSVCRT_ExternalContextBase_vtable &&
+            context->worker && context->worker->pool == pool)
+        worker = context->worker;
+
+    if (worker) {
+        EnterCriticalSection(&worker->cs);
+        list_add_tail(&worker->tasks, &task->entry);
+        LeaveCriticalSection(&worker->cs);
+
+        /* the pushing worker runs the task itself if nobody else can */
+        if (pool->idle_count || pool->worker_count < pool->max_workers + pool->extra_workers) {
+            EnterCriticalSection(&pool->cs);
+            scheduler_pool_signal(pool);
+            LeaveCriticalSection(&pool->cs);
+        }
+        return;
+    }
+
+    EnterCriticalSection(&pool->cs);
+    list_add_tail(&pool->tasks, &task->entry);
+    scheduler_pool_signal(pool);
+    ret = pool->worker_count != 0;
+    if (!ret)
+        list_remove(&task->entry);
+    LeaveCriticalSection(&pool->cs);
+
+    if (!ret) {
+        DWORD err = GetLastError();
+
+        Concurrency_Free(task);
+        call_Scheduler_Release(&this->scheduler);
+        throw_exception(EXCEPTION_SCHEDULER_RESOURCE_ALLOCATION_ERROR, HRESULT_FROM_WIN32(err), NULL);
+    }
+}
+
 static void ThreadScheduler_dtor(ThreadScheduler *this)
 {
     int i;
@@ -630,6 +969,14 @@ static void ThreadScheduler_dtor(ThreadScheduler *this)
     if(this->ref != 0) WARN("ref = %d\n", this->ref);
     SchedulerPolicy_dtor(&this->policy);
 
+    if(this->pool) {
+        EnterCriticalSection(&this->pool->cs);
+        this->pool->shutdown = TRUE;
+        WakeAllConditionVariable(&this->pool->cond);
+        LeaveCriticalSection(&this->pool->cs);
+        scheduler_pool_release(this->pool);
+    }
+
     for(i=0; i<this->shutdown_count; i++)
         SetEvent(this->shutdown_events[i]);
     MSVCRT_operator_delete(this->shutdown_events);
@@ -746,14 +1093,16 @@ DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
 void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
 {
-    FIXME("(%p %p %p %p) stub\n", this, proc, data, placement);
+    FIXME("(%p %p %p %p) placement ignored\n", this, proc, data, placement);
+    ThreadScheduler_schedule(this, proc, data);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask, 12)
 void __thiscall ThreadScheduler_ScheduleTask(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data)
 {
-    FIXME("(%p %p %p) stub\n", this, proc, data);
+    TRACE("(%p %p %p)\n", this, proc, data);
+    ThreadScheduler_schedule(this, proc, data);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_IsAvailableLocation, 8)
@@ -803,6 +1152,7 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
 
     this->shutdown_count = this->shutdown_size = 0;
     this->shutdown_events = NULL;
+    this->pool = NULL;
 
     InitializeCriticalSection(&this->cs);
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
@@ -1128,6 +1478,7 @@ void __asm_dummy_vtables(void) {
 
 void msvcrt_init_scheduler(void *base)
 {
+    msvcrt_module = base;
 #ifdef __x86_64__
     init_Context_rtti(base);
     init_ContextBase_rtti(base);
@@ -1142,6 +1493,8 @@ void msvcrt_free_scheduler(void)
 {
     if (context_tls_index != TLS_OUT_OF_INDEXES)
         TlsFree(context_tls_index);
+    if (keyed_event)
+        NtClose(keyed_event);
     if(default_scheduler_policy.policy_container)
         SchedulerPolicy_dtor(&default_scheduler_policy);
     if(default_scheduler) {
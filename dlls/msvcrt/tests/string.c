@@ -3216,6 +3216,92 @@ static void test__ismbclx(void)
     _setmbcp(cp);
 }
 
+static void test_wcs_primitives(void)
+{
+    static const WCHAR upperW[] = {'C',':','\\','W','I','N','D','O','W','S','\\','S','Y','S','T','E','M','3','2',0};
+    static const WCHAR lowerW[] = {'c',':','\\','w','i','n','d','o','w','s','\\','s','y','s','t','e','m','3','2',0};
+    LARGE_INTEGER start, end, freq;
+    unsigned int len, offset, i;
+    WCHAR *page, *str, *ptr, other[48];
+    DWORD old_prot;
+    int ret = 0;
+
+    /* strings ending right before an inaccessible page, at every alignment */
+    page = VirtualAlloc(NULL, 0x2000, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    ok(page != NULL, "VirtualAlloc failed\n");
+    if (!page) return;
+    VirtualProtect((char *)page + 0x1000, 0x1000, PAGE_NOACCESS, &old_prot);
+    for (offset = 0; offset < 8; offset++)
+    {
+        for (len = 0; len < 40; len++)
+        {
+            str = (WCHAR *)((char *)page + 0x1000) - len - 1 - offset;
+            for (i = 0; i < len; i++) str[i] = 'a' + i % 5;
+            for (i = len; i <= len + offset; i++) str[i] = 0;
+
+            ok(wcslen(str) == len, "offset %u: wcslen returned %u, expected %u\n", offset, (int)wcslen(str), len);
+            ptr = wcschr(str, 'e');
+            ok(ptr == (len > 4 ? str + 4 : NULL), "offset %u, len %u: wcschr returned %p for %p\n",
+               offset, len, ptr, str);
+            ok(wcschr(str, 'z') == NULL, "offset %u, len %u: wcschr found 'z'\n", offset, len);
+            ok(wcschr(str, 0) == str + len, "offset %u, len %u: wcschr didn't find the terminator\n", offset, len);
+            ok(!wcscmp(str, str), "offset %u, len %u: wcscmp failed\n", offset, len);
+
+            /* the same string and a longer one, with the same alignment or not */
+            ptr = other + (offset & 3);
+            memcpy(ptr, str, (len + 1) * sizeof(WCHAR));
+            ok(!wcscmp(str, ptr), "offset %u, len %u: wcscmp failed\n", offset, len);
+            ptr[len] = 'a';
+            ptr[len + 1] = 0;
+            ok(wcscmp(str, ptr) < 0, "offset %u, len %u: wcscmp failed\n", offset, len);
+            ok(wcscmp(ptr, str) > 0, "offset %u, len %u: wcscmp failed\n", offset, len);
+            if (len)
+            {
+                /* a difference in the last character */
+                memcpy(ptr, str, (len + 1) * sizeof(WCHAR));
+                ptr[len - 1] = 0xffff;
+                ok(wcscmp(str, ptr) < 0, "offset %u, len %u: wcscmp failed\n", offset, len);
+                ok(wcscmp(ptr, str) > 0, "offset %u, len %u: wcscmp failed\n", offset, len);
+            }
+        }
+    }
+    VirtualFree(page, 0, MEM_RELEASE);
+
+    ok(!_wcsicmp(upperW, lowerW), "_wcsicmp failed\n");
+    ok(wcscmp(upperW, lowerW) < 0, "wcscmp failed\n");
+
+    /* long strings */
+    str = malloc(4097 * sizeof(WCHAR));
+    ptr = malloc(4097 * sizeof(WCHAR));
+    ok(str && ptr, "malloc failed\n");
+    if (!str || !ptr)
+    {
+        free(ptr);
+        free(str);
+        return;
+    }
+    for (i = 0; i < 4096; i++) str[i] = 'A' + i % 26;
+    str[4096] = 0;
+    for (i = 0; i < 4096; i++) ptr[i] = 'a' + i % 26;
+    ptr[4096] = 0;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+    for (i = 0; i < 100; i++)
+    {
+        ret += wcslen(str + i % 4);
+        ret += wcschr(str + i % 4, '@') == NULL;
+        ret += wcscmp(str, str);
+        ret += _wcsicmp(str, ptr);
+    }
+    QueryPerformanceCounter(&end);
+    trace("wcslen, wcschr, wcscmp and _wcsicmp on 4096 chars: %.1f us (%d)\n",
+          (end.QuadPart - start.QuadPart) * 1e6 / freq.QuadPart / 100, ret);
+
+    free(ptr);
+    free(str);
+}
+
 START_TEST(string)
 {
     char mem[100];
@@ -3332,4 +3418,5 @@ START_TEST(string)
     test__wcsset_s();
     test__mbscmp();
     test__ismbclx();
+    test_wcs_primitives();
 }
@@ -25,12 +25,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
 #ifdef HAVE_UNISTD_H
 # include <unistd.h>
 #endif
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
 #include <ctype.h>
 
 #include "wine/debug.h"
+#include "wine/debug_ring.h"
 #include "wine/exception.h"
 #include "wine/library.h"
 #include "wine/unicode.h"
@@ -44,6 +49,24 @@ WINE_DECLARE_DEBUG_CHANNEL(timestamp);
 
 static struct __wine_debug_functions default_funcs;
 
+#define RING_KEYS 4096  /* size of the cache of strings recorded in a ring */
+#define RING_KEY_PROBES 4  /* cache slots where a string can be found */
+
+#define RING_FILE_SIZE (sizeof(struct debug_ring_header) + DEBUG_RING_STRINGS_SIZE + DEBUG_RING_SIZE)
+
+struct debug_ring
+{
+    struct debug_ring_header *header;
+    char                     *strings;    /* string table following the header */
+    char                     *data;       /* data area following the string table */
+    int                       busy;       /* a record is being written */
+    ULONG_PTR                 keys[RING_KEYS];  /* strings defined in the ring */
+    char                      buffer[DEBUG_RING_MAX_RECORD];  /* record being built */
+};
+
+static const char *ring_dir;              /* directory of the ring files, from WINEDEBUGRING */
+static struct debug_ring no_ring;         /* used when the ring file can't be created */
+
 /* ---------------------------------------------------------------------- */
 
 /* get the debug info pointer for the current thread */
@@ -116,16 +139,258 @@ static const char *NTDLL_dbgstr_wn( const WCHAR *src, int n )
      return res;
 }
 
+/* get the trace ring of the current thread, creating it the first time */
+static struct debug_ring *get_ring( struct debug_info *info )
+{
+    struct debug_ring_header *header;
+    struct debug_ring *ring;
+    LARGE_INTEGER now;
+    char name[MAX_PATH];
+    int fd;
+
+    if (info->ring) return info->ring->header ? info->ring : NULL;
+    if (!GetCurrentThreadId()) return NULL;  /* not connected to the server yet */
+
+    info->ring = &no_ring;
+    if (strlen( ring_dir ) > sizeof(name) - 32) return NULL;
+    sprintf( name, "%s/wine-%04x-%04x.trace", ring_dir, GetCurrentProcessId(), GetCurrentThreadId() );
+    if ((fd = open( name, O_RDWR | O_CREAT | O_TRUNC, 0666 )) == -1) return NULL;
+    if (ftruncate( fd, RING_FILE_SIZE ) == -1 ||
+        (header = mmap( NULL, RING_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) == MAP_FAILED)
+    {
+        close( fd );
+        return NULL;
+    }
+    close( fd );
+    if ((ring = wine_anon_mmap( NULL, sizeof(*ring), PROT_READ | PROT_WRITE, 0 )) == MAP_FAILED)
+    {
+        munmap( header, RING_FILE_SIZE );
+        return NULL;
+    }
+
+    NtQuerySystemTime( &now );
+    header->pid           = GetCurrentProcessId();
+    header->tid           = GetCurrentThreadId();
+    header->size          = DEBUG_RING_SIZE;
+    header->strings_size  = DEBUG_RING_STRINGS_SIZE;
+    header->long_size     = sizeof(long);
+    header->ptr_size      = sizeof(void *);
+    header->start_time    = now.QuadPart;
+    RtlQueryUnbiasedInterruptTime( &header->start_counter );
+    header->frequency     = 10000000;
+    header->version       = DEBUG_RING_VERSION;
+    header->magic         = DEBUG_RING_MAGIC;
+    ring->header  = header;
+    ring->strings = (char *)(header + 1);
+    ring->data    = ring->strings + DEBUG_RING_STRINGS_SIZE;
+    return info->ring = ring;
+}
+
+/* find the cache slot of a string key, or a free slot for it if create is set */
+static ULONG_PTR *ring_find_key( struct debug_ring *ring, ULONG_PTR key, BOOL create )
+{
+    unsigned int i, hash = (key ^ (key >> 12)) % RING_KEYS;
+    ULONG_PTR *slot, *free = NULL;
+
+    for (i = 0; i < RING_KEY_PROBES; i++)
+    {
+        slot = &ring->keys[(hash + i) % RING_KEYS];
+        if (*slot == key) return slot;
+        if (!*slot && !free) free = slot;
+    }
+    if (!create) return NULL;
+    return free ? free : &ring->keys[hash];
+}
+
+/* drop the oldest record of the ring */
+static void ring_drop_tail( struct debug_ring *ring )
+{
+    struct debug_ring_header *header = ring->header;
+    const struct debug_ring_record *rec;
+    ULONG_PTR *slot;
+
+    if (header->tail + sizeof(*rec) > header->size)  /* no room for a padding record */
+    {
+        header->used -= header->size - header->tail;
+        header->tail = 0;
+        return;
+    }
+    rec = (const struct debug_ring_record *)(ring->data + header->tail);
+    /* strings only go to the ring once the table is full; events recorded
+     * from now on can't rely on the dropped one */
+    if (rec->type == DEBUG_RING_STRING && (slot = ring_find_key( ring, rec->key, FALSE ))) *slot = 0;
+    if (rec->type != DEBUG_RING_PAD) header->dropped++;
+    header->used -= rec->size;
+    header->tail += rec->size;
+    if (header->tail == header->size) header->tail = 0;
+}
+
+/* append the record built in ring->buffer, overwriting the oldest ones if needed */
+static void ring_write( struct debug_ring *ring, unsigned int size )
+{
+    struct debug_ring_header *header = ring->header;
+    struct debug_ring_record *pad;
+
+    for (;;)
+    {
+        if (!header->used)
+        {
+            header->head = header->tail = 0;
+            break;
+        }
+        if (header->tail < header->head)
+        {
+            if (header->head + size <= header->size) break;
+            /* wrap around, padding the end of the data area */
+            if (header->head + sizeof(*pad) <= header->size)
+            {
+                pad = (struct debug_ring_record *)(ring->data + header->head);
+                pad->size = header->size - header->head;
+                pad->type = DEBUG_RING_PAD;
+                pad->cls  = 0;
+                pad->len  = 0;
+                pad->key  = 0;
+            }
+            header->used += header->size - header->head;
+            header->head = 0;
+            continue;
+        }
+        if (header->head + size <= header->tail) break;
+        ring_drop_tail( ring );
+    }
+    memcpy( ring->data + header->head, ring->buffer, size );
+    header->used += size;
+    header->head += size;
+    if (header->head == header->size) header->head = 0;
+}
+
+/* make sure the ring defines the string identified by its pointer */
+static void ring_add_string( struct debug_ring *ring, const char *str )
+{
+    struct debug_ring_header *header = ring->header;
+    struct debug_ring_record *rec = (struct debug_ring_record *)ring->buffer;
+    ULONG_PTR *slot, key = (ULONG_PTR)str;
+    unsigned int len;
+
+    if (!str || *(slot = ring_find_key( ring, key, TRUE )) == key) return;
+
+    len = strlen( str );
+    if (len > sizeof(ring->buffer) - sizeof(*rec)) len = sizeof(ring->buffer) - sizeof(*rec);
+    rec->size = (sizeof(*rec) + len + 7) & ~7;
+    rec->type = DEBUG_RING_STRING;
+    rec->cls  = 0;
+    rec->len  = len;
+    rec->key  = key;
+    memcpy( rec + 1, str, len );
+    /* the table is never overwritten, so that older events can still be decoded */
+    if (header->strings_used + rec->size <= header->strings_size)
+    {
+        memcpy( ring->strings + header->strings_used, rec, rec->size );
+        header->strings_used += rec->size;
+    }
+    else ring_write( ring, rec->size );
+    *slot = key;
+}
+
+/* record a debug message with its raw arguments; the format is only parsed to find them */
+static int ring_log( struct debug_ring *ring, unsigned char cls, const char *channel,
+                     const char *function, const char *format, va_list args )
+{
+    struct debug_ring_event *event = (struct debug_ring_event *)ring->buffer;
+    char *pos = (char *)(event + 1), *end = ring->buffer + sizeof(ring->buffer);
+    const char *str, *fmt = format;
+    enum debug_ring_arg type;
+    unsigned int stars;
+    int precision;
+    ULONGLONG value;
+    size_t len;
+    double d;
+
+    if (ring->busy) return 0;  /* called from a signal handler */
+    ring->busy = 1;
+
+    ring_add_string( ring, format );
+    ring_add_string( ring, channel );
+    ring_add_string( ring, function );
+
+    while (fmt && *fmt)
+    {
+        debug_ring_parse_format( fmt, &fmt, &stars, &precision, &type );
+        if (type == DEBUG_RING_ARG_NONE) break;
+        if (pos + (stars + 1) * sizeof(value) > end) break;
+        while (stars--)
+        {
+            value = (LONGLONG)va_arg( args, int );
+            memcpy( pos, &value, sizeof(value) );
+            pos += sizeof(value);
+            /* the precision is the last star, a negative one is ignored like in printf */
+            if (!stars && precision == DEBUG_RING_STAR_PRECISION) precision = max( (int)value, -1 );
+        }
+        switch (type)
+        {
+        case DEBUG_RING_ARG_INT:    value = (LONGLONG)va_arg( args, int ); break;
+        case DEBUG_RING_ARG_UINT:   value = va_arg( args, unsigned int ); break;
+        case DEBUG_RING_ARG_LONG:   value = (LONGLONG)va_arg( args, long ); break;
+        case DEBUG_RING_ARG_ULONG:  value = va_arg( args, unsigned long ); break;
+        case DEBUG_RING_ARG_INT64:
+        case DEBUG_RING_ARG_UINT64: value = va_arg( args, ULONGLONG ); break;
+        case DEBUG_RING_ARG_SIZE:   value = va_arg( args, size_t ); break;
+        case DEBUG_RING_ARG_PTR:    value = (ULONG_PTR)va_arg( args, void * ); break;
+        case DEBUG_RING_ARG_DOUBLE:
+            d = va_arg( args, double );
+            memcpy( &value, &d, sizeof(value) );
+            break;
+        case DEBUG_RING_ARG_STRING:
+            str = va_arg( args, const char * );
+            if (!str) len = DEBUG_RING_NULL_STRING;
+            else if (precision < 0) len = strlen( str );
+            else len = strnlen( str, precision );
+            if (str && len > DEBUG_RING_MAX_STRING) len = DEBUG_RING_MAX_STRING;
+            if (pos + sizeof(WORD) + (str ? len : 0) > end) goto done;
+            *pos++ = len;
+            *pos++ = len >> 8;
+            if (str)
+            {
+                memcpy( pos, str, len );
+                pos += len;
+            }
+            continue;
+        default:
+            break;
+        }
+        memcpy( pos, &value, sizeof(value) );
+        pos += sizeof(value);
+    }
+
+done:
+    event->hdr.size = (pos - ring->buffer + 7) & ~7;
+    event->hdr.type = DEBUG_RING_EVENT;
+    event->hdr.cls  = cls;
+    event->hdr.len  = pos - (char *)(event + 1);
+    event->hdr.key  = (ULONG_PTR)format;
+    RtlQueryUnbiasedInterruptTime( &event->time );
+    event->channel  = (ULONG_PTR)channel;
+    event->function = (ULONG_PTR)function;
+    ring_write( ring, event->hdr.size );
+
+    ring->busy = 0;
+    return event->hdr.len;
+}
+
 /***********************************************************************
  *		NTDLL_dbg_vprintf
  */
 static int NTDLL_dbg_vprintf( const char *format, va_list args )
 {
     struct debug_info *info = get_info();
-    int end;
+    struct debug_ring *ring;
+    int ret, end;
+
+    if (ring_dir && (ring = get_ring( info )))
+        return ring_log( ring, DEBUG_RING_NO_CLASS, NULL, NULL, format, args );
 
-    int ret = vsnprintf( info->out_pos, sizeof(info->output) - (info->out_pos - info->output),
-                         format, args );
+    ret = vsnprintf( info->out_pos, sizeof(info->output) - (info->out_pos - info->output),
+                     format, args );
 
     /* make sure we didn't exceed the buffer length
      * the two checks are due to glibc changes in vsnprintfs return value
@@ -161,8 +426,12 @@ static int NTDLL_dbg_vlog( enum __wine_debug_class cls, struct __wine_debug_chan
 {
     static const char * const classes[] = { "fixme", "err", "warn", "trace" };
     struct debug_info *info = get_info();
+    struct debug_ring *ring;
     int ret = 0;
 
+    if (ring_dir && (ring = get_ring( info )))
+        return ring_log( ring, cls, channel->name, function, format, args );
+
     /* only print header if we are at the beginning of the line */
     if (info->out_pos == info->output || info->out_pos[-1] == '\n')
     {
@@ -199,5 +468,24 @@ static const struct __wine_debug_functions funcs =
  */
 void debug_init(void)
 {
+    const char *dir = getenv( "WINEDEBUGRING" );
+
+    if (dir && *dir) ring_dir = dir;
     __wine_dbg_set_functions( &funcs, &default_funcs, sizeof(funcs) );
 }
+
+/***********************************************************************
+ *		debug_exit_thread
+ *
+ * Release the trace ring of the exiting thread; its file is kept.
+ */
+void debug_exit_thread(void)
+{
+    struct debug_info *info = get_info();
+    struct debug_ring *ring = info->ring;
+
+    if (!ring || ring == &no_ring) return;
+    info->ring = &no_ring;
+    munmap( ring->header, RING_FILE_SIZE );
+    munmap( ring, sizeof(*ring) );
+}
@@ -0,0 +1,466 @@
+/*
+ * In-process waits on eventfd-backed synchronization objects
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "config.h"
+#include "wine/port.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_POLL_H
+# include <sys/poll.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+#include <stdarg.h>
+#include <string.h>
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winternl.h"
+#include "wine/library.h"
+#include "wine/server.h"
+#include "wine/debug.h"
+#include "ntdll_misc.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(esync);
+
+/* When the server is started with WINEESYNC=1, events, semaphores and mutexes
+ * are backed by an eventfd whose counter holds the object state.  Non-alertable
+ * waits on such objects, as well as signaling and resetting them, are then
+ * performed directly on the eventfds without any server round trip.  Everything
+ * else, including waits that involve other objects, still goes through the
+ * server, which polls the eventfds of objects its own threads are waiting on.
+ *
+ * Objects are only ever acquired with a single read() of the eventfd, which is
+ * atomic; semaphores use EFD_SEMAPHORE so that a read takes one unit of the count.
+ * The semaphore count and maximum, and the mutex owner and recursion count, are
+ * kept in a memory area shared with the server.  The semaphore count is raised
+ * before writing to the eventfd and lowered after reading from it, so that the
+ * limit check never lets the eventfd counter go above the maximum.  The mutex
+ * state is only modified by the owner, or by the thread that just took the
+ * unowned mutex by reading its eventfd.
+ *
+ * PulseEvent signals the eventfd and resets it after yielding, so that threads
+ * blocked in poll() get a chance to see it, which is not guaranteed. */
+
+union esync_cache_entry
+{
+    LONG64 data;
+    struct
+    {
+        int            fd;       /* eventfd + 1, 0 if the object isn't backed by an eventfd */
+        unsigned short shm_idx;  /* index of the shared state, 0 if none */
+        unsigned char  type;     /* enum esync_type */
+        unsigned char  flags;    /* ESYNC_ACCESS_* and ESYNC_CACHE_VALID flags */
+    } s;
+};
+
+C_ASSERT( sizeof(union esync_cache_entry) == sizeof(LONG64) );
+C_ASSERT( ESYNC_SHM_ENTRIES <= 65536 );
+
+#define ESYNC_ACCESS_WAIT    0x01  /* handle has SYNCHRONIZE access */
+#define ESYNC_ACCESS_MODIFY  0x02  /* handle has EVENT/SEMAPHORE_MODIFY_STATE access */
+#define ESYNC_CACHE_VALID    0x80  /* entry has been filled */
+
+#define ESYNC_CACHE_BLOCK_SIZE  (65536 / sizeof(union esync_cache_entry))
+#define ESYNC_CACHE_ENTRIES     128
+
+static union esync_cache_entry *esync_cache[ESYNC_CACHE_ENTRIES];
+static struct esync_shm *esync_shm;
+static BOOL esync_disabled;
+
+struct esync_object
+{
+    int                fd;
+    enum esync_type    type;
+    unsigned int       access;
+    struct esync_shm  *shm;
+};
+
+static inline unsigned int handle_to_index( HANDLE handle, unsigned int *entry )
+{
+    unsigned int idx = (wine_server_obj_handle(handle) >> 2) - 1;
+    *entry = idx / ESYNC_CACHE_BLOCK_SIZE;
+    return idx % ESYNC_CACHE_BLOCK_SIZE;
+}
+
+static union esync_cache_entry *get_cache_block( unsigned int entry )
+{
+    void *ptr;
+
+    if (esync_cache[entry]) return esync_cache[entry];
+
+    ptr = wine_anon_mmap( NULL, ESYNC_CACHE_BLOCK_SIZE * sizeof(union esync_cache_entry),
+                          PROT_READ | PROT_WRITE, 0 );
+    if (ptr == MAP_FAILED) return NULL;
+    if (interlocked_cmpxchg_ptr( (void **)&esync_cache[entry], ptr, NULL ))
+        munmap( ptr, ESYNC_CACHE_BLOCK_SIZE * sizeof(union esync_cache_entry) );
+    return esync_cache[entry];
+}
+
+/* map the shared state of semaphores and mutexes, created by the server in its directory */
+static struct esync_shm *get_esync_shm( unsigned int idx )
+{
+    static const char name[] = "/" ESYNC_SHM_NAME;
+    size_t size = ESYNC_SHM_ENTRIES * sizeof(struct esync_shm);
+    const char *dir;
+    char *path;
+    void *ptr;
+    int fd;
+
+    if (esync_shm) return esync_shm + idx;
+
+    if (!(dir = wine_get_server_dir())) return NULL;
+    if (!(path = RtlAllocateHeap( GetProcessHeap(), 0, strlen(dir) + sizeof(name) ))) return NULL;
+    strcpy( path, dir );
+    strcat( path, name );
+    fd = open( path, O_RDWR );
+    RtlFreeHeap( GetProcessHeap(), 0, path );
+    if (fd == -1)
+    {
+        ERR( "cannot open shared memory: %d\n", errno );
+        return NULL;
+    }
+    ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if (ptr == MAP_FAILED) return NULL;
+    if (interlocked_cmpxchg_ptr( (void **)&esync_shm, ptr, NULL )) munmap( ptr, size );
+    return esync_shm + idx;
+}
+
+/***********************************************************************
+ *           get_esync_object
+ *
+ * Retrieve the eventfd of an object, asking the server the first time.
+ */
+static BOOL get_esync_object( HANDLE handle, struct esync_object *obj )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union esync_cache_entry *block, cache;
+    enum esync_type type;
+    unsigned int access, shm_idx;
+    NTSTATUS ret;
+    int fd;
+
+    if (esync_disabled || entry >= ESYNC_CACHE_ENTRIES) return FALSE;
+    if (!(block = get_cache_block( entry ))) return FALSE;
+
+    cache.data = interlocked_cmpxchg64( &block[idx].data, 0, 0 );
+    if (!(cache.s.flags & ESYNC_CACHE_VALID))
+    {
+        ret = server_get_esync_fd( handle, &fd, &type, &access, &shm_idx );
+        if (ret == STATUS_NOT_IMPLEMENTED)
+        {
+            esync_disabled = TRUE;
+            return FALSE;
+        }
+        if (ret) return FALSE;  /* let the server report the error */
+
+        cache.s.fd      = fd + 1;
+        cache.s.shm_idx = shm_idx;
+        cache.s.type    = type;
+        cache.s.flags   = ESYNC_CACHE_VALID;
+        if (access & SYNCHRONIZE) cache.s.flags |= ESYNC_ACCESS_WAIT;
+        if ((type == ESYNC_SEMAPHORE && (access & SEMAPHORE_MODIFY_STATE)) ||
+            ((type == ESYNC_AUTO_EVENT || type == ESYNC_MANUAL_EVENT) && (access & EVENT_MODIFY_STATE)))
+            cache.s.flags |= ESYNC_ACCESS_MODIFY;
+
+        if (interlocked_cmpxchg64( &block[idx].data, cache.data, 0 ))
+        {
+            /* another thread was faster */
+            if (fd != -1) close( fd );
+            cache.data = interlocked_cmpxchg64( &block[idx].data, 0, 0 );
+        }
+        TRACE( "%p -> fd %d type %u shm %u flags %x\n", handle, cache.s.fd - 1, cache.s.type,
+               cache.s.shm_idx, cache.s.flags );
+    }
+
+    if (!cache.s.fd) return FALSE;
+    obj->fd     = cache.s.fd - 1;
+    obj->type   = cache.s.type;
+    obj->access = cache.s.flags;
+    obj->shm    = NULL;
+    if (cache.s.shm_idx && !(obj->shm = get_esync_shm( cache.s.shm_idx ))) return FALSE;
+    return TRUE;
+}
+
+/***********************************************************************
+ *           esync_close
+ *
+ * Forget the eventfd of a handle that is being closed.
+ */
+void esync_close( HANDLE handle )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union esync_cache_entry cache;
+
+    if (entry >= ESYNC_CACHE_ENTRIES || !esync_cache[entry]) return;
+    do cache.data = esync_cache[entry][idx].data;
+    while (interlocked_cmpxchg64( &esync_cache[entry][idx].data, 0, cache.data ) != cache.data);
+    if (cache.s.fd) close( cache.s.fd - 1 );
+}
+
+static inline BOOL esync_signaled( int fd )
+{
+    struct pollfd pfd;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll( &pfd, 1, 0 ) == 1 && (pfd.revents & POLLIN);
+}
+
+static inline BOOL esync_read( int fd, ULONGLONG *value )
+{
+    return read( fd, value, sizeof(*value) ) == sizeof(*value);
+}
+
+static inline void esync_write( int fd, ULONGLONG value )
+{
+    if (write( fd, &value, sizeof(value) ) != sizeof(value))
+        ERR( "failed to signal fd %d: %d\n", fd, errno );
+}
+
+/* try to acquire an object, without blocking */
+static BOOL esync_grab( const struct esync_object *obj, BOOL *abandoned )
+{
+    DWORD tid = GetCurrentThreadId();
+    ULONGLONG value;
+
+    switch (obj->type)
+    {
+    case ESYNC_MANUAL_EVENT:
+        return esync_signaled( obj->fd );
+    case ESYNC_AUTO_EVENT:
+        return esync_read( obj->fd, &value );
+    case ESYNC_SEMAPHORE:
+        if (!esync_read( obj->fd, &value )) return FALSE;
+        interlocked_xchg_add( &obj->shm->count, -1 );
+        return TRUE;
+    case ESYNC_MUTEX:
+        if (obj->shm->value == tid)
+        {
+            obj->shm->count++;
+            return TRUE;
+        }
+        if (!esync_read( obj->fd, &value )) return FALSE;
+        *abandoned = (obj->shm->value == ESYNC_MUTEX_ABANDONED);
+        obj->shm->value = tid;
+        obj->shm->count = 1;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/* give back an event acquired by esync_grab */
+static void esync_release( const struct esync_object *obj )
+{
+    if (obj->type == ESYNC_AUTO_EVENT) esync_write( obj->fd, 1 );
+}
+
+/***********************************************************************
+ *           esync_wait_objects
+ *
+ * Wait on objects without going through the server. Returns
+ * STATUS_NOT_IMPLEMENTED if the wait has to be done by the server.
+ */
+NTSTATUS esync_wait_objects( DWORD count, const HANDLE *handles, BOOLEAN wait_any,
+                             const LARGE_INTEGER *timeout )
+{
+    struct esync_object objs[MAXIMUM_WAIT_OBJECTS];
+    struct pollfd fds[MAXIMUM_WAIT_OBJECTS];
+    LARGE_INTEGER now, end;
+    LONGLONG remaining;
+    BOOL abandoned;
+    DWORD i, j;
+    int ms;
+
+    if (esync_disabled) return STATUS_NOT_IMPLEMENTED;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!get_esync_object( handles[i], &objs[i] )) return STATUS_NOT_IMPLEMENTED;
+        if (!(objs[i].access & ESYNC_ACCESS_WAIT)) return STATUS_NOT_IMPLEMENTED;
+        if (wait_any) continue;
+        /* semaphores and mutexes can't be given back atomically, let the server grab them */
+        if (objs[i].type == ESYNC_SEMAPHORE || objs[i].type == ESYNC_MUTEX)
+            return STATUS_NOT_IMPLEMENTED;
+        /* let the server deal with duplicate handles in wait-all */
+        for (j = 0; j < i; j++) if (handles[j] == handles[i]) return STATUS_NOT_IMPLEMENTED;
+    }
+
+    if (timeout && timeout->QuadPart == TIMEOUT_INFINITE) timeout = NULL;
+    if (timeout)
+    {
+        NtQuerySystemTime( &now );
+        if (timeout->QuadPart <= 0) end.QuadPart = now.QuadPart - timeout->QuadPart;
+        else end.QuadPart = timeout->QuadPart;
+    }
+
+    for (;;)
+    {
+        if (wait_any)
+        {
+            for (i = 0; i < count; i++)
+            {
+                abandoned = FALSE;
+                if (esync_grab( &objs[i], &abandoned ))
+                    return (abandoned ? STATUS_ABANDONED_WAIT_0 : STATUS_WAIT_0) + i;
+            }
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+                if (!esync_grab( &objs[i], &abandoned )) break;
+            if (i == count) return STATUS_WAIT_0;
+            while (i--) esync_release( &objs[i] );
+        }
+
+        if (timeout)
+        {
+            NtQuerySystemTime( &now );
+            remaining = end.QuadPart - now.QuadPart;
+            if (remaining <= 0) return STATUS_TIMEOUT;
+            ms = min( (remaining + 9999) / 10000, INT_MAX );
+        }
+        else ms = -1;
+
+        for (i = 0; i < count; i++)
+        {
+            fds[i].fd = objs[i].fd;
+            fds[i].events = POLLIN;
+        }
+
+        /* system APCs interrupt the poll with SIGUSR1, they are handled by the signal handler */
+        if (poll( fds, count, ms ) == -1 && errno != EINTR)
+        {
+            ERR( "poll failed: %d\n", errno );
+            return STATUS_NOT_IMPLEMENTED;
+        }
+    }
+}
+
+static BOOL get_esync_event( HANDLE handle, struct esync_object *obj )
+{
+    if (!get_esync_object( handle, obj )) return FALSE;
+    if (obj->type != ESYNC_AUTO_EVENT && obj->type != ESYNC_MANUAL_EVENT) return FALSE;
+    return (obj->access & ESYNC_ACCESS_MODIFY) != 0;
+}
+
+/***********************************************************************
+ *           esync_set_event
+ */
+NTSTATUS esync_set_event( HANDLE handle, LONG *prev_state )
+{
+    struct esync_object obj;
+
+    if (!get_esync_event( handle, &obj )) return STATUS_NOT_IMPLEMENTED;
+
+    /* any non-zero value means signaled, waiters reset it with a single read */
+    if (prev_state) *prev_state = esync_signaled( obj.fd );
+    esync_write( obj.fd, 1 );
+    return STATUS_SUCCESS;
+}
+
+/***********************************************************************
+ *           esync_reset_event
+ */
+NTSTATUS esync_reset_event( HANDLE handle, LONG *prev_state )
+{
+    struct esync_object obj;
+    ULONGLONG value;
+    BOOL signaled;
+
+    if (!get_esync_event( handle, &obj )) return STATUS_NOT_IMPLEMENTED;
+
+    signaled = esync_read( obj.fd, &value );
+    if (prev_state) *prev_state = signaled;
+    return STATUS_SUCCESS;
+}
+
+/***********************************************************************
+ *           esync_pulse_event
+ */
+NTSTATUS esync_pulse_event( HANDLE handle )
+{
+    struct esync_object obj;
+    ULONGLONG value;
+
+    if (!get_esync_event( handle, &obj )) return STATUS_NOT_IMPLEMENTED;
+
+    /* waiters can still miss the pulse, there is no way to reset the eventfd
+     * only once all of them have been woken up */
+    esync_write( obj.fd, 1 );
+    NtYieldExecution();
+    esync_read( obj.fd, &value );
+    return STATUS_SUCCESS;
+}
+
+/***********************************************************************
+ *           esync_release_semaphore
+ */
+NTSTATUS esync_release_semaphore( HANDLE handle, ULONG count, ULONG *prev )
+{
+    struct esync_object obj;
+    ULONG current;
+
+    if (!get_esync_object( handle, &obj )) return STATUS_NOT_IMPLEMENTED;
+    if (obj.type != ESYNC_SEMAPHORE || !(obj.access & ESYNC_ACCESS_MODIFY))
+        return STATUS_NOT_IMPLEMENTED;
+
+    do
+    {
+        current = obj.shm->count;
+        if (current + count < current || current + count > obj.shm->value)
+            return STATUS_SEMAPHORE_LIMIT_EXCEEDED;
+    } while (interlocked_cmpxchg( &obj.shm->count, current + count, current ) != current);
+
+    if (prev) *prev = current;
+    if (count) esync_write( obj.fd, count );
+    return STATUS_SUCCESS;
+}
+
+/***********************************************************************
+ *           esync_release_mutex
+ */
+NTSTATUS esync_release_mutex( HANDLE handle, LONG *prev_count )
+{
+    struct esync_object obj;
+
+    if (!get_esync_object( handle, &obj ) || obj.type != ESYNC_MUTEX) return STATUS_NOT_IMPLEMENTED;
+
+    if (obj.shm->value != GetCurrentThreadId()) return STATUS_MUTANT_NOT_OWNED;
+    if (prev_count) *prev_count = 1 - obj.shm->count;
+    if (!--obj.shm->count)
+    {
+        obj.shm->value = 0;
+        esync_write( obj.fd, 1 );
+    }
+    return STATUS_SUCCESS;
+}
@@ -2240,6 +2240,52 @@ NTSTATUS server_get_unix_name( HANDLE handle, ANSI_STRING *unix_name )
     return ret;
 }
 
+/* retrieve the unix name and the granted access of a handle in a single server round trip */
+static NTSTATUS get_unix_name_and_access( HANDLE handle, ANSI_STRING *unix_name, ACCESS_MASK *access )
+{
+    struct __server_request_info name_info, access_info;
+    struct __server_batch_entry batch[2];
+    data_size_t size = 1024;
+    NTSTATUS ret;
+    char *name;
+
+    *access = 0;
+    if (!(name = RtlAllocateHeap( GetProcessHeap(), 0, size + 1 ))) return STATUS_NO_MEMORY;
+
+    wine_server_init_req( &name_info, REQ_get_handle_unix_name );
+    name_info.u.req.get_handle_unix_name_request.handle = wine_server_obj_handle( handle );
+    wine_server_set_reply( &name_info, name, size );
+    batch[0].req = &name_info;
+    batch[0].handle_from = -1;
+
+    wine_server_init_req( &access_info, REQ_get_object_info );
+    access_info.u.req.get_object_info_request.handle = wine_server_obj_handle( handle );
+    batch[1].req = &access_info;
+    batch[1].handle_from = -1;
+
+    wine_server_call_batch( batch, 2 );
+
+    if (!(ret = access_info.u.reply.reply_header.error))
+    {
+        *access = access_info.u.reply.get_object_info_reply.access;
+        ret = name_info.u.reply.reply_header.error;
+    }
+    if (ret)
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, name );
+        /* the name is too long for the initial buffer, fetch it on its own */
+        if (ret == STATUS_BUFFER_OVERFLOW) ret = server_get_unix_name( handle, unix_name );
+        return ret;
+    }
+
+    size = name_info.u.reply.get_handle_unix_name_reply.name_len;
+    name[size] = 0;
+    unix_name->Buffer = name;
+    unix_name->Length = size;
+    unix_name->MaximumLength = 1024 + 1;
+    return STATUS_SUCCESS;
+}
+
 static NTSTATUS fill_name_info( const ANSI_STRING *unix_name, FILE_NAME_INFORMATION *info, LONG *name_len )
 {
     UNICODE_STRING nt_name;
@@ -2440,18 +2486,19 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE hFile, PIO_STATUS_BLOCK io,
         {
             FILE_ALL_INFORMATION *info = ptr;
             ANSI_STRING unix_name;
+            ACCESS_MASK access;
 
             if (fd_get_file_info( fd, &st, &attr ) == -1) io->u.Status = FILE_GetNtStatus();
             else if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
                 io->u.Status = STATUS_INVALID_INFO_CLASS;
-            else if (!(io->u.Status = server_get_unix_name( hFile, &unix_name )))
+            else if (!(io->u.Status = get_unix_name_and_access( hFile, &unix_name, &access )))
             {
                 LONG name_len = len - FIELD_OFFSET(FILE_ALL_INFORMATION, NameInformation.FileName);
 
                 fill_file_info( &st, attr, info, FileAllInformation );
                 info->StandardInformation.DeletePending = FALSE; /* FIXME */
                 info->EaInformation.EaSize = 0;
-                info->AccessInformation.AccessFlags = 0;  /* FIXME */
+                info->AccessInformation.AccessFlags = access;
                 info->PositionInformation.CurrentByteOffset.QuadPart = lseek( fd, 0, SEEK_CUR );
                 info->ModeInformation.Mode = 0;  /* FIXME */
                 info->AlignmentInformation.AlignmentRequirement = 1;  /* FIXME */
@@ -46,6 +46,7 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(module);
 WINE_DECLARE_DEBUG_CHANNEL(relay);
+WINE_DECLARE_DEBUG_CHANNEL(relayprof);
 WINE_DECLARE_DEBUG_CHANNEL(snoop);
 WINE_DECLARE_DEBUG_CHANNEL(loaddll);
 WINE_DECLARE_DEBUG_CHANNEL(imports);
@@ -539,7 +540,7 @@ static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY
         const WCHAR *user = current_modref ? current_modref->ldr.BaseDllName.Buffer : NULL;
         proc = SNOOP_GetProcAddress( module, exports, exp_size, proc, ordinal, user );
     }
-    if (TRACE_ON(relay))
+    if (TRACE_ON(relay) || TRACE_ON(relayprof))
     {
         const WCHAR *user = current_modref ? current_modref->ldr.BaseDllName.Buffer : NULL;
         proc = RELAY_GetProcAddress( module, exports, exp_size, proc, ordinal, user );
@@ -1689,7 +1690,7 @@ static void load_builtin_callback( void *module, const char *filename )
     SERVER_END_REQ;
 
     /* setup relay debugging entry points */
-    if (TRACE_ON(relay)) RELAY_SetupDLL( module );
+    if (TRACE_ON(relay) || TRACE_ON(relayprof)) RELAY_SetupDLL( module );
 }
 
 
@@ -2784,6 +2785,7 @@ fail:
 void WINAPI LdrShutdownProcess(void)
 {
     TRACE("()\n");
+    if (TRACE_ON(relayprof)) RELAY_PrintProfile();
     process_detaching = TRUE;
     process_detach();
 }
@@ -2875,6 +2877,7 @@ static void free_modref( WINE_MODREF *wm )
 
     free_tls_slot( &wm->ldr );
     RtlReleaseActivationContext( wm->ldr.ActivationContext );
+    if (TRACE_ON(relayprof)) RELAY_FreeDLL( wm->ldr.BaseAddress );
     if (wm->ldr.Flags & LDR_WINE_INTERNAL) wine_dll_unload( wm->ldr.SectionHandle );
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.BaseAddress );
     if (cached_modref == wm) cached_modref = NULL;
@@ -70,6 +70,7 @@ extern void signal_init_thread( TEB *teb ) DECLSPEC_HIDDEN;
 extern void signal_init_process( CONTEXT *context, LPTHREAD_START_ROUTINE entry ) DECLSPEC_HIDDEN;
 extern void version_init( const WCHAR *appname ) DECLSPEC_HIDDEN;
 extern void debug_init(void) DECLSPEC_HIDDEN;
+extern void debug_exit_thread(void) DECLSPEC_HIDDEN;
 extern HANDLE thread_init(void) DECLSPEC_HIDDEN;
 extern void actctx_init(void) DECLSPEC_HIDDEN;
 extern void virtual_init(void) DECLSPEC_HIDDEN;
@@ -96,7 +97,19 @@ extern unsigned int server_queue_process_apc( HANDLE process, const apc_call_t *
 extern int server_remove_fd_from_cache( HANDLE handle ) DECLSPEC_HIDDEN;
 extern int server_get_unix_fd( HANDLE handle, unsigned int access, int *unix_fd,
                                int *needs_close, enum server_fd_type *type, unsigned int *options ) DECLSPEC_HIDDEN;
+extern NTSTATUS server_get_esync_fd( HANDLE handle, int *fd, enum esync_type *type,
+                                     unsigned int *access, unsigned int *shm_idx ) DECLSPEC_HIDDEN;
 extern int server_pipe( int fd[2] ) DECLSPEC_HIDDEN;
+
+/* esync */
+extern void esync_close( HANDLE handle ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_wait_objects( DWORD count, const HANDLE *handles, BOOLEAN wait_any,
+                                    const LARGE_INTEGER *timeout ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_set_event( HANDLE handle, LONG *prev_state ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_reset_event( HANDLE handle, LONG *prev_state ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_pulse_event( HANDLE handle ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_release_semaphore( HANDLE handle, ULONG count, ULONG *prev ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_release_mutex( HANDLE handle, LONG *prev_count ) DECLSPEC_HIDDEN;
 extern NTSTATUS alloc_object_attributes( const OBJECT_ATTRIBUTES *attr, struct object_attributes **ret,
                                          data_size_t *ret_len ) DECLSPEC_HIDDEN;
 extern NTSTATUS validate_open_object_attributes( const OBJECT_ATTRIBUTES *attr ) DECLSPEC_HIDDEN;
@@ -109,6 +122,8 @@ extern FARPROC RELAY_GetProcAddress( HMODULE module, const IMAGE_EXPORT_DIRECTOR
 extern FARPROC SNOOP_GetProcAddress( HMODULE hmod, const IMAGE_EXPORT_DIRECTORY *exports, DWORD exp_size,
                                      FARPROC origfun, DWORD ordinal, const WCHAR *user ) DECLSPEC_HIDDEN;
 extern void RELAY_SetupDLL( HMODULE hmod ) DECLSPEC_HIDDEN;
+extern void RELAY_FreeDLL( HMODULE hmod ) DECLSPEC_HIDDEN;
+extern void RELAY_PrintProfile(void) DECLSPEC_HIDDEN;
 extern void SNOOP_SetupDLL( HMODULE hmod ) DECLSPEC_HIDDEN;
 extern UNICODE_STRING system_dir DECLSPEC_HIDDEN;
 
@@ -211,8 +226,25 @@ struct debug_info
     char *out_pos;       /* current position in output buffer */
     char  strings[1024]; /* buffer for temporary strings */
     char  output[1024];  /* current output line */
+    struct debug_ring *ring;  /* binary trace ring, see wine/debug_ring.h */
 };
 
+#ifdef __x86_64__
+#define UNWIND_CACHE_SIZE 16
+
+/* per-thread cache of lookups in dynamic function tables */
+struct unwind_cache
+{
+    struct
+    {
+        ULONG64           pc;
+        ULONG64           base;
+        RUNTIME_FUNCTION *func;
+        LONG              generation;
+    } entries[UNWIND_CACHE_SIZE];
+};
+#endif
+
 /* thread private data, stored in NtCurrentTeb()->GdiTebBatch */
 struct ntdll_thread_data
 {
@@ -225,6 +257,10 @@ struct ntdll_thread_data
     int                wait_fd[2];    /* fd for sleeping server requests */
     BOOL               wow64_redir;   /* Wow64 filesystem redirection flag */
     pthread_t          pthread_id;    /* pthread thread id */
+    struct relay_thread_profile *relay_profile;  /* relay profiling data */
+#ifdef __x86_64__
+    struct unwind_cache unwind_cache; /* recent lookups in dynamic function tables */
+#endif
 };
 
 C_ASSERT( sizeof(struct ntdll_thread_data) <= sizeof(((TEB *)0)->GdiTebBatch) );
@@ -370,6 +370,7 @@ NTSTATUS WINAPI NtDuplicateObject( HANDLE source_process, HANDLE source,
             {
                 int fd = server_remove_fd_from_cache( source );
                 if (fd != -1) close( fd );
+                esync_close( source );
             }
         }
     }
@@ -383,6 +384,7 @@ NTSTATUS close_handle( HANDLE handle )
     NTSTATUS ret;
     int fd = server_remove_fd_from_cache( handle );
 
+    esync_close( handle );
     SERVER_START_REQ( close_handle )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -23,9 +23,11 @@
 #include "wine/port.h"
 
 #include <assert.h>
+#include <signal.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -34,6 +36,7 @@
 #include "wine/exception.h"
 #include "ntdll_misc.h"
 #include "wine/unicode.h"
+#include "wine/list.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(relay);
@@ -42,6 +45,7 @@ WINE_DEFAULT_DEBUG_CHANNEL(relay);
 
 WINE_DECLARE_DEBUG_CHANNEL(timestamp);
 WINE_DECLARE_DEBUG_CHANNEL(pid);
+WINE_DECLARE_DEBUG_CHANNEL(relayprof);
 
 struct relay_descr  /* descriptor for a module */
 {
@@ -63,12 +67,16 @@ struct relay_entry_point
 {
     void       *orig_func;    /* original entry point function */
     const char *name;         /* function name (if any) */
+    int         calls;        /* number of calls (relayprof only) */
+    LONGLONG    time;         /* time spent in the function, including callees (relayprof only) */
 };
 
 struct relay_private_data
 {
+    struct list              entry;             /* entry in the profiled modules list */
     HMODULE                  module;            /* module handle of this dll */
     unsigned int             base;              /* ordinal base */
+    unsigned int             nb_entry_points;   /* number of entry points */
     char                     dllname[40];       /* dll name (without .dll extension) */
     struct relay_entry_point entry_points[1];   /* list of dll entry points */
 };
@@ -84,6 +92,38 @@ static const WCHAR **debug_from_snoop_includelist;
 
 static RTL_RUN_ONCE init_once = RTL_RUN_ONCE_INIT;
 
+/* relay profiling: when the relayprof channel is enabled, relayed calls are only
+ * counted and timed, and a report is printed at exit or when receiving SIGPROF */
+
+#define RELAY_PROFILE_DEPTH 64
+
+struct relay_thread_profile
+{
+    struct list    entry;       /* entry in the profiled threads list */
+    DWORD          tid;         /* thread id */
+    ULONG          calls;       /* number of relayed calls */
+    ULONGLONG      time;        /* time spent in the outermost relayed calls */
+    unsigned int   depth;       /* number of calls in progress */
+    struct
+    {
+        const INT_PTR *stack;   /* stack pointer of the call */
+        ULONGLONG      start;   /* time of the call */
+    } frames[RELAY_PROFILE_DEPTH];
+};
+
+static struct list profile_modules = LIST_INIT( profile_modules );
+static struct list profile_threads = LIST_INIT( profile_threads );
+static int profile_report_pending;
+
+static RTL_CRITICAL_SECTION profile_section;
+static RTL_CRITICAL_SECTION_DEBUG profile_section_debug =
+{
+    0, 0, &profile_section,
+    { &profile_section_debug.ProcessLocksList, &profile_section_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": profile_section") }
+};
+static RTL_CRITICAL_SECTION profile_section = { &profile_section_debug, -1, 0, 0, 0, 0 };
+
 /* compare an ASCII and a Unicode string without depending on the current codepage */
 static inline int strcmpAW( const char *strA, const WCHAR *strW )
 {
@@ -168,6 +208,12 @@ static const WCHAR **load_list( HKEY hkey, const WCHAR *value )
     return list;
 }
 
+/* request a profile report, it is printed by the next thread returning from a relayed call */
+static void profile_signal_handler( int signal )
+{
+    profile_report_pending = TRUE;
+}
+
 /***********************************************************************
  *           init_debug_lists
  *
@@ -190,6 +236,16 @@ static DWORD WINAPI init_debug_lists( RTL_RUN_ONCE *once, void *param, void **co
     static const WCHAR SnoopFromIncludeW[] = {'S','n','o','o','p','F','r','o','m','I','n','c','l','u','d','e',0};
     static const WCHAR SnoopFromExcludeW[] = {'S','n','o','o','p','F','r','o','m','E','x','c','l','u','d','e',0};
 
+    if (TRACE_ON(relayprof))
+    {
+        struct sigaction sig_act;
+
+        sig_act.sa_handler = profile_signal_handler;
+        sig_act.sa_flags = SA_RESTART;
+        sigemptyset( &sig_act.sa_mask );
+        sigaction( SIGPROF, &sig_act, NULL );
+    }
+
     RtlOpenCurrentUser( KEY_ALL_ACCESS, &root );
     attr.Length = sizeof(attr);
     attr.RootDirectory = root;
@@ -325,6 +381,136 @@ static void print_timestamp(void)
     DPRINTF( "%3u.%03u:", ticks / 1000, ticks % 1000 );
 }
 
+/***********************************************************************
+ *           get_thread_profile
+ */
+static struct relay_thread_profile *get_thread_profile(void)
+{
+    struct relay_thread_profile *profile = ntdll_get_thread_data()->relay_profile;
+
+    if (profile) return profile;
+    if (!(profile = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*profile) ))) return NULL;
+    profile->tid = GetCurrentThreadId();
+    RtlEnterCriticalSection( &profile_section );
+    list_add_tail( &profile_threads, &profile->entry );
+    RtlLeaveCriticalSection( &profile_section );
+    return ntdll_get_thread_data()->relay_profile = profile;
+}
+
+/***********************************************************************
+ *           profile_entry
+ *
+ * Count a relayed call and remember when it started.
+ */
+static void profile_entry( struct relay_entry_point *entry_point, const INT_PTR *stack )
+{
+    struct relay_thread_profile *profile = get_thread_profile();
+
+    interlocked_xchg_add( &entry_point->calls, 1 );
+    if (!profile) return;
+    profile->calls++;
+    if (profile->depth == RELAY_PROFILE_DEPTH) return;  /* too deep, the call isn't timed */
+    profile->frames[profile->depth].stack = stack;
+    RtlQueryUnbiasedInterruptTime( &profile->frames[profile->depth].start );
+    profile->depth++;
+}
+
+/***********************************************************************
+ *           profile_exit
+ *
+ * Add the time spent in a relayed call to the function and thread totals.
+ */
+static void profile_exit( struct relay_entry_point *entry_point, const INT_PTR *stack )
+{
+    struct relay_thread_profile *profile = ntdll_get_thread_data()->relay_profile;
+    ULONGLONG now, time;
+    LONGLONG old;
+
+    if (!profile) return;
+
+    /* forget about the calls that never returned because of an exception */
+    while (profile->depth && profile->frames[profile->depth - 1].stack < stack) profile->depth--;
+    if (!profile->depth || profile->frames[profile->depth - 1].stack != stack) return;
+
+    RtlQueryUnbiasedInterruptTime( &now );
+    time = now - profile->frames[--profile->depth].start;
+    if (!profile->depth) profile->time += time;
+
+    do old = entry_point->time;
+    while (interlocked_cmpxchg64( &entry_point->time, old + time, old ) != old);
+}
+
+struct profile_line
+{
+    const struct relay_private_data *data;
+    unsigned int                     ordinal;
+};
+
+static int compare_profile_lines( const void *p1, const void *p2 )
+{
+    const struct profile_line *line1 = p1, *line2 = p2;
+    LONGLONG time1 = line1->data->entry_points[line1->ordinal].time;
+    LONGLONG time2 = line2->data->entry_points[line2->ordinal].time;
+
+    if (time1 != time2) return time1 > time2 ? -1 : 1;
+    return line2->data->entry_points[line2->ordinal].calls - line1->data->entry_points[line1->ordinal].calls;
+}
+
+/***********************************************************************
+ *           RELAY_PrintProfile
+ *
+ * Print the functions sorted by the time spent in them, and the per-thread totals.
+ */
+void RELAY_PrintProfile(void)
+{
+    const struct relay_thread_profile *thread;
+    const struct relay_private_data *data;
+    const struct relay_entry_point *entry_point;
+    struct profile_line *lines = NULL;
+    unsigned int i, count = 0, size = 0;
+
+    RtlEnterCriticalSection( &profile_section );
+
+    LIST_FOR_EACH_ENTRY( data, &profile_modules, struct relay_private_data, entry )
+    {
+        for (i = 0; i < data->nb_entry_points; i++)
+        {
+            if (!data->entry_points[i].calls) continue;
+            if (count == size)
+            {
+                struct profile_line *new_lines;
+                size = size ? size * 2 : 256;
+                if (lines) new_lines = RtlReAllocateHeap( GetProcessHeap(), 0, lines, size * sizeof(*lines) );
+                else new_lines = RtlAllocateHeap( GetProcessHeap(), 0, size * sizeof(*lines) );
+                if (!new_lines) goto done;
+                lines = new_lines;
+            }
+            lines[count].data = data;
+            lines[count].ordinal = i;
+            count++;
+        }
+    }
+    qsort( lines, count, sizeof(*lines), compare_profile_lines );
+
+    DPRINTF( "%04x:Relay profile\n", GetCurrentProcessId() );
+    DPRINTF( "       calls     time (ms)   average (us)  function\n" );
+    for (i = 0; i < count; i++)
+    {
+        entry_point = lines[i].data->entry_points + lines[i].ordinal;
+        DPRINTF( "%12u %13.3f %14.3f  ", entry_point->calls, entry_point->time / 10000.0,
+                 entry_point->time / 10.0 / entry_point->calls );
+        if (entry_point->name) DPRINTF( "%s.%s\n", lines[i].data->dllname, entry_point->name );
+        else DPRINTF( "%s.%u\n", lines[i].data->dllname, lines[i].data->base + lines[i].ordinal );
+    }
+    DPRINTF( "\n   thread       calls     time (ms)\n" );
+    LIST_FOR_EACH_ENTRY( thread, &profile_threads, struct relay_thread_profile, entry )
+        DPRINTF( "     %04x %11u %13.3f\n", thread->tid, thread->calls, thread->time / 10000.0 );
+
+done:
+    RtlLeaveCriticalSection( &profile_section );
+    RtlFreeHeap( GetProcessHeap(), 0, lines );
+}
+
 /***********************************************************************
  *           relay_trace_entry
  *
@@ -352,6 +538,7 @@ DECLSPEC_HIDDEN void * WINAPI relay_trace_entry( struct relay_descr *descr,
         RELAY_PrintArgs( stack + 1, nb_args, descr->arg_types[ordinal] );
         DPRINTF( ") ret=%08lx\n", stack[0] );
     }
+    if (TRACE_ON(relayprof)) profile_entry( entry_point, stack );
     return entry_point->orig_func;
 }
 
@@ -366,6 +553,13 @@ DECLSPEC_HIDDEN void WINAPI relay_trace_exit( struct relay_descr *descr, unsigne
     struct relay_private_data *data = descr->private;
     struct relay_entry_point *entry_point = data->entry_points + ordinal;
 
+    if (TRACE_ON(relayprof))
+    {
+        profile_exit( entry_point, stack );
+        if (profile_report_pending && interlocked_xchg( &profile_report_pending, FALSE ))
+            RELAY_PrintProfile();
+    }
+
     if (!TRACE_ON(relay)) return;
 
     if (TRACE_ON(timestamp)) print_timestamp();
@@ -702,6 +896,7 @@ void RELAY_SetupDLL( HMODULE module )
 
     data->module = module;
     data->base   = exports->Base;
+    data->nb_entry_points = exports->NumberOfFunctions;
     len = strlen( (char *)module + exports->Name );
     if (len > 4 && !strcasecmp( (char *)module + exports->Name + len - 4, ".dll" )) len -= 4;
     len = min( len, sizeof(data->dllname) - 1 );
@@ -730,6 +925,46 @@ void RELAY_SetupDLL( HMODULE module )
         data->entry_points[i].orig_func = (char *)module + *funcs;
         *funcs = entry_point_rva + descr->entry_point_offsets[i];
     }
+
+    if (TRACE_ON(relayprof))
+    {
+        RtlEnterCriticalSection( &profile_section );
+        list_add_tail( &profile_modules, &data->entry );
+        RtlLeaveCriticalSection( &profile_section );
+    }
+}
+
+/***********************************************************************
+ *           RELAY_FreeDLL
+ *
+ * Keep the profile of a dll that is being unloaded, its names won't be available anymore.
+ */
+void RELAY_FreeDLL( HMODULE module )
+{
+    IMAGE_EXPORT_DIRECTORY *exports;
+    struct relay_descr *descr;
+    struct relay_private_data *data;
+    unsigned int i;
+    DWORD size;
+    char *name;
+
+    exports = RtlImageDirectoryEntryToData( module, TRUE, IMAGE_DIRECTORY_ENTRY_EXPORT, &size );
+    if (!exports) return;
+
+    descr = (struct relay_descr *)((char *)exports + size);
+    if (descr->magic != RELAY_DESCR_MAGIC || !(data = descr->private)) return;
+
+    RtlEnterCriticalSection( &profile_section );
+    for (i = 0; i < data->nb_entry_points; i++)
+    {
+        if (!data->entry_points[i].name) continue;
+        if (data->entry_points[i].calls &&
+            (name = RtlAllocateHeap( GetProcessHeap(), 0, strlen( data->entry_points[i].name ) + 1 )))
+            data->entry_points[i].name = strcpy( name, data->entry_points[i].name );
+        else
+            data->entry_points[i].name = NULL;
+    }
+    RtlLeaveCriticalSection( &profile_section );
 }
 
 #else  /* __i386__ || __x86_64__ || __arm__ || __aarch64__ */
@@ -744,6 +979,14 @@ void RELAY_SetupDLL( HMODULE module )
 {
 }
 
+void RELAY_FreeDLL( HMODULE module )
+{
+}
+
+void RELAY_PrintProfile(void)
+{
+}
+
 #endif  /* __i386__ || __x86_64__ || __arm__ || __aarch64__ */
 
 
@@ -313,6 +313,100 @@ unsigned int wine_server_call( void *req_ptr )
 }
 
 
+/***********************************************************************
+ *           wine_server_call_batch (NTDLL.@)
+ *
+ * Perform several server calls in a single round trip.
+ *
+ * PARAMS
+ *     entries [I/O] Requests to perform, prepared with wine_server_init_req
+ *     count   [I]   Number of requests
+ *
+ * RETURNS
+ *     The error of the first request that failed, STATUS_SUCCESS if none did.
+ *
+ * NOTES
+ *     Requests are executed in order, the reply of each one being stored in
+ *     its request structure. A request can take a handle from the reply of a
+ *     previous one with the handle_from field; it fails without being executed
+ *     if that previous request failed. Only requests that don't block and don't
+ *     transfer file descriptors are allowed.
+ */
+unsigned int CDECL wine_server_call_batch( struct __server_batch_entry *entries, unsigned int count )
+{
+    data_size_t req_size = 0, reply_size = 0, pos, size;
+    unsigned int i, j, done = 0, ret;
+    char *buffer, *ptr;
+
+    if (count > MAX_BATCH_REQUESTS) return STATUS_INVALID_PARAMETER;
+
+    for (i = 0; i < count; i++)
+    {
+        const struct request_header *header = &entries[i].req->u.req.request_header;
+        req_size += sizeof(struct batch_header) + sizeof(union generic_request) +
+                    ((header->request_size + 7) & ~7);
+        reply_size += sizeof(union generic_reply) + ((header->reply_size + 7) & ~7);
+    }
+    if (!(buffer = RtlAllocateHeap( GetProcessHeap(), 0, req_size + reply_size )))
+        return STATUS_NO_MEMORY;
+
+    for (i = 0, ptr = buffer; i < count; i++)
+    {
+        struct __server_request_info *req = entries[i].req;
+        struct batch_header *header = (struct batch_header *)ptr;
+
+        header->handle_from   = entries[i].handle_from;
+        header->handle_offset = entries[i].handle_offset;
+        header->reply_offset  = entries[i].reply_offset;
+        ptr += sizeof(*header);
+        memcpy( ptr, &req->u.req, sizeof(req->u.req) );
+        ptr += sizeof(req->u.req);
+        for (j = 0; j < req->data_count; j++)
+        {
+            memcpy( ptr, req->data[j].ptr, req->data[j].size );
+            ptr += req->data[j].size;
+        }
+        size = req->u.req.request_header.request_size;
+        memset( ptr, 0, ((size + 7) & ~7) - size );
+        ptr += ((size + 7) & ~7) - size;
+    }
+
+    SERVER_START_REQ( batch )
+    {
+        wine_server_add_data( req, buffer, req_size );
+        wine_server_set_reply( req, buffer + req_size, reply_size );
+        ret = wine_server_call( req );
+        done = reply->count;
+        reply_size = wine_server_reply_size( reply );
+    }
+    SERVER_END_REQ;
+
+    for (i = pos = 0; i < count; i++)
+    {
+        struct __server_request_info *req = entries[i].req;
+        data_size_t max_size = req->u.req.request_header.reply_size;
+
+        if (i >= done || reply_size - pos < sizeof(req->u.reply))
+        {
+            memset( &req->u.reply, 0, sizeof(req->u.reply) );
+            req->u.reply.reply_header.error = ret ? ret : STATUS_INVALID_PARAMETER;
+            continue;
+        }
+        memcpy( &req->u.reply, buffer + req_size + pos, sizeof(req->u.reply) );
+        pos += sizeof(req->u.reply);
+        size = min( req->u.reply.reply_header.reply_size, max_size );
+        if (size) memcpy( req->reply_data, buffer + req_size + pos, size );
+        pos += (req->u.reply.reply_header.reply_size + 7) & ~7;
+    }
+
+    RtlFreeHeap( GetProcessHeap(), 0, buffer );
+
+    for (i = 0; i < count; i++)
+        if ((ret = entries[i].req->u.reply.reply_header.error)) break;
+    return ret;
+}
+
+
 /***********************************************************************
  *           server_enter_uninterrupted_section
  */
@@ -972,6 +1066,43 @@ done:
 }
 
 
+/***********************************************************************
+ *           server_get_esync_fd
+ *
+ * Retrieve the eventfd backing a synchronization object, or -1 if it
+ * doesn't have one. The returned fd is owned by the caller.
+ */
+NTSTATUS server_get_esync_fd( HANDLE handle, int *fd, enum esync_type *type,
+                              unsigned int *access, unsigned int *shm_idx )
+{
+    sigset_t sigset;
+    obj_handle_t fd_handle;
+    NTSTATUS ret;
+
+    *fd = -1;
+    server_enter_uninterrupted_section( &fd_cache_section, &sigset );
+    SERVER_START_REQ( get_esync_fd )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        if (!(ret = wine_server_call( req )))
+        {
+            *type = reply->type;
+            *access = reply->access;
+            *shm_idx = reply->shm_idx;
+            if (reply->type != ESYNC_NONE)
+            {
+                if ((*fd = receive_fd( &fd_handle )) != -1)
+                    assert( wine_server_ptr_handle(fd_handle) == handle );
+                else ret = STATUS_TOO_MANY_OPENED_FILES;
+            }
+        }
+    }
+    SERVER_END_REQ;
+    server_leave_uninterrupted_section( &fd_cache_section, &sigset );
+    return ret;
+}
+
+
 /***********************************************************************
  *           wine_server_fd_to_handle   (NTDLL.@)
  *
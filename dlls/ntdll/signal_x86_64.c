@@ -332,8 +332,6 @@ static inline struct amd64_thread_data *amd64_thread_data(void)
 
 struct dynamic_unwind_entry
 {
-    struct list entry;
-
     /* memory region which matches this entry */
     DWORD64 base;
     DWORD size;
@@ -345,9 +343,30 @@ struct dynamic_unwind_entry
     /* user defined callback */
     PGET_RUNTIME_FUNCTION_CALLBACK callback;
     PVOID context;
+
+    /* position in the index */
+    DWORD64 max_end;     /* highest end address of this entry and all the previous ones */
+    unsigned int serial; /* registration order, the first registered entry wins on overlap */
 };
 
-static struct list dynamic_unwind_list = LIST_INIT(dynamic_unwind_list);
+/* entries sorted by base address */
+static struct dynamic_unwind_entry **dynamic_unwind_index;
+static unsigned int dynamic_unwind_count;
+static unsigned int dynamic_unwind_max;
+static unsigned int dynamic_unwind_serial;
+
+/* bumped when an entry is removed, to invalidate the per-thread caches */
+static LONG dynamic_unwind_generation = 1;
+
+static inline struct unwind_cache *get_unwind_cache(void)
+{
+    return &ntdll_get_thread_data()->unwind_cache;
+}
+
+static inline unsigned int unwind_cache_hash( ULONG64 pc )
+{
+    return (pc ^ (pc >> 5) ^ (pc >> 12)) % UNWIND_CACHE_SIZE;
+}
 
 static RTL_CRITICAL_SECTION dynamic_unwind_section;
 static RTL_CRITICAL_SECTION_DEBUG dynamic_unwind_debug =
@@ -2319,15 +2338,117 @@ static RUNTIME_FUNCTION *find_function_info( ULONG64 pc, HMODULE module,
     return NULL;
 }
 
+/**********************************************************************
+ *           find_dynamic_unwind_entry
+ *
+ * Find the dynamic entry containing pc. Must be called with dynamic_unwind_section held.
+ */
+static struct dynamic_unwind_entry *find_dynamic_unwind_entry( ULONG64 pc )
+{
+    struct dynamic_unwind_entry *entry, *ret = NULL;
+    int min = 0, max = dynamic_unwind_count - 1;
+
+    /* find the last entry starting before pc */
+    while (min <= max)
+    {
+        int pos = (min + max) / 2;
+        if (pc < dynamic_unwind_index[pos]->base) max = pos - 1;
+        else min = pos + 1;
+    }
+
+    /* walk back over the entries that may still contain pc */
+    for ( ; max >= 0 && pc < dynamic_unwind_index[max]->max_end; max--)
+    {
+        entry = dynamic_unwind_index[max];
+        if (pc < entry->base + entry->size && (!ret || entry->serial < ret->serial)) ret = entry;
+    }
+    return ret;
+}
+
+/**********************************************************************
+ *           update_dynamic_unwind_index
+ *
+ * Recompute the max_end fields starting from the given position.
+ */
+static void update_dynamic_unwind_index( unsigned int pos )
+{
+    DWORD64 max_end = pos ? dynamic_unwind_index[pos - 1]->max_end : 0;
+
+    for ( ; pos < dynamic_unwind_count; pos++)
+    {
+        struct dynamic_unwind_entry *entry = dynamic_unwind_index[pos];
+        max_end = max( max_end, entry->base + entry->size );
+        entry->max_end = max_end;
+    }
+}
+
+/**********************************************************************
+ *           add_dynamic_unwind_entry
+ */
+static BOOL add_dynamic_unwind_entry( struct dynamic_unwind_entry *entry )
+{
+    int min = 0, max;
+
+    RtlEnterCriticalSection( &dynamic_unwind_section );
+
+    if (dynamic_unwind_count == dynamic_unwind_max)
+    {
+        unsigned int new_max = max( 16, dynamic_unwind_max * 2 );
+        struct dynamic_unwind_entry **new_index;
+
+        if (dynamic_unwind_index)
+            new_index = RtlReAllocateHeap( GetProcessHeap(), 0, dynamic_unwind_index,
+                                           new_max * sizeof(*new_index) );
+        else
+            new_index = RtlAllocateHeap( GetProcessHeap(), 0, new_max * sizeof(*new_index) );
+        if (!new_index)
+        {
+            RtlLeaveCriticalSection( &dynamic_unwind_section );
+            return FALSE;
+        }
+        dynamic_unwind_index = new_index;
+        dynamic_unwind_max = new_max;
+    }
+
+    /* insert after the entries with the same base */
+    max = dynamic_unwind_count - 1;
+    while (min <= max)
+    {
+        int pos = (min + max) / 2;
+        if (entry->base < dynamic_unwind_index[pos]->base) max = pos - 1;
+        else min = pos + 1;
+    }
+    memmove( dynamic_unwind_index + min + 1, dynamic_unwind_index + min,
+             (dynamic_unwind_count - min) * sizeof(*dynamic_unwind_index) );
+    dynamic_unwind_index[min] = entry;
+    dynamic_unwind_count++;
+    entry->serial = dynamic_unwind_serial++;
+    update_dynamic_unwind_index( min );
+
+    RtlLeaveCriticalSection( &dynamic_unwind_section );
+    return TRUE;
+}
+
 /**********************************************************************
  *           lookup_function_info
  */
 static RUNTIME_FUNCTION *lookup_function_info( ULONG64 pc, ULONG64 *base, LDR_MODULE **module )
 {
+    struct unwind_cache *cache = get_unwind_cache();
+    unsigned int hash = unwind_cache_hash( pc );
     RUNTIME_FUNCTION *func = NULL;
     struct dynamic_unwind_entry *entry;
+    LONG generation = dynamic_unwind_generation;
     ULONG size;
 
+    /* recently used dynamic function */
+    if (cache->entries[hash].pc == pc && cache->entries[hash].generation == generation)
+    {
+        *module = NULL;
+        *base = cache->entries[hash].base;
+        return cache->entries[hash].func;
+    }
+
     /* PE module or wine module */
     if (!LdrFindEntryForAddress( (void *)pc, module ))
     {
@@ -2344,18 +2465,19 @@ static RUNTIME_FUNCTION *lookup_function_info( ULONG64 pc, ULONG64 *base, LDR_MO
         *module = NULL;
 
         RtlEnterCriticalSection( &dynamic_unwind_section );
-        LIST_FOR_EACH_ENTRY( entry, &dynamic_unwind_list, struct dynamic_unwind_entry, entry )
+        if ((entry = find_dynamic_unwind_entry( pc )))
         {
-            if (pc >= entry->base && pc < entry->base + entry->size)
-            {
-                *base = entry->base;
+            *base = entry->base;
 
-                /* use callback or lookup in function table */
-                if (entry->callback)
-                    func = entry->callback( pc, entry->context );
-                else
-                    func = find_function_info( pc, (HMODULE)entry->base, entry->table, entry->table_size );
-                break;
+            /* use callback or lookup in function table */
+            if (entry->callback)
+                func = entry->callback( pc, entry->context );
+            else if ((func = find_function_info( pc, (HMODULE)entry->base, entry->table, entry->table_size )))
+            {
+                cache->entries[hash].pc         = pc;
+                cache->entries[hash].base       = entry->base;
+                cache->entries[hash].func       = func;
+                cache->entries[hash].generation = generation;
             }
         }
         RtlLeaveCriticalSection( &dynamic_unwind_section );
@@ -3181,10 +3303,11 @@ BOOLEAN CDECL RtlAddFunctionTable( RUNTIME_FUNCTION *table, DWORD count, DWORD64
     entry->callback   = NULL;
     entry->context    = NULL;
 
-    RtlEnterCriticalSection( &dynamic_unwind_section );
-    list_add_tail( &dynamic_unwind_list, &entry->entry );
-    RtlLeaveCriticalSection( &dynamic_unwind_section );
-
+    if (!add_dynamic_unwind_entry( entry ))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, entry );
+        return FALSE;
+    }
     return TRUE;
 }
 
@@ -3216,10 +3339,11 @@ BOOLEAN CDECL RtlInstallFunctionTableCallback( DWORD64 table, DWORD64 base, DWOR
     entry->callback   = callback;
     entry->context    = context;
 
-    RtlEnterCriticalSection( &dynamic_unwind_section );
-    list_add_tail( &dynamic_unwind_list, &entry->entry );
-    RtlLeaveCriticalSection( &dynamic_unwind_section );
-
+    if (!add_dynamic_unwind_entry( entry ))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, entry );
+        return FALSE;
+    }
     return TRUE;
 }
 
@@ -3229,19 +3353,27 @@ BOOLEAN CDECL RtlInstallFunctionTableCallback( DWORD64 table, DWORD64 base, DWOR
  */
 BOOLEAN CDECL RtlDeleteFunctionTable( RUNTIME_FUNCTION *table )
 {
-    struct dynamic_unwind_entry *entry, *to_free = NULL;
+    struct dynamic_unwind_entry *to_free = NULL;
+    unsigned int i, pos = 0;
 
     TRACE( "%p\n", table );
 
     RtlEnterCriticalSection( &dynamic_unwind_section );
-    LIST_FOR_EACH_ENTRY( entry, &dynamic_unwind_list, struct dynamic_unwind_entry, entry )
+    /* remove the first registered entry using this table */
+    for (i = 0; i < dynamic_unwind_count; i++)
     {
-        if (entry->table == table)
-        {
-            to_free = entry;
-            list_remove( &entry->entry );
-            break;
-        }
+        if (dynamic_unwind_index[i]->table != table) continue;
+        if (to_free && to_free->serial < dynamic_unwind_index[i]->serial) continue;
+        to_free = dynamic_unwind_index[i];
+        pos = i;
+    }
+    if (to_free)
+    {
+        dynamic_unwind_count--;
+        memmove( dynamic_unwind_index + pos, dynamic_unwind_index + pos + 1,
+                 (dynamic_unwind_count - pos) * sizeof(*dynamic_unwind_index) );
+        update_dynamic_unwind_index( pos );
+        interlocked_xchg_add( &dynamic_unwind_generation, 1 );
     }
     RtlLeaveCriticalSection( &dynamic_unwind_section );
 
@@ -266,6 +266,10 @@ NTSTATUS WINAPI NtQuerySemaphore( HANDLE handle, SEMAPHORE_INFORMATION_CLASS cla
 NTSTATUS WINAPI NtReleaseSemaphore( HANDLE handle, ULONG count, PULONG previous )
 {
     NTSTATUS ret;
+
+    if ((ret = esync_release_semaphore( handle, count, previous )) != STATUS_NOT_IMPLEMENTED)
+        return ret;
+
     SERVER_START_REQ( release_semaphore )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -340,17 +344,18 @@ NTSTATUS WINAPI NtOpenEvent( HANDLE *handle, ACCESS_MASK access, const OBJECT_AT
  *  NtSetEvent (NTDLL.@)
  *  ZwSetEvent (NTDLL.@)
  */
-NTSTATUS WINAPI NtSetEvent( HANDLE handle, PULONG NumberOfThreadsReleased )
+NTSTATUS WINAPI NtSetEvent( HANDLE handle, PULONG prev_state )
 {
     NTSTATUS ret;
 
-    /* FIXME: set NumberOfThreadsReleased */
+    if ((ret = esync_set_event( handle, (LONG *)prev_state )) != STATUS_NOT_IMPLEMENTED) return ret;
 
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
         req->op     = SET_EVENT;
         ret = wine_server_call( req );
+        if (!ret && prev_state) *prev_state = reply->state;
     }
     SERVER_END_REQ;
     return ret;
@@ -359,18 +364,18 @@ NTSTATUS WINAPI NtSetEvent( HANDLE handle, PULONG NumberOfThreadsReleased )
 /******************************************************************************
  *  NtResetEvent (NTDLL.@)
  */
-NTSTATUS WINAPI NtResetEvent( HANDLE handle, PULONG NumberOfThreadsReleased )
+NTSTATUS WINAPI NtResetEvent( HANDLE handle, PULONG prev_state )
 {
     NTSTATUS ret;
 
-    /* resetting an event can't release any thread... */
-    if (NumberOfThreadsReleased) *NumberOfThreadsReleased = 0;
+    if ((ret = esync_reset_event( handle, (LONG *)prev_state )) != STATUS_NOT_IMPLEMENTED) return ret;
 
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
         req->op     = RESET_EVENT;
         ret = wine_server_call( req );
+        if (!ret && prev_state) *prev_state = reply->state;
     }
     SERVER_END_REQ;
     return ret;
@@ -400,6 +405,8 @@ NTSTATUS WINAPI NtPulseEvent( HANDLE handle, PULONG PulseCount )
     if (PulseCount)
       FIXME("(%p,%d)\n", handle, *PulseCount);
 
+    if ((ret = esync_pulse_event( handle )) != STATUS_NOT_IMPLEMENTED) return ret;
+
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -510,6 +517,9 @@ NTSTATUS WINAPI NtReleaseMutant( IN HANDLE handle, OUT PLONG prev_count OPTIONAL
 {
     NTSTATUS    status;
 
+    if ((status = esync_release_mutex( handle, prev_count )) != STATUS_NOT_IMPLEMENTED)
+        return status;
+
     SERVER_START_REQ( release_mutex )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -1022,9 +1032,17 @@ static NTSTATUS wait_objects( DWORD count, const HANDLE *handles,
 {
     select_op_t select_op;
     UINT i, flags = SELECT_INTERRUPTIBLE;
+    NTSTATUS ret;
 
     if (!count || count > MAXIMUM_WAIT_OBJECTS) return STATUS_INVALID_PARAMETER_1;
 
+    /* alertable waits need the server to deliver user APCs */
+    if (!alertable)
+    {
+        ret = esync_wait_objects( count, handles, wait_any, timeout );
+        if (ret != STATUS_NOT_IMPLEMENTED) return ret;
+    }
+
     if (alertable) flags |= SELECT_ALERTABLE;
     select_op.wait.op = wait_any ? SELECT_WAIT : SELECT_WAIT_ALL;
     for (i = 0; i < count; i++) select_op.wait.handles[i] = wine_server_obj_handle( handles[i] );
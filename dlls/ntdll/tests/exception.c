@@ -2097,6 +2097,135 @@ static void test_dynamic_unwind(void)
 
 }
 
+static EXCEPTION_DISPOSITION WINAPI continue_handler( EXCEPTION_RECORD *rec, ULONG64 frame,
+                                                      CONTEXT *context, DISPATCHER_CONTEXT *dispatch )
+{
+    return ExceptionContinueExecution;
+}
+
+/* raise exceptions from code covered by a dynamic function table, whose handler continues them */
+static void test_exception_throughput( unsigned int tables )
+{
+    static const unsigned int loops = 100000;
+    static const BYTE code[] =
+    {
+        0x48, 0x83, 0xec, 0x28,         /* 00: sub $0x28,%rsp */
+        0xb9, 0xef, 0xbe, 0xad, 0xde,   /* 04: mov $0xdeadbeef,%ecx */
+        0x31, 0xd2,                     /* 09: xor %edx,%edx */
+        0x45, 0x31, 0xc0,               /* 0b: xor %r8d,%r8d */
+        0x45, 0x31, 0xc9,               /* 0e: xor %r9d,%r9d */
+        0x48, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, /* 11: movabs $RaiseException,%rax */
+        0xff, 0xd0,                     /* 1b: call *%rax */
+        0x48, 0x83, 0xc4, 0x28,         /* 1d: add $0x28,%rsp */
+        0xc3,                           /* 21: ret */
+    };
+    static const BYTE handler_code[] =
+    {
+        0x48, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, /* 00: movabs $continue_handler,%rax */
+        0xff, 0xe0,                     /* 0a: jmp *%rax */
+    };
+    static const BYTE unwind_info[] =
+    {
+        1 | (UNW_FLAG_EHANDLER << 3),   /* version + flags */
+        0x04,                           /* prolog size */
+        1,                              /* opcode count */
+        0,                              /* frame reg */
+
+        0x04, UWOP(ALLOC_SMALL, 4),     /* sub $0x28,%rsp */
+        0, 0,                           /* padding */
+
+        0x40, 0, 0, 0,                  /* handler rva */
+    };
+    void (WINAPI *func)(void);
+    RUNTIME_FUNCTION table;
+    DWORD start, i;
+    void *ptr;
+    BYTE *mem;
+
+    mem = VirtualAlloc( NULL, 0x1000, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE );
+    ok( mem != NULL, "VirtualAlloc failed\n" );
+    if (!mem) return;
+
+    memcpy( mem, code, sizeof(code) );
+    ptr = RaiseException;
+    memcpy( mem + 0x13, &ptr, sizeof(ptr) );
+    memcpy( mem + 0x40, handler_code, sizeof(handler_code) );
+    ptr = continue_handler;
+    memcpy( mem + 0x42, &ptr, sizeof(ptr) );
+    memcpy( mem + 0x80, unwind_info, sizeof(unwind_info) );
+
+    table.BeginAddress = 0;
+    table.EndAddress   = sizeof(code);
+    table.UnwindData   = 0x80;
+    ok( pRtlAddFunctionTable( &table, 1, (ULONG_PTR)mem ), "RtlAddFunctionTable failed\n" );
+
+    func = (void *)mem;
+    start = GetTickCount();
+    for (i = 0; i < loops; i++) func();
+    trace( "%u exceptions with %u other dynamic function tables: %u ms\n",
+           loops, tables, GetTickCount() - start );
+
+    ok( pRtlDeleteFunctionTable( &table ), "RtlDeleteFunctionTable failed\n" );
+    VirtualFree( mem, 0, MEM_RELEASE );
+}
+
+static void test_dynamic_unwind_lookup(void)
+{
+    static const unsigned int count = 4096, func_size = 64;
+    RUNTIME_FUNCTION *tables, *func;
+    ULONG_PTR base;
+    DWORD i, j;
+    char *mem;
+
+    mem = VirtualAlloc( NULL, count * func_size, MEM_RESERVE, PAGE_NOACCESS );
+    ok( mem != NULL, "VirtualAlloc failed\n" );
+    tables = HeapAlloc( GetProcessHeap(), 0, count * sizeof(*tables) );
+    ok( tables != NULL, "HeapAlloc failed\n" );
+    if (!mem || !tables)
+    {
+        HeapFree( GetProcessHeap(), 0, tables );
+        if (mem) VirtualFree( mem, 0, MEM_RELEASE );
+        return;
+    }
+
+    /* register one table per function, not in address order */
+    for (i = 0; i < count; i++)
+    {
+        j = (i * 1021) % count;
+        tables[j].BeginAddress = 0;
+        tables[j].EndAddress   = func_size;
+        tables[j].UnwindData   = 0;
+        ok( pRtlAddFunctionTable( &tables[j], 1, (ULONG_PTR)mem + j * func_size ),
+            "RtlAddFunctionTable failed for table %u\n", j );
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        base = 0xdeadbeef;
+        func = pRtlLookupFunctionEntry( (ULONG_PTR)mem + i * func_size + 8, &base, NULL );
+        ok( func == &tables[i], "%u: got function %p, expected %p\n", i, func, &tables[i] );
+        ok( base == (ULONG_PTR)mem + i * func_size, "%u: got base %lx\n", i, base );
+        if (func != &tables[i]) break;
+    }
+
+    if (winetest_interactive) test_exception_throughput( count );
+
+    /* a removed table isn't found anymore, even right after a lookup */
+    ok( pRtlDeleteFunctionTable( &tables[0] ), "RtlDeleteFunctionTable failed\n" );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)mem + 8, &base, NULL );
+    ok( func == NULL, "got function %p\n", func );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)mem + func_size + 8, &base, NULL );
+    ok( func == &tables[1], "got function %p, expected %p\n", func, &tables[1] );
+
+    for (i = 1; i < count; i++)
+        ok( pRtlDeleteFunctionTable( &tables[i] ), "RtlDeleteFunctionTable failed for table %u\n", i );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)mem + func_size + 8, &base, NULL );
+    ok( func == NULL, "got function %p\n", func );
+
+    HeapFree( GetProcessHeap(), 0, tables );
+    VirtualFree( mem, 0, MEM_RELEASE );
+}
+
 static int termination_handler_called;
 static void WINAPI termination_handler(ULONG flags, ULONG64 frame)
 {
@@ -2746,7 +2875,10 @@ START_TEST(exception)
     test_restore_context();
 
     if (pRtlAddFunctionTable && pRtlDeleteFunctionTable && pRtlInstallFunctionTableCallback && pRtlLookupFunctionEntry)
+    {
       test_dynamic_unwind();
+      test_dynamic_unwind_lookup();
+    }
     else
       skip( "Dynamic unwind functions not found\n" );
 
@@ -1244,6 +1244,8 @@ static void test_file_all_information(void)
     ok ( res == STATUS_SUCCESS, "can't get attributes, res %x\n", res);
     ok ( (fai_buf.fai.BasicInformation.FileAttributes & FILE_ATTRIBUTE_ARCHIVE) == FILE_ATTRIBUTE_ARCHIVE,
          "attribute %x not expected\n", fai_buf.fai.BasicInformation.FileAttributes );
+    ok ( fai_buf.fai.AccessInformation.AccessFlags == 0x13019f,
+         "access %x not expected\n", fai_buf.fai.AccessInformation.AccessFlags );
 
     /* Then SYSTEM */
     /* Clear fbi to avoid setting times */
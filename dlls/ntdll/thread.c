@@ -415,6 +415,7 @@ void terminate_thread( int status )
     close( ntdll_get_thread_data()->wait_fd[1] );
     close( ntdll_get_thread_data()->reply_fd );
     close( ntdll_get_thread_data()->request_fd );
+    debug_exit_thread();
     pthread_exit( UIntToPtr(status) );
 }
 
@@ -464,6 +465,7 @@ void exit_thread( int status )
     close( ntdll_get_thread_data()->wait_fd[1] );
     close( ntdll_get_thread_data()->reply_fd );
     close( ntdll_get_thread_data()->request_fd );
+    debug_exit_thread();
     pthread_exit( UIntToPtr(status) );
 }
 
@@ -483,8 +485,10 @@ static void start_thread( struct startup_info *info )
 
     debug_info.str_pos = debug_info.strings;
     debug_info.out_pos = debug_info.output;
+    debug_info.ring    = NULL;
     thread_data->debug_info = &debug_info;
     thread_data->pthread_id = pthread_self();
+    thread_data->relay_profile = NULL;
 
     signal_init_thread( teb );
     server_init_thread( func );
@@ -66,6 +66,7 @@
 #include "moniker.h"
 
 #include "wine/unicode.h"
+#include "wine/rbtree.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(ole);
@@ -163,6 +164,9 @@ struct class_reg_data
         HKEY hkey;
     } u;
     BOOL hkey;
+    const WCHAR *cached_path;    /* server path from the class cache, used instead of hkey */
+    DWORD cached_type;           /* registry type of cached_path */
+    enum comclass_threadingmodel cached_model;  /* threading model from the class cache */
 };
 
 struct registered_psclsid
@@ -1409,7 +1413,16 @@ static DWORD COM_RegReadPath(const struct class_reg_data *regdata, WCHAR *dst, D
 	WCHAR src[MAX_PATH];
 	DWORD dwLength = dstlen * sizeof(WCHAR);
 
-        if( (ret = RegQueryValueExW(regdata->u.hkey, NULL, NULL, &keytype, (BYTE*)src, &dwLength)) == ERROR_SUCCESS ) {
+        if (regdata->cached_path)
+        {
+            keytype = regdata->cached_type;
+            lstrcpynW(src, regdata->cached_path, ARRAYSIZE(src));
+            ret = ERROR_SUCCESS;
+        }
+        else
+            ret = RegQueryValueExW(regdata->u.hkey, NULL, NULL, &keytype, (BYTE*)src, &dwLength);
+
+        if (ret == ERROR_SUCCESS) {
             if (keytype == REG_EXPAND_SZ) {
               if (dstlen <= ExpandEnvironmentStringsW(src, dst, dstlen)) ret = ERROR_MORE_DATA;
             } else {
@@ -2873,7 +2886,9 @@ HRESULT WINAPI CoRegisterClassObject(
 
 static enum comclass_threadingmodel get_threading_model(const struct class_reg_data *data)
 {
-    if (data->hkey)
+    if (data->hkey && data->cached_path)
+        return data->cached_model;
+    else if (data->hkey)
     {
         static const WCHAR wszThreadingModel[] = {'T','h','r','e','a','d','i','n','g','M','o','d','e','l',0};
         static const WCHAR wszApartment[] = {'A','p','a','r','t','m','e','n','t',0};
@@ -2900,6 +2915,217 @@ static enum comclass_threadingmodel get_threading_model(const struct class_reg_d
         return data->u.actctx.data->model;
 }
 
+/* Registry data used to activate classes is cached per process, HKCR\CLSID is
+ * watched for changes and the whole cache is flushed when anything below it
+ * changes. */
+
+#define CLASS_CACHE_MAX_ENTRIES 256
+
+enum class_cache_kind
+{
+    CLASS_CACHE_TREAT_AS,
+    CLASS_CACHE_INPROC_SERVER,
+    CLASS_CACHE_INPROC_HANDLER
+};
+
+struct class_cache_key
+{
+    CLSID clsid;
+    enum class_cache_kind kind;
+};
+
+struct class_cache_data
+{
+    HRESULT hr;                          /* result of opening the key of the class */
+    CLSID treat_as;                      /* emulating class for CLASS_CACHE_TREAT_AS */
+    enum comclass_threadingmodel model;  /* threading model of the server */
+    DWORD type;                          /* registry type of the server path */
+    WCHAR path[MAX_PATH];                /* server path, not expanded */
+};
+
+struct class_cache_entry
+{
+    struct wine_rb_entry entry;
+    struct class_cache_key key;
+    struct class_cache_data data;
+};
+
+static int class_cache_compare(const void *key, const struct wine_rb_entry *entry)
+{
+    const struct class_cache_key *k = key;
+    const struct class_cache_entry *cached = WINE_RB_ENTRY_VALUE(entry, const struct class_cache_entry, entry);
+
+    if (k->kind != cached->key.kind) return k->kind < cached->key.kind ? -1 : 1;
+    return memcmp(&k->clsid, &cached->key.clsid, sizeof(k->clsid));
+}
+
+static struct wine_rb_tree class_cache = { class_cache_compare };
+static unsigned int class_cache_count;       /* protected by csClassCache */
+static unsigned int class_cache_generation;  /* protected by csClassCache */
+static HKEY class_cache_hkey;                /* HKCR\CLSID, watched for changes */
+static HANDLE class_cache_event;             /* signaled when HKCR\CLSID changes */
+static BOOL class_cache_disabled;
+
+static CRITICAL_SECTION csClassCache;
+static CRITICAL_SECTION_DEBUG class_cache_cs_debug =
+{
+    0, 0, &csClassCache,
+    { &class_cache_cs_debug.ProcessLocksList, &class_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": csClassCache") }
+};
+static CRITICAL_SECTION csClassCache = { &class_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static void class_cache_free_entry(struct wine_rb_entry *entry, void *context)
+{
+    HeapFree(GetProcessHeap(), 0, WINE_RB_ENTRY_VALUE(entry, struct class_cache_entry, entry));
+}
+
+static void class_cache_flush(void)
+{
+    wine_rb_clear(&class_cache, class_cache_free_entry, NULL);
+    class_cache_count = 0;
+    class_cache_generation++;
+}
+
+static BOOL class_cache_watch(void)
+{
+    return !RegNotifyChangeKeyValue(class_cache_hkey, TRUE, REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET,
+                                    class_cache_event, TRUE);
+}
+
+/* starts watching the registry or flushes the cache if it changed, returns
+ * whether the cache can be used; must be called with csClassCache held */
+static BOOL class_cache_check(void)
+{
+    static const WCHAR clsidW[] = {'C','L','S','I','D',0};
+
+    if (class_cache_disabled) return FALSE;
+
+    if (!class_cache_event)
+    {
+        if (open_classes_key(HKEY_CLASSES_ROOT, clsidW, KEY_NOTIFY, &class_cache_hkey) ||
+            !(class_cache_event = CreateEventW(NULL, FALSE, FALSE, NULL)) ||
+            !class_cache_watch())
+        {
+            WARN("cannot watch the registry, not caching class data\n");
+            class_cache_disabled = TRUE;
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    if (WaitForSingleObject(class_cache_event, 0) != WAIT_OBJECT_0) return TRUE;
+
+    /* watch again before flushing so that no change can be missed */
+    TRACE("registry changed, flushing the class cache\n");
+    if (!class_cache_watch()) class_cache_disabled = TRUE;
+    class_cache_flush();
+    return !class_cache_disabled;
+}
+
+/* looks up the cached data of a class; on a miss the returned generation has
+ * to be passed to class_cache_put() once the registry has been read */
+static BOOL class_cache_get(REFCLSID clsid, enum class_cache_kind kind,
+                            struct class_cache_data *data, unsigned int *generation)
+{
+    struct class_cache_key key;
+    struct wine_rb_entry *entry;
+    BOOL ret = FALSE;
+
+    key.clsid = *clsid;
+    key.kind = kind;
+
+    EnterCriticalSection(&csClassCache);
+    if (class_cache_check() && (entry = wine_rb_get(&class_cache, &key)))
+    {
+        *data = WINE_RB_ENTRY_VALUE(entry, struct class_cache_entry, entry)->data;
+        ret = TRUE;
+    }
+    *generation = class_cache_generation;
+    LeaveCriticalSection(&csClassCache);
+    return ret;
+}
+
+static void class_cache_put(REFCLSID clsid, enum class_cache_kind kind,
+                            const struct class_cache_data *data, unsigned int generation)
+{
+    struct class_cache_entry *cached;
+
+    EnterCriticalSection(&csClassCache);
+
+    /* don't cache data read before the last change of the registry */
+    if (!class_cache_check() || generation != class_cache_generation)
+    {
+        LeaveCriticalSection(&csClassCache);
+        return;
+    }
+
+    if (class_cache_count >= CLASS_CACHE_MAX_ENTRIES) class_cache_flush();
+
+    if ((cached = HeapAlloc(GetProcessHeap(), 0, sizeof(*cached))))
+    {
+        cached->key.clsid = *clsid;
+        cached->key.kind = kind;
+        cached->data = *data;
+        if (wine_rb_put(&class_cache, &cached->key, &cached->entry) == -1)
+            HeapFree(GetProcessHeap(), 0, cached);
+        else
+            class_cache_count++;
+    }
+
+    LeaveCriticalSection(&csClassCache);
+}
+
+static void class_cache_free(void)
+{
+    wine_rb_destroy(&class_cache, class_cache_free_entry, NULL);
+    if (class_cache_hkey) RegCloseKey(class_cache_hkey);
+    if (class_cache_event) CloseHandle(class_cache_event);
+    DeleteCriticalSection(&csClassCache);
+}
+
+/* opens the InprocServer32 or InprocHandler32 key of a class, or gets its
+ * data from the cache; regdata->u.hkey has to be closed if it is set */
+static HRESULT open_inproc_server(REFCLSID clsid, enum class_cache_kind kind, const WCHAR *keyname,
+                                  struct class_reg_data *regdata, struct class_cache_data *data)
+{
+    unsigned int generation;
+    DWORD len, ret;
+    HKEY hkey;
+
+    regdata->u.hkey = NULL;
+    regdata->hkey = TRUE;
+    regdata->cached_path = NULL;
+
+    if (!class_cache_get(clsid, kind, data, &generation))
+    {
+        data->hr = COM_OpenKeyForCLSID(clsid, keyname, KEY_READ, &hkey);
+        if (SUCCEEDED(data->hr))
+        {
+            regdata->u.hkey = hkey;
+            len = sizeof(data->path) - sizeof(WCHAR);
+            ret = RegQueryValueExW(hkey, NULL, NULL, &data->type, (BYTE *)data->path, &len);
+
+            /* let the caller report the error */
+            if (ret != ERROR_SUCCESS) return data->hr;
+
+            data->path[len / sizeof(WCHAR)] = 0;
+            data->model = get_threading_model(regdata);
+            RegCloseKey(hkey);
+            regdata->u.hkey = NULL;
+        }
+        class_cache_put(clsid, kind, data, generation);
+    }
+
+    if (SUCCEEDED(data->hr))
+    {
+        regdata->cached_path = data->path;
+        regdata->cached_type = data->type;
+        regdata->cached_model = data->model;
+    }
+    return data->hr;
+}
+
 static HRESULT get_inproc_class_object(APARTMENT *apt, const struct class_reg_data *regdata,
                                        REFCLSID rclsid, REFIID riid,
                                        BOOL hostifnecessary, void **ppv)
@@ -3068,9 +3294,9 @@ HRESULT WINAPI DECLSPEC_HOTPATCH CoGetClassObject(
     if (CLSCTX_INPROC_SERVER & dwClsContext)
     {
         static const WCHAR wszInprocServer32[] = {'I','n','p','r','o','c','S','e','r','v','e','r','3','2',0};
-        HKEY hkey;
+        struct class_cache_data data;
 
-        hres = COM_OpenKeyForCLSID(rclsid, wszInprocServer32, KEY_READ, &hkey);
+        hres = open_inproc_server(rclsid, CLASS_CACHE_INPROC_SERVER, wszInprocServer32, &clsreg, &data);
         if (FAILED(hres))
         {
             if (hres == REGDB_E_CLASSNOTREG)
@@ -3084,11 +3310,8 @@ HRESULT WINAPI DECLSPEC_HOTPATCH CoGetClassObject(
 
         if (SUCCEEDED(hres))
         {
-            clsreg.u.hkey = hkey;
-            clsreg.hkey = TRUE;
-
             hres = get_inproc_class_object(apt, &clsreg, rclsid, iid, !(dwClsContext & WINE_CLSCTX_DONT_HOST), ppv);
-            RegCloseKey(hkey);
+            if (clsreg.u.hkey) RegCloseKey(clsreg.u.hkey);
         }
 
         /* return if we got a class, otherwise fall through to one of the
@@ -3104,9 +3327,9 @@ HRESULT WINAPI DECLSPEC_HOTPATCH CoGetClassObject(
     if (CLSCTX_INPROC_HANDLER & dwClsContext)
     {
         static const WCHAR wszInprocHandler32[] = {'I','n','p','r','o','c','H','a','n','d','l','e','r','3','2',0};
-        HKEY hkey;
+        struct class_cache_data data;
 
-        hres = COM_OpenKeyForCLSID(rclsid, wszInprocHandler32, KEY_READ, &hkey);
+        hres = open_inproc_server(rclsid, CLASS_CACHE_INPROC_HANDLER, wszInprocHandler32, &clsreg, &data);
         if (FAILED(hres))
         {
             if (hres == REGDB_E_CLASSNOTREG)
@@ -3120,11 +3343,8 @@ HRESULT WINAPI DECLSPEC_HOTPATCH CoGetClassObject(
 
         if (SUCCEEDED(hres))
         {
-            clsreg.u.hkey = hkey;
-            clsreg.hkey = TRUE;
-
             hres = get_inproc_class_object(apt, &clsreg, rclsid, iid, !(dwClsContext & WINE_CLSCTX_DONT_HOST), ppv);
-            RegCloseKey(hkey);
+            if (clsreg.u.hkey) RegCloseKey(clsreg.u.hkey);
         }
 
         /* return if we got a class, otherwise fall through to one of the
@@ -3843,12 +4063,20 @@ HRESULT WINAPI CoGetTreatAsClass(REFCLSID clsidOld, LPCLSID clsidNew)
     WCHAR szClsidNew[CHARS_IN_GUID];
     HRESULT res = S_OK;
     LONG len = sizeof(szClsidNew);
+    struct class_cache_data data;
+    unsigned int generation;
 
     TRACE("(%s,%p)\n", debugstr_guid(clsidOld), clsidNew);
 
     if (!clsidOld || !clsidNew)
         return E_INVALIDARG;
 
+    if (class_cache_get(clsidOld, CLASS_CACHE_TREAT_AS, &data, &generation))
+    {
+        *clsidNew = data.treat_as;
+        return data.hr;
+    }
+
     *clsidNew = *clsidOld; /* copy over old value */
 
     res = COM_OpenKeyForCLSID(clsidOld, wszTreatAs, KEY_READ, &hkey);
@@ -3867,6 +4095,9 @@ HRESULT WINAPI CoGetTreatAsClass(REFCLSID clsidOld, LPCLSID clsidNew)
         ERR("Failed CLSIDFromStringA(%s), hres 0x%08x\n", debugstr_w(szClsidNew), res);
 done:
     if (hkey) RegCloseKey(hkey);
+    data.hr = res;
+    data.treat_as = *clsidNew;
+    class_cache_put(clsidOld, CLASS_CACHE_TREAT_AS, &data, generation);
     return res;
 }
 
@@ -5051,6 +5282,7 @@ HRESULT Handler_DllGetClassObject(REFCLSID rclsid, REFIID riid, LPVOID *ppv)
 
         regdata.u.hkey = hkey;
         regdata.hkey = TRUE;
+        regdata.cached_path = NULL;
 
         if (COM_RegReadPath(&regdata, dllpath, ARRAYSIZE(dllpath)) == ERROR_SUCCESS)
         {
@@ -5232,6 +5464,7 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID reserved)
         UnregisterClassW( wszAptWinClass, hProxyDll );
         RPC_UnregisterAllChannelHooks();
         COMPOBJ_DllList_Free();
+        class_cache_free();
         DeleteCriticalSection(&csRegisteredClassList);
         DeleteCriticalSection(&csApartment);
 	break;
@@ -2313,6 +2313,74 @@ exit:
     RegCloseKey(clsidkey);
 }
 
+static void test_class_registration_changes(void)
+{
+    static GUID deadbeef = {0xdeadbeef,0xdead,0xbeef,{0xde,0xad,0xbe,0xef,0xde,0xad,0xbe,0xef}};
+    static const char deadbeefA[] = "CLSID\\{DEADBEEF-DEAD-BEEF-DEAD-BEEFDEADBEEF}";
+    static const char dllA[] = "kernel32.dll";
+    IUnknown *unk;
+    HKEY classkey, serverkey;
+    DWORD start, count;
+    HRESULT hr;
+    LONG lr;
+
+    CoInitialize(NULL);
+
+    /* results are not cached across registry changes */
+    hr = CoGetClassObject(&deadbeef, CLSCTX_INPROC_SERVER, NULL, &IID_IClassFactory, (void **)&unk);
+    ok(hr == REGDB_E_CLASSNOTREG, "got 0x%08x\n", hr);
+
+    lr = RegCreateKeyExA(HKEY_CLASSES_ROOT, deadbeefA, 0, NULL, 0, KEY_ALL_ACCESS, NULL, &classkey, NULL);
+    if (lr)
+    {
+        skip("failed to create the class key, error %d\n", lr);
+        CoUninitialize();
+        return;
+    }
+    lr = RegCreateKeyExA(classkey, "InprocServer32", 0, NULL, 0, KEY_ALL_ACCESS, NULL, &serverkey, NULL);
+    ok(!lr, "RegCreateKeyEx returned %d\n", lr);
+    lr = RegSetValueExA(serverkey, NULL, 0, REG_SZ, (const BYTE *)dllA, sizeof(dllA));
+    ok(!lr, "RegSetValueEx returned %d\n", lr);
+    RegCloseKey(serverkey);
+
+    /* kernel32 doesn't export DllGetClassObject */
+    unk = (void *)0xdeadbeef;
+    hr = CoGetClassObject(&deadbeef, CLSCTX_INPROC_SERVER, NULL, &IID_IClassFactory, (void **)&unk);
+    ok(hr != REGDB_E_CLASSNOTREG && FAILED(hr), "got 0x%08x\n", hr);
+    ok(!unk, "got %p\n", unk);
+
+    lr = RegDeleteKeyA(classkey, "InprocServer32");
+    ok(!lr, "RegDeleteKey returned %d\n", lr);
+
+    hr = CoGetClassObject(&deadbeef, CLSCTX_INPROC_SERVER, NULL, &IID_IClassFactory, (void **)&unk);
+    ok(hr == REGDB_E_CLASSNOTREG, "got 0x%08x\n", hr);
+
+    RegCloseKey(classkey);
+    RegDeleteKeyA(HKEY_CLASSES_ROOT, deadbeefA);
+
+    /* repeated activations of a registered class */
+    hr = CoCreateInstance(&CLSID_InternetZoneManager, NULL, CLSCTX_INPROC_SERVER, &IID_IUnknown, (void **)&unk);
+    if (FAILED(hr))
+    {
+        skip("zone manager not available, hr 0x%08x\n", hr);
+        CoUninitialize();
+        return;
+    }
+    IUnknown_Release(unk);
+
+    start = GetTickCount();
+    for (count = 0; count < 1000; count++)
+    {
+        hr = CoCreateInstance(&CLSID_InternetZoneManager, NULL, CLSCTX_INPROC_SERVER, &IID_IUnknown, (void **)&unk);
+        if (FAILED(hr)) break;
+        IUnknown_Release(unk);
+    }
+    ok(count == 1000, "activation %u failed, hr 0x%08x\n", count, hr);
+    trace("%u activations in %u ms\n", count, GetTickCount() - start);
+
+    CoUninitialize();
+}
+
 static void test_CoInitializeEx(void)
 {
     HRESULT hr;
@@ -3718,6 +3786,7 @@ START_TEST(compobj)
     test_CoGetCallContext();
     test_CoGetContextToken();
     test_TreatAsClass();
+    test_class_registration_changes();
     test_CoInitializeEx();
     test_OleInitialize_InitCounting();
     test_OleRegGetMiscStatus();
@@ -5453,6 +5453,155 @@ todo_wine {
     ITypeLib_Release(tl);
 }
 
+static void test_name_binding(void)
+{
+    static WCHAR underlineW[] = {'U','n','d','e','r','l','i','n','e',0};
+    static WCHAR underline_lowerW[] = {'u','n','d','e','r','l','i','n','e',0};
+    static WCHAR addrefW[] = {'a','d','d','r','e','f',0};
+    static WCHAR bogusW[] = {'b','o','g','u','s',0};
+    OLECHAR *name;
+    ITypeInfo *typeinfo, *bound;
+    ITypeComp *typecomp;
+    DESCKIND desckind;
+    BINDPTR bindptr;
+    MEMBERID memid, memid2;
+    ITypeLib *typelib;
+    HRESULT hr;
+
+    hr = LoadTypeLib(wszStdOle2, &typelib);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    hr = ITypeLib_GetTypeInfoOfGuid(typelib, &IID_IFont, &typeinfo);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    hr = ITypeInfo_GetTypeComp(typeinfo, &typecomp);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    /* lookups are case-insensitive and search the inherited interfaces */
+    name = underlineW;
+    hr = ITypeInfo_GetIDsOfNames(typeinfo, &name, 1, &memid);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    name = underline_lowerW;
+    hr = ITypeInfo_GetIDsOfNames(typeinfo, &name, 1, &memid2);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(memid == memid2, "got %d and %d\n", memid, memid2);
+
+    name = addrefW;
+    hr = ITypeInfo_GetIDsOfNames(typeinfo, &name, 1, &memid);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    name = bogusW;
+    hr = ITypeInfo_GetIDsOfNames(typeinfo, &name, 1, &memid);
+    ok(hr == DISP_E_UNKNOWNNAME, "got 0x%08x\n", hr);
+
+    hr = ITypeComp_Bind(typecomp, underline_lowerW, 0, INVOKE_PROPERTYPUT, &bound, &desckind, &bindptr);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(desckind == DESCKIND_FUNCDESC, "got %d\n", desckind);
+    if (desckind == DESCKIND_FUNCDESC)
+    {
+        ok(bindptr.lpfuncdesc->invkind == INVOKE_PROPERTYPUT, "got %d\n", bindptr.lpfuncdesc->invkind);
+        ITypeInfo_ReleaseFuncDesc(bound, bindptr.lpfuncdesc);
+        ITypeInfo_Release(bound);
+    }
+
+    ITypeComp_Release(typecomp);
+    ITypeInfo_Release(typeinfo);
+    ITypeLib_Release(typelib);
+}
+
+static void test_name_index_rename(void)
+{
+    static OLECHAR dispW[] = {'d','i','s','p',0};
+    static OLECHAR func3W[] = {'f','u','n','c','3',0};
+    static OLECHAR newfuncW[] = {'n','e','w','f','u','n','c',0};
+    static OLECHAR newfunc_upperW[] = {'N','E','W','F','U','N','C',0};
+    static OLECHAR oldvarW[] = {'o','l','d','v','a','r',0};
+    static OLECHAR newvarW[] = {'n','e','w','v','a','r',0};
+    CHAR filenameA[MAX_PATH], nameA[16];
+    WCHAR filenameW[MAX_PATH], nameW[16];
+    ICreateTypeLib2 *ctl;
+    ICreateTypeInfo *cti;
+    ITypeInfo *ti;
+    FUNCDESC funcdesc;
+    VARDESC vardesc;
+    MEMBERID memid;
+    OLECHAR *name;
+    HRESULT hr;
+    UINT i;
+
+    GetTempFileNameA(".", "tlb", 0, filenameA);
+    MultiByteToWideChar(CP_ACP, 0, filenameA, -1, filenameW, MAX_PATH);
+
+    hr = CreateTypeLib2(SYS_WIN32, filenameW, &ctl);
+    ok(hr == S_OK, "got %08x\n", hr);
+
+    hr = ICreateTypeLib2_CreateTypeInfo(ctl, dispW, TKIND_DISPATCH, &cti);
+    ok(hr == S_OK, "got %08x\n", hr);
+
+    /* enough members for the names to be looked up through a hash index */
+    memset(&funcdesc, 0, sizeof(funcdesc));
+    funcdesc.funckind = FUNC_DISPATCH;
+    funcdesc.invkind = INVOKE_FUNC;
+    funcdesc.callconv = CC_STDCALL;
+    funcdesc.elemdescFunc.tdesc.vt = VT_VOID;
+    for (i = 0; i < 8; i++)
+    {
+        funcdesc.memid = 0x100 + i;
+        hr = ICreateTypeInfo_AddFuncDesc(cti, i, &funcdesc);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+        sprintf(nameA, "func%u", i);
+        MultiByteToWideChar(CP_ACP, 0, nameA, -1, nameW, sizeof(nameW)/sizeof(nameW[0]));
+        name = nameW;
+        hr = ICreateTypeInfo_SetFuncAndParamNames(cti, i, &name, 1);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+    }
+
+    memset(&vardesc, 0, sizeof(vardesc));
+    vardesc.memid = 0x200;
+    vardesc.varkind = VAR_DISPATCH;
+    vardesc.elemdescVar.tdesc.vt = VT_INT;
+    hr = ICreateTypeInfo_AddVarDesc(cti, 0, &vardesc);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    hr = ICreateTypeInfo_SetVarName(cti, 0, oldvarW);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    hr = ICreateTypeInfo_QueryInterface(cti, &IID_ITypeInfo, (void **)&ti);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    name = func3W;
+    hr = ITypeInfo_GetIDsOfNames(ti, &name, 1, &memid);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(memid == 0x103, "got %x\n", memid);
+    name = oldvarW;
+    hr = ITypeInfo_GetIDsOfNames(ti, &name, 1, &memid);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(memid == 0x200, "got %x\n", memid);
+
+    /* renamed members are found under their new name only */
+    name = newfuncW;
+    hr = ICreateTypeInfo_SetFuncAndParamNames(cti, 3, &name, 1);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    name = func3W;
+    hr = ITypeInfo_GetIDsOfNames(ti, &name, 1, &memid);
+    ok(hr == DISP_E_UNKNOWNNAME, "got 0x%08x\n", hr);
+    name = newfunc_upperW;
+    hr = ITypeInfo_GetIDsOfNames(ti, &name, 1, &memid);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(memid == 0x103, "got %x\n", memid);
+
+    hr = ICreateTypeInfo_SetVarName(cti, 0, newvarW);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    name = oldvarW;
+    hr = ITypeInfo_GetIDsOfNames(ti, &name, 1, &memid);
+    ok(hr == DISP_E_UNKNOWNNAME, "got 0x%08x\n", hr);
+    name = newvarW;
+    hr = ITypeInfo_GetIDsOfNames(ti, &name, 1, &memid);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(memid == 0x200, "got %x\n", memid);
+
+    ITypeInfo_Release(ti);
+    ICreateTypeInfo_Release(cti);
+    ICreateTypeLib2_Release(ctl);
+    DeleteFileA(filenameA);
+}
+
 static void test_TypeInfo2_GetContainingTypeLib(void)
 {
     static const WCHAR test[] = {'t','e','s','t','.','t','l','b',0};
@@ -6293,6 +6442,8 @@ START_TEST(typelib)
     test_SetFuncAndParamNames();
     test_SetDocString();
     test_FindName();
+    test_name_binding();
+    test_name_index_rename();
 
     if ((filename = create_test_typelib(2)))
     {
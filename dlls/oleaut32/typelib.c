@@ -1263,6 +1263,8 @@ typedef struct tagITypeInfoImpl
 
     struct list *pcustdata_list;
     struct list custdata_list;
+
+    struct tlb_name_index *name_index;  /* hash index of the member names, built on first use */
 } ITypeInfoImpl;
 
 static inline ITypeInfoImpl *info_impl_from_ITypeComp( ITypeComp *iface )
@@ -1702,16 +1704,123 @@ static inline TLBVarDesc *TLB_get_vardesc_by_memberid(TLBVarDesc *vardescs,
     return NULL;
 }
 
-static inline TLBVarDesc *TLB_get_vardesc_by_name(TLBVarDesc *vardescs,
-        UINT n, const OLECHAR *name)
+/* case-insensitive hash index of the function and variable names of a typeinfo,
+ * the functions are numbered first and each bucket is sorted by number */
+struct tlb_name_index
 {
-    while(n){
-        if(!lstrcmpiW(TLB_get_bstr(vardescs->Name), name))
-            return vardescs;
-        ++vardescs;
-        --n;
+    UINT bucket_mask;
+    UINT *buckets;  /* first member of each bucket + 1, 0 if empty */
+    UINT *next;     /* next member in the same bucket + 1, 0 if none */
+    ULONG *hashes;
+};
+
+#define TLB_NAME_INDEX_MIN_MEMBERS 8
+
+/* used for typeinfos with few members or names that can't be hashed */
+static struct tlb_name_index no_name_index;
+
+/* only names made of identifier characters are hashed, lstrcmpiW may consider
+ * other strings equal even if they differ by more than the case */
+static BOOL TLB_hash_name(const OLECHAR *name, ULONG *hash)
+{
+    ULONG h = 0;
+    WCHAR c;
+
+    if (!name) return FALSE;
+    for (; *name; name++)
+    {
+        c = *name;
+        if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        else if (!(c >= 'A' && c <= 'Z') && !(c >= '0' && c <= '9') && c != '_') return FALSE;
+        h = h * 31 + c;
     }
-    return NULL;
+    *hash = h;
+    return TRUE;
+}
+
+static inline const TLBString *TLB_get_member_name(const ITypeInfoImpl *info, UINT i)
+{
+    if (i < info->typeattr.cFuncs) return info->funcdescs[i].Name;
+    return info->vardescs[i - info->typeattr.cFuncs].Name;
+}
+
+static const struct tlb_name_index *TLB_get_name_index(ITypeInfoImpl *info)
+{
+    UINT i, size, count = info->typeattr.cFuncs + info->typeattr.cVars;
+    struct tlb_name_index *index;
+    const TLBString *name;
+    ULONG hash;
+
+    if ((index = info->name_index)) return index;
+
+    if (count < TLB_NAME_INDEX_MIN_MEMBERS)
+        index = &no_name_index;
+    else
+    {
+        for (size = 16; size < count * 2; size <<= 1) ;
+        index = heap_alloc(sizeof(*index) + (size + 2 * count) * sizeof(UINT));
+        if (!index) return &no_name_index;
+        index->bucket_mask = size - 1;
+        index->buckets = (UINT *)(index + 1);
+        index->next = index->buckets + size;
+        index->hashes = (ULONG *)(index->next + count);
+        memset(index->buckets, 0, size * sizeof(UINT));
+
+        /* insert backwards so that the buckets end up sorted */
+        for (i = count; i--;)
+        {
+            index->next[i] = 0;
+            /* unnamed members only match NULL names, which are never hashed */
+            if (!(name = TLB_get_member_name(info, i))) continue;
+            if (!TLB_hash_name(name->str, &hash))
+            {
+                heap_free(index);
+                index = &no_name_index;
+                break;
+            }
+            index->hashes[i] = hash;
+            index->next[i] = index->buckets[hash & index->bucket_mask];
+            index->buckets[hash & index->bucket_mask] = i + 1;
+        }
+    }
+
+    if (InterlockedCompareExchangePointer((void **)&info->name_index, index, NULL))
+    {
+        if (index != &no_name_index) heap_free(index);
+        index = info->name_index;
+    }
+    return index;
+}
+
+static void TLB_free_name_index(ITypeInfoImpl *info)
+{
+    if (info->name_index != &no_name_index) heap_free(info->name_index);
+    info->name_index = NULL;
+}
+
+/* returns the number of the next function or variable after pos whose name matches
+ * case-insensitively, functions coming first; pos is -1 to start from the first
+ * member and -1 is returned when there are no more matches */
+static int TLB_find_member_by_name(ITypeInfoImpl *info, const OLECHAR *name, int pos)
+{
+    UINT i, count = info->typeattr.cFuncs + info->typeattr.cVars;
+    const struct tlb_name_index *index = TLB_get_name_index(info);
+    ULONG hash;
+
+    if (index != &no_name_index && TLB_hash_name(name, &hash))
+    {
+        i = pos < 0 ? index->buckets[hash & index->bucket_mask] : index->next[pos];
+        for (; i; i = index->next[i - 1])
+            if (index->hashes[i - 1] == hash &&
+                !lstrcmpiW(TLB_get_bstr(TLB_get_member_name(info, i - 1)), name))
+                return i - 1;
+        return -1;
+    }
+
+    for (i = pos + 1; i < count; i++)
+        if (!lstrcmpiW(TLB_get_bstr(TLB_get_member_name(info, i)), name))
+            return i;
+    return -1;
 }
 
 static inline TLBCustData *TLB_get_custdata_by_guid(struct list *custdata_list, REFGUID guid)
@@ -5097,16 +5206,18 @@ static HRESULT WINAPI ITypeLib2_fnFindName(
     len = (lstrlenW(name) + 1)*sizeof(WCHAR);
     for(tic = 0; count < *found && tic < This->TypeInfoCount; ++tic) {
         ITypeInfoImpl *pTInfo = This->typeinfos[tic];
-        TLBVarDesc *var;
-        UINT fdc;
+        int member;
 
         if(!TLB_str_memcmp(name, pTInfo->Name, len)) {
             memid[count] = MEMBERID_NIL;
             goto ITypeLib2_fnFindName_exit;
         }
 
-        for(fdc = 0; fdc < pTInfo->typeattr.cFuncs; ++fdc) {
-            TLBFuncDesc *func = &pTInfo->funcdescs[fdc];
+        /* function names are compared case-sensitively, variable names are not */
+        for(member = TLB_find_member_by_name(pTInfo, name, -1);
+            member >= 0 && member < pTInfo->typeattr.cFuncs;
+            member = TLB_find_member_by_name(pTInfo, name, member)) {
+            TLBFuncDesc *func = &pTInfo->funcdescs[member];
 
             if(!TLB_str_memcmp(name, func->Name, len)) {
                 memid[count] = func->funcdesc.memid;
@@ -5114,9 +5225,8 @@ static HRESULT WINAPI ITypeLib2_fnFindName(
             }
         }
 
-        var = TLB_get_vardesc_by_name(pTInfo->vardescs, pTInfo->typeattr.cVars, name);
-        if (var) {
-            memid[count] = var->vardesc.memid;
+        if (member >= 0) {
+            memid[count] = pTInfo->vardescs[member - pTInfo->typeattr.cFuncs].vardesc.memid;
             goto ITypeLib2_fnFindName_exit;
         }
 
@@ -5633,6 +5743,7 @@ static void ITypeInfoImpl_Destroy(ITypeInfoImpl *This)
     }
 
     TLB_FreeCustData(&This->custdata_list);
+    TLB_free_name_index(This);
 
     heap_free(This);
 }
@@ -5651,7 +5762,10 @@ static ULONG WINAPI ITypeInfo_fnRelease(ITypeInfo2 *iface)
         BOOL not_attached_to_typelib = This->not_attached_to_typelib;
         ITypeLib2_Release(&This->pTypeLib->ITypeLib2_iface);
         if (not_attached_to_typelib)
+        {
+            TLB_free_name_index(This);
             heap_free(This);
+        }
         /* otherwise This will be freed when typelib is freed */
     }
 
@@ -6253,7 +6367,8 @@ static HRESULT WINAPI ITypeInfo_fnGetIDsOfNames( ITypeInfo2 *iface,
     ITypeInfoImpl *This = impl_from_ITypeInfo2(iface);
     const TLBVarDesc *pVDesc;
     HRESULT ret=S_OK;
-    UINT i, fdc;
+    UINT i;
+    int member;
 
     TRACE("(%p) Name %s cNames %d\n", This, debugstr_w(*rgszNames),
             cNames);
@@ -6262,26 +6377,25 @@ static HRESULT WINAPI ITypeInfo_fnGetIDsOfNames( ITypeInfo2 *iface,
     for (i = 0; i < cNames; i++)
         pMemId[i] = MEMBERID_NIL;
 
-    for (fdc = 0; fdc < This->typeattr.cFuncs; ++fdc) {
+    member = TLB_find_member_by_name(This, *rgszNames, -1);
+    if (member >= 0 && member < This->typeattr.cFuncs) {
         int j;
-        const TLBFuncDesc *pFDesc = &This->funcdescs[fdc];
-        if(!lstrcmpiW(*rgszNames, TLB_get_bstr(pFDesc->Name))) {
-            if(cNames) *pMemId=pFDesc->funcdesc.memid;
-            for(i=1; i < cNames; i++){
-                for(j=0; j<pFDesc->funcdesc.cParams; j++)
-                    if(!lstrcmpiW(rgszNames[i],TLB_get_bstr(pFDesc->pParamDesc[j].Name)))
-                            break;
-                if( j<pFDesc->funcdesc.cParams)
-                    pMemId[i]=j;
-                else
-                   ret=DISP_E_UNKNOWNNAME;
-            };
-            TRACE("-- 0x%08x\n", ret);
-            return ret;
-        }
+        const TLBFuncDesc *pFDesc = &This->funcdescs[member];
+        if(cNames) *pMemId=pFDesc->funcdesc.memid;
+        for(i=1; i < cNames; i++){
+            for(j=0; j<pFDesc->funcdesc.cParams; j++)
+                if(!lstrcmpiW(rgszNames[i],TLB_get_bstr(pFDesc->pParamDesc[j].Name)))
+                        break;
+            if( j<pFDesc->funcdesc.cParams)
+                pMemId[i]=j;
+            else
+               ret=DISP_E_UNKNOWNNAME;
+        };
+        TRACE("-- 0x%08x\n", ret);
+        return ret;
     }
-    pVDesc = TLB_get_vardesc_by_name(This->vardescs, This->typeattr.cVars, *rgszNames);
-    if(pVDesc){
+    if(member >= 0){
+        pVDesc = &This->vardescs[member - This->typeattr.cFuncs];
         if(cNames)
             *pMemId = pVDesc->vardesc.memid;
         return ret;
@@ -7584,6 +7698,7 @@ static HRESULT WINAPI ITypeInfo_fnGetRefTypeInfo(
 
         *pTypeInfoImpl = *This;
         pTypeInfoImpl->ref = 0;
+        pTypeInfoImpl->name_index = NULL;
         list_init(&pTypeInfoImpl->custdata_list);
 
         if (This->typeattr.typekind == TKIND_INTERFACE)
@@ -8484,7 +8599,7 @@ static HRESULT WINAPI ITypeComp_fnBind(
     const TLBFuncDesc *pFDesc;
     const TLBVarDesc *pVDesc;
     HRESULT hr = DISP_E_MEMBERNOTFOUND;
-    UINT fdc;
+    int member;
 
     TRACE("(%p)->(%s, %x, 0x%x, %p, %p, %p)\n", This, debugstr_w(szName), lHash, wFlags, ppTInfo, pDescKind, pBindPtr);
 
@@ -8492,18 +8607,18 @@ static HRESULT WINAPI ITypeComp_fnBind(
     pBindPtr->lpfuncdesc = NULL;
     *ppTInfo = NULL;
 
-    for(fdc = 0; fdc < This->typeattr.cFuncs; ++fdc){
-        pFDesc = &This->funcdescs[fdc];
-        if (!lstrcmpiW(TLB_get_bstr(pFDesc->Name), szName)) {
-            if (!wFlags || (pFDesc->funcdesc.invkind & wFlags))
-                break;
-            else
-                /* name found, but wrong flags */
-                hr = TYPE_E_TYPEMISMATCH;
-        }
+    for(member = TLB_find_member_by_name(This, szName, -1);
+        member >= 0 && member < This->typeattr.cFuncs;
+        member = TLB_find_member_by_name(This, szName, member)){
+        pFDesc = &This->funcdescs[member];
+        if (!wFlags || (pFDesc->funcdesc.invkind & wFlags))
+            break;
+        else
+            /* name found, but wrong flags */
+            hr = TYPE_E_TYPEMISMATCH;
     }
 
-    if (fdc < This->typeattr.cFuncs)
+    if (member >= 0 && member < This->typeattr.cFuncs)
     {
         HRESULT hr = TLB_AllocAndInitFuncDesc(
             &pFDesc->funcdesc,
@@ -8516,9 +8631,11 @@ static HRESULT WINAPI ITypeComp_fnBind(
         ITypeInfo_AddRef(*ppTInfo);
         return S_OK;
     } else {
-        pVDesc = TLB_get_vardesc_by_name(This->vardescs, This->typeattr.cVars, szName);
-        if(pVDesc){
-            HRESULT hr = TLB_AllocAndInitVarDesc(&pVDesc->vardesc, &pBindPtr->lpvardesc);
+        /* the first match after the functions is the first variable with that name */
+        if(member >= 0){
+            HRESULT hr;
+            pVDesc = &This->vardescs[member - This->typeattr.cFuncs];
+            hr = TLB_AllocAndInitVarDesc(&pVDesc->vardesc, &pBindPtr->lpvardesc);
             if (FAILED(hr))
                 return hr;
             *pDescKind = DESCKIND_VARDESC;
@@ -10483,6 +10600,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnAddFuncDesc(ICreateTypeInfo2 *iface,
     memcpy(func_desc, &tmp_func_desc, sizeof(tmp_func_desc));
     list_init(&func_desc->custdata_list);
 
+    TLB_free_name_index(This);
     ++This->typeattr.cFuncs;
 
     This->needs_layout = TRUE;
@@ -10653,6 +10771,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnAddVarDesc(ICreateTypeInfo2 *iface,
     TLB_AllocAndInitVarDesc(varDesc, &var_desc->vardesc_create);
     var_desc->vardesc = *var_desc->vardesc_create;
 
+    TLB_free_name_index(This);
     ++This->typeattr.cVars;
 
     This->needs_layout = TRUE;
@@ -10693,6 +10812,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnSetFuncAndParamNames(ICreateTypeInfo2 *
         }
     }
 
+    TLB_free_name_index(This);
     func_desc->Name = TLB_append_str(&This->pTypeLib->name_list, *names);
 
     for (i = 1; i < numNames; ++i) {
@@ -10716,6 +10836,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnSetVarName(ICreateTypeInfo2 *iface,
     if(index >= This->typeattr.cVars)
         return TYPE_E_ELEMENTNOTFOUND;
 
+    TLB_free_name_index(This);
     This->vardescs[index].Name = TLB_append_str(&This->pTypeLib->name_list, name);
     return S_OK;
 }
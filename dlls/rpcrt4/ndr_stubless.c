@@ -149,6 +149,223 @@ static inline void call_freer(PMIDL_STUB_MESSAGE pStubMsg, unsigned char *pMemor
     if (m) m(pStubMsg, pMemory, pFormat);
 }
 
+/* The parameters of -Oif procedures are resolved once into their type format and
+ * marshalling routines, and cached for the next calls. Base types and structures
+ * without pointers don't need to be interpreted and are directly copied to and
+ * from the buffer. */
+
+struct param_plan
+{
+    PFORMAT_STRING format;        /* type format of the parameter */
+    NDR_BUFFERSIZE sizer;
+    NDR_MARSHALL   marshaller;
+    NDR_UNMARSHALL unmarshaller;
+    unsigned short flat_size;     /* size of a type copied as is, 0 if it needs a routine */
+    unsigned char  flat_align;    /* buffer alignment of a type copied as is */
+    unsigned char  flat_struct;   /* the flat type is a structure */
+    unsigned char  deref;         /* the stack holds a pointer to the data */
+};
+
+struct proc_plan
+{
+    PFORMAT_STRING       types;   /* type formats of the stub descriptor */
+    const NDR_PARAM_OIF *params;  /* parameter descriptions in the procedure format */
+    unsigned int         count;
+    NDR_PARAM_OIF       *params_copy;  /* to detect another format loaded at the same address */
+    struct param_plan    plan[1];
+};
+
+#define PROC_PLAN_HASH_SIZE  1024
+#define PROC_PLAN_MAX_PROBES 8
+
+static struct proc_plan *proc_plans[PROC_PLAN_HASH_SIZE];
+
+/* size of the base types that are the same in memory and on the wire */
+static unsigned int flat_base_type_size(unsigned char fc)
+{
+    switch (fc)
+    {
+    case RPC_FC_BYTE:
+    case RPC_FC_CHAR:
+    case RPC_FC_SMALL:
+    case RPC_FC_USMALL:
+        return sizeof(UCHAR);
+    case RPC_FC_WCHAR:
+    case RPC_FC_SHORT:
+    case RPC_FC_USHORT:
+        return sizeof(USHORT);
+    case RPC_FC_LONG:
+    case RPC_FC_ULONG:
+    case RPC_FC_ERROR_STATUS_T:
+    case RPC_FC_ENUM32:
+        return sizeof(ULONG);
+    case RPC_FC_FLOAT:
+        return sizeof(float);
+    case RPC_FC_DOUBLE:
+        return sizeof(double);
+    case RPC_FC_HYPER:
+        return sizeof(ULONGLONG);
+    default:
+        return 0;
+    }
+}
+
+static struct proc_plan *build_proc_plan(PFORMAT_STRING types, const NDR_PARAM_OIF *params,
+                                         unsigned int count)
+{
+    struct proc_plan *plan;
+    unsigned int i, size = FIELD_OFFSET(struct proc_plan, plan[count]);
+
+    if (!(plan = HeapAlloc(GetProcessHeap(), 0, size + count * sizeof(*params)))) return NULL;
+    plan->types = types;
+    plan->params = params;
+    plan->count = count;
+    plan->params_copy = (NDR_PARAM_OIF *)((char *)plan + size);
+    memcpy(plan->params_copy, params, count * sizeof(*params));
+
+    for (i = 0; i < count; i++)
+    {
+        struct param_plan *param = &plan->plan[i];
+
+        param->flat_size = 0;
+        param->flat_align = 1;
+        param->flat_struct = FALSE;
+        if (params[i].attr.IsBasetype)
+        {
+            param->format = &plan->params_copy[i].u.type_format_char;
+            param->deref = params[i].attr.IsSimpleRef;
+            param->flat_size = param->flat_align = flat_base_type_size(param->format[0]);
+        }
+        else
+        {
+            param->format = &types[params[i].u.type_offset];
+            param->deref = !params[i].attr.IsByValue;
+            if (param->format[0] == RPC_FC_STRUCT)
+            {
+                param->flat_size = *(const WORD *)(param->format + 2);
+                param->flat_align = param->format[1] + 1;
+                param->flat_struct = TRUE;
+            }
+        }
+        param->sizer = NdrBufferSizer[param->format[0] & NDR_TABLE_MASK];
+        param->marshaller = NdrMarshaller[param->format[0] & NDR_TABLE_MASK];
+        param->unmarshaller = NdrUnmarshaller[param->format[0] & NDR_TABLE_MASK];
+
+        /* let the interpreter report unsupported types */
+        if (!param->sizer || !param->marshaller || !param->unmarshaller)
+        {
+            HeapFree(GetProcessHeap(), 0, plan);
+            return NULL;
+        }
+    }
+    return plan;
+}
+
+/* returns the cached plan of a procedure, or NULL to interpret the format string */
+static const struct proc_plan *get_proc_plan(const MIDL_STUB_MESSAGE *pStubMsg, PFORMAT_STRING pFormat,
+                                             unsigned int count)
+{
+    const NDR_PARAM_OIF *params = (const NDR_PARAM_OIF *)pFormat;
+    PFORMAT_STRING types = pStubMsg->StubDesc->pFormatTypes;
+    unsigned int i, hash = ((ULONG_PTR)params >> 2) % PROC_PLAN_HASH_SIZE;
+    struct proc_plan *plan, *new_plan = NULL;
+
+    for (i = 0; i < PROC_PLAN_MAX_PROBES; i++)
+    {
+        struct proc_plan **slot = &proc_plans[(hash + i) % PROC_PLAN_HASH_SIZE];
+
+        if (!(plan = *slot))
+        {
+            if (!new_plan && !(new_plan = build_proc_plan(types, params, count))) return NULL;
+            if (!(plan = InterlockedCompareExchangePointer((void **)slot, new_plan, NULL)))
+                return new_plan;
+        }
+        if (plan->params == params && plan->types == types && plan->count == count &&
+            !memcmp(plan->params_copy, params, count * sizeof(*params)))
+        {
+            HeapFree(GetProcessHeap(), 0, new_plan);
+            return plan;
+        }
+    }
+    HeapFree(GetProcessHeap(), 0, new_plan);
+    return NULL;
+}
+
+static inline void plan_buffer_size(PMIDL_STUB_MESSAGE pStubMsg, unsigned char *pMemory,
+                                    const struct param_plan *param)
+{
+    ULONG length;
+
+    if (param->deref) pMemory = *(unsigned char **)pMemory;
+    if (!param->flat_size)
+    {
+        param->sizer(pStubMsg, pMemory, param->format);
+        return;
+    }
+
+    length = (pStubMsg->BufferLength + param->flat_align - 1) & ~(param->flat_align - 1);
+    if (length + param->flat_size < length)
+    {
+        ERR("buffer length overflow - BufferLength = %u, size = %u\n", length, param->flat_size);
+        RpcRaiseException(RPC_X_BAD_STUB_DATA);
+    }
+    pStubMsg->BufferLength = length + param->flat_size;
+}
+
+static inline void plan_marshall(PMIDL_STUB_MESSAGE pStubMsg, unsigned char *pMemory,
+                                 const struct param_plan *param)
+{
+    ULONG_PTR mask = param->flat_align - 1;
+
+    if (param->deref) pMemory = *(unsigned char **)pMemory;
+    if (!param->flat_size)
+    {
+        param->marshaller(pStubMsg, pMemory, param->format);
+        return;
+    }
+
+    memset(pStubMsg->Buffer, 0, (param->flat_align - (ULONG_PTR)pStubMsg->Buffer) & mask);
+    pStubMsg->Buffer = (unsigned char *)(((ULONG_PTR)pStubMsg->Buffer + mask) & ~mask);
+    if (param->flat_struct) pStubMsg->BufferMark = pStubMsg->Buffer;
+
+    if (pStubMsg->Buffer + param->flat_size < pStubMsg->Buffer ||
+        pStubMsg->Buffer + param->flat_size > (unsigned char *)pStubMsg->RpcMsg->Buffer + pStubMsg->BufferLength)
+        RpcRaiseException(RPC_X_BAD_STUB_DATA);
+    memcpy(pStubMsg->Buffer, pMemory, param->flat_size);
+    pStubMsg->Buffer += param->flat_size;
+}
+
+static inline void plan_unmarshall(PMIDL_STUB_MESSAGE pStubMsg, unsigned char **ppMemory,
+                                   const struct param_plan *param)
+{
+    ULONG_PTR mask = param->flat_align - 1;
+    unsigned char *end;
+
+    if (param->deref) ppMemory = (unsigned char **)*ppMemory;
+    if (!param->flat_size)
+    {
+        param->unmarshaller(pStubMsg, ppMemory, param->format, 0);
+        return;
+    }
+
+    pStubMsg->Buffer = (unsigned char *)(((ULONG_PTR)pStubMsg->Buffer + mask) & ~mask);
+    if (param->flat_struct) pStubMsg->BufferMark = pStubMsg->Buffer;
+
+    /* copying base types is checked against the end of the received data */
+    if (param->flat_struct || (!pStubMsg->IsClient && !*ppMemory))
+        end = (unsigned char *)pStubMsg->RpcMsg->Buffer + pStubMsg->BufferLength;
+    else
+        end = pStubMsg->BufferEnd;
+    if (pStubMsg->Buffer + param->flat_size < pStubMsg->Buffer ||
+        pStubMsg->Buffer + param->flat_size > end)
+        RpcRaiseException(RPC_X_BAD_STUB_DATA);
+
+    /* for servers, point straight into the RPC buffer */
+    if (!pStubMsg->IsClient && !*ppMemory) *ppMemory = pStubMsg->Buffer;
+    else memcpy(*ppMemory, pStubMsg->Buffer, param->flat_size);
+    pStubMsg->Buffer += param->flat_size;
+}
+
 static DWORD calc_arg_size(MIDL_STUB_MESSAGE *pStubMsg, PFORMAT_STRING pFormat)
 {
     DWORD size;
@@ -422,7 +639,8 @@ static void client_free_handle(
 }
 
 void client_do_args( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat, enum stubless_phase phase,
-                     void **fpu_args, unsigned short number_of_params, unsigned char *pRetVal )
+                     void **fpu_args, unsigned short number_of_params, unsigned char *pRetVal,
+                     const struct proc_plan *plan )
 {
     const NDR_PARAM_OIF *params = (const NDR_PARAM_OIF *)pFormat;
     unsigned int i;
@@ -461,16 +679,21 @@ void client_do_args( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat, enum s
         case STUBLESS_CALCSIZE:
             if (params[i].attr.IsSimpleRef && !*(unsigned char **)pArg)
                 RpcRaiseException(RPC_X_NULL_REF_POINTER);
-            if (params[i].attr.IsIn) call_buffer_sizer(pStubMsg, pArg, &params[i]);
+            if (!params[i].attr.IsIn) break;
+            if (plan) plan_buffer_size(pStubMsg, pArg, &plan->plan[i]);
+            else call_buffer_sizer(pStubMsg, pArg, &params[i]);
             break;
         case STUBLESS_MARSHAL:
-            if (params[i].attr.IsIn) call_marshaller(pStubMsg, pArg, &params[i]);
+            if (!params[i].attr.IsIn) break;
+            if (plan) plan_marshall(pStubMsg, pArg, &plan->plan[i]);
+            else call_marshaller(pStubMsg, pArg, &params[i]);
             break;
         case STUBLESS_UNMARSHAL:
             if (params[i].attr.IsOut)
             {
                 if (params[i].attr.IsReturn && pRetVal) pArg = pRetVal;
-                call_unmarshaller(pStubMsg, &pArg, &params[i], 0);
+                if (plan) plan_unmarshall(pStubMsg, &pArg, &plan->plan[i]);
+                else call_unmarshaller(pStubMsg, &pArg, &params[i], 0);
             }
             break;
         case STUBLESS_FREE:
@@ -628,6 +851,8 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
     PFORMAT_STRING pHandleFormat;
     /* correlation cache */
     ULONG_PTR NdrCorrCache[256];
+    /* cached marshalling plan of the procedure */
+    const struct proc_plan *plan = NULL;
 
     TRACE("pStubDesc %p, pFormat %p, ...\n", pStubDesc, pFormat);
 
@@ -706,6 +931,8 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
             }
 #endif
         }
+
+        plan = get_proc_plan(&stubMsg, pFormat, number_of_params);
     }
     else
     {
@@ -757,7 +984,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
         {
             TRACE( "INITOUT\n" );
             client_do_args(&stubMsg, pFormat, STUBLESS_INITOUT, fpu_stack,
-                           number_of_params, (unsigned char *)&RetVal);
+                           number_of_params, (unsigned char *)&RetVal, plan);
         }
 
         __TRY
@@ -765,7 +992,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
             /* 2. CALCSIZE */
             TRACE( "CALCSIZE\n" );
             client_do_args(&stubMsg, pFormat, STUBLESS_CALCSIZE, fpu_stack,
-                           number_of_params, (unsigned char *)&RetVal);
+                           number_of_params, (unsigned char *)&RetVal, plan);
 
             /* 3. GETBUFFER */
             TRACE( "GETBUFFER\n" );
@@ -796,7 +1023,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
             /* 4. MARSHAL */
             TRACE( "MARSHAL\n" );
             client_do_args(&stubMsg, pFormat, STUBLESS_MARSHAL, fpu_stack,
-                           number_of_params, (unsigned char *)&RetVal);
+                           number_of_params, (unsigned char *)&RetVal, plan);
 
             /* 5. SENDRECEIVE */
             TRACE( "SENDRECEIVE\n" );
@@ -834,7 +1061,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
             /* 6. UNMARSHAL */
             TRACE( "UNMARSHAL\n" );
             client_do_args(&stubMsg, pFormat, STUBLESS_UNMARSHAL, fpu_stack,
-                           number_of_params, (unsigned char *)&RetVal);
+                           number_of_params, (unsigned char *)&RetVal, plan);
         }
         __EXCEPT_ALL
         {
@@ -843,7 +1070,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
                 /* 7. FREE */
                 TRACE( "FREE\n" );
                 client_do_args(&stubMsg, pFormat, STUBLESS_FREE, fpu_stack,
-                               number_of_params, (unsigned char *)&RetVal);
+                               number_of_params, (unsigned char *)&RetVal, plan);
                 RetVal = NdrProxyErrorHandler(GetExceptionCode());
             }
             else
@@ -879,7 +1106,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
         /* 2. CALCSIZE */
         TRACE( "CALCSIZE\n" );
         client_do_args(&stubMsg, pFormat, STUBLESS_CALCSIZE, fpu_stack,
-                       number_of_params, (unsigned char *)&RetVal);
+                       number_of_params, (unsigned char *)&RetVal, plan);
 
         /* 3. GETBUFFER */
         TRACE( "GETBUFFER\n" );
@@ -901,7 +1128,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
         /* 4. MARSHAL */
         TRACE( "MARSHAL\n" );
         client_do_args(&stubMsg, pFormat, STUBLESS_MARSHAL, fpu_stack,
-                       number_of_params, (unsigned char *)&RetVal);
+                       number_of_params, (unsigned char *)&RetVal, plan);
 
         /* 5. SENDRECEIVE */
         TRACE( "SENDRECEIVE\n" );
@@ -928,7 +1155,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
         /* 6. UNMARSHAL */
         TRACE( "UNMARSHAL\n" );
         client_do_args(&stubMsg, pFormat, STUBLESS_UNMARSHAL, fpu_stack,
-                       number_of_params, (unsigned char *)&RetVal);
+                       number_of_params, (unsigned char *)&RetVal, plan);
     }
 
     if (ext_flags.HasNewCorrDesc)
@@ -1139,7 +1366,7 @@ LONG_PTR __cdecl call_server_func(SERVER_ROUTINE func, unsigned char * args, uns
 
 static LONG_PTR *stub_do_args(MIDL_STUB_MESSAGE *pStubMsg,
                               PFORMAT_STRING pFormat, enum stubless_phase phase,
-                              unsigned short number_of_params)
+                              unsigned short number_of_params, const struct proc_plan *plan)
 {
     const NDR_PARAM_OIF *params = (const NDR_PARAM_OIF *)pFormat;
     unsigned int i;
@@ -1158,8 +1385,9 @@ static LONG_PTR *stub_do_args(MIDL_STUB_MESSAGE *pStubMsg,
         switch (phase)
         {
         case STUBLESS_MARSHAL:
-            if (params[i].attr.IsOut || params[i].attr.IsReturn)
-                call_marshaller(pStubMsg, pArg, &params[i]);
+            if (!params[i].attr.IsOut && !params[i].attr.IsReturn) break;
+            if (plan) plan_marshall(pStubMsg, pArg, &plan->plan[i]);
+            else call_marshaller(pStubMsg, pArg, &params[i]);
             break;
         case STUBLESS_MUSTFREE:
             if (params[i].attr.MustFree)
@@ -1208,12 +1436,14 @@ static LONG_PTR *stub_do_args(MIDL_STUB_MESSAGE *pStubMsg,
                 *(void **)pArg = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY,
                                            params[i].attr.ServerAllocSize * 8);
 
-            if (params[i].attr.IsIn)
-                call_unmarshaller(pStubMsg, &pArg, &params[i], 0);
+            if (!params[i].attr.IsIn) break;
+            if (plan) plan_unmarshall(pStubMsg, &pArg, &plan->plan[i]);
+            else call_unmarshaller(pStubMsg, &pArg, &params[i], 0);
             break;
         case STUBLESS_CALCSIZE:
-            if (params[i].attr.IsOut || params[i].attr.IsReturn)
-                call_buffer_sizer(pStubMsg, pArg, &params[i]);
+            if (!params[i].attr.IsOut && !params[i].attr.IsReturn) break;
+            if (plan) plan_buffer_size(pStubMsg, pArg, &plan->plan[i]);
+            else call_buffer_sizer(pStubMsg, pArg, &params[i]);
             break;
         default:
             RpcRaiseException(RPC_S_INTERNAL_ERROR);
@@ -1263,6 +1493,8 @@ LONG WINAPI NdrStubCall2(
     LONG_PTR *retval_ptr = NULL;
     /* correlation cache */
     ULONG_PTR NdrCorrCache[256];
+    /* cached marshalling plan of the procedure */
+    const struct proc_plan *plan = NULL;
 
     TRACE("pThis %p, pChannel %p, pRpcMsg %p, pdwStubPhase %p\n", pThis, pChannel, pRpcMsg, pdwStubPhase);
 
@@ -1386,6 +1618,8 @@ LONG WINAPI NdrStubCall2(
             if (ext_flags.Unused & 0x2) /* has range on conformance */
                 stubMsg.CorrDespIncrement = 12;
         }
+
+        plan = get_proc_plan(&stubMsg, pFormat, number_of_params);
     }
     else
     {
@@ -1459,7 +1693,7 @@ LONG WINAPI NdrStubCall2(
         case STUBLESS_MARSHAL:
         case STUBLESS_MUSTFREE:
         case STUBLESS_FREE:
-            retval_ptr = stub_do_args(&stubMsg, pFormat, phase, number_of_params);
+            retval_ptr = stub_do_args(&stubMsg, pFormat, phase, number_of_params, plan);
             break;
         default:
             ERR("shouldn't reach here. phase %d\n", phase);
@@ -1676,7 +1910,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_async_client_call( PMIDL_STUB_DESC pStubDesc,
 
     /* 1. CALCSIZE */
     TRACE( "CALCSIZE\n" );
-    client_do_args(pStubMsg, pFormat, STUBLESS_CALCSIZE, NULL, async_call_data->number_of_params, NULL);
+    client_do_args(pStubMsg, pFormat, STUBLESS_CALCSIZE, NULL, async_call_data->number_of_params, NULL, NULL);
 
     /* 2. GETBUFFER */
     TRACE( "GETBUFFER\n" );
@@ -1701,7 +1935,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_async_client_call( PMIDL_STUB_DESC pStubDesc,
 
     /* 3. MARSHAL */
     TRACE( "MARSHAL\n" );
-    client_do_args(pStubMsg, pFormat, STUBLESS_MARSHAL, NULL, async_call_data->number_of_params, NULL);
+    client_do_args(pStubMsg, pFormat, STUBLESS_MARSHAL, NULL, async_call_data->number_of_params, NULL, NULL);
 
     /* 4. SENDRECEIVE */
     TRACE( "SEND\n" );
@@ -1789,7 +2023,7 @@ RPC_STATUS NdrpCompleteAsyncClientCall(RPC_ASYNC_STATE *pAsync, void *Reply)
     /* 2. UNMARSHAL */
     TRACE( "UNMARSHAL\n" );
     client_do_args(pStubMsg, async_call_data->pParamFormat, STUBLESS_UNMARSHAL,
-                   NULL, async_call_data->number_of_params, Reply);
+                   NULL, async_call_data->number_of_params, Reply, NULL);
 
 cleanup:
     if (pStubMsg->fHasNewCorrDesc)
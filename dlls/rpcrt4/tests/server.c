@@ -1564,10 +1564,29 @@ void __cdecl s_authinfo_test(unsigned int protseq, int secure)
     }
 }
 
+static void
+round_trip_tests(void)
+{
+  vector_t v = {1, 2, 3};
+  DWORD start, elapsed;
+  int i, count = 0;
+
+  start = GetTickCount();
+  for (i = 0; i < 200; i++)
+  {
+    if (sum(i, 1) == i + 1) count++;
+    if (dot_self(&v) == 14) count++;
+  }
+  elapsed = GetTickCount() - start;
+  ok(count == 400, "got %d successful calls\n", count);
+  trace("%d round trips in %u ms\n", count, elapsed);
+}
+
 static void
 run_tests(void)
 {
   basic_tests();
+  round_trip_tests();
   union_tests();
   pointer_tests();
   array_tests();
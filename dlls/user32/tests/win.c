@@ -7313,6 +7313,40 @@ static void test_GetWindowModuleFileName(void)
     }
 }
 
+static void test_other_process_window_info(void)
+{
+    WINDOWINFO info;
+    RECT rect, client;
+    HWND hwnd;
+
+    hwnd = FindWindowA("Shell_TrayWnd", NULL);
+    if (!hwnd || !pGetWindowInfo)
+    {
+        skip("no tray window or GetWindowInfo\n");
+        return;
+    }
+
+    memset(&info, 0xcc, sizeof(info));
+    info.cbSize = sizeof(info);
+    ok(pGetWindowInfo(hwnd, &info), "GetWindowInfo failed %u\n", GetLastError());
+    GetWindowRect(hwnd, &rect);
+    ok(EqualRect(&info.rcWindow, &rect), "wrong window rect %s / %s\n",
+       wine_dbgstr_rect(&info.rcWindow), wine_dbgstr_rect(&rect));
+    GetClientRect(hwnd, &client);
+    MapWindowPoints(hwnd, 0, (POINT *)&client, 2);
+    ok(EqualRect(&info.rcClient, &client), "wrong client rect %s / %s\n",
+       wine_dbgstr_rect(&info.rcClient), wine_dbgstr_rect(&client));
+    ok(info.dwStyle == GetWindowLongA(hwnd, GWL_STYLE), "wrong style %08x\n", info.dwStyle);
+    ok(info.dwExStyle == GetWindowLongA(hwnd, GWL_EXSTYLE), "wrong exstyle %08x\n", info.dwExStyle);
+    ok(info.atomWindowType == GetClassLongA(hwnd, GCW_ATOM), "wrong atom %04x\n", info.atomWindowType);
+    ok(!info.dwWindowStatus, "wrong status %08x\n", info.dwWindowStatus);
+    ok(IsWindowVisible(hwnd) == !!(info.dwStyle & WS_VISIBLE), "wrong visibility\n");
+
+    SetLastError(0xdeadbeef);
+    ok(!pGetWindowInfo((HWND)0xdeadbeef, &info), "GetWindowInfo succeeded\n");
+    ok(GetLastError() == ERROR_INVALID_WINDOW_HANDLE, "wrong error %u\n", GetLastError());
+}
+
 static void test_hwnd_message(void)
 {
     static const WCHAR mainwindowclassW[] = {'M','a','i','n','W','i','n','d','o','w','C','l','a','s','s',0};
@@ -10012,6 +10046,7 @@ START_TEST(win)
     test_deferwindowpos();
     test_LockWindowUpdate(hwndMain);
     test_desktop();
+    test_other_process_window_info();
 
     /* add the tests above this line */
     if (hhook) UnhookWindowsHookEx(hhook);
@@ -3118,6 +3118,46 @@ BOOL WINAPI IsChild( HWND parent, HWND child )
 }
 
 
+/***********************************************************************
+ *           get_window_styles
+ *
+ * Retrieve the styles of a list of at most MAX_BATCH_REQUESTS windows, with a
+ * single server round trip for the windows that belong to other processes.
+ */
+static void get_window_styles( const HWND *list, LONG *styles, unsigned int count )
+{
+    struct __server_request_info info[MAX_BATCH_REQUESTS];
+    struct __server_batch_entry batch[MAX_BATCH_REQUESTS];
+    unsigned int i, pos[MAX_BATCH_REQUESTS], other = 0;
+    WND *win;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((win = WIN_GetPtr( list[i] )) != WND_OTHER_PROCESS)
+        {
+            if (win && win != WND_DESKTOP) WIN_ReleasePtr( win );
+            styles[i] = GetWindowLongW( list[i], GWL_STYLE );
+            continue;
+        }
+        wine_server_init_req( &info[other], REQ_set_window_info );
+        info[other].u.req.set_window_info_request.handle = wine_server_user_handle( list[i] );
+        info[other].u.req.set_window_info_request.flags = 0;  /* don't set anything, just retrieve */
+        info[other].u.req.set_window_info_request.extra_offset = -1;
+        batch[other].req = &info[other];
+        batch[other].handle_from = -1;
+        pos[other++] = i;
+    }
+    if (!other) return;
+
+    wine_server_call_batch( batch, other );
+    for (i = 0; i < other; i++)
+    {
+        if (info[i].u.reply.reply_header.error) styles[pos[i]] = 0;
+        else styles[pos[i]] = info[i].u.reply.set_window_info_reply.old_style;
+    }
+}
+
+
 /***********************************************************************
  *		IsWindowVisible (USER32.@)
  */
@@ -3125,14 +3165,24 @@ BOOL WINAPI IsWindowVisible( HWND hwnd )
 {
     HWND *list;
     BOOL retval = TRUE;
-    int i;
+    LONG styles[MAX_BATCH_REQUESTS];
+    int i, j, count;
 
     if (!(GetWindowLongW( hwnd, GWL_STYLE ) & WS_VISIBLE)) return FALSE;
     if (!(list = list_window_parents( hwnd ))) return TRUE;
     if (list[0])
     {
-        for (i = 0; list[i+1]; i++)
-            if (!(GetWindowLongW( list[i], GWL_STYLE ) & WS_VISIBLE)) break;
+        for (i = 0; list[i+1]; i += count)
+        {
+            for (count = 0; count < MAX_BATCH_REQUESTS && list[i+count+1]; count++) ;
+            get_window_styles( list + i, styles, count );
+            for (j = 0; j < count; j++) if (!(styles[j] & WS_VISIBLE)) break;
+            if (j < count)
+            {
+                i += j;
+                break;
+            }
+        }
         retval = !list[i+1] && (list[i] == GetDesktopWindow());  /* top message window isn't visible */
     }
     HeapFree( GetProcessHeap(), 0, list );
@@ -3151,7 +3201,8 @@ BOOL WIN_IsWindowDrawable( HWND hwnd, BOOL icon )
 {
     HWND *list;
     BOOL retval = TRUE;
-    int i;
+    LONG styles[MAX_BATCH_REQUESTS];
+    int i, j, count;
     LONG style = GetWindowLongW( hwnd, GWL_STYLE );
 
     if (!(style & WS_VISIBLE)) return FALSE;
@@ -3160,9 +3211,18 @@ BOOL WIN_IsWindowDrawable( HWND hwnd, BOOL icon )
     if (!(list = list_window_parents( hwnd ))) return TRUE;
     if (list[0])
     {
-        for (i = 0; list[i+1]; i++)
-            if ((GetWindowLongW( list[i], GWL_STYLE ) & (WS_VISIBLE|WS_MINIMIZE)) != WS_VISIBLE)
+        for (i = 0; list[i+1]; i += count)
+        {
+            for (count = 0; count < MAX_BATCH_REQUESTS && list[i+count+1]; count++) ;
+            get_window_styles( list + i, styles, count );
+            for (j = 0; j < count; j++)
+                if ((styles[j] & (WS_VISIBLE|WS_MINIMIZE)) != WS_VISIBLE) break;
+            if (j < count)
+            {
+                i += j;
                 break;
+            }
+        }
         retval = !list[i+1] && (list[i] == GetDesktopWindow());  /* top message window isn't visible */
     }
     HeapFree( GetProcessHeap(), 0, list );
@@ -3668,6 +3728,70 @@ UINT WINAPI GetWindowModuleFileNameW( HWND hwnd, LPWSTR module, UINT size )
     return GetModuleFileNameW( hinst, module, size );
 }
 
+/******************************************************************************
+ *              get_other_process_window_info
+ *
+ * Retrieve the GetWindowInfo data of a window that belongs to another process,
+ * with a single server round trip.
+ */
+static BOOL get_other_process_window_info( HWND hwnd, WINDOWINFO *info )
+{
+    struct __server_request_info rect_info, win_info, class_info, input_info;
+    const struct get_window_rectangles_reply *rect_reply = &rect_info.u.reply.get_window_rectangles_reply;
+    const struct set_window_info_reply *win_reply = &win_info.u.reply.set_window_info_reply;
+    struct __server_batch_entry batch[4];
+    unsigned int i, status;
+
+    wine_server_init_req( &rect_info, REQ_get_window_rectangles );
+    rect_info.u.req.get_window_rectangles_request.handle = wine_server_user_handle( hwnd );
+    rect_info.u.req.get_window_rectangles_request.relative = COORDS_SCREEN;
+    batch[0].req = &rect_info;
+
+    wine_server_init_req( &win_info, REQ_set_window_info );
+    win_info.u.req.set_window_info_request.handle = wine_server_user_handle( hwnd );
+    win_info.u.req.set_window_info_request.flags = 0;  /* don't set anything, just retrieve */
+    win_info.u.req.set_window_info_request.extra_offset = -1;
+    batch[1].req = &win_info;
+
+    wine_server_init_req( &class_info, REQ_set_class_info );
+    class_info.u.req.set_class_info_request.window = wine_server_user_handle( hwnd );
+    class_info.u.req.set_class_info_request.flags = 0;
+    class_info.u.req.set_class_info_request.extra_offset = -1;
+    batch[2].req = &class_info;
+
+    wine_server_init_req( &input_info, REQ_get_thread_input );
+    input_info.u.req.get_thread_input_request.tid = GetCurrentThreadId();
+    batch[3].req = &input_info;
+
+    for (i = 0; i < 4; i++) batch[i].handle_from = -1;
+    wine_server_call_batch( batch, 4 );
+
+    if ((status = rect_info.u.reply.reply_header.error))
+    {
+        SetLastError( RtlNtStatusToDosError( status ));
+        return FALSE;
+    }
+    SetRect( &info->rcWindow, rect_reply->window.left, rect_reply->window.top,
+             rect_reply->window.right, rect_reply->window.bottom );
+    SetRect( &info->rcClient, rect_reply->client.left, rect_reply->client.top,
+             rect_reply->client.right, rect_reply->client.bottom );
+
+    info->dwStyle = info->dwExStyle = 0;
+    if (!win_info.u.reply.reply_header.error)
+    {
+        info->dwStyle = win_reply->old_style;
+        info->dwExStyle = win_reply->old_ex_style;
+    }
+    info->atomWindowType = 0;
+    if (!class_info.u.reply.reply_header.error)
+        info->atomWindowType = class_info.u.reply.set_class_info_reply.old_atom;
+    info->dwWindowStatus = 0;
+    if (!input_info.u.reply.reply_header.error &&
+        wine_server_ptr_handle( input_info.u.reply.get_thread_input_reply.active ) == hwnd)
+        info->dwWindowStatus = WS_ACTIVECAPTION;
+    return TRUE;
+}
+
 /******************************************************************************
  *              GetWindowInfo (USER32.@)
  *
@@ -3675,17 +3799,28 @@ UINT WINAPI GetWindowModuleFileNameW( HWND hwnd, LPWSTR module, UINT size )
  */
 BOOL WINAPI DECLSPEC_HOTPATCH GetWindowInfo( HWND hwnd, PWINDOWINFO pwi)
 {
+    WND *win;
+
     if (!pwi) return FALSE;
-    if (!WIN_GetRectangles( hwnd, COORDS_SCREEN, &pwi->rcWindow, &pwi->rcClient )) return FALSE;
 
-    pwi->dwStyle = GetWindowLongW(hwnd, GWL_STYLE);
-    pwi->dwExStyle = GetWindowLongW(hwnd, GWL_EXSTYLE);
-    pwi->dwWindowStatus = ((GetActiveWindow() == hwnd) ? WS_ACTIVECAPTION : 0);
+    if ((win = WIN_GetPtr( hwnd )) == WND_OTHER_PROCESS)
+    {
+        if (!get_other_process_window_info( hwnd, pwi )) return FALSE;
+    }
+    else
+    {
+        if (win && win != WND_DESKTOP) WIN_ReleasePtr( win );
+        if (!WIN_GetRectangles( hwnd, COORDS_SCREEN, &pwi->rcWindow, &pwi->rcClient )) return FALSE;
+
+        pwi->dwStyle = GetWindowLongW(hwnd, GWL_STYLE);
+        pwi->dwExStyle = GetWindowLongW(hwnd, GWL_EXSTYLE);
+        pwi->dwWindowStatus = ((GetActiveWindow() == hwnd) ? WS_ACTIVECAPTION : 0);
+        pwi->atomWindowType = GetClassLongW( hwnd, GCW_ATOM );
+    }
 
     pwi->cxWindowBorders = pwi->rcClient.left - pwi->rcWindow.left;
     pwi->cyWindowBorders = pwi->rcWindow.bottom - pwi->rcClient.bottom;
 
-    pwi->atomWindowType = GetClassLongW( hwnd, GCW_ATOM );
     pwi->wCreatorVersion = 0x0400;
 
     return TRUE;
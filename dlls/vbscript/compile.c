@@ -1324,6 +1324,82 @@ static HRESULT fill_array_desc(compile_ctx_t *ctx, dim_decl_t *dim_decl, array_d
     return S_OK;
 }
 
+/*
+ * Local variables and arguments are bound to frame slots. Non-negative slots are
+ * indexes into function variables, negative ones refer to arguments (-1 being the first one).
+ */
+static BOOL lookup_local_slot(function_t *func, const WCHAR *name, int *ret)
+{
+    unsigned i;
+
+    /* Function name refers to its return value or the function itself, leave it to the interpreter. */
+    if(func->name && !strcmpiW(func->name, name))
+        return FALSE;
+
+    for(i = 0; i < func->var_cnt; i++) {
+        if(!strcmpiW(func->vars[i].name, name)) {
+            *ret = i;
+            return TRUE;
+        }
+    }
+
+    for(i = 0; i < func->arg_cnt; i++) {
+        if(!strcmpiW(func->args[i].name, name)) {
+            *ret = -(int)i-1;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* Dim statements may follow the first use of a variable, so binding is done once the whole function is compiled. */
+static void bind_local_identifiers(compile_ctx_t *ctx, function_t *func)
+{
+    instr_t *instr;
+    int slot;
+
+    if(func->type == FUNC_GLOBAL || (!func->var_cnt && !func->arg_cnt))
+        return;
+
+    for(instr = ctx->code->instrs+func->code_off; instr < ctx->code->instrs+ctx->instr_cnt; instr++) {
+        switch(instr->op) {
+        case OP_icall:
+            if(lookup_local_slot(func, instr->arg1.bstr, &slot)) {
+                instr->op = OP_icall_local;
+                instr->arg1.lng = slot;
+            }
+            break;
+        case OP_assign_ident:
+            if(lookup_local_slot(func, instr->arg1.bstr, &slot)) {
+                instr->op = OP_assign_local;
+                instr->arg1.lng = slot;
+            }
+            break;
+        case OP_set_ident:
+            if(lookup_local_slot(func, instr->arg1.bstr, &slot)) {
+                instr->op = OP_set_local;
+                instr->arg1.lng = slot;
+            }
+            break;
+        case OP_incc:
+            if(lookup_local_slot(func, instr->arg1.bstr, &slot)) {
+                instr->op = OP_incc_local;
+                instr->arg1.lng = slot;
+            }
+            break;
+        case OP_step:
+            if(lookup_local_slot(func, instr->arg2.bstr, &slot)) {
+                instr->op = OP_step_local;
+                instr->arg2.lng = slot;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *func)
 {
     HRESULT hres;
@@ -1436,6 +1512,7 @@ static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *f
         assert(array_id == func->array_cnt);
     }
 
+    bind_local_identifiers(ctx, func);
     return S_OK;
 }
 
@@ -1750,6 +1827,7 @@ void release_vbscode(vbscode_t *code)
 
     heap_free(code->bstr_pool);
     heap_free(code->source);
+    heap_free(code->ref_cache);
     heap_free(code->instrs);
     heap_free(code);
 }
@@ -1768,6 +1846,8 @@ static vbscode_t *alloc_vbscode(compile_ctx_t *ctx, const WCHAR *source)
         return NULL;
     }
 
+    ret->ref_cache = NULL;
+
     ret->instrs = heap_alloc(32*sizeof(instr_t));
     if(!ret->instrs) {
         release_vbscode(ret);
@@ -1881,6 +1961,10 @@ HRESULT compile_script(script_ctx_t *script, const WCHAR *src, const WCHAR *deli
         script->global_funcs = ctx.funcs;
     }
 
+    /* Identifiers cached by global code may now resolve to the new globals. */
+    if(ctx.global_vars || ctx.funcs)
+        script->globals_version++;
+
     if(ctx.classes) {
         class_desc_t *class = ctx.classes;
 
@@ -1898,6 +1982,7 @@ HRESULT compile_script(script_ctx_t *script, const WCHAR *src, const WCHAR *deli
     if(TRACE_ON(vbscript_disas))
         dump_code(&ctx);
 
+    code->instr_cnt = ctx.instr_cnt;
     ctx.code = NULL;
     release_compiler(&ctx);
 
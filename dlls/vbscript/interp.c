@@ -219,6 +219,55 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
     return S_OK;
 }
 
+struct _ref_cache_t {
+    unsigned version;
+    ref_t ref;
+};
+
+/*
+ * Global code looks up global variables before anything else, so found variables and functions
+ * may be cached per instruction until globals_version changes. It's bumped when global variables
+ * or functions are added and when the script is released.
+ */
+static HRESULT lookup_identifier_cached(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_t invoke_type, ref_t *ref)
+{
+    ref_cache_t *cache;
+    HRESULT hres;
+
+    if(ctx->func->type != FUNC_GLOBAL)
+        return lookup_identifier(ctx, name, invoke_type, ref);
+
+    if(!ctx->code->ref_cache) {
+        ctx->code->ref_cache = heap_alloc_zero(ctx->code->instr_cnt * sizeof(*ctx->code->ref_cache));
+        if(!ctx->code->ref_cache)
+            return lookup_identifier(ctx, name, invoke_type, ref);
+    }
+
+    cache = ctx->code->ref_cache + (ctx->instr - ctx->code->instrs);
+    if(cache->ref.type != REF_NONE && cache->version == ctx->script->globals_version) {
+        *ref = cache->ref;
+        return S_OK;
+    }
+
+    hres = lookup_identifier(ctx, name, invoke_type, ref);
+    if(SUCCEEDED(hres) && (ref->type == REF_VAR || ref->type == REF_CONST || ref->type == REF_FUNC)) {
+        cache->version = ctx->script->globals_version;
+        cache->ref = *ref;
+    }
+    return hres;
+}
+
+static inline VARIANT *get_local_var(exec_ctx_t *ctx, int slot)
+{
+    if(slot >= 0) {
+        assert(slot < ctx->func->var_cnt);
+        return ctx->vars + slot;
+    }
+
+    assert(-slot-1 < ctx->func->arg_cnt);
+    return ctx->args + (-slot-1);
+}
+
 static HRESULT add_dynamic_var(exec_ctx_t *ctx, const WCHAR *name,
         BOOL is_const, VARIANT **out_var)
 {
@@ -245,6 +294,7 @@ static HRESULT add_dynamic_var(exec_ctx_t *ctx, const WCHAR *name,
     if(ctx->func->type == FUNC_GLOBAL) {
         new_var->next = ctx->script->global_vars;
         ctx->script->global_vars = new_var;
+        ctx->script->globals_version++;
     }else {
         new_var->next = ctx->dynamic_vars;
         ctx->dynamic_vars = new_var;
@@ -522,18 +572,11 @@ static HRESULT array_access(exec_ctx_t *ctx, SAFEARRAY *array, DISPPARAMS *dp, V
     return S_OK;
 }
 
-static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
+static HRESULT call_ref(exec_ctx_t *ctx, BSTR identifier, ref_t ref, unsigned arg_cnt, VARIANT *res)
 {
-    BSTR identifier = ctx->instr->arg1.bstr;
-    const unsigned arg_cnt = ctx->instr->arg2.uint;
     DISPPARAMS dp;
-    ref_t ref;
     HRESULT hres;
 
-    hres = lookup_identifier(ctx, identifier, VBDISP_CALLGET, &ref);
-    if(FAILED(hres))
-        return hres;
-
     switch(ref.type) {
     case REF_VAR:
     case REF_CONST: {
@@ -622,6 +665,20 @@ static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
     return S_OK;
 }
 
+static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
+{
+    BSTR identifier = ctx->instr->arg1.bstr;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    ref_t ref;
+    HRESULT hres;
+
+    hres = lookup_identifier_cached(ctx, identifier, VBDISP_CALLGET, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    return call_ref(ctx, identifier, ref, arg_cnt, res);
+}
+
 static HRESULT interp_icall(exec_ctx_t *ctx)
 {
     VARIANT v;
@@ -642,6 +699,25 @@ static HRESULT interp_icallv(exec_ctx_t *ctx)
     return do_icall(ctx, NULL);
 }
 
+static HRESULT interp_icall_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    VARIANT v;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%d\n", slot);
+
+    ref.type = REF_VAR;
+    ref.u.v = get_local_var(ctx, slot);
+    hres = call_ref(ctx, NULL, ref, arg_cnt, &v);
+    if(FAILED(hres))
+        return hres;
+
+    return stack_push(ctx, &v);
+}
+
 static HRESULT do_mcall(exec_ctx_t *ctx, VARIANT *res)
 {
     const BSTR identifier = ctx->instr->arg1.bstr;
@@ -716,15 +792,10 @@ static HRESULT assign_value(exec_ctx_t *ctx, VARIANT *dst, VARIANT *src, WORD fl
     return S_OK;
 }
 
-static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+static HRESULT assign_ref(exec_ctx_t *ctx, BSTR name, ref_t ref, WORD flags, DISPPARAMS *dp)
 {
-    ref_t ref;
     HRESULT hres;
 
-    hres = lookup_identifier(ctx, name, VBDISP_LET, &ref);
-    if(FAILED(hres))
-        return hres;
-
     switch(ref.type) {
     case REF_VAR: {
         VARIANT *v = ref.u.v;
@@ -802,6 +873,27 @@ static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *
     return hres;
 }
 
+static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+{
+    ref_t ref;
+    HRESULT hres;
+
+    hres = lookup_identifier_cached(ctx, name, VBDISP_LET, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    return assign_ref(ctx, name, ref, flags, dp);
+}
+
+static HRESULT assign_local(exec_ctx_t *ctx, int slot, WORD flags, DISPPARAMS *dp)
+{
+    ref_t ref;
+
+    ref.type = REF_VAR;
+    ref.u.v = get_local_var(ctx, slot);
+    return assign_ref(ctx, NULL, ref, flags, dp);
+}
+
 static HRESULT interp_assign_ident(exec_ctx_t *ctx)
 {
     const BSTR arg = ctx->instr->arg1.bstr;
@@ -847,6 +939,51 @@ static HRESULT interp_set_ident(exec_ctx_t *ctx)
     return S_OK;
 }
 
+static HRESULT interp_assign_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    HRESULT hres;
+
+    TRACE("%d\n", slot);
+
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_local(ctx, slot, DISPATCH_PROPERTYPUT, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt+1);
+    return S_OK;
+}
+
+static HRESULT interp_set_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    HRESULT hres;
+
+    TRACE("%d\n", slot);
+
+    if(arg_cnt) {
+        FIXME("arguments not supported\n");
+        return E_NOTIMPL;
+    }
+
+    hres = stack_assume_disp(ctx, 0, NULL);
+    if(FAILED(hres))
+        return hres;
+
+    vbstack_to_dp(ctx, 0, TRUE, &dp);
+    hres = assign_local(ctx, slot, DISPATCH_PROPERTYPUTREF, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, 1);
+    return S_OK;
+}
+
 static HRESULT interp_assign_member(exec_ctx_t *ctx)
 {
     BSTR identifier = ctx->instr->arg1.bstr;
@@ -1068,16 +1205,12 @@ static HRESULT interp_dim(exec_ctx_t *ctx)
     return S_OK;
 }
 
-static HRESULT interp_step(exec_ctx_t *ctx)
+static HRESULT do_step(exec_ctx_t *ctx, VARIANT *var)
 {
-    const BSTR ident = ctx->instr->arg2.bstr;
     BOOL gteq_zero;
     VARIANT zero;
-    ref_t ref;
     HRESULT hres;
 
-    TRACE("%s\n", debugstr_w(ident));
-
     V_VT(&zero) = VT_I2;
     V_I2(&zero) = 0;
     hres = VarCmp(stack_top(ctx, 0), &zero, ctx->script->lcid, 0);
@@ -1086,16 +1219,7 @@ static HRESULT interp_step(exec_ctx_t *ctx)
 
     gteq_zero = hres == VARCMP_GT || hres == VARCMP_EQ;
 
-    hres = lookup_identifier(ctx, ident, VBDISP_ANY, &ref);
-    if(FAILED(hres))
-        return hres;
-
-    if(ref.type != REF_VAR) {
-        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
-        return E_FAIL;
-    }
-
-    hres = VarCmp(ref.u.v, stack_top(ctx, 1), ctx->script->lcid, 0);
+    hres = VarCmp(var, stack_top(ctx, 1), ctx->script->lcid, 0);
     if(FAILED(hres))
         return hres;
 
@@ -1108,6 +1232,35 @@ static HRESULT interp_step(exec_ctx_t *ctx)
     return S_OK;
 }
 
+static HRESULT interp_step(exec_ctx_t *ctx)
+{
+    const BSTR ident = ctx->instr->arg2.bstr;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%s\n", debugstr_w(ident));
+
+    hres = lookup_identifier_cached(ctx, ident, VBDISP_ANY, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    if(ref.type != REF_VAR) {
+        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
+        return E_FAIL;
+    }
+
+    return do_step(ctx, ref.u.v);
+}
+
+static HRESULT interp_step_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg2.lng;
+
+    TRACE("%d\n", slot);
+
+    return do_step(ctx, get_local_var(ctx, slot));
+}
+
 static HRESULT interp_newenum(exec_ctx_t *ctx)
 {
     variant_val_t v;
@@ -1970,16 +2123,29 @@ static HRESULT interp_neg(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
+static HRESULT do_incc(exec_ctx_t *ctx, VARIANT *var)
+{
+    VARIANT v;
+    HRESULT hres;
+
+    hres = VarAdd(stack_top(ctx, 0), var, &v);
+    if(FAILED(hres))
+        return hres;
+
+    VariantClear(var);
+    *var = v;
+    return S_OK;
+}
+
 static HRESULT interp_incc(exec_ctx_t *ctx)
 {
     const BSTR ident = ctx->instr->arg1.bstr;
-    VARIANT v;
     ref_t ref;
     HRESULT hres;
 
     TRACE("\n");
 
-    hres = lookup_identifier(ctx, ident, VBDISP_LET, &ref);
+    hres = lookup_identifier_cached(ctx, ident, VBDISP_LET, &ref);
     if(FAILED(hres))
         return hres;
 
@@ -1988,13 +2154,16 @@ static HRESULT interp_incc(exec_ctx_t *ctx)
         return E_FAIL;
     }
 
-    hres = VarAdd(stack_top(ctx, 0), ref.u.v, &v);
-    if(FAILED(hres))
-        return hres;
+    return do_incc(ctx, ref.u.v);
+}
 
-    VariantClear(ref.u.v);
-    *ref.u.v = v;
-    return S_OK;
+static HRESULT interp_incc_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+
+    TRACE("%d\n", slot);
+
+    return do_incc(ctx, get_local_var(ctx, slot));
 }
 
 static HRESULT interp_catch(exec_ctx_t *ctx)
@@ -121,6 +121,8 @@ static void release_script(script_ctx_t *ctx)
 
     release_dynamic_vars(ctx->global_vars);
     ctx->global_vars = NULL;
+    /* Invalidate identifier lookups cached by global code. */
+    ctx->globals_version++;
 
     while(!list_empty(&ctx->named_items)) {
         named_item_t *iter = LIST_ENTRY(list_head(&ctx->named_items), named_item_t, entry);
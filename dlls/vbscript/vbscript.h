@@ -193,6 +193,7 @@ struct _script_ctx_t {
     HRESULT err_number;
 
     dynamic_var_t *global_vars;
+    unsigned globals_version;
     function_t *global_funcs;
     class_desc_t *classes;
     class_desc_t *procs;
@@ -223,6 +224,7 @@ typedef enum {
     X(add,            1, 0,           0)          \
     X(and,            1, 0,           0)          \
     X(assign_ident,   1, ARG_BSTR,    ARG_UINT)   \
+    X(assign_local,   1, ARG_INT,     ARG_UINT)   \
     X(assign_member,  1, ARG_BSTR,    ARG_UINT)   \
     X(bool,           1, ARG_INT,     0)          \
     X(catch,          1, ARG_ADDR,    ARG_UINT)    \
@@ -242,10 +244,12 @@ typedef enum {
     X(gt,             1, 0,           0)          \
     X(gteq,           1, 0,           0)          \
     X(icall,          1, ARG_BSTR,    ARG_UINT)   \
+    X(icall_local,    1, ARG_INT,     ARG_UINT)   \
     X(icallv,         1, ARG_BSTR,    ARG_UINT)   \
     X(idiv,           1, 0,           0)          \
     X(imp,            1, 0,           0)          \
     X(incc,           1, ARG_BSTR,    0)          \
+    X(incc_local,     1, ARG_INT,     0)          \
     X(is,             1, 0,           0)          \
     X(jmp,            0, ARG_ADDR,    0)          \
     X(jmp_false,      0, ARG_ADDR,    0)          \
@@ -269,9 +273,11 @@ typedef enum {
     X(pop,            1, ARG_UINT,    0)          \
     X(ret,            0, 0,           0)          \
     X(set_ident,      1, ARG_BSTR,    ARG_UINT)   \
+    X(set_local,      1, ARG_INT,     ARG_UINT)   \
     X(set_member,     1, ARG_BSTR,    ARG_UINT)   \
     X(short,          1, ARG_INT,     0)          \
     X(step,           0, ARG_ADDR,    ARG_BSTR)   \
+    X(step_local,     0, ARG_ADDR,    ARG_INT)    \
     X(stop,           1, 0,           0)          \
     X(string,         1, ARG_STR,     0)          \
     X(sub,            1, 0,           0)          \
@@ -333,10 +339,16 @@ struct _function_t {
     function_t *next;
 };
 
+typedef struct _ref_cache_t ref_cache_t;
+
 struct _vbscode_t {
     instr_t *instrs;
+    unsigned instr_cnt;
     WCHAR *source;
 
+    /* Cached identifier lookups of global code, indexed by instruction offset. */
+    ref_cache_t *ref_cache;
+
     BOOL option_explicit;
 
     BOOL pending_exec;
@@ -44,6 +44,7 @@ static HMODULE vcomp_module;
 static int     vcomp_max_threads;
 static int     vcomp_num_threads;
 static BOOL    vcomp_nested_fork = FALSE;
+static BOOL    vcomp_proc_bind = FALSE;
 
 static RTL_CRITICAL_SECTION vcomp_section;
 static RTL_CRITICAL_SECTION_DEBUG critsect_debug =
@@ -59,6 +60,9 @@ static RTL_CRITICAL_SECTION vcomp_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 #define VCOMP_DYNAMIC_FLAGS_GUIDED      0x03
 #define VCOMP_DYNAMIC_FLAGS_INCREMENT   0x40
 
+/* number of polls of a barrier before sleeping on the team condition variable */
+#define VCOMP_BARRIER_SPIN_COUNT        4000
+
 struct vcomp_thread_data
 {
     struct vcomp_team_data  *team;
@@ -70,6 +74,7 @@ struct vcomp_thread_data
     /* only used for concurrent tasks */
     struct list             entry;
     CONDITION_VARIABLE      cond;
+    int                     bound_cpu;
 
     /* single */
     unsigned int            single;
@@ -96,7 +101,7 @@ struct vcomp_team_data
     __ms_va_list            valist;
 
     /* barrier */
-    unsigned int            barrier;
+    int                     barrier;
     int                     barrier_count;
 };
 
@@ -108,7 +113,7 @@ struct vcomp_task_data
     /* section */
     unsigned int            section;
     int                     num_sections;
-    int                     section_index;
+    __int64                 section_state;  /* section << 32 | remaining sections */
 
     /* dynamic */
     unsigned int            dynamic;
@@ -117,6 +122,7 @@ struct vcomp_task_data
     unsigned int            dynamic_iterations;
     int                     dynamic_step;
     unsigned int            dynamic_chunksize;
+    __int64                 dynamic_state;  /* dynamic << 32 | remaining iterations */
 };
 
 #if defined(__i386__)
@@ -379,6 +385,26 @@ static short interlocked_xchg_add16(short *dest, short incr)
 
 #endif  /* __GNUC__ */
 
+static inline void spin_pause(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __asm__ __volatile__( "rep;nop" : : : "memory" );
+#elif defined(__GNUC__)
+    __asm__ __volatile__( "" : : : "memory" );
+#endif
+}
+
+static inline __int64 interlocked_read64(__int64 *dest)
+{
+    return interlocked_cmpxchg64(dest, 0, 0);
+}
+
+static inline void interlocked_write64(__int64 *dest, __int64 val)
+{
+    __int64 old;
+    do old = *dest; while (interlocked_cmpxchg64(dest, val, old) != old);
+}
+
 static inline struct vcomp_thread_data *vcomp_get_thread_data(void)
 {
     return (struct vcomp_thread_data *)TlsGetValue(vcomp_context_tls);
@@ -407,7 +433,9 @@ static struct vcomp_thread_data *vcomp_init_thread_data(void)
 
     data->task.single           = 0;
     data->task.section          = 0;
+    data->task.section_state    = 0;
     data->task.dynamic          = 0;
+    data->task.dynamic_state    = 0;
 
     thread_data = &data->thread;
     thread_data->team           = NULL;
@@ -1054,25 +1082,43 @@ void CDECL _vcomp_flush(void)
 void CDECL _vcomp_barrier(void)
 {
     struct vcomp_team_data *team_data = vcomp_init_thread_data()->team;
+    volatile int *barrier_ptr;
+    int barrier, spin;
 
     TRACE("()\n");
 
     if (!team_data)
         return;
 
-    EnterCriticalSection(&vcomp_section);
-    if (++team_data->barrier_count >= team_data->num_threads)
+    /* the generation has to be read before arriving, the last thread bumps it */
+    barrier_ptr = &team_data->barrier;
+    barrier = *barrier_ptr;
+    if (interlocked_xchg_add(&team_data->barrier_count, 1) + 1 >= team_data->num_threads)
     {
-        team_data->barrier++;
         team_data->barrier_count = 0;
+        interlocked_xchg_add(&team_data->barrier, 1);
+        EnterCriticalSection(&vcomp_section);
         WakeAllConditionVariable(&team_data->cond);
+        LeaveCriticalSection(&vcomp_section);
+        return;
     }
-    else
+
+    /* spinning only helps when every thread of the team has its own cpu */
+    if (team_data->num_threads <= vcomp_max_threads)
     {
-        unsigned int barrier = team_data->barrier;
-        while (team_data->barrier == barrier)
-            SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
+        for (spin = 0; spin < VCOMP_BARRIER_SPIN_COUNT; spin++)
+        {
+            /* the interlocked read orders the accesses after the barrier,
+             * the plain load is not enough on weakly ordered cpus */
+            if (*barrier_ptr != barrier &&
+                interlocked_cmpxchg((int *)barrier_ptr, 0, 0) != barrier) return;
+            spin_pause();
+        }
     }
+
+    EnterCriticalSection(&vcomp_section);
+    while (*barrier_ptr == barrier)
+        SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
     LeaveCriticalSection(&vcomp_section);
 }
 
@@ -1134,7 +1180,8 @@ void CDECL _vcomp_sections_init(int n)
     {
         task_data->section       = thread_data->section;
         task_data->num_sections  = n;
-        task_data->section_index = 0;
+        interlocked_write64(&task_data->section_state,
+                           ((__int64)thread_data->section << 32) | (unsigned int)max(n, 0));
     }
     LeaveCriticalSection(&vcomp_section);
 }
@@ -1143,18 +1190,23 @@ int CDECL _vcomp_sections_next(void)
 {
     struct vcomp_thread_data *thread_data = vcomp_init_thread_data();
     struct vcomp_task_data *task_data = thread_data->task;
-    int i = -1;
+    __int64 state, prev;
+    int i;
 
     TRACE("()\n");
 
-    EnterCriticalSection(&vcomp_section);
-    if (thread_data->section == task_data->section &&
-        task_data->section_index != task_data->num_sections)
+    /* a construct is only reinitialized once all of its sections were handed out,
+     * so num_sections is stable while the state has remaining sections */
+    state = interlocked_read64(&task_data->section_state);
+    for (;;)
     {
-        i = task_data->section_index++;
+        if ((unsigned int)(state >> 32) != thread_data->section || !(unsigned int)state)
+            return -1;
+        i = task_data->num_sections - (unsigned int)state;
+        if ((prev = interlocked_cmpxchg64(&task_data->section_state, state - 1, state)) == state)
+            return i;
+        state = prev;
     }
-    LeaveCriticalSection(&vcomp_section);
-    return i;
 }
 
 void CDECL _vcomp_for_static_simple_init(unsigned int first, unsigned int last, int step,
@@ -1350,6 +1402,8 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
             task_data->dynamic_iterations   = iterations;
             task_data->dynamic_step         = step;
             task_data->dynamic_chunksize    = chunksize;
+            interlocked_write64(&task_data->dynamic_state,
+                               ((__int64)thread_data->dynamic << 32) | iterations);
         }
         LeaveCriticalSection(&vcomp_section);
     }
@@ -1374,26 +1428,39 @@ int CDECL _vcomp_for_dynamic_next(unsigned int *begin, unsigned int *end)
     else if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_CHUNKED ||
              thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED)
     {
-        unsigned int iterations = 0;
-        EnterCriticalSection(&vcomp_section);
-        if (thread_data->dynamic == task_data->dynamic &&
-            task_data->dynamic_iterations != 0)
+        unsigned int iterations, remaining, first;
+        __int64 state, prev;
+
+        /* chunks are claimed by decrementing the remaining iterations, tagged with
+         * the loop counter, the loop parameters can't change while some are left */
+        state = interlocked_read64(&task_data->dynamic_state);
+        for (;;)
         {
-            iterations = min(task_data->dynamic_iterations, task_data->dynamic_chunksize);
+            remaining = (unsigned int)state;
+            if ((unsigned int)(state >> 32) != thread_data->dynamic || !remaining)
+                return 0;
+
+            iterations = min(remaining, task_data->dynamic_chunksize);
             if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED &&
-                task_data->dynamic_iterations > num_threads * task_data->dynamic_chunksize)
+                remaining > num_threads * task_data->dynamic_chunksize)
             {
-                iterations = (task_data->dynamic_iterations + num_threads - 1) / num_threads;
+                iterations = (remaining + num_threads - 1) / num_threads;
             }
-            *begin = task_data->dynamic_first;
-            *end   = task_data->dynamic_first + (iterations - 1) * task_data->dynamic_step;
-            task_data->dynamic_iterations -= iterations;
-            task_data->dynamic_first      += iterations * task_data->dynamic_step;
-            if (!task_data->dynamic_iterations)
-                *end = task_data->dynamic_last;
+            if (!iterations)
+                return 0;
+            first = task_data->dynamic_first +
+                    (task_data->dynamic_iterations - remaining) * task_data->dynamic_step;
+
+            if ((prev = interlocked_cmpxchg64(&task_data->dynamic_state, state - iterations, state)) == state)
+                break;
+            state = prev;
         }
-        LeaveCriticalSection(&vcomp_section);
-        return iterations != 0;
+
+        *begin = first;
+        *end   = first + (iterations - 1) * task_data->dynamic_step;
+        if (iterations == remaining)
+            *end = task_data->dynamic_last;
+        return 1;
     }
 
     return 0;
@@ -1419,6 +1486,12 @@ static DWORD WINAPI _vcomp_fork_worker(void *param)
         if (team != NULL)
         {
             LeaveCriticalSection(&vcomp_section);
+            if (vcomp_proc_bind && thread_data->bound_cpu != thread_data->thread_num % vcomp_max_threads)
+            {
+                thread_data->bound_cpu = thread_data->thread_num % vcomp_max_threads;
+                if (thread_data->bound_cpu < (int)sizeof(DWORD_PTR) * 8)
+                    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << thread_data->bound_cpu);
+            }
             _vcomp_fork_call_wrapper(team->wrapper, team->nargs, team->valist);
             EnterCriticalSection(&vcomp_section);
 
@@ -1477,7 +1550,9 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
 
     task_data.single            = 0;
     task_data.section           = 0;
+    task_data.section_state     = 0;
     task_data.dynamic           = 0;
+    task_data.dynamic_state     = 0;
 
     thread_data.team            = &team_data;
     thread_data.task            = &task_data;
@@ -1533,6 +1608,7 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
             data->section       = 1;
             data->dynamic       = 1;
             data->dynamic_type  = 0;
+            data->bound_cpu     = -1;
             InitializeConditionVariable(&data->cond);
 
             thread = CreateThread(NULL, 0, _vcomp_fork_worker, data, 0, NULL);
@@ -1682,6 +1758,7 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
         case DLL_PROCESS_ATTACH:
         {
             SYSTEM_INFO sysinfo;
+            char env[16];
 
             if ((vcomp_context_tls = TlsAlloc()) == TLS_OUT_OF_INDEXES)
             {
@@ -1693,6 +1770,11 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
             vcomp_module      = instance;
             vcomp_max_threads = sysinfo.dwNumberOfProcessors;
             vcomp_num_threads = sysinfo.dwNumberOfProcessors;
+
+            /* pin worker threads to one cpu each, like OMP_PROC_BIND=close */
+            if (GetEnvironmentVariableA("OMP_PROC_BIND", env, sizeof(env)) &&
+                (!lstrcmpiA(env, "true") || !lstrcmpiA(env, "close") || !lstrcmpiA(env, "spread")))
+                vcomp_proc_bind = TRUE;
             break;
         }
 
@@ -2222,6 +2222,58 @@ static void test_reduction_float_double(void)
     }
 }
 
+static void CDECL for_dynamic_scaling_cb(unsigned int flags, int loops, LONG *sum)
+{
+    unsigned int begin, end, i;
+    LONG local = 0;
+    int j;
+
+    for (j = 0; j < loops; j++)
+    {
+        p_vcomp_for_dynamic_init(flags | VCOMP_DYNAMIC_FLAGS_INCREMENT, 0, 9999, 1, 4);
+        while (p_vcomp_for_dynamic_next(&begin, &end))
+        {
+            for (i = begin; i <= end; i++)
+                local += i & 7;
+        }
+        p_vcomp_barrier();
+    }
+
+    InterlockedExchangeAdd(sum, local);
+}
+
+static void test_vcomp_for_dynamic_scaling(void)
+{
+    static const unsigned int flags[] = {VCOMP_DYNAMIC_FLAGS_CHUNKED, VCOMP_DYNAMIC_FLAGS_GUIDED};
+    int max_threads = pomp_get_max_threads();
+    LARGE_INTEGER start, end, freq;
+    unsigned int i;
+    int num_threads;
+    LONG sum;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+
+    for (i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+    {
+        for (num_threads = 1; num_threads <= max(max_threads, 4); num_threads *= 2)
+        {
+            pomp_set_num_threads(num_threads);
+
+            sum = 0;
+            p_vcomp_fork(TRUE, 3, for_dynamic_scaling_cb, flags[i], 10, &sum);
+            ok(sum == 10 * 35000, "%s schedule, %d threads: expected sum == %d, got %d\n",
+               flags[i] == VCOMP_DYNAMIC_FLAGS_GUIDED ? "guided" : "dynamic", num_threads, 10 * 35000, sum);
+        }
+    }
+
+    QueryPerformanceCounter(&end);
+    trace("%.2f ms for 10 loops with barriers per schedule and team size\n",
+          (end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart);
+
+    pomp_set_num_threads(max_threads);
+}
+
 START_TEST(vcomp)
 {
     if (!init_vcomp())
@@ -2234,6 +2286,7 @@ START_TEST(vcomp)
     test_vcomp_for_static_simple_init();
     test_vcomp_for_static_init();
     test_vcomp_for_dynamic_init();
+    test_vcomp_for_dynamic_scaling();
     test_vcomp_master_begin();
     test_vcomp_single_begin();
     test_vcomp_enter_critsect();
@@ -93,6 +93,65 @@ static inline float to_sRGB_component(float f)
     return 1.055f * powf(f, 1.0f/2.4f) - 0.055f;
 }
 
+static inline BYTE to_sRGB_byte(float f)
+{
+    return (BYTE)floorf(to_sRGB_component(f) * 255.0f + 0.51f);
+}
+
+/* to_sRGB_byte() is monotonic, so instead of calling powf for each pixel the
+ * conversions search the smallest value in [0,1] giving each 8-bit result */
+static float sRGB_thresholds[256];
+static UINT alpha_reciprocals[256];
+static INIT_ONCE init_tables_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL WINAPI init_tables(INIT_ONCE *once, void *param, void **context)
+{
+    UINT i, lo, hi, mid;
+    float f;
+
+    for (i = 1; i < 256; i++)
+    {
+        /* positive floats are ordered like their bit patterns */
+        lo = 0;
+        hi = 0x3f800000; /* 1.0f */
+        while (lo < hi)
+        {
+            mid = lo + (hi - lo) / 2;
+            memcpy(&f, &mid, sizeof(f));
+            if (to_sRGB_byte(f) >= i) hi = mid;
+            else lo = mid + 1;
+        }
+        memcpy(&sRGB_thresholds[i], &lo, sizeof(f));
+
+        alpha_reciprocals[i] = ((1 << 24) + i - 1) / i;
+    }
+    return TRUE;
+}
+
+static inline BYTE lookup_sRGB_byte(float f)
+{
+    UINT i, value = 0;
+
+    if (!(f >= 0.0f && f <= 1.0f)) return to_sRGB_byte(f);
+
+    for (i = 128; i; i >>= 1)
+        if (sRGB_thresholds[value + i] <= f) value += i;
+    return value;
+}
+
+/* c * a / 255 without a division */
+static inline BYTE premultiply(BYTE c, BYTE a)
+{
+    UINT x = c * a;
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+/* c * 255 / a without a division */
+static inline BYTE unpremultiply(BYTE c, BYTE a)
+{
+    return (c * 255 * (ULONGLONG)alpha_reciprocals[a]) >> 24;
+}
+
 #if 0 /* FIXME: enable once needed */
 static void from_sRGB(BYTE *bgr)
 {
@@ -335,41 +394,22 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         {
             HRESULT res;
             INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
             const BYTE *srcbyte;
-            BYTE *dstrow;
             DWORD *dstpixel;
 
-            srcstride = prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
+            /* read the source in place and expand each row from its end */
+            res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+            if (FAILED(res)) return res;
 
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcbyte = srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++)
-                    {
-                        *dstpixel++ = 0xff000000|(*srcbyte<<16)|(*srcbyte<<8)|*srcbyte;
-                        srcbyte++;
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
+            for (y=0; y<prc->Height; y++) {
+                srcbyte = pbBuffer + cbStride * y + prc->Width;
+                dstpixel = (DWORD*)(pbBuffer + cbStride * y) + prc->Width;
+                for (x=0; x<prc->Width; x++)
+                {
+                    srcbyte--;
+                    *--dstpixel = 0xff000000|(*srcbyte<<16)|(*srcbyte<<8)|*srcbyte;
                 }
             }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
         }
         return S_OK;
     case format_8bppIndexed:
@@ -612,94 +652,36 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         }
         return S_OK;
     case format_24bppBGR:
+    case format_24bppRGB:
         if (prc)
         {
             HRESULT res;
             INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
             const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
+            DWORD *dstpixel;
 
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
+            /* read the source in place and expand each row from its end */
+            res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+            if (FAILED(res)) return res;
 
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
+            for (y=0; y<prc->Height; y++) {
+                srcpixel = pbBuffer + cbStride * y + 3 * prc->Width;
+                dstpixel = (DWORD*)(pbBuffer + cbStride * y) + prc->Width;
+                if (source_format == format_24bppBGR)
+                {
                     for (x=0; x<prc->Width; x++) {
-                        *dstpixel++=*srcpixel++; /* blue */
-                        *dstpixel++=*srcpixel++; /* green */
-                        *dstpixel++=*srcpixel++; /* red */
-                        *dstpixel++=255; /* alpha */
+                        srcpixel -= 3;
+                        *--dstpixel = 0xff000000|srcpixel[2]<<16|srcpixel[1]<<8|srcpixel[0];
                     }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
                 }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
-        return S_OK;
-    case format_24bppRGB:
-        if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-            BYTE tmppixel[3];
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
+                else
+                {
                     for (x=0; x<prc->Width; x++) {
-                        tmppixel[0]=*srcpixel++; /* red */
-                        tmppixel[1]=*srcpixel++; /* green */
-                        tmppixel[2]=*srcpixel++; /* blue */
-
-                        *dstpixel++=tmppixel[2]; /* blue */
-                        *dstpixel++=tmppixel[1]; /* green */
-                        *dstpixel++=tmppixel[0]; /* red */
-                        *dstpixel++=255; /* alpha */
+                        srcpixel -= 3;
+                        *--dstpixel = 0xff000000|srcpixel[0]<<16|srcpixel[1]<<8|srcpixel[2];
                     }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
                 }
             }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
         }
         return S_OK;
     case format_32bppBGR:
@@ -736,9 +718,9 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
                     BYTE alpha = pbBuffer[cbStride*y+4*x+3];
                     if (alpha != 0 && alpha != 255)
                     {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
+                        pbBuffer[cbStride*y+4*x] = unpremultiply(pbBuffer[cbStride*y+4*x], alpha);
+                        pbBuffer[cbStride*y+4*x+1] = unpremultiply(pbBuffer[cbStride*y+4*x+1], alpha);
+                        pbBuffer[cbStride*y+4*x+2] = unpremultiply(pbBuffer[cbStride*y+4*x+2], alpha);
                     }
                 }
         }
@@ -897,9 +879,9 @@ static HRESULT copypixels_to_32bppPBGRA(struct FormatConverter *This, const WICR
                     BYTE alpha = pbBuffer[cbStride*y+4*x+3];
                     if (alpha != 255)
                     {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
+                        pbBuffer[cbStride*y+4*x] = premultiply(pbBuffer[cbStride*y+4*x], alpha);
+                        pbBuffer[cbStride*y+4*x+1] = premultiply(pbBuffer[cbStride*y+4*x+1], alpha);
+                        pbBuffer[cbStride*y+4*x+2] = premultiply(pbBuffer[cbStride*y+4*x+2], alpha);
                     }
                 }
         }
@@ -996,7 +978,7 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
 
                     for (x = 0; x < prc->Width; x++)
                     {
-                        BYTE gray = (BYTE)floorf(to_sRGB_component(gray_float[x]) * 255.0f + 0.51f);
+                        BYTE gray = lookup_sRGB_byte(gray_float[x]);
                         *bgr++ = gray;
                         *bgr++ = gray;
                         *bgr++ = gray;
@@ -1173,7 +1155,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
                     BYTE *dstpixel = dst;
 
                     for (x=0; x < prc->Width; x++)
-                        *dstpixel++ = (BYTE)floorf(to_sRGB_component(*srcpixel++) * 255.0f + 0.51f);
+                        *dstpixel++ = lookup_sRGB_byte(*srcpixel++);
 
                     src += srcstride;
                     dst += cbStride;
@@ -1186,6 +1168,51 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
         return hr;
     }
 
+    if (source_format == format_24bppBGR || source_format == format_24bppRGB ||
+        source_format == format_32bppBGR || source_format == format_32bppBGRA ||
+        source_format == format_32bppPBGRA)
+    {
+        UINT bpp = (source_format == format_24bppBGR || source_format == format_24bppRGB) ? 3 : 4;
+        UINT red = (source_format == format_24bppRGB) ? 0 : 2, blue = 2 - red;
+
+        if (!prc) return S_OK;
+
+        /* compute the luminance straight from the source pixels */
+        srcstride = bpp * prc->Width;
+        srcdatasize = srcstride * prc->Height;
+
+        srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
+        if (!srcdata) return E_OUTOFMEMORY;
+
+        hr = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
+        if (SUCCEEDED(hr))
+        {
+            INT x, y;
+            BYTE *src = srcdata, *dst = pbBuffer;
+
+            for (y = 0; y < prc->Height; y++)
+            {
+                const BYTE *pixel = src;
+
+                for (x = 0; x < prc->Width; x++)
+                {
+                    float gray = (pixel[red] * 0.2126f + pixel[1] * 0.7152f + pixel[blue] * 0.0722f) / 255.0f;
+
+                    dst[x] = lookup_sRGB_byte(gray);
+                    pixel += bpp;
+                }
+                src += srcstride;
+                dst += cbStride;
+            }
+        }
+
+        HeapFree(GetProcessHeap(), 0, srcdata);
+        return hr;
+    }
+
+    if (!prc)
+        return copypixels_to_24bppBGR(This, NULL, 0, 0, NULL, source_format);
+
     srcstride = 3 * prc->Width;
     srcdatasize = srcstride * prc->Height;
 
@@ -1206,8 +1233,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
             {
                 float gray = (bgr[2] * 0.2126f + bgr[1] * 0.7152f + bgr[0] * 0.0722f) / 255.0f;
 
-                gray = to_sRGB_component(gray) * 255.0f;
-                dst[x] = (BYTE)floorf(gray + 0.51f);
+                dst[x] = lookup_sRGB_byte(gray);
                 bgr += 3;
             }
             src += srcstride;
@@ -1398,6 +1424,8 @@ static HRESULT WINAPI FormatConverter_Initialize(IWICFormatConverter *iface,
 
     if (pIPalette && !fixme++) FIXME("ignoring palette\n");
 
+    InitOnceExecuteOnce(&init_tables_once, init_tables, NULL, NULL);
+
     EnterCriticalSection(&This->lock);
 
     if (This->source)
@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include <stdarg.h>
+#include <math.h>
 
 #define COBJMACROS
 
@@ -42,14 +43,49 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+    /* filtered modes: source pixels and weights used by each destination column/row */
+    UINT xtaps, ytaps;
+    UINT *xstart, *ystart;
+    INT *xweights, *yweights;
+    BOOL premultiply; /* straight alpha, colors are filtered premultiplied */
+    /* horizontally filtered source rows, kept between CopyPixels calls */
+    INT *rows;
+    UINT *row_index;
+    INT rows_x, rows_width;
+    UINT rows_next_y; /* first row after the rows copied by the previous call */
+    INT *accum;
+    BYTE *src_row;
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
+/* filter weights are fixed point numbers with FILTER_BITS fractional bits,
+ * horizontally filtered values keep ROW_BITS fractional bits */
+#define FILTER_BITS 14
+#define ROW_BITS 7
+
 static inline BitmapScaler *impl_from_IWICBitmapScaler(IWICBitmapScaler *iface)
 {
     return CONTAINING_RECORD(iface, BitmapScaler, IWICBitmapScaler_iface);
 }
 
+static void Filter_Free(BitmapScaler *This)
+{
+    HeapFree(GetProcessHeap(), 0, This->xstart);
+    HeapFree(GetProcessHeap(), 0, This->ystart);
+    HeapFree(GetProcessHeap(), 0, This->xweights);
+    HeapFree(GetProcessHeap(), 0, This->yweights);
+    HeapFree(GetProcessHeap(), 0, This->rows);
+    HeapFree(GetProcessHeap(), 0, This->row_index);
+    HeapFree(GetProcessHeap(), 0, This->accum);
+    HeapFree(GetProcessHeap(), 0, This->src_row);
+    This->xstart = This->ystart = NULL;
+    This->xweights = This->yweights = NULL;
+    This->rows = NULL;
+    This->row_index = NULL;
+    This->accum = NULL;
+    This->src_row = NULL;
+}
+
 static HRESULT WINAPI BitmapScaler_QueryInterface(IWICBitmapScaler *iface, REFIID iid,
     void **ppv)
 {
@@ -96,6 +132,7 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+        Filter_Free(This);
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -190,6 +227,293 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+/* formats made of 8-bit channels, which the filtered modes interpolate directly;
+ * others are scaled with the nearest neighbor mode to keep their precision */
+static BOOL is_byte_channel_format(const WICPixelFormatGUID *format)
+{
+    static const WICPixelFormatGUID *formats[] =
+    {
+        &GUID_WICPixelFormat8bppGray,
+        &GUID_WICPixelFormat24bppBGR,
+        &GUID_WICPixelFormat24bppRGB,
+        &GUID_WICPixelFormat32bppBGR,
+        &GUID_WICPixelFormat32bppBGRA,
+        &GUID_WICPixelFormat32bppPBGRA,
+        &GUID_WICPixelFormat32bppRGBA,
+        &GUID_WICPixelFormat32bppPRGBA,
+        &GUID_WICPixelFormat32bppCMYK
+    };
+    UINT i;
+
+    for (i = 0; i < sizeof(formats)/sizeof(formats[0]); i++)
+        if (IsEqualGUID(format, formats[i])) return TRUE;
+    return FALSE;
+}
+
+/* Keys cubic convolution kernel, a = -0.5 */
+static double cubic_weight(double x)
+{
+    x = fabs(x);
+    if (x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+}
+
+/* Compute the source pixels and the weights of each destination pixel along one axis.
+ * Every destination pixel uses the same number of consecutive source pixels, taps
+ * falling outside of the source are folded onto the edge pixels. */
+static HRESULT create_filter(WICBitmapInterpolationMode mode, UINT src_size, UINT dst_size,
+    UINT *taps_ret, UINT **start_ret, INT **weights_ret)
+{
+    double scale, center, left, right, lo, hi, total, *ideal, *window;
+    UINT *start, taps, ideal_taps, d, k, largest;
+    INT *weights, sum, pos, first;
+
+    if (!src_size || !dst_size) return E_INVALIDARG;
+
+    scale = (double)src_size / dst_size;
+    switch (mode)
+    {
+    case WICBitmapInterpolationModeLinear: ideal_taps = 2; break;
+    case WICBitmapInterpolationModeCubic: ideal_taps = 4; break;
+    default: ideal_taps = (UINT)ceil(scale) + 1; break;
+    }
+    taps = min(ideal_taps, src_size);
+
+    start = HeapAlloc(GetProcessHeap(), 0, dst_size * sizeof(*start));
+    weights = HeapAlloc(GetProcessHeap(), 0, dst_size * taps * sizeof(*weights));
+    ideal = HeapAlloc(GetProcessHeap(), 0, (ideal_taps + taps) * sizeof(*ideal));
+    if (!start || !weights || !ideal)
+    {
+        HeapFree(GetProcessHeap(), 0, start);
+        HeapFree(GetProcessHeap(), 0, weights);
+        HeapFree(GetProcessHeap(), 0, ideal);
+        return E_OUTOFMEMORY;
+    }
+    window = ideal + ideal_taps;
+
+    for (d = 0; d < dst_size; d++)
+    {
+        if (mode == WICBitmapInterpolationModeFant)
+        {
+            /* average the source area covered by the destination pixel */
+            left = d * scale;
+            right = (d + 1) * scale;
+            first = (INT)floor(left);
+            for (k = 0; k < ideal_taps; k++)
+            {
+                lo = max(left, (double)(first + (INT)k));
+                hi = min(right, (double)(first + (INT)k + 1));
+                ideal[k] = hi > lo ? hi - lo : 0.0;
+            }
+        }
+        else
+        {
+            center = (d + 0.5) * scale - 0.5;
+            first = (INT)floor(center) - (INT)(ideal_taps / 2 - 1);
+            for (k = 0; k < ideal_taps; k++)
+            {
+                if (mode == WICBitmapInterpolationModeLinear)
+                    ideal[k] = max(0.0, 1.0 - fabs(center - (first + (INT)k)));
+                else
+                    ideal[k] = cubic_weight(center - (first + (INT)k));
+            }
+        }
+
+        start[d] = min(max(first, 0), (INT)(src_size - taps));
+        for (k = 0; k < taps; k++) window[k] = 0.0;
+        for (k = 0; k < ideal_taps; k++)
+        {
+            pos = min(max(first + (INT)k, 0), (INT)src_size - 1);
+            window[pos - start[d]] += ideal[k];
+        }
+
+        total = 0.0;
+        for (k = 0; k < taps; k++) total += window[k];
+
+        /* round to fixed point, the largest weight absorbs the rounding error */
+        sum = largest = 0;
+        for (k = 0; k < taps; k++)
+        {
+            weights[d * taps + k] = (INT)floor(window[k] / total * (1 << FILTER_BITS) + 0.5);
+            sum += weights[d * taps + k];
+            if (fabs(window[k]) > fabs(window[largest])) largest = k;
+        }
+        weights[d * taps + largest] += (1 << FILTER_BITS) - sum;
+    }
+
+    HeapFree(GetProcessHeap(), 0, ideal);
+    *taps_ret = taps;
+    *start_ret = start;
+    *weights_ret = weights;
+    return S_OK;
+}
+
+static HRESULT Filter_Initialize(BitmapScaler *This)
+{
+    HRESULT hr;
+
+    hr = create_filter(This->mode, This->src_width, This->width,
+        &This->xtaps, &This->xstart, &This->xweights);
+
+    if (SUCCEEDED(hr))
+        hr = create_filter(This->mode, This->src_height, This->height,
+            &This->ytaps, &This->ystart, &This->yweights);
+
+    if (SUCCEEDED(hr))
+    {
+        This->row_index = HeapAlloc(GetProcessHeap(), 0, This->ytaps * sizeof(*This->row_index));
+        This->src_row = HeapAlloc(GetProcessHeap(), 0, This->src_width * (This->bpp / 8));
+        if (!This->row_index || !This->src_row) hr = E_OUTOFMEMORY;
+    }
+
+    return hr;
+}
+
+/* horizontally filter the source pixels of a row of destination pixels */
+static void Filter_Row(BitmapScaler *This, const BYTE *src, UINT src_x,
+    UINT dst_x, UINT dst_width, INT *dst)
+{
+    UINT channels = This->bpp / 8, taps = This->xtaps;
+    UINT i, k, c;
+
+    for (i = 0; i < dst_width; i++)
+    {
+        const INT *weights = This->xweights + (dst_x + i) * taps;
+        const BYTE *pixel = src + (This->xstart[dst_x + i] - src_x) * channels;
+
+        for (c = 0; c < channels; c++)
+        {
+            INT sum = 1 << (FILTER_BITS - ROW_BITS - 1);
+
+            if (This->premultiply && c < 3)
+            {
+                /* color * alpha, the result is divided by 255 to keep the range of a channel */
+                for (k = 0, sum = 0; k < taps; k++)
+                    sum += weights[k] * pixel[k * channels + c] * pixel[k * channels + 3];
+                dst[i * channels + c] = (sum + (255 << (FILTER_BITS - ROW_BITS - 1))) /
+                    (255 << (FILTER_BITS - ROW_BITS));
+                continue;
+            }
+
+            for (k = 0; k < taps; k++)
+                sum += weights[k] * pixel[k * channels + c];
+            dst[i * channels + c] = sum >> (FILTER_BITS - ROW_BITS);
+        }
+    }
+}
+
+/* divide the filtered colors of straight alpha pixels by their filtered alpha */
+static void Filter_Unpremultiply(const INT *accum, UINT width, BYTE *dst)
+{
+    static const INT bias = 1 << (FILTER_BITS + ROW_BITS - 1);
+    LONGLONG value;
+    INT alpha;
+    UINT i, c;
+
+    for (i = 0; i < width; i++, accum += 4, dst += 4)
+    {
+        alpha = accum[3] - bias;
+        for (c = 0; c < 3; c++)
+        {
+            if (!dst[3] || alpha <= 0)
+                value = 0;
+            else
+                value = ((LONGLONG)(accum[c] - bias) * 255 + alpha / 2) / alpha;
+            dst[c] = value < 0 ? 0 : value > 255 ? 255 : value;
+        }
+    }
+}
+
+/* The filtered modes stream the source: each source row is read and filtered
+ * horizontally once, and kept in a ring of ytaps rows as long as the following
+ * destination rows need it, including across calls copying one scanline at a time. */
+static HRESULT Filter_CopyPixels(BitmapScaler *This, const WICRect *rc,
+    UINT stride, BYTE *buffer)
+{
+    UINT channels = This->bpp / 8, row_size = rc->Width * channels;
+    UINT i, j, k, y, row, slot;
+    WICRect src_rect;
+    const INT *weights, *src;
+    INT *rows, *accum, value;
+    BYTE *dst;
+    HRESULT hr;
+
+    if (!rc->Width || !rc->Height) return S_OK;
+
+    if (!This->rows || This->rows_x != rc->X || This->rows_width != rc->Width)
+    {
+        rows = HeapAlloc(GetProcessHeap(), 0, This->ytaps * row_size * sizeof(*rows));
+        accum = HeapAlloc(GetProcessHeap(), 0, row_size * sizeof(*accum));
+        if (!rows || !accum)
+        {
+            HeapFree(GetProcessHeap(), 0, rows);
+            HeapFree(GetProcessHeap(), 0, accum);
+            return E_OUTOFMEMORY;
+        }
+        HeapFree(GetProcessHeap(), 0, This->rows);
+        HeapFree(GetProcessHeap(), 0, This->accum);
+        This->rows = rows;
+        This->accum = accum;
+        This->rows_x = rc->X;
+        This->rows_width = rc->Width;
+        This->rows_next_y = ~0u;
+    }
+
+    /* the rows are only reused by a call continuing the scanlines of the previous
+     * one, the source may have been modified before any other call */
+    if (rc->Y != This->rows_next_y)
+        for (k = 0; k < This->ytaps; k++) This->row_index[k] = ~0u;
+    This->rows_next_y = rc->Y + rc->Height;
+
+    /* only the source columns used by the destination columns are read */
+    src_rect.X = This->xstart[rc->X];
+    src_rect.Width = This->xstart[rc->X + rc->Width - 1] + This->xtaps - src_rect.X;
+    src_rect.Height = 1;
+
+    for (j = 0; j < rc->Height; j++)
+    {
+        y = rc->Y + j;
+
+        for (k = 0; k < This->ytaps; k++)
+        {
+            row = This->ystart[y] + k;
+            slot = row % This->ytaps;
+            if (This->row_index[slot] == row) continue;
+
+            src_rect.Y = row;
+            hr = IWICBitmapSource_CopyPixels(This->source, &src_rect, src_rect.Width * channels,
+                src_rect.Width * channels, This->src_row);
+            if (FAILED(hr)) return hr;
+
+            Filter_Row(This, This->src_row, src_rect.X, rc->X, rc->Width,
+                This->rows + slot * row_size);
+            This->row_index[slot] = row;
+        }
+
+        accum = This->accum;
+        for (i = 0; i < row_size; i++) accum[i] = 1 << (FILTER_BITS + ROW_BITS - 1);
+
+        weights = This->yweights + y * This->ytaps;
+        for (k = 0; k < This->ytaps; k++)
+        {
+            if (!weights[k]) continue;
+            src = This->rows + ((This->ystart[y] + k) % This->ytaps) * row_size;
+            for (i = 0; i < row_size; i++) accum[i] += weights[k] * src[i];
+        }
+
+        dst = buffer + stride * j;
+        for (i = 0; i < row_size; i++)
+        {
+            value = accum[i] >> (FILTER_BITS + ROW_BITS);
+            dst[i] = value < 0 ? 0 : value > 255 ? 255 : value;
+        }
+        if (This->premultiply) Filter_Unpremultiply(accum, rc->Width, dst);
+    }
+
+    return S_OK;
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -244,6 +568,12 @@ static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
         goto end;
     }
 
+    if (This->xweights)
+    {
+        hr = Filter_CopyPixels(This, &dest_rect, cbStride, pbBuffer);
+        goto end;
+    }
+
     /* MSDN recommends calling CopyPixels once for each scanline from top to
      * bottom, and claims codecs optimize for this. Ideally, when called in this
      * way, we should avoid requesting a scanline from the source more than
@@ -331,6 +661,15 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
         hr = get_pixelformat_bpp(&src_pixelformat, &This->bpp);
     }
 
+    if (SUCCEEDED(hr) && !is_byte_channel_format(&src_pixelformat) &&
+        (mode == WICBitmapInterpolationModeLinear || mode == WICBitmapInterpolationModeCubic ||
+         mode == WICBitmapInterpolationModeFant))
+    {
+        FIXME("interpolation of %s not supported, using nearest neighbor\n",
+            debugstr_guid(&src_pixelformat));
+        mode = WICBitmapInterpolationModeNearestNeighbor;
+    }
+
     if (SUCCEEDED(hr))
     {
         switch (mode)
@@ -353,6 +692,21 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
             This->fn_get_required_source_rect = NearestNeighbor_GetRequiredSourceRect;
             This->fn_copy_scanline = NearestNeighbor_CopyScanline;
             break;
+        case WICBitmapInterpolationModeLinear:
+        case WICBitmapInterpolationModeCubic:
+        case WICBitmapInterpolationModeFant:
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+            This->premultiply = IsEqualGUID(&src_pixelformat, &GUID_WICPixelFormat32bppBGRA) ||
+                                IsEqualGUID(&src_pixelformat, &GUID_WICPixelFormat32bppRGBA);
+            hr = Filter_Initialize(This);
+            if (FAILED(hr))
+            {
+                Filter_Free(This);
+                IWICBitmapSource_Release(This->source);
+                This->source = NULL;
+            }
+            break;
         }
     }
 
@@ -390,6 +744,16 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+    This->xtaps = This->ytaps = 0;
+    This->xstart = This->ystart = NULL;
+    This->xweights = This->yweights = NULL;
+    This->premultiply = FALSE;
+    This->rows = NULL;
+    This->row_index = NULL;
+    This->rows_x = This->rows_width = 0;
+    This->rows_next_y = ~0u;
+    This->accum = NULL;
+    This->src_row = NULL;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
@@ -972,6 +972,264 @@ static void test_clipper(void)
     IWICBitmapClipper_Release(clipper);
 }
 
+static void fill_gray_bitmap(IWICBitmap *bitmap, BYTE value)
+{
+    IWICBitmapLock *lock;
+    UINT size;
+    BYTE *data;
+    HRESULT hr;
+
+    hr = IWICBitmap_Lock(bitmap, NULL, WICBitmapLockWrite, &lock);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    if (FAILED(hr)) return;
+    hr = IWICBitmapLock_GetDataPointer(lock, &size, &data);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    memset(data, value, size);
+    IWICBitmapLock_Release(lock);
+}
+
+static void test_bitmap_scaler(void)
+{
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeNearestNeighbor,
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant
+    };
+    static const BYTE ramp[] = { 0, 100, 200, 250 };
+    /* opaque red next to transparent green */
+    static const BYTE edge[] = { 0x00,0x00,0xff,0xff, 0x00,0xff,0x00,0x00 };
+    static const WORD gray16[] = { 0x1234, 0x1234, 0x1234, 0x1234 };
+    WICPixelFormatGUID format;
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    UINT width, height, i, j, x, y;
+    BYTE color[8 * 6 * 3], buffer[13 * 11 * 3], row[160 * 4];
+    WICRect rect;
+    DWORD start;
+    HRESULT hr;
+
+    for (i = 0; i < sizeof(color); i += 3)
+    {
+        color[i] = 0x20;
+        color[i + 1] = 0x80;
+        color[i + 2] = 0xe0;
+    }
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 8, 6, &GUID_WICPixelFormat24bppBGR,
+        8 * 3, sizeof(color), color, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    /* every mode preserves a solid color, when shrinking or enlarging */
+    for (i = 0; i < sizeof(modes)/sizeof(modes[0]); i++)
+    {
+        for (j = 0; j < 2; j++)
+        {
+            width = j ? 13 : 3;
+            height = j ? 11 : 2;
+
+            hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+            ok(hr == S_OK, "got 0x%08x\n", hr);
+            hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, width, height, modes[i]);
+            ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+
+            memset(buffer, 0, sizeof(buffer));
+            hr = IWICBitmapScaler_CopyPixels(scaler, NULL, width * 3, sizeof(buffer), buffer);
+            ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+            for (x = 0; x < width * height * 3; x++)
+                if (buffer[x] != color[x % 3]) break;
+            ok(x == width * height * 3, "%u: %ux%u: got %#x at %u\n", modes[i], width, height, buffer[x], x);
+
+            /* a sub-rectangle, one scanline at a time */
+            rect.X = 1;
+            rect.Width = width - 2;
+            rect.Height = 1;
+            for (y = 0; y < height; y++)
+            {
+                rect.Y = y;
+                memset(buffer, 0, sizeof(buffer));
+                hr = IWICBitmapScaler_CopyPixels(scaler, &rect, rect.Width * 3, sizeof(buffer), buffer);
+                ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+                for (x = 0; x < rect.Width * 3; x++)
+                    if (buffer[x] != color[x % 3]) break;
+                ok(x == rect.Width * 3, "%u: row %u: got %#x at %u\n", modes[i], y, buffer[x], x);
+            }
+
+            IWICBitmapScaler_Release(scaler);
+        }
+    }
+
+    IWICBitmap_Release(bitmap);
+
+    /* halving averages pairs of pixels */
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 4, 1, &GUID_WICPixelFormat8bppGray,
+        4, sizeof(ramp), (BYTE *)ramp, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, 2, 1, WICBitmapInterpolationModeFant);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    memset(buffer, 0, sizeof(buffer));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 2, sizeof(buffer), buffer);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(buffer[0] == 50 && buffer[1] == 225, "got %u,%u\n", buffer[0], buffer[1]);
+    IWICBitmapScaler_Release(scaler);
+
+    /* enlarging interpolates between the source pixels */
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, 8, 1, WICBitmapInterpolationModeLinear);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    memset(buffer, 0, sizeof(buffer));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 8, sizeof(buffer), buffer);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(buffer[0] == 0 && buffer[7] == 250, "got %u,%u\n", buffer[0], buffer[7]);
+    for (x = 1; x < 8; x++)
+        ok(buffer[x] >= buffer[x - 1], "%u: got %u after %u\n", x, buffer[x], buffer[x - 1]);
+    ok(buffer[2] > 0 && buffer[2] < 100, "got %u\n", buffer[2]);
+    IWICBitmapScaler_Release(scaler);
+
+    IWICBitmap_Release(bitmap);
+
+    /* the color of transparent pixels doesn't bleed into the visible ones */
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 2, 1, &GUID_WICPixelFormat32bppBGRA,
+        8, sizeof(edge), (BYTE *)edge, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    for (i = 1; i < sizeof(modes)/sizeof(modes[0]); i++)
+    {
+        width = modes[i] == WICBitmapInterpolationModeFant ? 1 : 6;
+
+        hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+        hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, width, 1, modes[i]);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        memset(buffer, 0xcc, sizeof(buffer));
+        hr = IWICBitmapScaler_CopyPixels(scaler, NULL, width * 4, sizeof(buffer), buffer);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        for (x = 0; x < width; x++)
+        {
+            BYTE *pixel = buffer + x * 4;
+
+            if (!pixel[3]) continue;
+            ok(pixel[0] <= 1 && pixel[1] <= 1 && pixel[2] >= 254,
+               "%u: pixel %u: got %02x%02x%02x%02x\n", modes[i], x, pixel[3], pixel[2], pixel[1], pixel[0]);
+        }
+        if (width == 1)
+            ok(abs(buffer[3] - 0x80) <= 1, "%u: got alpha %#x\n", modes[i], buffer[3]);
+        IWICBitmapScaler_Release(scaler);
+    }
+
+    IWICBitmap_Release(bitmap);
+
+    /* formats with other than 8-bit channels are scaled without being converted */
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 2, 2, &GUID_WICPixelFormat16bppGray,
+        4, sizeof(gray16), (BYTE *)gray16, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    for (i = 0; i < sizeof(modes)/sizeof(modes[0]); i++)
+    {
+        hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+        hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, 3, 3, modes[i]);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        hr = IWICBitmapScaler_GetPixelFormat(scaler, &format);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        ok(IsEqualGUID(&format, &GUID_WICPixelFormat16bppGray), "%u: got %s\n", modes[i],
+           wine_dbgstr_guid(&format));
+        memset(buffer, 0, sizeof(buffer));
+        hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 3 * 2, sizeof(buffer), buffer);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        for (x = 0; x < 9; x++)
+            if (((WORD *)buffer)[x] != 0x1234) break;
+        ok(x == 9, "%u: got %#x at %u\n", modes[i], ((WORD *)buffer)[x], x);
+        IWICBitmapScaler_Release(scaler);
+    }
+
+    IWICBitmap_Release(bitmap);
+
+    /* the source may change between two calls */
+    hr = IWICImagingFactory_CreateBitmap(factory, 4, 4, &GUID_WICPixelFormat8bppGray,
+        WICBitmapCacheOnLoad, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    for (i = 1; i < sizeof(modes)/sizeof(modes[0]); i++)
+    {
+        fill_gray_bitmap(bitmap, 0x10);
+
+        hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+        hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, 2, 2, modes[i]);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+
+        rect.X = 0;
+        rect.Y = 0;
+        rect.Width = 2;
+        rect.Height = 1;
+        memset(buffer, 0, sizeof(buffer));
+        hr = IWICBitmapScaler_CopyPixels(scaler, &rect, 2, sizeof(buffer), buffer);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        ok(buffer[0] == 0x10 && buffer[1] == 0x10, "%u: got %#x,%#x\n", modes[i], buffer[0], buffer[1]);
+
+        fill_gray_bitmap(bitmap, 0xe0);
+
+        memset(buffer, 0, sizeof(buffer));
+        hr = IWICBitmapScaler_CopyPixels(scaler, &rect, 2, sizeof(buffer), buffer);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        ok(buffer[0] == 0xe0 && buffer[1] == 0xe0, "%u: got %#x,%#x\n", modes[i], buffer[0], buffer[1]);
+
+        fill_gray_bitmap(bitmap, 0x40);
+
+        memset(buffer, 0, sizeof(buffer));
+        hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 2, sizeof(buffer), buffer);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+        for (x = 0; x < 4; x++)
+            if (buffer[x] != 0x40) break;
+        ok(x == 4, "%u: got %#x at %u\n", modes[i], buffer[x], x);
+
+        IWICBitmapScaler_Release(scaler);
+    }
+
+    IWICBitmap_Release(bitmap);
+
+    if (!winetest_interactive)
+    {
+        skip("skipping the scaling throughput test\n");
+        return;
+    }
+
+    /* throughput of making a thumbnail of a 4K picture */
+    hr = IWICImagingFactory_CreateBitmap(factory, 3840, 2160, &GUID_WICPixelFormat32bppBGRA,
+        WICBitmapCacheOnLoad, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    start = GetTickCount();
+    for (i = 0; i < sizeof(modes)/sizeof(modes[0]); i++)
+    {
+        hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+        hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource*)bitmap, 160, 90, modes[i]);
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+
+        rect.X = 0;
+        rect.Width = 160;
+        rect.Height = 1;
+        for (y = 0; y < 90; y++)
+        {
+            rect.Y = y;
+            hr = IWICBitmapScaler_CopyPixels(scaler, &rect, sizeof(row), sizeof(row), row);
+            if (hr != S_OK) break;
+        }
+        ok(hr == S_OK, "%u: got 0x%08x\n", modes[i], hr);
+
+        IWICBitmapScaler_Release(scaler);
+    }
+    trace("3840x2160 to 160x90 in every mode: %u ms\n", GetTickCount() - start);
+
+    IWICBitmap_Release(bitmap);
+}
+
 START_TEST(bitmap)
 {
     HRESULT hr;
@@ -988,6 +1246,7 @@ START_TEST(bitmap)
     test_CreateBitmapFromHICON();
     test_CreateBitmapFromHBITMAP();
     test_clipper();
+    test_bitmap_scaler();
 
     IWICImagingFactory_Release(factory);
 
@@ -346,6 +346,16 @@ static const BYTE bits_32bppBGRA[] = {
 static const struct bitmap_data testdata_32bppBGRA = {
     &GUID_WICPixelFormat32bppBGRA, 32, bits_32bppBGRA, 4, 2, 96.0, 96.0};
 
+static const BYTE bits_32bppBGRA_alpha[] = {
+    200,100,50,128, 10,20,30,255, 255,255,255,0, 255,128,0,64};
+static const struct bitmap_data testdata_32bppBGRA_alpha = {
+    &GUID_WICPixelFormat32bppBGRA, 32, bits_32bppBGRA_alpha, 4, 1, 96.0, 96.0};
+
+static const BYTE bits_32bppPBGRA[] = {
+    100,50,25,128, 10,20,30,255, 0,0,0,0, 64,32,0,64};
+static const struct bitmap_data testdata_32bppPBGRA = {
+    &GUID_WICPixelFormat32bppPBGRA, 32, bits_32bppPBGRA, 4, 1, 96.0, 96.0};
+
 /* XP and 2003 use linear color conversion, later versions use sRGB gamma */
 static const float bits_32bppGrayFloat_xp[] = {
     0.114000f,0.587000f,0.299000f,0.000000f,
@@ -399,6 +409,121 @@ static void test_conversion(const struct bitmap_data *src, const struct bitmap_d
     DeleteTestBitmap(src_obj);
 }
 
+/* the colors of bits_24bppBGR with their gray level */
+static const struct
+{
+    BYTE b, g, r, gray;
+}
+path_colors[] =
+{
+    { 255,0,0, 76 }, { 0,255,0, 220 }, { 0,0,255, 127 }, { 0,0,0, 0 },
+    { 0,255,255, 247 }, { 255,0,255, 145 }, { 255,255,0, 230 }, { 255,255,255, 255 },
+};
+
+static BYTE *put_path_pixel(BYTE *ptr, const WICPixelFormatGUID *format, UINT color, BOOL gray_source)
+{
+    BYTE b = path_colors[color].b, g = path_colors[color].g, r = path_colors[color].r;
+
+    if (gray_source) b = g = r = path_colors[color].gray;
+
+    if (IsEqualGUID(format, &GUID_WICPixelFormat8bppGray))
+    {
+        *ptr++ = path_colors[color].gray;
+    }
+    else if (IsEqualGUID(format, &GUID_WICPixelFormat24bppRGB))
+    {
+        *ptr++ = r;
+        *ptr++ = g;
+        *ptr++ = b;
+    }
+    else
+    {
+        *ptr++ = b;
+        *ptr++ = g;
+        *ptr++ = r;
+        if (!IsEqualGUID(format, &GUID_WICPixelFormat24bppBGR)) *ptr++ = 0xff;
+    }
+    return ptr;
+}
+
+static void test_conversion_paths(void)
+{
+    static const struct
+    {
+        const WICPixelFormatGUID *src_format;
+        UINT src_bpp;
+        const WICPixelFormatGUID *dst_format;
+        UINT dst_bpp;
+        const char *name;
+    }
+    tests[] =
+    {
+        /* expanded in place */
+        { &GUID_WICPixelFormat8bppGray, 1, &GUID_WICPixelFormat32bppBGRA, 4, "8bppGray -> 32bppBGRA" },
+        { &GUID_WICPixelFormat24bppBGR, 3, &GUID_WICPixelFormat32bppBGRA, 4, "24bppBGR -> 32bppBGRA" },
+        { &GUID_WICPixelFormat24bppRGB, 3, &GUID_WICPixelFormat32bppBGRA, 4, "24bppRGB -> 32bppBGRA" },
+        /* converted to gray directly */
+        { &GUID_WICPixelFormat24bppBGR, 3, &GUID_WICPixelFormat8bppGray, 1, "24bppBGR -> 8bppGray" },
+        { &GUID_WICPixelFormat24bppRGB, 3, &GUID_WICPixelFormat8bppGray, 1, "24bppRGB -> 8bppGray" },
+        { &GUID_WICPixelFormat32bppBGR, 4, &GUID_WICPixelFormat8bppGray, 1, "32bppBGR -> 8bppGray" },
+        { &GUID_WICPixelFormat32bppBGRA, 4, &GUID_WICPixelFormat8bppGray, 1, "32bppBGRA -> 8bppGray" },
+    };
+    static const WICRect rects[] = { { 0, 0, 5, 3 }, { 1, 1, 3, 2 } };
+    /* odd sizes, and a destination stride with some padding */
+    BYTE src[5 * 3 * 4], buffer[3 * (5 * 4 + 4)], expect[3 * (5 * 4 + 4)], *ptr;
+    IWICBitmapSource *converted;
+    IWICBitmap *bitmap;
+    UINT i, j, x, y, stride;
+    BOOL gray_source;
+    HRESULT hr;
+
+    for (i = 0; i < sizeof(tests)/sizeof(tests[0]); i++)
+    {
+        ptr = src;
+        for (y = 0; y < 3; y++)
+            for (x = 0; x < 5; x++)
+                ptr = put_path_pixel(ptr, tests[i].src_format, (y * 5 + x) % 8, FALSE);
+
+        hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 5, 3, tests[i].src_format,
+            5 * tests[i].src_bpp, 5 * 3 * tests[i].src_bpp, src, &bitmap);
+        ok(hr == S_OK, "%s: CreateBitmapFromMemory error %#x\n", tests[i].name, hr);
+        if (FAILED(hr)) continue;
+
+        hr = WICConvertBitmapSource(tests[i].dst_format, (IWICBitmapSource *)bitmap, &converted);
+        ok(hr == S_OK, "%s: WICConvertBitmapSource error %#x\n", tests[i].name, hr);
+        if (FAILED(hr))
+        {
+            IWICBitmap_Release(bitmap);
+            continue;
+        }
+
+        gray_source = IsEqualGUID(tests[i].src_format, &GUID_WICPixelFormat8bppGray);
+
+        for (j = 0; j < sizeof(rects)/sizeof(rects[0]); j++)
+        {
+            stride = rects[j].Width * tests[i].dst_bpp + 4;
+
+            memset(expect, 0xcc, sizeof(expect));
+            for (y = 0; y < rects[j].Height; y++)
+            {
+                ptr = expect + y * stride;
+                for (x = 0; x < rects[j].Width; x++)
+                    ptr = put_path_pixel(ptr, tests[i].dst_format,
+                        ((rects[j].Y + y) * 5 + rects[j].X + x) % 8, gray_source);
+            }
+
+            memset(buffer, 0xcc, sizeof(buffer));
+            hr = IWICBitmapSource_CopyPixels(converted, &rects[j], stride, sizeof(buffer), buffer);
+            ok(hr == S_OK, "%s: CopyPixels error %#x\n", tests[i].name, hr);
+            ok(!memcmp(buffer, expect, sizeof(buffer)), "%s: rect %u: unexpected pixel data\n",
+               tests[i].name, j);
+        }
+
+        IWICBitmapSource_Release(converted);
+        IWICBitmap_Release(bitmap);
+    }
+}
+
 static void test_invalid_conversion(void)
 {
     BitmapTestSrc *src_obj;
@@ -1168,6 +1293,7 @@ START_TEST(converter)
     test_conversion(&testdata_32bppBGR, &testdata_24bppRGB, "32bppBGR -> 24bppRGB", FALSE);
     test_conversion(&testdata_24bppRGB, &testdata_32bppBGR, "24bppRGB -> 32bppBGR", FALSE);
     test_conversion(&testdata_32bppBGRA, &testdata_24bppRGB, "32bppBGRA -> 24bppRGB", FALSE);
+    test_conversion(&testdata_32bppBGRA_alpha, &testdata_32bppPBGRA, "32bppBGRA -> 32bppPBGRA", FALSE);
 
     test_conversion(&testdata_24bppRGB, &testdata_32bppGrayFloat, "24bppRGB -> 32bppGrayFloat", FALSE);
     test_conversion(&testdata_32bppBGR, &testdata_32bppGrayFloat, "32bppBGR -> 32bppGrayFloat", FALSE);
@@ -1179,6 +1305,7 @@ START_TEST(converter)
 
     test_invalid_conversion();
     test_default_converter();
+    test_conversion_paths();
 
     test_encoder(&testdata_BlackWhite, &CLSID_WICPngEncoder,
                  &testdata_BlackWhite, &CLSID_WICPngDecoder, "PNG encoder BlackWhite");
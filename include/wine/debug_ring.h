@@ -0,0 +1,192 @@
+/*
+ * Binary trace ring buffers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __WINE_WINE_DEBUG_RING_H
+#define __WINE_WINE_DEBUG_RING_H
+
+#include <string.h>
+
+/* When WINEDEBUGRING is set to a directory, debug messages are not formatted but
+ * recorded with their raw arguments in a per-thread ring buffer, mapped from a
+ * file in that directory. The files survive the process and are decoded with
+ * "winedump dump".
+ *
+ * The header is followed by a string table, which is only ever appended to, and
+ * by the ring data area. Events refer to their format, channel and function by
+ * key; the strings go to the table, or to the ring itself once the table is full. */
+
+#define DEBUG_RING_MAGIC       0x474e5244  /* "DRNG" */
+#define DEBUG_RING_VERSION     2
+#define DEBUG_RING_SIZE        (1024 * 1024)  /* size of the data area of a ring */
+#define DEBUG_RING_STRINGS_SIZE (256 * 1024)  /* size of the string table */
+#define DEBUG_RING_MAX_RECORD  2048           /* maximum size of a record */
+#define DEBUG_RING_MAX_STRING  512            /* maximum length of a recorded string */
+#define DEBUG_RING_NO_CLASS    0xff           /* class of text printed outside of a message */
+#define DEBUG_RING_NULL_STRING 0xffff         /* length of a NULL string argument */
+
+struct debug_ring_header
+{
+    unsigned int      magic;          /* DEBUG_RING_MAGIC */
+    unsigned int      version;        /* DEBUG_RING_VERSION */
+    unsigned int      pid;            /* process id of the writer */
+    unsigned int      tid;            /* thread id of the writer */
+    unsigned int      size;           /* size of the data area following the header */
+    unsigned char     long_size;      /* sizeof(long) in the writer */
+    unsigned char     ptr_size;       /* sizeof(void *) in the writer */
+    unsigned short    __pad;
+    unsigned int      head;           /* offset of the next record */
+    unsigned int      tail;           /* offset of the oldest record */
+    unsigned int      used;           /* bytes used by the records from tail to head */
+    unsigned int      dropped;        /* number of records overwritten so far */
+    unsigned int      strings_size;   /* size of the string table following the header */
+    unsigned int      strings_used;   /* bytes used by the string records in the table */
+    unsigned __int64  start_time;     /* system time when the ring was created */
+    unsigned __int64  start_counter;  /* performance counter when the ring was created */
+    unsigned __int64  frequency;      /* performance counter frequency */
+};
+
+enum debug_ring_record_type
+{
+    DEBUG_RING_PAD,     /* unused space at the end of the data area */
+    DEBUG_RING_STRING,  /* text of a format, channel or function name, in the table or the ring */
+    DEBUG_RING_EVENT    /* debug message */
+};
+
+struct debug_ring_record
+{
+    unsigned short    size;           /* size of the record including the header, multiple of 8 */
+    unsigned char     type;           /* enum debug_ring_record_type */
+    unsigned char     cls;            /* debug class of an event */
+    unsigned int      len;            /* length of the string or of the event arguments */
+    unsigned __int64  key;            /* string: pointer identifying it; event: key of the format */
+};
+
+struct debug_ring_event
+{
+    struct debug_ring_record hdr;
+    unsigned __int64  time;           /* performance counter */
+    unsigned __int64  channel;        /* key of the channel name */
+    unsigned __int64  function;       /* key of the function name */
+    /* followed by the arguments: 8 bytes for numbers and pointers, a 16-bit length
+     * and the characters for strings, without alignment */
+};
+
+enum debug_ring_arg
+{
+    DEBUG_RING_ARG_NONE,    /* no more arguments */
+    DEBUG_RING_ARG_INT,
+    DEBUG_RING_ARG_UINT,
+    DEBUG_RING_ARG_LONG,
+    DEBUG_RING_ARG_ULONG,
+    DEBUG_RING_ARG_INT64,
+    DEBUG_RING_ARG_UINT64,
+    DEBUG_RING_ARG_SIZE,
+    DEBUG_RING_ARG_PTR,
+    DEBUG_RING_ARG_DOUBLE,
+    DEBUG_RING_ARG_STRING
+};
+
+#define DEBUG_RING_STAR_PRECISION (-2)  /* precision given by the last star argument */
+
+/* find the next conversion of a printf format; returns its start, or the end of the
+ * format if there is none. The width and precision can take 'stars' int arguments;
+ * precision is -1 if there is none. */
+static inline const char *debug_ring_parse_format( const char *format, const char **end,
+                                                   unsigned int *stars, int *precision,
+                                                   enum debug_ring_arg *type )
+{
+    const char *p;
+    int longs = 0, size = 0, long_double = 0;
+
+    *stars = 0;
+    *precision = -1;
+    *type = DEBUG_RING_ARG_NONE;
+    for (;;)
+    {
+        while (*format && *format != '%') format++;
+        if (format[0] == '%' && format[1] == '%') format += 2;
+        else break;
+    }
+    if (!*format)
+    {
+        *end = format;
+        return format;
+    }
+
+    for (p = format + 1; *p && strchr( "-+ #0123456789.*'", *p ); p++)
+    {
+        if (*p == '*') (*stars)++;
+        if (*p != '.') continue;
+        if (p[1] == '*') *precision = DEBUG_RING_STAR_PRECISION;
+        else for (*precision = 0; p[1] >= '0' && p[1] <= '9'; p++)
+            *precision = *precision * 10 + p[1] - '0';
+    }
+    for (;; p++)
+    {
+        if (*p == 'l') longs++;
+        else if (*p == 'L') long_double = 1;
+        else if (*p == 'z' || *p == 't') size = 1;
+        else if (*p == 'j' || *p == 'q') longs = 2;
+        else if (p[0] == 'I' && p[1] == '6' && p[2] == '4')
+        {
+            longs = 2;
+            p += 2;
+        }
+        else if (*p != 'h') break;
+    }
+
+    switch (*p)
+    {
+    case 'd':
+    case 'i':
+        *type = size ? DEBUG_RING_ARG_SIZE : longs > 1 ? DEBUG_RING_ARG_INT64 :
+                longs ? DEBUG_RING_ARG_LONG : DEBUG_RING_ARG_INT;
+        break;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        *type = size ? DEBUG_RING_ARG_SIZE : longs > 1 ? DEBUG_RING_ARG_UINT64 :
+                longs ? DEBUG_RING_ARG_ULONG : DEBUG_RING_ARG_UINT;
+        break;
+    case 'c':
+        *type = longs ? DEBUG_RING_ARG_NONE : DEBUG_RING_ARG_INT;
+        break;
+    case 'p':
+        *type = DEBUG_RING_ARG_PTR;
+        break;
+    case 's':
+        *type = longs ? DEBUG_RING_ARG_NONE : DEBUG_RING_ARG_STRING;
+        break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        *type = long_double ? DEBUG_RING_ARG_NONE : DEBUG_RING_ARG_DOUBLE;
+        break;
+    }
+    /* unsupported conversions stop the argument list */
+    *end = (*type == DEBUG_RING_ARG_NONE) ? format : p + 1;
+    return format;
+}
+
+#endif  /* __WINE_WINE_DEBUG_RING_H */
@@ -49,7 +49,16 @@ struct __server_request_info
     struct __server_iovec data[__SERVER_MAX_DATA];  /* request variable size data */
 };
 
+struct __server_batch_entry
+{
+    struct __server_request_info *req;  /* request, prepared like for wine_server_call */
+    int             handle_from;        /* index of the entry whose reply provides a handle, -1 if none */
+    unsigned short  handle_offset;      /* offset of the handle in the request */
+    unsigned short  reply_offset;       /* offset of the handle in the reply of entry handle_from */
+};
+
 extern unsigned int wine_server_call( void *req_ptr );
+extern unsigned int CDECL wine_server_call_batch( struct __server_batch_entry *entries, unsigned int count );
 extern void CDECL wine_server_send_fd( int fd );
 extern int CDECL wine_server_fd_to_handle( int fd, unsigned int access, unsigned int attributes, HANDLE *handle );
 extern int CDECL wine_server_handle_to_fd( HANDLE handle, unsigned int access, int *unix_fd, unsigned int *options );
@@ -63,6 +72,16 @@ static inline unsigned int wine_server_call_err( void *req_ptr )
     return res;
 }
 
+/* prepare a request to be sent with wine_server_call_batch */
+static inline void wine_server_init_req( void *req_ptr, enum request type )
+{
+    struct __server_request_info * const req = req_ptr;
+    memset( &req->u.req, 0, sizeof(req->u.req) );
+    req->u.req.request_header.req = type;
+    req->data_count = 0;
+    req->reply_data = NULL;
+}
+
 /* get the size of the variable part of the returned reply */
 static inline data_size_t wine_server_reply_size( const void *reply )
 {
@@ -1221,6 +1221,8 @@ struct event_op_request
 struct event_op_reply
 {
     struct reply_header __header;
+    int           state;
+    char __pad_12[4];
 };
 enum event_op { PULSE_EVENT, SET_EVENT, RESET_EVENT };
 
@@ -1410,6 +1412,40 @@ struct open_semaphore_reply
 
 
 
+struct get_esync_fd_request
+{
+    struct request_header __header;
+    obj_handle_t handle;
+};
+struct get_esync_fd_reply
+{
+    struct reply_header __header;
+    int          type;
+    unsigned int access;
+    unsigned int shm_idx;
+    char __pad_20[4];
+};
+enum esync_type
+{
+    ESYNC_NONE,
+    ESYNC_AUTO_EVENT,
+    ESYNC_MANUAL_EVENT,
+    ESYNC_SEMAPHORE,
+    ESYNC_MUTEX
+};
+
+
+struct esync_shm
+{
+    int          count;
+    unsigned int value;
+};
+#define ESYNC_SHM_NAME        "esync"
+#define ESYNC_SHM_ENTRIES     65536
+#define ESYNC_MUTEX_ABANDONED (~0u)
+
+
+
 struct create_file_request
 {
     struct request_header __header;
@@ -5540,6 +5576,54 @@ struct terminate_job_reply
 };
 
 
+struct request_stats
+{
+    unsigned int     count;
+    unsigned int     blocked;
+    unsigned __int64 time;
+    unsigned __int64 reply_size;
+};
+
+
+struct get_request_stats_request
+{
+    struct request_header __header;
+    process_id_t pid;
+};
+struct get_request_stats_reply
+{
+    struct reply_header __header;
+    timeout_t    start_time;
+    /* VARARG(stats,request_stats); */
+};
+
+
+#define MAX_BATCH_REQUESTS 16
+
+
+struct batch_header
+{
+    int            handle_from;
+    unsigned short handle_offset;
+    unsigned short reply_offset;
+};
+
+
+struct batch_request
+{
+    struct request_header __header;
+    /* VARARG(requests,bytes); */
+    char __pad_12[4];
+};
+struct batch_reply
+{
+    struct reply_header __header;
+    unsigned int count;
+    /* VARARG(replies,bytes); */
+    char __pad_12[4];
+};
+
+
 enum request
 {
     REQ_new_process,
@@ -5583,6 +5667,7 @@ enum request
     REQ_release_semaphore,
     REQ_query_semaphore,
     REQ_open_semaphore,
+    REQ_get_esync_fd,
     REQ_create_file,
     REQ_open_file_object,
     REQ_alloc_file_handle,
@@ -5826,9 +5911,306 @@ enum request
     REQ_set_job_limits,
     REQ_set_job_completion_port,
     REQ_terminate_job,
+    REQ_get_request_stats,
+    REQ_batch,
     REQ_NB_REQUESTS
 };
 
+#ifdef WANT_REQUEST_NAMES
+
+static const char * const server_request_names[REQ_NB_REQUESTS] =
+{
+    "new_process",
+    "get_new_process_info",
+    "new_thread",
+    "get_startup_info",
+    "init_process_done",
+    "init_thread",
+    "terminate_process",
+    "terminate_thread",
+    "get_process_info",
+    "get_process_vm_counters",
+    "set_process_info",
+    "get_thread_info",
+    "get_thread_times",
+    "set_thread_info",
+    "get_dll_info",
+    "suspend_thread",
+    "resume_thread",
+    "load_dll",
+    "unload_dll",
+    "queue_apc",
+    "get_apc_result",
+    "close_handle",
+    "set_handle_info",
+    "dup_handle",
+    "open_process",
+    "open_thread",
+    "select",
+    "create_event",
+    "event_op",
+    "query_event",
+    "open_event",
+    "create_keyed_event",
+    "open_keyed_event",
+    "create_mutex",
+    "release_mutex",
+    "open_mutex",
+    "query_mutex",
+    "create_semaphore",
+    "release_semaphore",
+    "query_semaphore",
+    "open_semaphore",
+    "get_esync_fd",
+    "create_file",
+    "open_file_object",
+    "alloc_file_handle",
+    "get_handle_unix_name",
+    "get_handle_fd",
+    "get_directory_cache_entry",
+    "flush",
+    "lock_file",
+    "unlock_file",
+    "create_socket",
+    "accept_socket",
+    "accept_into_socket",
+    "set_socket_event",
+    "get_socket_event",
+    "get_socket_info",
+    "enable_socket_event",
+    "set_socket_deferred",
+    "alloc_console",
+    "free_console",
+    "get_console_renderer_events",
+    "open_console",
+    "get_console_wait_event",
+    "get_console_mode",
+    "set_console_mode",
+    "set_console_input_info",
+    "get_console_input_info",
+    "append_console_input_history",
+    "get_console_input_history",
+    "create_console_output",
+    "set_console_output_info",
+    "get_console_output_info",
+    "write_console_input",
+    "read_console_input",
+    "write_console_output",
+    "fill_console_output",
+    "read_console_output",
+    "move_console_output",
+    "send_console_signal",
+    "read_directory_changes",
+    "read_change",
+    "create_mapping",
+    "open_mapping",
+    "get_mapping_info",
+    "get_mapping_committed_range",
+    "add_mapping_committed_range",
+    "create_snapshot",
+    "next_process",
+    "next_thread",
+    "wait_debug_event",
+    "queue_exception_event",
+    "get_exception_status",
+    "continue_debug_event",
+    "debug_process",
+    "debug_break",
+    "set_debugger_kill_on_exit",
+    "read_process_memory",
+    "write_process_memory",
+    "create_key",
+    "open_key",
+    "delete_key",
+    "flush_key",
+    "enum_key",
+    "set_key_value",
+    "get_key_value",
+    "enum_key_value",
+    "delete_key_value",
+    "load_registry",
+    "unload_registry",
+    "save_registry",
+    "set_registry_notification",
+    "create_timer",
+    "open_timer",
+    "set_timer",
+    "cancel_timer",
+    "get_timer_info",
+    "get_thread_context",
+    "set_thread_context",
+    "get_selector_entry",
+    "add_atom",
+    "delete_atom",
+    "find_atom",
+    "get_atom_information",
+    "set_atom_information",
+    "empty_atom_table",
+    "init_atom_table",
+    "get_msg_queue",
+    "set_queue_fd",
+    "set_queue_mask",
+    "get_queue_status",
+    "get_process_idle_event",
+    "send_message",
+    "post_quit_message",
+    "send_hardware_message",
+    "get_message",
+    "reply_message",
+    "accept_hardware_message",
+    "get_message_reply",
+    "set_win_timer",
+    "kill_win_timer",
+    "is_window_hung",
+    "get_serial_info",
+    "set_serial_info",
+    "register_async",
+    "cancel_async",
+    "get_async_result",
+    "read",
+    "write",
+    "ioctl",
+    "set_irp_result",
+    "create_named_pipe",
+    "get_named_pipe_info",
+    "set_named_pipe_info",
+    "create_window",
+    "destroy_window",
+    "get_desktop_window",
+    "set_window_owner",
+    "get_window_info",
+    "set_window_info",
+    "set_parent",
+    "get_window_parents",
+    "get_window_children",
+    "get_window_children_from_point",
+    "get_window_tree",
+    "set_window_pos",
+    "get_window_rectangles",
+    "get_window_text",
+    "set_window_text",
+    "get_windows_offset",
+    "get_visible_region",
+    "get_surface_region",
+    "get_window_region",
+    "set_window_region",
+    "get_update_region",
+    "update_window_zorder",
+    "redraw_window",
+    "set_window_property",
+    "remove_window_property",
+    "get_window_property",
+    "get_window_properties",
+    "create_winstation",
+    "open_winstation",
+    "close_winstation",
+    "get_process_winstation",
+    "set_process_winstation",
+    "enum_winstation",
+    "create_desktop",
+    "open_desktop",
+    "open_input_desktop",
+    "close_desktop",
+    "get_thread_desktop",
+    "set_thread_desktop",
+    "enum_desktop",
+    "set_user_object_info",
+    "register_hotkey",
+    "unregister_hotkey",
+    "attach_thread_input",
+    "get_thread_input",
+    "get_last_input_time",
+    "get_key_state",
+    "set_key_state",
+    "set_foreground_window",
+    "set_focus_window",
+    "set_active_window",
+    "set_capture_window",
+    "set_caret_window",
+    "set_caret_info",
+    "set_hook",
+    "remove_hook",
+    "start_hook_chain",
+    "finish_hook_chain",
+    "get_hook_info",
+    "create_class",
+    "destroy_class",
+    "set_class_info",
+    "open_clipboard",
+    "close_clipboard",
+    "empty_clipboard",
+    "set_clipboard_data",
+    "get_clipboard_data",
+    "get_clipboard_formats",
+    "enum_clipboard_formats",
+    "release_clipboard",
+    "get_clipboard_info",
+    "set_clipboard_viewer",
+    "add_clipboard_listener",
+    "remove_clipboard_listener",
+    "open_token",
+    "set_global_windows",
+    "adjust_token_privileges",
+    "get_token_privileges",
+    "check_token_privileges",
+    "duplicate_token",
+    "access_check",
+    "get_token_sid",
+    "get_token_groups",
+    "get_token_default_dacl",
+    "set_token_default_dacl",
+    "set_security_object",
+    "get_security_object",
+    "get_system_handles",
+    "create_mailslot",
+    "set_mailslot_info",
+    "create_directory",
+    "open_directory",
+    "get_directory_entry",
+    "create_symlink",
+    "open_symlink",
+    "query_symlink",
+    "get_object_info",
+    "get_object_type",
+    "unlink_object",
+    "get_token_impersonation_level",
+    "allocate_locally_unique_id",
+    "create_device_manager",
+    "create_device",
+    "delete_device",
+    "get_next_device_request",
+    "make_process_system",
+    "get_token_statistics",
+    "create_completion",
+    "open_completion",
+    "add_completion",
+    "remove_completion",
+    "query_completion",
+    "set_completion_info",
+    "add_fd_completion",
+    "set_fd_disp_info",
+    "set_fd_name_info",
+    "get_window_layered_info",
+    "set_window_layered_info",
+    "alloc_user_handle",
+    "free_user_handle",
+    "set_cursor",
+    "update_rawinput_devices",
+    "get_suspend_context",
+    "set_suspend_context",
+    "create_job",
+    "open_job",
+    "assign_job",
+    "process_in_job",
+    "set_job_limits",
+    "set_job_completion_port",
+    "terminate_job",
+    "get_request_stats",
+    "batch",
+};
+
+#endif /* WANT_REQUEST_NAMES */
+
 union generic_request
 {
     struct request_max_size max_size;
@@ -5874,6 +6256,7 @@ union generic_request
     struct release_semaphore_request release_semaphore_request;
     struct query_semaphore_request query_semaphore_request;
     struct open_semaphore_request open_semaphore_request;
+    struct get_esync_fd_request get_esync_fd_request;
     struct create_file_request create_file_request;
     struct open_file_object_request open_file_object_request;
     struct alloc_file_handle_request alloc_file_handle_request;
@@ -6117,6 +6500,8 @@ union generic_request
     struct set_job_limits_request set_job_limits_request;
     struct set_job_completion_port_request set_job_completion_port_request;
     struct terminate_job_request terminate_job_request;
+    struct get_request_stats_request get_request_stats_request;
+    struct batch_request batch_request;
 };
 union generic_reply
 {
@@ -6163,6 +6548,7 @@ union generic_reply
     struct release_semaphore_reply release_semaphore_reply;
     struct query_semaphore_reply query_semaphore_reply;
     struct open_semaphore_reply open_semaphore_reply;
+    struct get_esync_fd_reply get_esync_fd_reply;
     struct create_file_reply create_file_reply;
     struct open_file_object_reply open_file_object_reply;
     struct alloc_file_handle_reply alloc_file_handle_reply;
@@ -6406,8 +6792,10 @@ union generic_reply
     struct set_job_limits_reply set_job_limits_reply;
     struct set_job_completion_port_reply set_job_completion_port_reply;
     struct terminate_job_reply terminate_job_reply;
+    struct get_request_stats_reply get_request_stats_reply;
+    struct batch_reply batch_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 537
+#define SERVER_PROTOCOL_VERSION 540
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
@@ -64,6 +64,7 @@ struct sbcs_table
     const WCHAR          *cp2uni_glyphs;     /* code page -> Unicode map with glyph chars */
     const unsigned char  *uni2cp_low;        /* Unicode -> code page map */
     const unsigned short *uni2cp_high;
+    int                   ascii_identity;    /* 7-bit ASCII maps to itself both ways */
 };
 
 struct dbcs_table
@@ -194,9 +195,33 @@ WINE_UNICODE_INLINE int isprintW( WCHAR wc )
 
 /* some useful string manipulation routines */
 
+/* The search functions check a machine word of characters at a time once the
+ * string is aligned; aligned reads never cross a page boundary, so they can't
+ * fault past the end of the string. */
+#define WINE_WCHAR_WORD_COUNT (sizeof(ULONG_PTR) / sizeof(WCHAR))
+#define WINE_WCHAR_WORD_ONES  (~(ULONG_PTR)0 / 0xffff)
+
+/* the words alias the WCHAR strings they are read from */
+#ifdef __GNUC__
+typedef ULONG_PTR __attribute__((__may_alias__)) wine_wchar_word_t;
+#else
+typedef ULONG_PTR wine_wchar_word_t;
+#endif
+
+/* non-zero if one of the characters packed in the word is null */
+WINE_UNICODE_INLINE ULONG_PTR wine_wchar_word_has_zero( ULONG_PTR word )
+{
+    return (word - WINE_WCHAR_WORD_ONES) & ~word & (WINE_WCHAR_WORD_ONES << 15);
+}
+
 WINE_UNICODE_INLINE unsigned int strlenW( const WCHAR *str )
 {
     const WCHAR *s = str;
+    if (!((ULONG_PTR)s & 1))
+    {
+        for ( ; (ULONG_PTR)s % sizeof(ULONG_PTR); s++) if (!*s) return s - str;
+        while (!wine_wchar_word_has_zero( *(const wine_wchar_word_t *)s )) s += WINE_WCHAR_WORD_COUNT;
+    }
     while (*s) s++;
     return s - str;
 }
@@ -213,6 +238,18 @@ WINE_UNICODE_INLINE WCHAR *strcpyW( WCHAR *dst, const WCHAR *src )
 
 WINE_UNICODE_INLINE int strcmpW( const WCHAR *str1, const WCHAR *str2 )
 {
+    /* words can only be compared when both strings have the same alignment */
+    if (!((ULONG_PTR)str1 & 1) && !(((ULONG_PTR)str1 ^ (ULONG_PTR)str2) % sizeof(ULONG_PTR)))
+    {
+        for ( ; (ULONG_PTR)str1 % sizeof(ULONG_PTR); str1++, str2++)
+            if (!*str1 || *str1 != *str2) return *str1 - *str2;
+        while (*(const wine_wchar_word_t *)str1 == *(const wine_wchar_word_t *)str2 &&
+               !wine_wchar_word_has_zero( *(const wine_wchar_word_t *)str1 ))
+        {
+            str1 += WINE_WCHAR_WORD_COUNT;
+            str2 += WINE_WCHAR_WORD_COUNT;
+        }
+    }
     while (*str1 && (*str1 == *str2)) { str1++; str2++; }
     return *str1 - *str2;
 }
@@ -232,6 +269,21 @@ WINE_UNICODE_INLINE WCHAR *strcatW( WCHAR *dst, const WCHAR *src )
 
 WINE_UNICODE_INLINE WCHAR *strchrW( const WCHAR *str, WCHAR ch )
 {
+    if (!((ULONG_PTR)str & 1))
+    {
+        ULONG_PTR pattern = ch * WINE_WCHAR_WORD_ONES, word;
+        for ( ; (ULONG_PTR)str % sizeof(ULONG_PTR); str++)
+        {
+            if (*str == ch) return (WCHAR *)(ULONG_PTR)str;
+            if (!*str) return NULL;
+        }
+        for (;;)
+        {
+            word = *(const wine_wchar_word_t *)str;
+            if (wine_wchar_word_has_zero( word ) || wine_wchar_word_has_zero( word ^ pattern )) break;
+            str += WINE_WCHAR_WORD_COUNT;
+        }
+    }
     do { if (*str == ch) return (WCHAR *)(ULONG_PTR)str; } while (*str++);
     return NULL;
 }
@@ -279,8 +331,17 @@ WINE_UNICODE_INLINE WCHAR *struprW( WCHAR *str )
 
 WINE_UNICODE_INLINE WCHAR *memchrW( const WCHAR *ptr, WCHAR ch, size_t n )
 {
-    const WCHAR *end;
-    for (end = ptr + n; ptr < end; ptr++) if (*ptr == ch) return (WCHAR *)(ULONG_PTR)ptr;
+    const WCHAR *end = ptr + n;
+    if (!((ULONG_PTR)ptr & 1))
+    {
+        ULONG_PTR pattern = ch * WINE_WCHAR_WORD_ONES;
+        for ( ; ptr < end && (ULONG_PTR)ptr % sizeof(ULONG_PTR); ptr++)
+            if (*ptr == ch) return (WCHAR *)(ULONG_PTR)ptr;
+        while ((size_t)(end - ptr) >= WINE_WCHAR_WORD_COUNT &&
+               !wine_wchar_word_has_zero( *(const wine_wchar_word_t *)ptr ^ pattern ))
+            ptr += WINE_WCHAR_WORD_COUNT;
+    }
+    for ( ; ptr < end; ptr++) if (*ptr == ch) return (WCHAR *)(ULONG_PTR)ptr;
     return NULL;
 }
 
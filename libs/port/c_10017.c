@@ -756,5 +756,6 @@ const struct sbcs_table DECLSPEC_HIDDEN cptable_10017 =
     cp2uni,
     cp2uni,
     uni2cp_low,
-    uni2cp_high
+    uni2cp_high,
+    1
 };
@@ -425,5 +425,6 @@ const struct sbcs_table DECLSPEC_HIDDEN cptable_874 =
     cp2uni,
     cp2uni + 256,
     uni2cp_low,
-    uni2cp_high
+    uni2cp_high,
+    1
 };
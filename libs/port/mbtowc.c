@@ -18,6 +18,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
  */
 
+#include "config.h"
+
 #include <string.h>
 
 #include "wine/unicode.h"
@@ -49,6 +51,33 @@ static inline int check_invalid_chars_sbcs( const struct sbcs_table *table, int
     return srclen;
 }
 
+/* spread the 7-bit ASCII chars stored in the low half of a word to one WCHAR each */
+static inline ULONG_PTR spread_ascii_chars( ULONG_PTR val )
+{
+    val = (val | val << 16) & ((ULONG_PTR)~0 / 0xffffffff * 0xffff);
+    return (val | val << 8) & ((ULONG_PTR)~0 / 0xffff * 0xff);
+}
+
+/* convert the leading 7-bit ASCII chars a machine word at a time; returns the number of chars converted */
+static inline unsigned int mbstowcs_ascii( const unsigned char *src, unsigned int srclen, WCHAR *dst )
+{
+    const unsigned int half = sizeof(ULONG_PTR) * 4;
+    unsigned int pos = 0;
+    ULONG_PTR val, lo, hi;
+
+    while (srclen - pos >= sizeof(val))
+    {
+        memcpy( &val, src + pos, sizeof(val) );
+        if (val & ((ULONG_PTR)~0 / 0xff * 0x80)) break;
+        lo = spread_ascii_chars( val & ((ULONG_PTR)~0 >> half) );
+        hi = spread_ascii_chars( val >> half );
+        memcpy( dst + pos, &lo, sizeof(lo) );
+        memcpy( dst + pos + sizeof(val) / 2, &hi, sizeof(hi) );
+        pos += sizeof(val);
+    }
+    return pos;
+}
+
 /* mbstowcs for single-byte code page */
 /* all lengths are in characters, not bytes */
 static inline int mbstowcs_sbcs( const struct sbcs_table *table, int flags,
@@ -95,6 +124,18 @@ static inline int mbstowcs_sbcs( const struct sbcs_table *table, int flags,
     }
 }
 
+/* mbstowcs for single-byte code page where 7-bit ASCII maps to itself */
+static int mbstowcs_sbcs_ascii( const struct sbcs_table *table,
+                                const unsigned char *src, unsigned int srclen,
+                                WCHAR *dst, unsigned int dstlen )
+{
+    unsigned int pos = mbstowcs_ascii( src, min( srclen, dstlen ), dst );
+    int ret = mbstowcs_sbcs( table, 0, src + pos, srclen - pos, dst + pos, dstlen - pos );
+
+    if (ret < 0) return ret;
+    return ret + pos;
+}
+
 /* mbstowcs for single-byte code page with char decomposition */
 static int mbstowcs_sbcs_decompose( const struct sbcs_table *table, int flags,
                                     const unsigned char *src, unsigned int srclen,
@@ -259,6 +300,9 @@ int wine_cp_mbstowcs( const union cptable *table, int flags,
         if (!(flags & MB_COMPOSITE))
         {
             if (!dstlen) return srclen;
+            /* the unrolled table lookups are just as fast for short strings */
+            if (table->sbcs.ascii_identity && !(flags & MB_USEGLYPHCHARS) && srclen >= 64)
+                return mbstowcs_sbcs_ascii( &table->sbcs, src, srclen, dst, dstlen );
             return mbstowcs_sbcs( &table->sbcs, flags, src, srclen, dst, dstlen );
         }
         return mbstowcs_sbcs_decompose( &table->sbcs, flags, src, srclen, dst, dstlen );
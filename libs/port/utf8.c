@@ -58,17 +58,98 @@ static inline unsigned int get_surrogate_value( const WCHAR *src, unsigned int s
     return src[0];
 }
 
+/* 7-bit ASCII runs are checked a whole machine word at a time */
+#define ASCII_MASK_MBS  ((ULONG_PTR)~0 / 0xff * 0x80)
+#define ASCII_MASK_WCS  ((ULONG_PTR)~0 / 0xffff * 0xff80)
+
+/* get the length of the run of 7-bit ASCII chars at the start of a multibyte string */
+static inline unsigned int get_ascii_run_mbs( const char *src, unsigned int srclen )
+{
+    unsigned int len = 0;
+    ULONG_PTR val;
+
+    while (srclen - len >= sizeof(val))
+    {
+        memcpy( &val, src + len, sizeof(val) );
+        if (val & ASCII_MASK_MBS) break;
+        len += sizeof(val);
+    }
+    while (len < srclen && !(src[len] & 0x80)) len++;
+    return len;
+}
+
+/* get the length of the run of 7-bit ASCII chars at the start of a wide char string */
+static inline unsigned int get_ascii_run_wcs( const WCHAR *src, unsigned int srclen )
+{
+    unsigned int len = 0;
+    ULONG_PTR val;
+
+    while (srclen - len >= sizeof(val) / sizeof(WCHAR))
+    {
+        memcpy( &val, src + len, sizeof(val) );
+        if (val & ASCII_MASK_WCS) break;
+        len += sizeof(val) / sizeof(WCHAR);
+    }
+    while (len < srclen && src[len] < 0x80) len++;
+    return len;
+}
+
+/* copy the run of 7-bit ASCII chars at the start of a multibyte string */
+static inline unsigned int copy_ascii_run_mbs( WCHAR *dst, const char *src, unsigned int len )
+{
+    unsigned int i, pos = 0;
+    ULONG_PTR val;
+
+    while (len - pos >= sizeof(val))
+    {
+        memcpy( &val, src + pos, sizeof(val) );
+        if (val & ASCII_MASK_MBS) break;
+        for (i = 0; i < sizeof(val); i++) dst[pos + i] = (unsigned char)src[pos + i];
+        pos += sizeof(val);
+    }
+    while (pos < len && !(src[pos] & 0x80))
+    {
+        dst[pos] = src[pos];
+        pos++;
+    }
+    return pos;
+}
+
+/* copy the run of 7-bit ASCII chars at the start of a wide char string */
+static inline unsigned int copy_ascii_run_wcs( char *dst, const WCHAR *src, unsigned int len )
+{
+    unsigned int i, pos = 0;
+    ULONG_PTR val;
+
+    while (len - pos >= sizeof(val) / sizeof(WCHAR))
+    {
+        memcpy( &val, src + pos, sizeof(val) );
+        if (val & ASCII_MASK_WCS) break;
+        for (i = 0; i < sizeof(val) / sizeof(WCHAR); i++) dst[pos + i] = src[pos + i];
+        pos += sizeof(val) / sizeof(WCHAR);
+    }
+    while (pos < len && src[pos] < 0x80)
+    {
+        dst[pos] = src[pos];
+        pos++;
+    }
+    return pos;
+}
+
 /* query necessary dst length for src string */
 static inline int get_length_wcs_utf8( int flags, const WCHAR *src, unsigned int srclen )
 {
     int len;
-    unsigned int val;
+    unsigned int val, run;
 
     for (len = 0; srclen; srclen--, src++)
     {
         if (*src < 0x80)  /* 0x00-0x7f: 1 byte */
         {
-            len++;
+            run = get_ascii_run_wcs( src, srclen );
+            len += run;
+            src += run - 1;
+            srclen -= run - 1;
             continue;
         }
         if (*src < 0x800)  /* 0x80-0x7ff: 2 bytes */
@@ -104,12 +185,16 @@ int wine_utf8_wcstombs( int flags, const WCHAR *src, int srclen, char *dst, int
     for (len = dstlen; srclen; srclen--, src++)
     {
         WCHAR ch = *src;
-        unsigned int val;
+        unsigned int val, run;
 
         if (ch < 0x80)  /* 0x00-0x7f: 1 byte */
         {
-            if (!len--) return -1;  /* overflow */
-            *dst++ = ch;
+            if (!len) return -1;  /* overflow */
+            run = copy_ascii_run_wcs( dst, src, min( srclen, len ));
+            dst += run;
+            len -= run;
+            src += run - 1;
+            srclen -= run - 1;
             continue;
         }
 
@@ -282,12 +367,16 @@ static inline int get_length_mbs_utf8( int flags, const char *src, int srclen )
 
     while (src < srcend)
     {
-        unsigned char ch = *src++;
+        unsigned char ch = *src;
+
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
-            ret++;
+            unsigned int run = get_ascii_run_mbs( src, srcend - src );
+            ret += run;
+            src += run;
             continue;
         }
+        src++;
         if ((res = decode_utf8_char( ch, &src, srcend )) <= 0x10ffff)
         {
             if (res > 0xffff) ret++;
@@ -313,12 +402,16 @@ int wine_utf8_mbstowcs( int flags, const char *src, int srclen, WCHAR *dst, int
 
     while ((dst < dstend) && (src < srcend))
     {
-        unsigned char ch = *src++;
+        unsigned char ch = *src;
+
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
-            *dst++ = ch;
+            unsigned int run = copy_ascii_run_mbs( dst, src, min( srcend - src, dstend - dst ));
+            dst += run;
+            src += run;
             continue;
         }
+        src++;
         if ((res = decode_utf8_char( ch, &src, srcend )) <= 0xffff)
         {
             *dst++ = res;
@@ -88,6 +88,22 @@ static int get_length_sbcs( const struct sbcs_table *table, int flags,
     return ret;
 }
 
+/* copy the leading 7-bit ASCII chars a machine word at a time; returns the number of chars copied */
+static inline unsigned int wcstombs_ascii( const WCHAR *src, unsigned int srclen, char *dst )
+{
+    unsigned int i, pos = 0;
+    ULONG_PTR val;
+
+    while (srclen - pos >= sizeof(val) / sizeof(WCHAR))
+    {
+        memcpy( &val, src + pos, sizeof(val) );
+        if (val & ((ULONG_PTR)~0 / 0xffff * 0xff80)) break;
+        for (i = 0; i < sizeof(val) / sizeof(WCHAR); i++) dst[pos + i] = src[pos + i];
+        pos += sizeof(val) / sizeof(WCHAR);
+    }
+    return pos;
+}
+
 /* wcstombs for single-byte code page */
 static inline int wcstombs_sbcs( const struct sbcs_table *table,
                                  const WCHAR *src, unsigned int srclen,
@@ -95,6 +111,7 @@ static inline int wcstombs_sbcs( const struct sbcs_table *table,
 {
     const unsigned char  * const uni2cp_low = table->uni2cp_low;
     const unsigned short * const uni2cp_high = table->uni2cp_high;
+    unsigned int pos;
     int ret = srclen;
 
     if (dstlen < srclen)
@@ -106,6 +123,15 @@ static inline int wcstombs_sbcs( const struct sbcs_table *table,
 
     while (srclen >= 16)
     {
+        if (table->ascii_identity)
+        {
+            /* 7-bit ASCII maps to itself, no need for the table */
+            pos = wcstombs_ascii( src, srclen, dst );
+            src += pos;
+            dst += pos;
+            srclen -= pos;
+            if (srclen < 16) break;
+        }
         dst[0]  = uni2cp_low[uni2cp_high[src[0]  >> 8] + (src[0]  & 0xff)];
         dst[1]  = uni2cp_low[uni2cp_high[src[1]  >> 8] + (src[1]  & 0xff)];
         dst[2]  = uni2cp_low[uni2cp_high[src[2]  >> 8] + (src[2]  & 0xff)];
@@ -352,11 +352,98 @@ static inline int compare_case_weights(int flags, const WCHAR *str1, int len1,
     return len1 - len2;
 }
 
+/* compare the strings at all weight levels in a single pass; returns FALSE if the
+ * levels can't be compared together because hyphens or apostrophes are skipped */
+static inline int compare_all_weights(int flags, const WCHAR *str1, int len1,
+                                      const WCHAR *str2, int len2, int *result)
+{
+    unsigned int ce1, ce2;
+    int ret, diacritic = 0, case_diff = 0;
+
+    while (len1 > 0 && len2 > 0)
+    {
+        if (flags & NORM_IGNORESYMBOLS)
+        {
+            int skip = 0;
+            if (get_char_typeW(*str1) & (C1_PUNCT | C1_SPACE))
+            {
+                str1++;
+                len1--;
+                skip = 1;
+            }
+            if (get_char_typeW(*str2) & (C1_PUNCT | C1_SPACE))
+            {
+                str2++;
+                len2--;
+                skip = 1;
+            }
+            if (skip) continue;
+        }
+
+        if (!(flags & SORT_STRINGSORT) &&
+            (*str1 == '-' || *str1 == '\'') != (*str2 == '-' || *str2 == '\''))
+            return 0;
+
+        ce1 = collation_table[collation_table[*str1 >> 8] + (*str1 & 0xff)];
+        ce2 = collation_table[collation_table[*str2 >> 8] + (*str2 & 0xff)];
+
+        if (ce1 != (unsigned int)-1 && ce2 != (unsigned int)-1)
+        {
+            if ((ret = (ce1 >> 16) - (ce2 >> 16)))
+            {
+                *result = ret;
+                return 1;
+            }
+            if (!diacritic) diacritic = ((ce1 >> 8) & 0xff) - ((ce2 >> 8) & 0xff);
+            if (!case_diff) case_diff = ((ce1 >> 4) & 0x0f) - ((ce2 >> 4) & 0x0f);
+        }
+        else if ((ret = *str1 - *str2))
+        {
+            *result = ret;
+            return 1;
+        }
+
+        str1++;
+        str2++;
+        len1--;
+        len2--;
+    }
+    while (len1 && !*str1)
+    {
+        str1++;
+        len1--;
+    }
+    while (len2 && !*str2)
+    {
+        str2++;
+        len2--;
+    }
+
+    if (!(ret = len1 - len2))
+    {
+        if (!(flags & NORM_IGNORENONSPACE)) ret = diacritic;
+        if (!ret && !(flags & NORM_IGNORECASE)) ret = case_diff;
+    }
+    *result = ret;
+    return 1;
+}
+
 int wine_compare_string(int flags, const WCHAR *str1, int len1,
                         const WCHAR *str2, int len2)
 {
     int ret;
 
+    /* identical characters have identical weights at every level */
+    while (len1 > 0 && len2 > 0 && *str1 == *str2)
+    {
+        str1++;
+        str2++;
+        len1--;
+        len2--;
+    }
+
+    if (compare_all_weights(flags, str1, len1, str2, len2, &ret)) return ret;
+
     ret = compare_unicode_weights(flags, str1, len1, str2, len2);
     if (!ret)
     {
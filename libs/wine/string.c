@@ -26,11 +26,18 @@
 #define WINE_UNICODE_INLINE  /* nothing */
 #include "wine/unicode.h"
 
+/* identical characters don't need to go through the case mapping tables */
+static inline int compare_char_nocase( WCHAR ch1, WCHAR ch2 )
+{
+    if (ch1 == ch2) return 0;
+    return tolowerW(ch1) - tolowerW(ch2);
+}
+
 int strcmpiW( const WCHAR *str1, const WCHAR *str2 )
 {
     for (;;)
     {
-        int ret = tolowerW(*str1) - tolowerW(*str2);
+        int ret = compare_char_nocase( *str1, *str2 );
         if (ret || !*str1) return ret;
         str1++;
         str2++;
@@ -41,7 +48,7 @@ int strncmpiW( const WCHAR *str1, const WCHAR *str2, int n )
 {
     int ret = 0;
     for ( ; n > 0; n--, str1++, str2++)
-        if ((ret = tolowerW(*str1) - tolowerW(*str2)) || !*str1) break;
+        if ((ret = compare_char_nocase( *str1, *str2 )) || !*str1) break;
     return ret;
 }
 
@@ -49,7 +56,7 @@ int memicmpW( const WCHAR *str1, const WCHAR *str2, int n )
 {
     int ret = 0;
     for ( ; n > 0; n--, str1++, str2++)
-        if ((ret = tolowerW(*str1) - tolowerW(*str2))) break;
+        if ((ret = compare_char_nocase( *str1, *str2 ))) break;
     return ret;
 }
 
@@ -27,6 +27,8 @@
 #include <stdarg.h>
 
 #include "debugger.h"
+#define WANT_REQUEST_NAMES
+#include "wine/server.h"
 #include "wingdi.h"
 #include "winuser.h"
 #include "tlhelp32.h"
@@ -106,6 +108,7 @@ void info_help(void)
             "  info reg             Displays values of the general registers at top of stack",
             "  info all-reg         Displays the general and floating point registers",
             "  info segments <pid>  Displays information about all known segments",
+            "  info server <pid>    Shows wineserver request statistics (of a given process)",
             "  info share           Displays all loaded modules",
             "  info share <addr>    Displays internal module state",
             "  info stack [<len>]   Dumps information about top of stack, up to len words",
@@ -781,6 +784,68 @@ void info_win32_virtual(DWORD pid)
     if (pid != dbg_curr_pid) CloseHandle(hProc);
 }
 
+static const struct request_stats* sort_stats;
+
+static int compare_request_stats(const void* p1, const void* p2)
+{
+    const struct request_stats* s1 = &sort_stats[*(const unsigned*)p1];
+    const struct request_stats* s2 = &sort_stats[*(const unsigned*)p2];
+
+    if (s1->time != s2->time) return s1->time < s2->time ? 1 : -1;
+    return s2->count - s1->count;
+}
+
+void info_wine_server_stats(DWORD pid)
+{
+    struct request_stats*       stats;
+    unsigned                    order[REQ_NB_REQUESTS];
+    unsigned                    i, count = 0, used = 0;
+    timeout_t                   start_time = 0;
+    LARGE_INTEGER               now;
+    NTSTATUS                    status;
+
+    if (!(stats = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, REQ_NB_REQUESTS * sizeof(*stats))))
+        return;
+
+    SERVER_START_REQ(get_request_stats)
+    {
+        req->pid = pid;
+        wine_server_set_reply(req, stats, REQ_NB_REQUESTS * sizeof(*stats));
+        if (!(status = wine_server_call(req)))
+        {
+            count = wine_server_reply_size(reply) / sizeof(*stats);
+            start_time = reply->start_time;
+        }
+    }
+    SERVER_END_REQ;
+
+    if (status)
+    {
+        dbg_printf("Cannot get server statistics of process <%04x> (%08x)\n", pid, status);
+        HeapFree(GetProcessHeap(), 0, stats);
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+        if (stats[i].count) order[used++] = i;
+    sort_stats = stats;
+    qsort(order, used, sizeof(order[0]), compare_request_stats);
+
+    NtQuerySystemTime(&now);
+    dbg_printf("Requests of %s over %u seconds (sorted by handler time)\n",
+               pid ? "process" : "all processes", (unsigned)((now.QuadPart - start_time) / 10000000));
+    dbg_printf("%-32s %10s %10s %12s %10s %12s\n",
+               "request", "calls", "blocked", "time (ms)", "avg (us)", "reply bytes");
+    for (i = 0; i < used; i++)
+    {
+        const struct request_stats* s = &stats[order[i]];
+        dbg_printf("%-32s %10u %10u %12.3f %10.3f %12s\n",
+                   server_request_names[order[i]], s->count, s->blocked, s->time / 1000000.0,
+                   s->time / 1000.0 / s->count, wine_dbgstr_longlong(s->reply_size));
+    }
+    HeapFree(GetProcessHeap(), 0, stats);
+}
+
 void info_wine_dbg_channel(BOOL turn_on, const char* cls, const char* name)
 {
     struct dbg_lvalue           lvalue;
@@ -0,0 +1,315 @@
+/*
+ * Wine server eventfd-based synchronization
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "config.h"
+#include "wine/port.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_EVENTFD_H
+# include <sys/eventfd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winternl.h"
+
+#include "handle.h"
+#include "file.h"
+#include "thread.h"
+#include "request.h"
+#include "esync.h"
+
+/* delay before polling again an fd that is signaled but couldn't satisfy any waiter */
+#define ESYNC_REARM_DELAY  (-TICKS_PER_SEC / 1000)
+
+/* check if eventfd-based synchronization has been enabled with WINEESYNC */
+int do_esync(void)
+{
+#ifdef HAVE_SYS_EVENTFD_H
+    static int enabled = -1;
+
+    if (enabled == -1)
+    {
+        const char *env = getenv( "WINEESYNC" );
+        enabled = env && atoi( env );
+    }
+    return enabled;
+#else
+    return 0;
+#endif
+}
+
+/* shared memory holding the state of semaphores and mutexes */
+static struct esync_shm *shm_base;
+static unsigned int shm_next = 1;  /* first never used entry, entry 0 is invalid */
+static unsigned int shm_free;      /* list of freed entries, linked through the value field */
+
+/* map the shared memory, creating its file in the server directory */
+static int init_shm(void)
+{
+    static int failed;
+    size_t size = ESYNC_SHM_ENTRIES * sizeof(struct esync_shm);
+    void *ptr;
+    int fd;
+
+    if (shm_base) return 1;
+    if (failed) return 0;
+
+    failed = 1;
+    if ((fd = open( ESYNC_SHM_NAME, O_CREAT | O_TRUNC | O_RDWR, 0600 )) == -1)
+    {
+        fprintf( stderr, "wineserver: cannot create %s: %s\n", ESYNC_SHM_NAME, strerror( errno ));
+        return 0;
+    }
+    if (ftruncate( fd, size ) == -1 ||
+        (ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) == MAP_FAILED)
+    {
+        fprintf( stderr, "wineserver: cannot map %s: %s\n", ESYNC_SHM_NAME, strerror( errno ));
+        close( fd );
+        return 0;
+    }
+    close( fd );
+    shm_base = ptr;
+    failed = 0;
+    return 1;
+}
+
+static struct esync_shm *alloc_shm_entry(void)
+{
+    struct esync_shm *shm;
+
+    if (!init_shm()) return NULL;
+    if (shm_free)
+    {
+        shm = shm_base + shm_free;
+        shm_free = shm->value;
+    }
+    else if (shm_next < ESYNC_SHM_ENTRIES) shm = shm_base + shm_next++;
+    else return NULL;
+    shm->count = 0;
+    shm->value = 0;
+    return shm;
+}
+
+static void free_shm_entry( struct esync_shm *shm )
+{
+    shm->count = 0;
+    shm->value = shm_free;
+    shm_free = shm - shm_base;
+}
+
+/* create the eventfd backing an object; the object falls back to its own state on failure */
+void esync_init( struct esync *esync, struct object *obj, const struct fd_ops *ops,
+                 enum esync_type type, unsigned int initial )
+{
+    esync->obj   = obj;
+    esync->fd    = NULL;
+    esync->rearm = NULL;
+    esync->type  = type;
+    esync->shm   = NULL;
+
+#ifdef HAVE_SYS_EVENTFD_H
+    if (do_esync())
+    {
+        int unix_fd = eventfd( initial, EFD_CLOEXEC | EFD_NONBLOCK |
+                               (type == ESYNC_SEMAPHORE ? EFD_SEMAPHORE : 0) );
+
+        if (unix_fd == -1) return;
+        if ((type == ESYNC_SEMAPHORE || type == ESYNC_MUTEX) && !(esync->shm = alloc_shm_entry()))
+        {
+            close( unix_fd );
+            return;
+        }
+        if (!(esync->fd = create_anonymous_fd( ops, unix_fd, obj, 0 )) && esync->shm)
+        {
+            free_shm_entry( esync->shm );
+            esync->shm = NULL;
+        }
+    }
+#endif
+}
+
+void esync_destroy( struct esync *esync )
+{
+    if (esync->rearm) remove_timeout_user( esync->rearm );
+    if (esync->fd) release_object( esync->fd );
+    if (esync->shm) free_shm_entry( esync->shm );
+    esync->rearm = NULL;
+    esync->fd = NULL;
+    esync->shm = NULL;
+}
+
+/* check if the counter is non-zero, without modifying it */
+int esync_signaled( struct esync *esync )
+{
+    struct pollfd pfd;
+
+    pfd.fd = get_unix_fd( esync->fd );
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll( &pfd, 1, 0 ) == 1 && (pfd.revents & POLLIN);
+}
+
+/* reset the counter to zero and return its previous value */
+unsigned int esync_drain( struct esync *esync )
+{
+    unsigned __int64 value;
+
+    if (read( get_unix_fd( esync->fd ), &value, sizeof(value) ) != sizeof(value)) return 0;
+    return value;
+}
+
+/* add count to the counter */
+void esync_signal( struct esync *esync, unsigned int count )
+{
+    unsigned __int64 value = count;
+
+    if (!count) return;
+    if (write( get_unix_fd( esync->fd ), &value, sizeof(value) ) != sizeof(value))
+        fprintf( stderr, "wineserver: failed to signal eventfd: %s\n", strerror( errno ));
+}
+
+/* only poll the fd while server threads are waiting on the object */
+void esync_queue_changed( struct esync *esync )
+{
+    if (!esync->fd || esync->rearm) return;
+    set_fd_events( esync->fd, list_empty( &esync->obj->wait_queue ) ? 0 : POLLIN );
+}
+
+static void esync_rearm( void *private )
+{
+    struct esync *esync = private;
+
+    esync->rearm = NULL;
+    esync_queue_changed( esync );
+}
+
+/* the counter was modified, possibly by a client: wake up the server threads */
+void esync_poll_event( struct esync *esync )
+{
+    wake_up( esync->obj, 0 );
+
+    /* a waiter that is still there while the object is signaled is waiting for other
+     * objects too; stop polling for a while instead of spinning on the signaled fd */
+    if (!list_empty( &esync->obj->wait_queue ) && esync_signaled( esync ))
+    {
+        set_fd_events( esync->fd, 0 );
+        if (!(esync->rearm = add_timeout_user( ESYNC_REARM_DELAY, esync_rearm, esync )))
+            set_fd_events( esync->fd, POLLIN );
+    }
+    else esync_queue_changed( esync );
+}
+
+static struct esync *get_object_esync( struct object *obj )
+{
+    struct esync *esync;
+
+    if ((esync = get_event_esync( obj ))) return esync;
+    if ((esync = get_semaphore_esync( obj ))) return esync;
+    return get_mutex_esync( obj );
+}
+
+/* take a signaled object for a server thread; this can fail if a client got it first */
+int esync_acquire( struct object *obj, struct thread *thread )
+{
+    struct esync *esync;
+    unsigned __int64 value;
+
+    if (!(esync = get_object_esync( obj ))) return 1;
+
+    switch (esync->type)
+    {
+    case ESYNC_MANUAL_EVENT:
+        return esync_signaled( esync );
+    case ESYNC_SEMAPHORE:
+        if (read( get_unix_fd( esync->fd ), &value, sizeof(value) ) != sizeof(value)) return 0;
+        interlocked_xchg_add( &esync->shm->count, -1 );
+        return 1;
+    case ESYNC_MUTEX:
+        /* the owner is only updated by mutex_satisfied */
+        if (esync->shm->value == thread->id) return 1;
+        /* fall through */
+    default:
+        return read( get_unix_fd( esync->fd ), &value, sizeof(value) ) == sizeof(value);
+    }
+}
+
+/* give back an object taken by esync_acquire */
+void esync_release( struct object *obj, struct thread *thread )
+{
+    struct esync *esync;
+
+    if (!(esync = get_object_esync( obj ))) return;
+
+    switch (esync->type)
+    {
+    case ESYNC_MANUAL_EVENT:
+        break;
+    case ESYNC_SEMAPHORE:
+        interlocked_xchg_add( &esync->shm->count, 1 );
+        esync_signal( esync, 1 );
+        break;
+    case ESYNC_MUTEX:
+        if (esync->shm->value == thread->id) break;
+        /* fall through */
+    default:
+        esync_signal( esync, 1 );
+        break;
+    }
+}
+
+/* retrieve the eventfd of an object */
+DECL_HANDLER(get_esync_fd)
+{
+    struct object *obj;
+    struct esync *esync;
+
+    if (!do_esync())
+    {
+        set_error( STATUS_NOT_IMPLEMENTED );
+        return;
+    }
+    if (!(obj = get_handle_obj( current->process, req->handle, 0, NULL ))) return;
+
+    if ((esync = get_object_esync( obj )))
+    {
+        reply->type    = esync->type;
+        reply->access  = get_handle_access( current->process, req->handle );
+        reply->shm_idx = esync->shm ? esync->shm - shm_base : 0;
+        send_client_fd( current->process, get_unix_fd( esync->fd ), req->handle );
+    }
+    else reply->type = ESYNC_NONE;
+
+    release_object( obj );
+}
@@ -0,0 +1,59 @@
+/*
+ * Wine server eventfd-based synchronization
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __WINE_SERVER_ESYNC_H
+#define __WINE_SERVER_ESYNC_H
+
+#include "object.h"
+
+/* The counter of the eventfd is the authoritative state of the object: clients
+ * that retrieved it with get_esync_fd wait on it and modify it directly, and
+ * the server polls it while some of its own threads are waiting on the object.
+ * Acquiring an object is always a single read(), semaphores use EFD_SEMAPHORE
+ * so that a read only takes one unit of the count.  Semaphores and mutexes
+ * also keep an entry in a memory area shared with all the clients, holding
+ * the semaphore count and maximum, and the mutex owner and recursion count. */
+struct esync
+{
+    struct object       *obj;      /* object using the eventfd */
+    struct fd           *fd;       /* eventfd, NULL if not available */
+    struct timeout_user *rearm;    /* timeout re-enabling the polling of a signaled fd */
+    enum esync_type      type;     /* type of the object */
+    struct esync_shm    *shm;      /* shared state of semaphores and mutexes */
+};
+
+struct fd_ops;
+struct thread;
+
+extern int do_esync(void);
+extern void esync_init( struct esync *esync, struct object *obj, const struct fd_ops *ops,
+                        enum esync_type type, unsigned int initial );
+extern void esync_destroy( struct esync *esync );
+extern int esync_signaled( struct esync *esync );
+extern unsigned int esync_drain( struct esync *esync );
+extern void esync_signal( struct esync *esync, unsigned int count );
+extern void esync_queue_changed( struct esync *esync );
+extern void esync_poll_event( struct esync *esync );
+extern int esync_acquire( struct object *obj, struct thread *thread );
+extern void esync_release( struct object *obj, struct thread *thread );
+
+extern struct esync *get_event_esync( struct object *obj );
+extern struct esync *get_semaphore_esync( struct object *obj );
+extern struct esync *get_mutex_esync( struct object *obj );
+
+#endif  /* __WINE_SERVER_ESYNC_H */
@@ -32,31 +32,37 @@
 #include "winternl.h"
 
 #include "handle.h"
+#include "file.h"
 #include "thread.h"
 #include "request.h"
 #include "security.h"
+#include "esync.h"
 
 struct event
 {
     struct object  obj;             /* object header */
     int            manual_reset;    /* is it a manual reset event? */
     int            signaled;        /* event has been signaled */
+    struct esync   esync;           /* eventfd holding the state in esync mode */
 };
 
 static void event_dump( struct object *obj, int verbose );
 static struct object_type *event_get_type( struct object *obj );
+static int event_add_queue( struct object *obj, struct wait_queue_entry *entry );
+static void event_remove_queue( struct object *obj, struct wait_queue_entry *entry );
 static int event_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void event_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static unsigned int event_map_access( struct object *obj, unsigned int access );
 static int event_signal( struct object *obj, unsigned int access);
+static void event_destroy( struct object *obj );
 
 static const struct object_ops event_ops =
 {
     sizeof(struct event),      /* size */
     event_dump,                /* dump */
     event_get_type,            /* get_type */
-    add_queue,                 /* add_queue */
-    remove_queue,              /* remove_queue */
+    event_add_queue,           /* add_queue */
+    event_remove_queue,        /* remove_queue */
     event_signaled,            /* signaled */
     event_satisfied,           /* satisfied */
     event_signal,              /* signal */
@@ -69,7 +75,20 @@ static const struct object_ops event_ops =
     default_unlink_name,       /* unlink_name */
     no_open_file,              /* open_file */
     no_close_handle,           /* close_handle */
-    no_destroy                 /* destroy */
+    event_destroy              /* destroy */
+};
+
+static void event_poll_event( struct fd *fd, int event );
+
+static const struct fd_ops event_fd_ops =
+{
+    NULL,                      /* get_poll_events */
+    event_poll_event,          /* poll_event */
+    NULL,                      /* flush */
+    NULL,                      /* get_fd_type */
+    NULL,                      /* ioctl */
+    NULL,                      /* queue_async */
+    NULL                       /* reselect_async */
 };
 
 
@@ -119,6 +138,8 @@ struct event *create_event( struct object *root, const struct unicode_str *name,
             /* initialize it if it didn't already exist */
             event->manual_reset = manual_reset;
             event->signaled     = initial_state;
+            esync_init( &event->esync, &event->obj, &event_fd_ops,
+                        manual_reset ? ESYNC_MANUAL_EVENT : ESYNC_AUTO_EVENT, initial_state );
         }
     }
     return event;
@@ -129,32 +150,47 @@ struct event *get_event_obj( struct process *process, obj_handle_t handle, unsig
     return (struct event *)get_handle_obj( process, handle, access, &event_ops );
 }
 
+struct esync *get_event_esync( struct object *obj )
+{
+    struct event *event = (struct event *)obj;
+
+    if (obj->ops != &event_ops || !event->esync.fd) return NULL;
+    return &event->esync;
+}
+
+static int is_event_signaled( struct event *event )
+{
+    if (event->esync.fd) return esync_signaled( &event->esync );
+    return event->signaled;
+}
+
 void pulse_event( struct event *event )
 {
-    event->signaled = 1;
-    /* wake up all waiters if manual reset, a single one otherwise */
-    wake_up( &event->obj, !event->manual_reset );
-    event->signaled = 0;
+    set_event( event );
+    reset_event( event );
 }
 
 void set_event( struct event *event )
 {
-    event->signaled = 1;
+    /* any non-zero counter means signaled, clients reset it with a single read */
+    if (event->esync.fd) esync_signal( &event->esync, 1 );
+    else event->signaled = 1;
     /* wake up all waiters if manual reset, a single one otherwise */
     wake_up( &event->obj, !event->manual_reset );
 }
 
 void reset_event( struct event *event )
 {
-    event->signaled = 0;
+    if (event->esync.fd) esync_drain( &event->esync );
+    else event->signaled = 0;
 }
 
 static void event_dump( struct object *obj, int verbose )
 {
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
-    fprintf( stderr, "Event manual=%d signaled=%d\n",
-             event->manual_reset, event->signaled );
+    fprintf( stderr, "Event manual=%d signaled=%d%s\n", event->manual_reset,
+             is_event_signaled( event ), event->esync.fd ? " esync" : "" );
 }
 
 static struct object_type *event_get_type( struct object *obj )
@@ -164,19 +200,38 @@ static struct object_type *event_get_type( struct object *obj )
     return get_object_type( &str );
 }
 
+static int event_add_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    if (!add_queue( obj, entry )) return 0;
+    esync_queue_changed( &event->esync );
+    return 1;
+}
+
+static void event_remove_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    remove_queue( obj, entry );
+    esync_queue_changed( &event->esync );
+}
+
 static int event_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
-    return event->signaled;
+    return is_event_signaled( event );
 }
 
 static void event_satisfied( struct object *obj, struct wait_queue_entry *entry )
 {
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
+    /* in esync mode the eventfd has already been read by check_wait */
+    if (event->esync.fd) return;
     /* Reset if it's an auto-reset event */
-    if (!event->manual_reset) event->signaled = 0;
+    if (!event->manual_reset) reset_event( event );
 }
 
 static unsigned int event_map_access( struct object *obj, unsigned int access )
@@ -202,6 +257,20 @@ static int event_signal( struct object *obj, unsigned int access )
     return 1;
 }
 
+static void event_destroy( struct object *obj )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    esync_destroy( &event->esync );
+}
+
+static void event_poll_event( struct fd *fd, int event )
+{
+    struct event *ev = get_fd_user( fd );
+    assert( ev->obj.ops == &event_ops );
+    esync_poll_event( &ev->esync );
+}
+
 struct keyed_event *create_keyed_event( struct object *root, const struct unicode_str *name,
                                         unsigned int attr, const struct security_descriptor *sd )
 {
@@ -311,6 +380,7 @@ DECL_HANDLER(event_op)
     struct event *event;
 
     if (!(event = get_event_obj( current->process, req->handle, EVENT_MODIFY_STATE ))) return;
+    reply->state = is_event_signaled( event );
     switch(req->op)
     {
     case PULSE_EVENT:
@@ -337,7 +407,7 @@ DECL_HANDLER(query_event)
     if (!(event = get_event_obj( current->process, req->handle, EVENT_QUERY_STATE ))) return;
 
     reply->manual_reset = event->manual_reset;
-    reply->state = event->signaled;
+    reply->state = is_event_signaled( event );
 
     release_object( event );
 }
@@ -32,9 +32,11 @@
 #include "winternl.h"
 
 #include "handle.h"
+#include "file.h"
 #include "thread.h"
 #include "request.h"
 #include "security.h"
+#include "esync.h"
 
 struct mutex
 {
@@ -42,11 +44,14 @@ struct mutex
     struct thread *owner;           /* mutex owner */
     unsigned int   count;           /* recursion count */
     int            abandoned;       /* has it been abandoned? */
-    struct list    entry;           /* entry in owner thread mutex list */
+    struct list    entry;           /* entry in owner thread mutex list, or in esync mutex list */
+    struct esync   esync;           /* eventfd and shared state in esync mode */
 };
 
 static void mutex_dump( struct object *obj, int verbose );
 static struct object_type *mutex_get_type( struct object *obj );
+static int mutex_add_queue( struct object *obj, struct wait_queue_entry *entry );
+static void mutex_remove_queue( struct object *obj, struct wait_queue_entry *entry );
 static int mutex_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void mutex_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static unsigned int mutex_map_access( struct object *obj, unsigned int access );
@@ -58,8 +63,8 @@ static const struct object_ops mutex_ops =
     sizeof(struct mutex),      /* size */
     mutex_dump,                /* dump */
     mutex_get_type,            /* get_type */
-    add_queue,                 /* add_queue */
-    remove_queue,              /* remove_queue */
+    mutex_add_queue,           /* add_queue */
+    mutex_remove_queue,        /* remove_queue */
     mutex_signaled,            /* signaled */
     mutex_satisfied,           /* satisfied */
     mutex_signal,              /* signal */
@@ -75,6 +80,22 @@ static const struct object_ops mutex_ops =
     mutex_destroy              /* destroy */
 };
 
+static void mutex_poll_event( struct fd *fd, int event );
+
+static const struct fd_ops mutex_fd_ops =
+{
+    NULL,                      /* get_poll_events */
+    mutex_poll_event,          /* poll_event */
+    NULL,                      /* flush */
+    NULL,                      /* get_fd_type */
+    NULL,                      /* ioctl */
+    NULL,                      /* queue_async */
+    NULL                       /* reselect_async */
+};
+
+/* mutexes backed by an eventfd, their owner is only known through the shared state */
+static struct list esync_mutexes = LIST_INIT( esync_mutexes );
+
 
 /* grab a mutex for a given thread */
 static void do_grab( struct mutex *mutex, struct thread *thread )
@@ -112,16 +133,68 @@ static struct mutex *create_mutex( struct object *root, const struct unicode_str
             mutex->count = 0;
             mutex->owner = NULL;
             mutex->abandoned = 0;
-            if (owned) do_grab( mutex, current );
+            /* the eventfd is signaled while the mutex is free */
+            esync_init( &mutex->esync, &mutex->obj, &mutex_fd_ops, ESYNC_MUTEX, !owned );
+            if (mutex->esync.fd)
+            {
+                list_add_tail( &esync_mutexes, &mutex->entry );
+                if (owned)
+                {
+                    mutex->esync.shm->value = current->id;
+                    mutex->esync.shm->count = 1;
+                }
+            }
+            else if (owned) do_grab( mutex, current );
         }
     }
     return mutex;
 }
 
+struct esync *get_mutex_esync( struct object *obj )
+{
+    struct mutex *mutex = (struct mutex *)obj;
+
+    if (obj->ops != &mutex_ops || !mutex->esync.fd) return NULL;
+    return &mutex->esync;
+}
+
+/* release a mutex owned by a thread in esync mode */
+static int release_esync_mutex( struct mutex *mutex, struct thread *thread, unsigned int *prev )
+{
+    struct esync_shm *shm = mutex->esync.shm;
+
+    /* only the owner modifies the shared state while the mutex is owned */
+    if (shm->value != thread->id)
+    {
+        set_error( STATUS_MUTANT_NOT_OWNED );
+        return 0;
+    }
+    if (prev) *prev = shm->count;
+    if (!--shm->count)
+    {
+        shm->value = 0;
+        esync_signal( &mutex->esync, 1 );
+        wake_up( &mutex->obj, 0 );
+    }
+    return 1;
+}
+
 void abandon_mutexes( struct thread *thread )
 {
+    struct mutex *mutex;
     struct list *ptr;
 
+    LIST_FOR_EACH_ENTRY( mutex, &esync_mutexes, struct mutex, entry )
+    {
+        struct esync_shm *shm = mutex->esync.shm;
+
+        if (shm->value != thread->id) continue;
+        shm->count = 0;
+        shm->value = ESYNC_MUTEX_ABANDONED;
+        esync_signal( &mutex->esync, 1 );
+        wake_up( &mutex->obj, 0 );
+    }
+
     while ((ptr = list_head( &thread->mutex_list )) != NULL)
     {
         struct mutex *mutex = LIST_ENTRY( ptr, struct mutex, entry );
@@ -136,7 +209,11 @@ static void mutex_dump( struct object *obj, int verbose )
 {
     struct mutex *mutex = (struct mutex *)obj;
     assert( obj->ops == &mutex_ops );
-    fprintf( stderr, "Mutex count=%u owner=%p\n", mutex->count, mutex->owner );
+    if (mutex->esync.fd)
+        fprintf( stderr, "Mutex count=%d owner=%04x esync\n", mutex->esync.shm->count,
+                 mutex->esync.shm->value );
+    else
+        fprintf( stderr, "Mutex count=%u owner=%p\n", mutex->count, mutex->owner );
 }
 
 static struct object_type *mutex_get_type( struct object *obj )
@@ -146,19 +223,55 @@ static struct object_type *mutex_get_type( struct object *obj )
     return get_object_type( &str );
 }
 
+static int mutex_add_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct mutex *mutex = (struct mutex *)obj;
+    assert( obj->ops == &mutex_ops );
+    if (!add_queue( obj, entry )) return 0;
+    esync_queue_changed( &mutex->esync );
+    return 1;
+}
+
+static void mutex_remove_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct mutex *mutex = (struct mutex *)obj;
+    assert( obj->ops == &mutex_ops );
+    remove_queue( obj, entry );
+    esync_queue_changed( &mutex->esync );
+}
+
 static int mutex_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct mutex *mutex = (struct mutex *)obj;
     assert( obj->ops == &mutex_ops );
+    if (mutex->esync.fd)
+        return (mutex->esync.shm->value == get_wait_queue_thread( entry )->id ||
+                esync_signaled( &mutex->esync ));
     return (!mutex->count || (mutex->owner == get_wait_queue_thread( entry )));
 }
 
 static void mutex_satisfied( struct object *obj, struct wait_queue_entry *entry )
 {
     struct mutex *mutex = (struct mutex *)obj;
+    struct thread *thread = get_wait_queue_thread( entry );
     assert( obj->ops == &mutex_ops );
 
-    do_grab( mutex, get_wait_queue_thread( entry ));
+    if (mutex->esync.fd)
+    {
+        /* the eventfd has already been read by check_wait, unless the thread owns it */
+        struct esync_shm *shm = mutex->esync.shm;
+
+        if (shm->value != thread->id)
+        {
+            if (shm->value == ESYNC_MUTEX_ABANDONED) make_wait_abandoned( entry );
+            shm->value = thread->id;
+            shm->count = 0;
+        }
+        shm->count++;
+        return;
+    }
+
+    do_grab( mutex, thread );
     if (mutex->abandoned) make_wait_abandoned( entry );
     mutex->abandoned = 0;
 }
@@ -182,6 +295,7 @@ static int mutex_signal( struct object *obj, unsigned int access )
         set_error( STATUS_ACCESS_DENIED );
         return 0;
     }
+    if (mutex->esync.fd) return release_esync_mutex( mutex, current, NULL );
     if (!mutex->count || (mutex->owner != current))
     {
         set_error( STATUS_MUTANT_NOT_OWNED );
@@ -196,11 +310,24 @@ static void mutex_destroy( struct object *obj )
     struct mutex *mutex = (struct mutex *)obj;
     assert( obj->ops == &mutex_ops );
 
+    if (mutex->esync.fd)
+    {
+        list_remove( &mutex->entry );
+        esync_destroy( &mutex->esync );
+        return;
+    }
     if (!mutex->count) return;
     mutex->count = 0;
     do_release( mutex );
 }
 
+static void mutex_poll_event( struct fd *fd, int event )
+{
+    struct mutex *mutex = get_fd_user( fd );
+    assert( mutex->obj.ops == &mutex_ops );
+    esync_poll_event( &mutex->esync );
+}
+
 /* create a mutex */
 DECL_HANDLER(create_mutex)
 {
@@ -242,7 +369,8 @@ DECL_HANDLER(release_mutex)
     if ((mutex = (struct mutex *)get_handle_obj( current->process, req->handle,
                                                  0, &mutex_ops )))
     {
-        if (!mutex->count || (mutex->owner != current)) set_error( STATUS_MUTANT_NOT_OWNED );
+        if (mutex->esync.fd) release_esync_mutex( mutex, current, &reply->prev_count );
+        else if (!mutex->count || (mutex->owner != current)) set_error( STATUS_MUTANT_NOT_OWNED );
         else
         {
             reply->prev_count = mutex->count;
@@ -260,9 +388,21 @@ DECL_HANDLER(query_mutex)
     if ((mutex = (struct mutex *)get_handle_obj( current->process, req->handle,
                                                  MUTANT_QUERY_STATE, &mutex_ops )))
     {
-        reply->count = mutex->count;
-        reply->owned = (mutex->owner == current);
-        reply->abandoned = mutex->abandoned;
+        if (mutex->esync.fd)
+        {
+            struct esync_shm *shm = mutex->esync.shm;
+            int owned = shm->value && shm->value != ESYNC_MUTEX_ABANDONED;
+
+            reply->count = owned ? shm->count : 0;
+            reply->owned = (shm->value == current->id);
+            reply->abandoned = (shm->value == ESYNC_MUTEX_ABANDONED);
+        }
+        else
+        {
+            reply->count = mutex->count;
+            reply->owned = (mutex->owner == current);
+            reply->abandoned = mutex->abandoned;
+        }
 
         release_object( mutex );
     }
@@ -527,6 +527,7 @@ struct thread *create_process( int fd, struct thread *parent_thread, int inherit
     process->peb             = 0;
     process->ldt_copy        = 0;
     process->dir_cache       = NULL;
+    process->req_stats       = NULL;
     process->winstation      = 0;
     process->desktop         = 0;
     process->token           = NULL;
@@ -640,6 +641,7 @@ static void process_destroy( struct object *obj )
     if (process->id) free_ptid( process->id );
     if (process->token) release_object( process->token );
     free( process->dir_cache );
+    free( process->req_stats );
 }
 
 /* dump a process on stdout for debugging purposes */
@@ -1696,3 +1698,17 @@ DECL_HANDLER(set_job_completion_port)
 
     release_object( job );
 }
+
+/* retrieve the per-request statistics of a process */
+DECL_HANDLER(get_request_stats)
+{
+    struct process *process = NULL;
+    const struct request_stats *stats;
+
+    if (req->pid && !(process = get_process_from_id( req->pid ))) return;
+
+    reply->start_time = process ? process->start_time : server_start_time;
+    if ((stats = get_request_stats( process )))
+        set_reply_data( stats, min( get_reply_max_size(), REQ_NB_REQUESTS * sizeof(*stats) ));
+    if (process) release_object( process );
+}
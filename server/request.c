@@ -126,6 +126,7 @@ static const struct fd_ops master_socket_fd_ops =
 struct thread *current = NULL;  /* thread handling the current request */
 unsigned int global_error = 0;  /* global error code for when no thread is current */
 timeout_t server_start_time = 0;  /* server startup time */
+static struct request_stats server_req_stats[REQ_NB_REQUESTS];  /* statistics of all processes */
 int server_dir_fd = -1;    /* file descriptor for the server dir */
 int config_dir_fd = -1;    /* file descriptor for the config dir */
 
@@ -286,11 +287,200 @@ static void send_reply( union generic_reply *reply )
         fatal_protocol_error( current, "reply write: %s\n", strerror( errno ));
 }
 
+/* get a monotonic time in nanoseconds, for request statistics */
+static unsigned __int64 get_monotonic_ns(void)
+{
+#ifdef __APPLE__
+    static mach_timebase_info_data_t timebase;
+
+    if (!timebase.denom) mach_timebase_info( &timebase );
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#elif defined(HAVE_CLOCK_GETTIME)
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * (unsigned __int64)1000000000 + ts.tv_nsec;
+#else
+    struct timeval tv;
+
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec * (unsigned __int64)1000000000 + tv.tv_usec * 1000;
+#endif
+}
+
+static inline void update_request_stats( struct request_stats *stats, unsigned __int64 time,
+                                         data_size_t reply_size, int blocked )
+{
+    stats->count++;
+    stats->blocked += blocked;
+    stats->time += time;
+    stats->reply_size += reply_size;
+}
+
+/* account a request to the statistics of its process and of the whole server */
+static void add_request_stats( struct process *process, enum request req, unsigned __int64 time,
+                               data_size_t reply_size, int blocked )
+{
+    update_request_stats( &server_req_stats[req], time, reply_size, blocked );
+
+    if (!process->req_stats &&
+        !(process->req_stats = calloc( REQ_NB_REQUESTS, sizeof(*process->req_stats) )))
+        return;
+    update_request_stats( &process->req_stats[req], time, reply_size, blocked );
+}
+
+/* retrieve the request statistics of a process, or of all processes if NULL */
+const struct request_stats *get_request_stats( struct process *process )
+{
+    if (!process) return server_req_stats;
+    return process->req_stats;
+}
+
+/* check if a request can be part of a batch: it must not block, nor transfer file descriptors */
+static int is_batch_request( enum request req )
+{
+    switch (req)
+    {
+    case REQ_close_handle:
+    case REQ_dup_handle:
+    case REQ_get_object_info:
+    case REQ_get_handle_unix_name:
+    case REQ_create_key:
+    case REQ_open_key:
+    case REQ_enum_key:
+    case REQ_set_key_value:
+    case REQ_get_key_value:
+    case REQ_delete_key_value:
+    case REQ_get_window_info:
+    case REQ_set_window_info:
+    case REQ_get_window_parents:
+    case REQ_get_window_children:
+    case REQ_get_window_tree:
+    case REQ_get_window_rectangles:
+    case REQ_get_window_text:
+    case REQ_get_window_property:
+    case REQ_set_window_property:
+    case REQ_set_class_info:
+    case REQ_get_thread_input:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* execute several requests in a single round trip */
+DECL_HANDLER(batch)
+{
+    const char *ptr = get_req_data(), *end = ptr + get_req_data_size();
+    const union generic_request saved_req = current->req;
+    const void *saved_data = current->req_data;
+    data_size_t max_size = get_reply_max_size(), pos = 0;
+    data_size_t reply_pos[MAX_BATCH_REQUESTS];
+    unsigned int count = 0, error = STATUS_SUCCESS;
+    char *replies = NULL;
+
+    if (max_size && !(replies = mem_alloc( max_size ))) return;
+
+    while (ptr < end)
+    {
+        const struct batch_header *header = (const struct batch_header *)ptr;
+        union generic_reply *sub_reply;
+        enum request type;
+        data_size_t size, reply_max;
+        unsigned __int64 start;
+
+        if (count == MAX_BATCH_REQUESTS ||
+            end - ptr < sizeof(*header) + sizeof(union generic_request))
+        {
+            error = STATUS_INVALID_PARAMETER;
+            break;
+        }
+        memcpy( &current->req, header + 1, sizeof(current->req) );
+        ptr += sizeof(*header) + sizeof(union generic_request);
+
+        type = current->req.request_header.req;
+        size = current->req.request_header.request_size;
+        reply_max = current->req.request_header.reply_size;
+        if (type >= REQ_NB_REQUESTS || !is_batch_request( type ) || size > end - ptr ||
+            max_size - pos < sizeof(*sub_reply) ||
+            ((reply_max + 7) & ~7) > max_size - pos - sizeof(*sub_reply))
+        {
+            error = STATUS_INVALID_PARAMETER;
+            break;
+        }
+        current->req_data = (void *)ptr;
+        ptr += (size + 7) & ~7;
+
+        reply_pos[count] = pos;
+        sub_reply = (union generic_reply *)(replies + pos);
+        memset( sub_reply, 0, sizeof(*sub_reply) );
+        clear_error();
+
+        if (header->handle_from != -1)
+        {
+            const union generic_reply *source;
+
+            if (header->handle_from < 0 || (unsigned int)header->handle_from >= count ||
+                header->handle_offset < sizeof(struct request_header) ||
+                header->handle_offset > sizeof(union generic_request) - sizeof(obj_handle_t) ||
+                header->reply_offset < sizeof(struct reply_header) ||
+                header->reply_offset > sizeof(union generic_reply) - sizeof(obj_handle_t))
+            {
+                error = STATUS_INVALID_PARAMETER;
+                break;
+            }
+            source = (const union generic_reply *)(replies + reply_pos[header->handle_from]);
+            if (source->reply_header.error)
+            {
+                /* the request depends on a failed one, skip it */
+                sub_reply->reply_header.error = source->reply_header.error;
+                pos += sizeof(*sub_reply);
+                count++;
+                continue;
+            }
+            memcpy( (char *)&current->req + header->handle_offset,
+                    (const char *)source + header->reply_offset, sizeof(obj_handle_t) );
+        }
+
+        start = get_monotonic_ns();
+        current->reply_size = 0;
+        current->reply_data = NULL;
+        if (debug_level) trace_request();
+        req_handlers[type]( &current->req, sub_reply );
+
+        sub_reply->reply_header.error = current->error;
+        sub_reply->reply_header.reply_size = current->reply_size;
+        add_request_stats( current->process, type, get_monotonic_ns() - start,
+                           sizeof(*sub_reply) + current->reply_size, 0 );
+        if (debug_level) trace_reply( type, sub_reply );
+
+        pos += sizeof(*sub_reply);
+        if (current->reply_size)
+        {
+            memcpy( replies + pos, current->reply_data, current->reply_size );
+            pos += (current->reply_size + 7) & ~7;
+        }
+        free( current->reply_data );
+        current->reply_data = NULL;
+        current->reply_size = 0;
+        count++;
+    }
+
+    /* return the replies of the requests executed before an invalid one, too */
+    current->req = saved_req;
+    current->req_data = (void *)saved_data;
+    set_error( error );
+    reply->count = count;
+    if (pos) set_reply_data_ptr( replies, pos );
+    else free( replies );
+}
+
 /* call a request handler */
 static void call_req_handler( struct thread *thread )
 {
     union generic_reply reply;
     enum request req = thread->req.request_header.req;
+    unsigned __int64 start = get_monotonic_ns();
 
     current = thread;
     current->reply_size = 0;
@@ -310,6 +500,9 @@ static void call_req_handler( struct thread *thread )
         {
             reply.reply_header.error = current->error;
             reply.reply_header.reply_size = current->reply_size;
+            if (req < REQ_NB_REQUESTS)
+                add_request_stats( current->process, req, get_monotonic_ns() - start,
+                                   sizeof(reply) + current->reply_size, current->error == STATUS_PENDING );
             if (debug_level) trace_reply( req, &reply );
             send_reply( &reply );
         }
@@ -55,6 +55,7 @@ extern int send_client_fd( struct process *process, int fd, obj_handle_t handle
 extern void read_request( struct thread *thread );
 extern void write_reply( struct thread *thread );
 extern unsigned int get_tick_count(void);
+extern const struct request_stats *get_request_stats( struct process *process );
 extern void open_master_socket(void);
 extern void close_master_socket( timeout_t timeout );
 extern void shutdown_master_socket(void);
@@ -153,6 +154,7 @@ DECL_HANDLER(create_semaphore);
 DECL_HANDLER(release_semaphore);
 DECL_HANDLER(query_semaphore);
 DECL_HANDLER(open_semaphore);
+DECL_HANDLER(get_esync_fd);
 DECL_HANDLER(create_file);
 DECL_HANDLER(open_file_object);
 DECL_HANDLER(alloc_file_handle);
@@ -396,6 +398,8 @@ DECL_HANDLER(process_in_job);
 DECL_HANDLER(set_job_limits);
 DECL_HANDLER(set_job_completion_port);
 DECL_HANDLER(terminate_job);
+DECL_HANDLER(get_request_stats);
+DECL_HANDLER(batch);
 
 #ifdef WANT_REQUEST_HANDLERS
 
@@ -443,6 +447,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_release_semaphore,
     (req_handler)req_query_semaphore,
     (req_handler)req_open_semaphore,
+    (req_handler)req_get_esync_fd,
     (req_handler)req_create_file,
     (req_handler)req_open_file_object,
     (req_handler)req_alloc_file_handle,
@@ -686,6 +691,8 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_set_job_limits,
     (req_handler)req_set_job_completion_port,
     (req_handler)req_terminate_job,
+    (req_handler)req_get_request_stats,
+    (req_handler)req_batch,
 };
 
 C_ASSERT( sizeof(affinity_t) == 8 );
@@ -921,6 +928,8 @@ C_ASSERT( sizeof(struct create_event_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct event_op_request, handle) == 12 );
 C_ASSERT( FIELD_OFFSET(struct event_op_request, op) == 16 );
 C_ASSERT( sizeof(struct event_op_request) == 24 );
+C_ASSERT( FIELD_OFFSET(struct event_op_reply, state) == 8 );
+C_ASSERT( sizeof(struct event_op_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct query_event_request, handle) == 12 );
 C_ASSERT( sizeof(struct query_event_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct query_event_reply, manual_reset) == 8 );
@@ -985,6 +994,12 @@ C_ASSERT( FIELD_OFFSET(struct open_semaphore_request, rootdir) == 20 );
 C_ASSERT( sizeof(struct open_semaphore_request) == 24 );
 C_ASSERT( FIELD_OFFSET(struct open_semaphore_reply, handle) == 8 );
 C_ASSERT( sizeof(struct open_semaphore_reply) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_esync_fd_request, handle) == 12 );
+C_ASSERT( sizeof(struct get_esync_fd_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_esync_fd_reply, type) == 8 );
+C_ASSERT( FIELD_OFFSET(struct get_esync_fd_reply, access) == 12 );
+C_ASSERT( FIELD_OFFSET(struct get_esync_fd_reply, shm_idx) == 16 );
+C_ASSERT( sizeof(struct get_esync_fd_reply) == 24 );
 C_ASSERT( FIELD_OFFSET(struct create_file_request, access) == 12 );
 C_ASSERT( FIELD_OFFSET(struct create_file_request, sharing) == 16 );
 C_ASSERT( FIELD_OFFSET(struct create_file_request, create) == 20 );
@@ -2364,6 +2379,13 @@ C_ASSERT( sizeof(struct set_job_completion_port_request) == 32 );
 C_ASSERT( FIELD_OFFSET(struct terminate_job_request, handle) == 12 );
 C_ASSERT( FIELD_OFFSET(struct terminate_job_request, status) == 16 );
 C_ASSERT( sizeof(struct terminate_job_request) == 24 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_request, pid) == 12 );
+C_ASSERT( sizeof(struct get_request_stats_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_reply, start_time) == 8 );
+C_ASSERT( sizeof(struct get_request_stats_reply) == 16 );
+C_ASSERT( sizeof(struct batch_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct batch_reply, count) == 8 );
+C_ASSERT( sizeof(struct batch_reply) == 16 );
 
 #endif  /* WANT_REQUEST_HANDLERS */
 
@@ -32,31 +32,37 @@
 #include "winternl.h"
 
 #include "handle.h"
+#include "file.h"
 #include "thread.h"
 #include "request.h"
 #include "security.h"
+#include "esync.h"
 
 struct semaphore
 {
     struct object  obj;    /* object header */
     unsigned int   count;  /* current count */
     unsigned int   max;    /* maximum possible count */
+    struct esync   esync;  /* eventfd holding the count in esync mode */
 };
 
 static void semaphore_dump( struct object *obj, int verbose );
 static struct object_type *semaphore_get_type( struct object *obj );
+static int semaphore_add_queue( struct object *obj, struct wait_queue_entry *entry );
+static void semaphore_remove_queue( struct object *obj, struct wait_queue_entry *entry );
 static int semaphore_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void semaphore_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static unsigned int semaphore_map_access( struct object *obj, unsigned int access );
 static int semaphore_signal( struct object *obj, unsigned int access );
+static void semaphore_destroy( struct object *obj );
 
 static const struct object_ops semaphore_ops =
 {
     sizeof(struct semaphore),      /* size */
     semaphore_dump,                /* dump */
     semaphore_get_type,            /* get_type */
-    add_queue,                     /* add_queue */
-    remove_queue,                  /* remove_queue */
+    semaphore_add_queue,           /* add_queue */
+    semaphore_remove_queue,        /* remove_queue */
     semaphore_signaled,            /* signaled */
     semaphore_satisfied,           /* satisfied */
     semaphore_signal,              /* signal */
@@ -69,7 +75,20 @@ static const struct object_ops semaphore_ops =
     default_unlink_name,           /* unlink_name */
     no_open_file,                  /* open_file */
     no_close_handle,               /* close_handle */
-    no_destroy                     /* destroy */
+    semaphore_destroy              /* destroy */
+};
+
+static void semaphore_poll_event( struct fd *fd, int event );
+
+static const struct fd_ops semaphore_fd_ops =
+{
+    NULL,                          /* get_poll_events */
+    semaphore_poll_event,          /* poll_event */
+    NULL,                          /* flush */
+    NULL,                          /* get_fd_type */
+    NULL,                          /* ioctl */
+    NULL,                          /* queue_async */
+    NULL                           /* reselect_async */
 };
 
 
@@ -91,14 +110,58 @@ static struct semaphore *create_semaphore( struct object *root, const struct uni
             /* initialize it if it didn't already exist */
             sem->count = initial;
             sem->max   = max;
+            esync_init( &sem->esync, &sem->obj, &semaphore_fd_ops, ESYNC_SEMAPHORE, initial );
+            if (sem->esync.fd)
+            {
+                sem->esync.shm->count = initial;
+                sem->esync.shm->value = max;
+            }
         }
     }
     return sem;
 }
 
+struct esync *get_semaphore_esync( struct object *obj )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+
+    if (obj->ops != &semaphore_ops || !sem->esync.fd) return NULL;
+    return &sem->esync;
+}
+
+/* in esync mode, the count is in the shared memory */
+static unsigned int get_semaphore_count( struct semaphore *sem )
+{
+    if (sem->esync.fd) return sem->esync.shm->count;
+    return sem->count;
+}
+
 static int release_semaphore( struct semaphore *sem, unsigned int count,
                               unsigned int *prev )
 {
+    if (sem->esync.fd)
+    {
+        /* the shared count is increased before writing to the eventfd and decreased
+         * after reading from it, so it never underestimates the eventfd counter */
+        int *shm_count = &sem->esync.shm->count;
+        unsigned int current;
+
+        do
+        {
+            current = *shm_count;
+            if (prev) *prev = current;
+            if (current + count < current || current + count > sem->max)
+            {
+                set_error( STATUS_SEMAPHORE_LIMIT_EXCEEDED );
+                return 0;
+            }
+        } while (interlocked_cmpxchg( shm_count, current + count, current ) != current);
+
+        esync_signal( &sem->esync, count );
+        wake_up( &sem->obj, count );
+        return 1;
+    }
+
     if (prev) *prev = sem->count;
     if (sem->count + count < sem->count || sem->count + count > sem->max)
     {
@@ -122,7 +185,8 @@ static void semaphore_dump( struct object *obj, int verbose )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    fprintf( stderr, "Semaphore count=%d max=%d\n", sem->count, sem->max );
+    fprintf( stderr, "Semaphore count=%d max=%d%s\n", get_semaphore_count( sem ), sem->max,
+             sem->esync.fd ? " esync" : "" );
 }
 
 static struct object_type *semaphore_get_type( struct object *obj )
@@ -132,10 +196,28 @@ static struct object_type *semaphore_get_type( struct object *obj )
     return get_object_type( &str );
 }
 
+static int semaphore_add_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    if (!add_queue( obj, entry )) return 0;
+    esync_queue_changed( &sem->esync );
+    return 1;
+}
+
+static void semaphore_remove_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    remove_queue( obj, entry );
+    esync_queue_changed( &sem->esync );
+}
+
 static int semaphore_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
+    if (sem->esync.fd) return esync_signaled( &sem->esync );
     return (sem->count > 0);
 }
 
@@ -143,6 +225,8 @@ static void semaphore_satisfied( struct object *obj, struct wait_queue_entry *en
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
+    /* in esync mode the eventfd has already been read by check_wait */
+    if (sem->esync.fd) return;
     assert( sem->count );
     sem->count--;
 }
@@ -169,6 +253,20 @@ static int semaphore_signal( struct object *obj, unsigned int access )
     return release_semaphore( sem, 1, NULL );
 }
 
+static void semaphore_destroy( struct object *obj )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    esync_destroy( &sem->esync );
+}
+
+static void semaphore_poll_event( struct fd *fd, int event )
+{
+    struct semaphore *sem = get_fd_user( fd );
+    assert( sem->obj.ops == &semaphore_ops );
+    esync_poll_event( &sem->esync );
+}
+
 /* create a semaphore */
 DECL_HANDLER(create_semaphore)
 {
@@ -223,7 +321,7 @@ DECL_HANDLER(query_semaphore)
     if ((sem = (struct semaphore *)get_handle_obj( current->process, req->handle,
                                                    SEMAPHORE_QUERY_STATE, &semaphore_ops )))
     {
-        reply->current = sem->count;
+        reply->current = get_semaphore_count( sem );
         reply->max = sem->max;
         release_object( sem );
     }
@@ -51,6 +51,7 @@
 #include "request.h"
 #include "user.h"
 #include "security.h"
+#include "esync.h"
 
 
 #ifdef __i386__
@@ -689,12 +690,21 @@ static int check_wait( struct thread *thread )
          * want to do something when signaled, even if others are not */
         for (i = 0, entry = wait->queues; i < wait->count; i++, entry++)
             not_ok |= !entry->obj->ops->signaled( entry->obj, entry );
-        if (!not_ok) return STATUS_WAIT_0;
+        if (!not_ok)
+        {
+            /* clients may take eventfd-backed objects at any time, grab them all or none */
+            for (i = 0, entry = wait->queues; i < wait->count; i++, entry++)
+                if (!esync_acquire( entry->obj, thread )) break;
+            if (i == wait->count) return STATUS_WAIT_0;
+            while (i--) esync_release( wait->queues[i].obj, thread );
+        }
     }
     else
     {
         for (i = 0, entry = wait->queues; i < wait->count; i++, entry++)
-            if (entry->obj->ops->signaled( entry->obj, entry )) return i;
+            if (entry->obj->ops->signaled( entry->obj, entry ) &&
+                esync_acquire( entry->obj, thread ))
+                return i;
     }
 
     if ((wait->flags & SELECT_ALERTABLE) && !list_empty(&thread->user_apc)) return STATUS_USER_APC;
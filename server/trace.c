@@ -1206,6 +1206,33 @@ static void dump_varargs_handle_infos( const char *prefix, data_size_t size )
     fputc( '}', stderr );
 }
 
+static void dump_varargs_request_stats( const char *prefix, data_size_t size )
+{
+    const struct request_stats *stats;
+    unsigned int i = 0;
+    int first = 1;
+
+    /* only dump the requests that have been called */
+    fprintf( stderr, "%s{", prefix );
+    while (size >= sizeof(*stats))
+    {
+        stats = cur_data;
+        if (stats->count)
+        {
+            if (!first) fputc( ',', stderr );
+            fprintf( stderr, "{req=%u,count=%u,blocked=%u", i, stats->count, stats->blocked );
+            dump_uint64( ",time=", &stats->time );
+            dump_uint64( ",reply_size=", &stats->reply_size );
+            fputc( '}', stderr );
+            first = 0;
+        }
+        size -= sizeof(*stats);
+        remove_data( sizeof(*stats) );
+        i++;
+    }
+    fputc( '}', stderr );
+}
+
 typedef void (*dump_func)( const void *req );
 
 /* Everything below this line is generated automatically by tools/make_requests */
@@ -1579,6 +1606,11 @@ static void dump_event_op_request( const struct event_op_request *req )
     fprintf( stderr, ", op=%d", req->op );
 }
 
+static void dump_event_op_reply( const struct event_op_reply *req )
+{
+    fprintf( stderr, " state=%d", req->state );
+}
+
 static void dump_query_event_request( const struct query_event_request *req )
 {
     fprintf( stderr, " handle=%04x", req->handle );
@@ -1722,6 +1754,18 @@ static void dump_open_semaphore_reply( const struct open_semaphore_reply *req )
     fprintf( stderr, " handle=%04x", req->handle );
 }
 
+static void dump_get_esync_fd_request( const struct get_esync_fd_request *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
+static void dump_get_esync_fd_reply( const struct get_esync_fd_reply *req )
+{
+    fprintf( stderr, " type=%d", req->type );
+    fprintf( stderr, ", access=%08x", req->access );
+    fprintf( stderr, ", shm_idx=%08x", req->shm_idx );
+}
+
 static void dump_create_file_request( const struct create_file_request *req )
 {
     fprintf( stderr, " access=%08x", req->access );
@@ -4468,6 +4512,28 @@ static void dump_terminate_job_request( const struct terminate_job_request *req
     fprintf( stderr, ", status=%d", req->status );
 }
 
+static void dump_get_request_stats_request( const struct get_request_stats_request *req )
+{
+    fprintf( stderr, " pid=%04x", req->pid );
+}
+
+static void dump_get_request_stats_reply( const struct get_request_stats_reply *req )
+{
+    dump_timeout( " start_time=", &req->start_time );
+    dump_varargs_request_stats( ", stats=", cur_size );
+}
+
+static void dump_batch_request( const struct batch_request *req )
+{
+    dump_varargs_bytes( " requests=", cur_size );
+}
+
+static void dump_batch_reply( const struct batch_reply *req )
+{
+    fprintf( stderr, " count=%08x", req->count );
+    dump_varargs_bytes( ", replies=", cur_size );
+}
+
 static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_new_process_request,
     (dump_func)dump_get_new_process_info_request,
@@ -4510,6 +4576,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_release_semaphore_request,
     (dump_func)dump_query_semaphore_request,
     (dump_func)dump_open_semaphore_request,
+    (dump_func)dump_get_esync_fd_request,
     (dump_func)dump_create_file_request,
     (dump_func)dump_open_file_object_request,
     (dump_func)dump_alloc_file_handle_request,
@@ -4753,6 +4820,8 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_set_job_limits_request,
     (dump_func)dump_set_job_completion_port_request,
     (dump_func)dump_terminate_job_request,
+    (dump_func)dump_get_request_stats_request,
+    (dump_func)dump_batch_request,
 };
 
 static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
@@ -4784,7 +4853,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_open_thread_reply,
     (dump_func)dump_select_reply,
     (dump_func)dump_create_event_reply,
-    NULL,
+    (dump_func)dump_event_op_reply,
     (dump_func)dump_query_event_reply,
     (dump_func)dump_open_event_reply,
     (dump_func)dump_create_keyed_event_reply,
@@ -4797,6 +4866,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_release_semaphore_reply,
     (dump_func)dump_query_semaphore_reply,
     (dump_func)dump_open_semaphore_reply,
+    (dump_func)dump_get_esync_fd_reply,
     (dump_func)dump_create_file_reply,
     (dump_func)dump_open_file_object_reply,
     (dump_func)dump_alloc_file_handle_reply,
@@ -5040,6 +5110,8 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     NULL,
     NULL,
+    (dump_func)dump_get_request_stats_reply,
+    (dump_func)dump_batch_reply,
 };
 
 static const char * const req_names[REQ_NB_REQUESTS] = {
@@ -5084,6 +5156,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "release_semaphore",
     "query_semaphore",
     "open_semaphore",
+    "get_esync_fd",
     "create_file",
     "open_file_object",
     "alloc_file_handle",
@@ -5327,6 +5400,8 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "set_job_limits",
     "set_job_completion_port",
     "terminate_job",
+    "get_request_stats",
+    "batch",
 };
 
 static const struct
@@ -242,6 +242,7 @@ dumpers[] =
     {SIG_EMF,           get_kind_emf,   emf_dump},
     {SIG_FNT,           get_kind_fnt,   fnt_dump},
     {SIG_MSFT,          get_kind_msft,  msft_dump},
+    {SIG_TRACE,         get_kind_trace, trace_dump},
     {SIG_UNKNOWN,       NULL,           NULL} /* sentinel */
 };
 
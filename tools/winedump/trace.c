@@ -0,0 +1,328 @@
+/*
+ *  Dump a binary debug trace ring (WINEDEBUGRING)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "config.h"
+#include "wine/port.h"
+#include "winedump.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "windef.h"
+#include "winbase.h"
+#include "wine/debug_ring.h"
+
+struct trace_string
+{
+    ULONGLONG    key;
+    const char  *str;
+    unsigned int len;
+};
+
+static const struct debug_ring_header *header;
+static const char *string_table;
+static const char *ring_data;
+static struct trace_string *strings;
+static unsigned int nb_strings;
+
+/* return the next record of the ring, updating the position and the remaining size */
+static const struct debug_ring_record *next_record( unsigned int *pos, unsigned int *left )
+{
+    const struct debug_ring_record *rec;
+
+    while (*left)
+    {
+        if (*pos + sizeof(*rec) > header->size)  /* implicit wrap around */
+        {
+            if (header->size - *pos > *left) break;
+            *left -= header->size - *pos;
+            *pos = 0;
+            continue;
+        }
+        rec = (const struct debug_ring_record *)(ring_data + *pos);
+        if (rec->size < sizeof(*rec) || rec->size > *left || *pos + rec->size > header->size)
+        {
+            printf( "*** invalid record at offset %x\n", *pos );
+            break;
+        }
+        *left -= rec->size;
+        *pos += rec->size;
+        if (*pos == header->size) *pos = 0;
+        if (rec->type != DEBUG_RING_PAD) return rec;
+    }
+    return NULL;
+}
+
+static int compare_strings( const void *p1, const void *p2 )
+{
+    const struct trace_string *s1 = p1, *s2 = p2;
+
+    if (s1->key < s2->key) return -1;
+    return s1->key > s2->key;
+}
+
+static const struct trace_string *find_string( ULONGLONG key )
+{
+    struct trace_string str;
+
+    str.key = key;
+    return bsearch( &str, strings, nb_strings, sizeof(*strings), compare_strings );
+}
+
+static void add_string( const struct debug_ring_record *rec, unsigned int *size )
+{
+    if (rec->type != DEBUG_RING_STRING) return;
+    if (rec->len > rec->size - sizeof(*rec)) return;
+    if (nb_strings == *size)
+    {
+        *size = *size ? *size * 2 : 256;
+        strings = realloc( strings, *size * sizeof(*strings) );
+    }
+    strings[nb_strings].key = rec->key;
+    strings[nb_strings].str = (const char *)(rec + 1);
+    strings[nb_strings].len = rec->len;
+    nb_strings++;
+}
+
+static void load_strings(void)
+{
+    const struct debug_ring_record *rec;
+    unsigned int pos, left = header->used, size = 0, i, j;
+
+    /* the string table first, then the strings recorded in the ring once it was full */
+    for (pos = 0; pos + sizeof(*rec) <= header->strings_used; pos += rec->size)
+    {
+        rec = (const struct debug_ring_record *)(string_table + pos);
+        if (rec->size < sizeof(*rec) || pos + rec->size > header->strings_used)
+        {
+            printf( "*** invalid string record at offset %x\n", pos );
+            break;
+        }
+        add_string( rec, &size );
+    }
+
+    pos = header->tail;
+    while ((rec = next_record( &pos, &left ))) add_string( rec, &size );
+    if (!nb_strings) return;
+
+    /* strings are recorded again after being overwritten, remove the duplicates */
+    qsort( strings, nb_strings, sizeof(*strings), compare_strings );
+    for (i = j = 1; i < nb_strings; i++)
+        if (strings[i].key != strings[j - 1].key) strings[j++] = strings[i];
+    nb_strings = j;
+}
+
+/* copy a string to a null-terminated buffer, the ring contains the characters only */
+static const char *get_string( const char *str, unsigned int len, char *buffer, unsigned int size )
+{
+    if (len >= size) len = size - 1;
+    memcpy( buffer, str, len );
+    buffer[len] = 0;
+    return buffer;
+}
+
+/* print a message by applying the recorded arguments to its format */
+static void print_message( const char *format, const char *args, const char *end )
+{
+    char spec[64], str[DEBUG_RING_MAX_STRING + 1];
+    const char *start, *next, *p;
+    enum debug_ring_arg type;
+    unsigned int stars, len, str_len;
+    int precision;
+    ULONGLONG value;
+    double d;
+
+    while (*format)
+    {
+        start = debug_ring_parse_format( format, &next, &stars, &precision, &type );
+        for (p = format; p < start; p++)
+        {
+            putchar( *p );
+            if (p[0] == '%' && p[1] == '%') p++;
+        }
+        format = start;
+        if (type == DEBUG_RING_ARG_NONE) break;
+        if (args + (stars + (type != DEBUG_RING_ARG_STRING)) * sizeof(value) > end) break;
+        if (type == DEBUG_RING_ARG_STRING && args + stars * sizeof(value) + sizeof(WORD) > end) break;
+
+        /* rebuild the conversion with a 64-bit size, the writer may have a different ABI */
+        len = 0;
+        spec[len++] = '%';
+        for (p = start + 1; *p && strchr( "-+ #0123456789.*'", *p ) && len < sizeof(spec) - 16; p++)
+        {
+            if (*p != '*')
+            {
+                spec[len++] = *p;
+                continue;
+            }
+            memcpy( &value, args, sizeof(value) );
+            args += sizeof(value);
+            /* a negative precision is ignored */
+            if (p[-1] == '.' && (int)value < 0) len--;
+            else len += sprintf( spec + len, "%d", (int)value );
+        }
+
+        switch (type)
+        {
+        case DEBUG_RING_ARG_STRING:
+            str_len = (unsigned char)args[0] | ((unsigned char)args[1] << 8);
+            args += sizeof(WORD);
+            sprintf( spec + len, "s" );
+            if (str_len == DEBUG_RING_NULL_STRING) printf( spec, "(null)" );
+            else if (args + str_len <= end)
+            {
+                printf( spec, get_string( args, str_len, str, sizeof(str) ));
+                args += str_len;
+            }
+            break;
+        case DEBUG_RING_ARG_DOUBLE:
+            memcpy( &d, args, sizeof(d) );
+            args += sizeof(d);
+            sprintf( spec + len, "%c", next[-1] );
+            printf( spec, d );
+            break;
+        case DEBUG_RING_ARG_PTR:
+            memcpy( &value, args, sizeof(value) );
+            args += sizeof(value);
+            if (value >> 32) printf( "0x%x%08x", (unsigned int)(value >> 32), (unsigned int)value );
+            else if (value) printf( "0x%x", (unsigned int)value );
+            else printf( "(nil)" );
+            break;
+        default:
+            memcpy( &value, args, sizeof(value) );
+            args += sizeof(value);
+            if (next[-1] == 'c')
+            {
+                sprintf( spec + len, "c" );
+                printf( spec, (int)value );
+            }
+            else
+            {
+                sprintf( spec + len, "ll%c", next[-1] );
+                printf( spec, value );
+            }
+            break;
+        }
+        format = next;
+    }
+    for (p = format; *p; p++)
+    {
+        putchar( *p );
+        if (p[0] == '%' && p[1] == '%') p++;
+    }
+}
+
+void trace_dump(void)
+{
+    static const char * const classes[] = { "fixme", "err", "warn", "trace" };
+    char format[DEBUG_RING_MAX_RECORD], channel[32], function[256];
+    const struct debug_ring_event *event;
+    const struct debug_ring_record *rec;
+    const struct trace_string *str;
+    unsigned int pos, left, count = 0;
+    ULONGLONG time;
+    BOOL line_start = TRUE;
+
+    header = PRD(0, sizeof(*header));
+    if (!header || header->version != DEBUG_RING_VERSION ||
+        !(string_table = PRD(sizeof(*header), header->strings_size + header->size)))
+    {
+        printf( header ? "Unsupported or truncated trace ring\n" : "Truncated trace ring\n" );
+        return;
+    }
+    ring_data = string_table + header->strings_size;
+
+    printf( "Trace ring\n" );
+    printf( "----------\n\n" );
+    printf( "Version:        %u\n", header->version );
+    printf( "Process:        %04x\n", header->pid );
+    printf( "Thread:         %04x\n", header->tid );
+    printf( "Data size:      %u\n", header->size );
+    printf( "Long size:      %u\n", header->long_size );
+    printf( "Pointer size:   %u\n", header->ptr_size );
+    printf( "Used:           %u (tail %x head %x)\n", header->used, header->tail, header->head );
+    printf( "Dropped:        %u\n", header->dropped );
+    printf( "String table:   %u/%u\n", header->strings_used, header->strings_size );
+    printf( "Start time:     %s\n",
+            get_time_str( (header->start_time - 116444736000000000) / 10000000 ));
+    printf( "\n" );
+
+    if (header->tail >= header->size || header->used > header->size ||
+        header->strings_used > header->strings_size || !header->frequency)
+    {
+        printf( "Unsupported trace ring\n" );
+        return;
+    }
+
+    load_strings();
+
+    pos = header->tail;
+    left = header->used;
+    while ((rec = next_record( &pos, &left )))
+    {
+        if (rec->type != DEBUG_RING_EVENT) continue;
+        event = (const struct debug_ring_event *)rec;
+        if (rec->size < sizeof(*event) || rec->len > rec->size - sizeof(*event)) continue;
+        count++;
+
+        if (rec->cls != DEBUG_RING_NO_CLASS && line_start)
+        {
+            time = (event->time - header->start_counter) * 1000000 / header->frequency;
+            printf( "%3u.%06u:%04x:%04x:", (unsigned int)(time / 1000000),
+                    (unsigned int)(time % 1000000), header->pid, header->tid );
+            if ((str = find_string( event->channel )))
+                get_string( str->str, str->len, channel, sizeof(channel) );
+            else
+                strcpy( channel, "?" );
+            if ((str = find_string( event->function )))
+                get_string( str->str, str->len, function, sizeof(function) );
+            else
+                strcpy( function, "?" );
+            if (rec->cls < sizeof(classes) / sizeof(classes[0]))
+                printf( "%s:%s:%s ", classes[rec->cls], channel, function );
+        }
+
+        if (!rec->key) continue;
+        if (!(str = find_string( rec->key )))
+        {
+            printf( "<format %x%08x overwritten>\n", (unsigned int)(rec->key >> 32), (unsigned int)rec->key );
+            line_start = TRUE;
+            continue;
+        }
+        get_string( str->str, str->len, format, sizeof(format) );
+        print_message( format, (const char *)(event + 1), (const char *)(event + 1) + rec->len );
+        line_start = str->len && format[str->len - 1] == '\n';
+    }
+    if (!line_start) printf( "\n" );
+    printf( "\n%u events\n", count );
+
+    free( strings );
+    strings = NULL;
+    nb_strings = 0;
+}
+
+enum FileSig get_kind_trace(void)
+{
+    const struct debug_ring_header *hdr;
+
+    hdr = PRD(0, sizeof(*hdr));
+    if (hdr && hdr->magic == DEBUG_RING_MAGIC) return SIG_TRACE;
+    return SIG_UNKNOWN;
+}